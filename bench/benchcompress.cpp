@@ -0,0 +1,91 @@
+#include "imagedecoder.h"
+#include "blockcompress.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// Peak signal to noise ratio over the given channels of two RGBA8 images
+static double Psnr(const std::vector<UINT8>& a, const std::vector<UINT8>& b, UINT firstChannel, UINT channelCount)
+{
+	double squared = 0.0;
+	size_t samples = 0;
+	for (size_t i = 0; i < a.size(); i += 4) {
+		for (UINT c = firstChannel; c < firstChannel + channelCount; c++) {
+			double difference = (double)a[i + c] - b[i + c];
+			squared += difference * difference;
+			samples++;
+		}
+	}
+	return squared == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 * samples / squared);
+}
+
+// Encodes level 0 of the shipped images to BC1, BC3, BC5 and BC7 on one thread and on a
+// worker per hardware thread, reporting p50 encode time, throughput and the PSNR of the
+// decoded blocks against the source over the channels each format keeps.
+int main(int argc, char* args[]) {
+
+	int iterations = argc > 1 ? atoi(args[1]) : 3;
+	if (iterations <= 0) {
+		printf("usage: bench_compress [iterations]\n");
+		return 1;
+	}
+
+	WorkerPool workers;
+	workers.Init();
+	printf("bench_compress: %d iterations, %u workers\n", iterations, workers.GetThreadCount());
+
+	struct Format {
+		const char* name;
+		DXGI_FORMAT format;
+		UINT firstChannel, channelCount;
+	};
+	const Format formats[] = {
+		{ "BC1", DXGI_FORMAT_BC1_UNORM, 0, 3 },
+		{ "BC3", DXGI_FORMAT_BC3_UNORM, 0, 4 },
+		{ "BC5", DXGI_FORMAT_BC5_UNORM, 0, 2 },
+		{ "BC7", DXGI_FORMAT_BC7_UNORM, 0, 4 },
+	};
+
+	ImageDecoder decoder;
+	for (const char* name : { "gato.png", "brick_color.jpg" })
+	{
+		ImageData image;
+		if (!decoder.Load(std::string(ASSET_DIR "/") + name, DXGI_FORMAT_R8G8B8A8_UNORM, &image)) {
+			printf("bench_compress: could not decode %s\n", name);
+			return 1;
+		}
+		printf("  %s %ux%u\n", name, image.width, image.height);
+
+		for (const Format& format : formats)
+		{
+			UINT blocksWide = (image.width + 3) / 4, blocksHigh = (image.height + 3) / 4;
+			std::vector<UINT8> blocks((size_t)blocksWide * blocksHigh * GetBlockSize(format.format));
+			double p50[2];
+			for (UINT threaded = 0; threaded < 2; threaded++)
+			{
+				std::vector<double> times(iterations);
+				for (int i = 0; i < iterations; i++) {
+					auto start = std::chrono::steady_clock::now();
+					CompressImage(image.pixels.data(), image.width, image.height, format.format, blocks.data(), threaded ? &workers : nullptr);
+					auto end = std::chrono::steady_clock::now();
+					times[i] = std::chrono::duration<double, std::milli>(end - start).count();
+				}
+				std::sort(times.begin(), times.end());
+				p50[threaded] = times[(iterations - 1) / 2];
+			}
+
+			std::vector<UINT8> decoded(image.pixels.size());
+			if (!DecompressImage(blocks.data(), image.width, image.height, format.format, decoded.data())) {
+				printf("bench_compress: could not decode the %s blocks\n", format.name);
+				return 1;
+			}
+			printf("    %s  1 thread %.1f ms  %.1f Mpixel/s  %u threads %.1f ms  %.1f Mpixel/s  PSNR %.2f dB\n", format.name,
+				p50[0], image.width * image.height / (p50[0] * 1000.0), workers.GetThreadCount(), p50[1], image.width * image.height / (p50[1] * 1000.0),
+				Psnr(image.pixels, decoded, format.firstChannel, format.channelCount));
+		}
+	}
+	return 0;
+}
\ No newline at end of file
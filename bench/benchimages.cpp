@@ -0,0 +1,177 @@
+#include "imagedecoder.h"
+#include "colorconvert.h"
+#include "textureloader.h"
+#include "mipgenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+
+#define BENCH_DIRECTORY_COPIES 100
+
+// Loads every image in the directory through the texture loader with the given number of
+// decode workers, returns the wall time in milliseconds or a negative value on failure
+static double LoadDirectory(const std::vector<std::filesystem::path>& files, UINT threadCount)
+{
+	TextureLoader loader;
+	loader.Init(threadCount);
+	std::unique_ptr<Texture[]> textures(new Texture[files.size()]);
+
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < files.size(); i++) {
+		loader.Queue(&textures[i], files[i]);
+	}
+	Texture* tex;
+	bool loaded = true;
+	while (loader.PopDecoded(&tex, true)) {
+		loaded = loaded && tex->GetState() == TS_DECODED;
+		tex->CleanObsoleteTextureData();
+	}
+	auto end = std::chrono::steady_clock::now();
+	return loaded ? std::chrono::duration<double, std::milli>(end - start).count() : -1.0;
+}
+
+// Times decoding of the shipped images straight into a reused RGBA8 buffer, the YCbCr
+// conversion and box/Kaiser mip chain generation on their own (scalar and with the build's
+// instruction set), and loading a whole
+// directory of images on 1, 2, 4, ... decode workers. Without a directory a temporary one
+// holding copies of the shipped images is used.
+int main(int argc, char* args[]) {
+
+	int iterations = argc > 1 ? atoi(args[1]) : 20;
+	if (iterations <= 0) {
+		printf("usage: bench_images [iterations] [directory]\n");
+		return 1;
+	}
+
+	printf("bench_images: %d iterations, %s colour conversion, %s mip filters\n", iterations, GetColorConvertPath(), GetMipGeneratorPath());
+
+	ImageDecoder decoder;
+	std::vector<double> times(iterations);
+	for (const char* name : { "gato.png", "brick_color.jpg" })
+	{
+		std::ifstream file(std::string(ASSET_DIR "/") + name, std::ios::binary | std::ios::ate);
+		std::vector<UINT8> data(file ? (size_t)file.tellg() : 0);
+		file.seekg(0);
+		ImageInfo info;
+		if (!file.read(reinterpret_cast<char*>(data.data()), data.size()) || !ImageDecoder::ReadInfo(data, &info)) {
+			printf("bench_images: could not read %s\n", name);
+			return 1;
+		}
+
+		std::vector<UINT8> pixels((size_t)info.width * info.height * 4);
+		for (int i = 0; i < iterations; i++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			if (!decoder.Decode(data, DXGI_FORMAT_R8G8B8A8_UNORM, pixels.data(), info.width * 4)) {
+				printf("bench_images: could not decode %s\n", name);
+				return 1;
+			}
+			auto end = std::chrono::steady_clock::now();
+			times[i] = std::chrono::duration<double, std::milli>(end - start).count();
+		}
+
+		std::sort(times.begin(), times.end());
+		double p50 = times[(iterations - 1) / 2];
+		printf("  %-16s %ux%u  p50 %.3f ms  max %.3f ms  %.1f Mpixel/s\n", name, info.width, info.height,
+			p50, times[iterations - 1], info.width * info.height / (p50 * 1000.0));
+	}
+
+	// Colour conversion alone over a 1024x1024 image worth of rows
+	const UINT width = 1024, rows = 1024;
+	std::vector<UINT8> y(width), cb(width), cr(width), rgba((size_t)width * 4);
+	for (UINT i = 0; i < width; i++) {
+		y[i] = (UINT8)(i * 7); cb[i] = (UINT8)(i * 13); cr[i] = (UINT8)(i * 29);
+	}
+	for (bool scalar : { true, false })
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++) {
+			for (UINT row = 0; row < rows; row++) {
+				if (scalar) ConvertYCbCrToRgbaScalar(y.data(), cb.data(), cr.data(), rgba.data(), width, false);
+				else ConvertYCbCrToRgba(y.data(), cb.data(), cr.data(), rgba.data(), width, false);
+			}
+		}
+		auto end = std::chrono::steady_clock::now();
+		double ms = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+		printf("  ycbcr to rgba    %-6s %.3f ms per Mpixel\n", scalar ? "scalar" : GetColorConvertPath(), ms);
+	}
+
+	// Mip chain of a 1024x1024 image, each level filtered from the one above
+	UINT mipLevels = GetMipLevelCount(width, rows);
+	MipLevel levels[D3D12_REQ_MIP_LEVELS];
+	std::vector<UINT8> chain((size_t)GetMipChainLayout(width, rows, mipLevels, levels));
+	for (size_t i = 0; i < (size_t)width * rows * 4; i++) {
+		chain[i] = (UINT8)((i * 2654435761u) >> 13);
+	}
+	for (MIP_FILTER filter : { MF_BOX, MF_KAISER })
+	{
+		for (bool scalar : { true, false })
+		{
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; i++) {
+				for (UINT mip = 1; mip < mipLevels; mip++) {
+					const UINT8* src = chain.data() + levels[mip - 1].offset;
+					UINT8* dst = chain.data() + levels[mip].offset;
+					if (filter == MF_BOX) {
+						if (scalar) DownsampleBoxScalar(src, levels[mip - 1].width, levels[mip - 1].height, dst);
+						else DownsampleBox(src, levels[mip - 1].width, levels[mip - 1].height, dst);
+					}
+					else {
+						if (scalar) DownsampleKaiserScalar(src, levels[mip - 1].width, levels[mip - 1].height, dst);
+						else DownsampleKaiser(src, levels[mip - 1].width, levels[mip - 1].height, dst);
+					}
+				}
+			}
+			auto end = std::chrono::steady_clock::now();
+			double ms = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+			printf("  %-6s mips      %-6s %.3f ms per 1024x1024 chain\n", filter == MF_BOX ? "box" : "kaiser", scalar ? "scalar" : GetMipGeneratorPath(), ms);
+		}
+	}
+
+	// Directory Load
+	std::filesystem::path directory = argc > 2 ? std::filesystem::path(args[2]) : std::filesystem::temp_directory_path() / "bench_images";
+	std::error_code error;
+	if (argc <= 2) {
+		std::filesystem::create_directories(directory, error);
+		for (int i = 0; i < BENCH_DIRECTORY_COPIES; i++) {
+			for (const char* name : { "gato.png", "brick_color.jpg" }) {
+				std::filesystem::path copy = directory / (std::to_string(i) + "_" + name);
+				std::filesystem::copy_file(std::string(ASSET_DIR "/") + name, copy, std::filesystem::copy_options::skip_existing, error);
+			}
+		}
+	}
+	std::vector<std::filesystem::path> files;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, error)) {
+		std::string extension = entry.path().extension().string();
+		if (extension == ".png" || extension == ".jpg" || extension == ".jpeg") {
+			files.push_back(entry.path());
+		}
+	}
+	if (files.empty()) {
+		printf("bench_images: no images in %s\n", directory.string().c_str());
+		return 1;
+	}
+
+	UINT hardwareThreads = std::max<UINT>(1, std::thread::hardware_concurrency());
+	printf("  directory        %zu images, %u hardware threads\n", files.size(), hardwareThreads);
+	double singleThreadMs = 0.0;
+	for (UINT threadCount = 1; threadCount <= hardwareThreads * 2; threadCount *= 2)
+	{
+		double ms = LoadDirectory(files, threadCount);
+		if (ms < 0.0) {
+			printf("bench_images: could not decode every image in %s\n", directory.string().c_str());
+			return 1;
+		}
+		singleThreadMs = threadCount == 1 ? ms : singleThreadMs;
+		printf("  %2u workers       %.1f ms wall  %.1f images/s  %.2fx\n", threadCount, ms, files.size() * 1000.0 / ms, singleThreadMs / ms);
+	}
+
+	if (argc <= 2) {
+		std::filesystem::remove_all(directory, error);
+	}
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "headlessdevice.h"
+#include "mockcommandlist.h"
+#include "framerecorder.h"
+#include "frameupdater.h"
+#include "scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Every heap allocation made while the benchmark runs goes through here
+static UINT64 allocationCount = 0;
+
+// Array and nothrow forms are replaced too, so every new is malloc and pairs with the free below.
+// Kept out of line, GCC otherwise sees malloc or free inlined against operator new or delete and warns.
+#if defined(_MSC_VER)
+#define ALLOC_NOINLINE __declspec(noinline)
+#else
+#define ALLOC_NOINLINE __attribute__((noinline))
+#endif
+
+static void* CountedAlloc(size_t size) noexcept
+{
+	allocationCount++;
+	return malloc(size ? size : 1);
+}
+
+ALLOC_NOINLINE void* operator new(size_t size)
+{
+	if (void* p = CountedAlloc(size)) return p;
+	throw std::bad_alloc();
+}
+
+ALLOC_NOINLINE void* operator new[](size_t size)
+{
+	if (void* p = CountedAlloc(size)) return p;
+	throw std::bad_alloc();
+}
+
+ALLOC_NOINLINE void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+ALLOC_NOINLINE void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+
+ALLOC_NOINLINE void operator delete(void* p) noexcept { free(p); }
+ALLOC_NOINLINE void operator delete(void* p, size_t) noexcept { free(p); }
+ALLOC_NOINLINE void operator delete[](void* p) noexcept { free(p); }
+ALLOC_NOINLINE void operator delete[](void* p, size_t) noexcept { free(p); }
+ALLOC_NOINLINE void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+ALLOC_NOINLINE void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+// Measures the CPU cost of one frame as the renderer runs it: the frame update (frame slot,
+// scene, texture cache, streaming requests, constants, rebinding on a variant change) and
+// command list recording, against a recording command list and a fake GPU.
+int main(int argc, char* args[]) {
+
+	int frameCount = argc > 1 ? atoi(args[1]) : 10000;
+	if (frameCount <= 0) {
+		printf("usage: bench_renderer [frames]\n");
+		return 1;
+	}
+
+	HeadlessDevice* device = new HeadlessDevice();
+	MockCommandList* commandList = new MockCommandList();
+
+	// Create Command Queue, Frame Scheduler & Texture Streaming
+	D3D12_COMMAND_QUEUE_DESC cqDesc = {};
+	ID3D12CommandQueue* commandQueue;
+	device->CreateCommandQueue(&cqDesc, IID_PPV_ARGS(&commandQueue));
+	GpuTimeline gpuTimeline;
+	FrameScheduler frameScheduler;
+	ResourceManager resourceManager;
+	AsyncUploader uploader;
+	TextureCache textureCache;
+	TextureStreamer textureStreamer;
+	if (!gpuTimeline.Init(device, commandQueue) || !frameScheduler.Init(device, &gpuTimeline, FRAMES_IN_FLIGHT) ||
+		!resourceManager.Init(device, &gpuTimeline) || !uploader.Init(device) ||
+		!textureCache.Init(&resourceManager, &uploader, &gpuTimeline) || !textureStreamer.Init(device, &uploader, &gpuTimeline))
+	{
+		printf("bench_renderer: failed to create the frame resources\n");
+		return 1;
+	}
+
+	// The scene texture through the cache and a streamed 512x512 chain, as the renderer loads them
+	TextureHandle sceneTexture = textureCache.Acquire(ASSET_DIR "/gato.png");
+	D3D12_RESOURCE_DESC streamedDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 512, 512, 1, 10);
+	std::vector<std::vector<UINT8>> levels(streamedDesc.MipLevels);
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources(streamedDesc.MipLevels);
+	for (UINT mip = 0; mip < streamedDesc.MipLevels; mip++)
+	{
+		UINT size = std::max<UINT>(1, 512 >> mip);
+		levels[mip].assign((size_t)size * size * 4, (UINT8)(mip * 25));
+		subresources[mip] = { levels[mip].data(), (LONG_PTR)size * 4, (LONG_PTR)size * size * 4 };
+	}
+	UINT32 streamedTexture = textureStreamer.Register(streamedDesc, subresources.data(), L"Streamed Texture Resource");
+	textureCache.WaitForResident(sceneTexture);
+	uploader.Flush();
+
+	// Create Constant Buffer Resource Heap, one slice per frame in flight like the renderer
+	int alignedSize = (sizeof(ConstantBufferPerObject) + 255) & ~255;
+	int sliceSize = alignedSize * 2; // Cube & Plane
+	CD3DX12_HEAP_PROPERTIES uHeapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resoDesc = CD3DX12_RESOURCE_DESC::Buffer(sliceSize * FRAMES_IN_FLIGHT);
+	ID3D12Resource* constantBufferUploadHeap;
+	UINT8* cbvGPUAddress;
+	device->CreateCommittedResource(&uHeapProp, D3D12_HEAP_FLAG_NONE, &resoDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&constantBufferUploadHeap));
+	CD3DX12_RANGE readRange(0, 0);
+	constantBufferUploadHeap->Map(0, &readRange, reinterpret_cast<void**>(&cbvGPUAddress));
+
+	// Create Render Target & Geometry stand-ins
+	CD3DX12_HEAP_PROPERTIES dHeapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	CD3DX12_RESOURCE_DESC geometryDesc = CD3DX12_RESOURCE_DESC::Buffer(2048);
+	ID3D12Resource* backBuffer;
+	ID3D12Resource* geometryBuffer;
+	device->CreateCommittedResource(&dHeapProp, D3D12_HEAP_FLAG_NONE, &geometryDesc,
+		D3D12_RESOURCE_STATE_PRESENT, nullptr, IID_PPV_ARGS(&backBuffer));
+	device->CreateCommittedResource(&dHeapProp, D3D12_HEAP_FLAG_NONE, &geometryDesc,
+		D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&geometryBuffer));
+
+	// Same draws as the app: 36 index cube, 6 index plane, fullscreen triangle
+	FrameBindings bindings;
+	bindings.vertexBufferView = { geometryBuffer->GetGPUVirtualAddress(), 1024, sizeof(Vertex) };
+	bindings.indexBufferView16 = { geometryBuffer->GetGPUVirtualAddress() + 1024, 512, DXGI_FORMAT_R16_UINT };
+	bindings.indexBufferView32 = { geometryBuffer->GetGPUVirtualAddress() + 1536, 512, DXGI_FORMAT_R32_UINT };
+	bindings.cube = { 0, 0, 36, 24, DXGI_FORMAT_R16_UINT };
+	bindings.renderTri = { 24, 36, 3, 3, DXGI_FORMAT_R16_UINT };
+	bindings.plane = { 27, 39, 6, 4, DXGI_FORMAT_R16_UINT };
+	bindings.viewport = { 0.0f, 0.0f, (float)DEFAULT_WINDOW_WIDTH, (float)DEFAULT_WINDOW_HEIGHT, 0.0f, 1.0f };
+	bindings.scissorRect = { 0, 0, DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT };
+	bindings.smViewport = { 0.0f, 0.0f, 512.0f, 512.0f, 0.0f, 1.0f };
+	bindings.smScissorRect = { 0, 0, 512, 512 };
+
+	// Stand-in pipelines indexed by variant mask, rebound like Renderer::FillFrameBindings
+	ID3D12PipelineState* scenePSOs[1 << 2];
+	ID3D12PipelineState* postPSOs[1 << 3];
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+	for (ID3D12PipelineState*& pso : scenePSOs) {
+		device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pso));
+	}
+	for (ID3D12PipelineState*& pso : postPSOs) {
+		device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pso));
+	}
+
+	Scene scene;
+	scene.Init(DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT);
+	scene.GetSettings().rotateY = true;
+
+	FrameRecorder frameRecorder;
+	auto fillFrameBindings = [&]() {
+		bindings.scenePSO = scenePSOs[scene.GetLightingMask()];
+		bindings.postPSO = postPSOs[scene.GetPostMask()];
+		frameRecorder.SetBindings(bindings);
+	};
+	fillFrameBindings();
+
+	FrameTargets targets;
+	targets.frameScheduler = &frameScheduler;
+	targets.scene = &scene;
+	targets.textureCache = &textureCache;
+	targets.textureStreamer = &textureStreamer;
+	targets.streamedTexture = streamedTexture;
+	targets.viewportHeight = (float)DEFAULT_WINDOW_HEIGHT;
+	targets.constantBuffer = cbvGPUAddress;
+	targets.constantBufferSliceSize = sliceSize;
+	targets.constantBufferStride = alignedSize;
+	FrameUpdater frameUpdater;
+	frameUpdater.SetTargets(targets);
+
+	std::vector<double> frameTimes(frameCount);
+	D3D12_CPU_DESCRIPTOR_HANDLE backBufferRtv = {};
+	UINT64 constantBytes = 0;
+	UINT64 rebinds = 0;
+	UINT64 startAllocations = allocationCount;
+	UINT64 startCommands = commandList->GetCommandCount();
+	UINT64 startDraws = commandList->GetDrawCount();
+
+	for (int frame = 0; frame < frameCount; frame++)
+	{
+		// Switch the post process option now and then, as the menu would
+		if (frame % 1000 == 999) {
+			scene.GetSettings().ppOption = (scene.GetSettings().ppOption + 1) % 4;
+		}
+		auto start = std::chrono::steady_clock::now();
+
+		if (frameUpdater.Update(16.0f)) {
+			fillFrameBindings();
+			rebinds++;
+		}
+		int frameSlot = frameUpdater.GetFrameSlot();
+		constantBytes += frameUpdater.GetConstantBytes();
+
+		commandList->Reset(frameScheduler.GetCommandAllocator(frameSlot), nullptr);
+		CD3DX12_RESOURCE_BARRIER resoBarr = CD3DX12_RESOURCE_BARRIER::Transition(backBuffer, D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+		commandList->ResourceBarrier(1, &resoBarr);
+		frameRecorder.RecordPasses(commandList, constantBufferUploadHeap->GetGPUVirtualAddress() + frameSlot * sliceSize, alignedSize, backBufferRtv, true);
+		resoBarr = CD3DX12_RESOURCE_BARRIER::Transition(backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+		commandList->ResourceBarrier(1, &resoBarr);
+		commandList->Close();
+		ID3D12CommandList* ppCommandLists[] = { commandList };
+		commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+		textureCache.MarkUsed(sceneTexture, frameScheduler.EndFrame());
+
+		auto end = std::chrono::steady_clock::now();
+		frameTimes[frame] = std::chrono::duration<double, std::micro>(end - start).count();
+	}
+
+	gpuTimeline.WaitForIdle();
+	UINT64 allocations = allocationCount - startAllocations;
+	UINT64 commands = commandList->GetCommandCount() - startCommands;
+	UINT64 draws = commandList->GetDrawCount() - startDraws;
+
+	std::sort(frameTimes.begin(), frameTimes.end());
+	double p50 = frameTimes[(frameCount - 1) * 50 / 100];
+	double p99 = frameTimes[(frameCount - 1) * 99 / 100];
+	double max = frameTimes[frameCount - 1];
+
+	printf("bench_renderer: %d frames\n", frameCount);
+	printf("  cpu frame time   p50 %.3f us  p99 %.3f us  max %.3f us\n", p50, p99, max);
+	printf("  allocations      %.2f per frame\n", (double)allocations / frameCount);
+	printf("  constant buffer  %.1f bytes per frame\n", (double)constantBytes / frameCount);
+	printf("  command list     %.1f commands, %.1f draws per frame\n", (double)commands / frameCount, (double)draws / frameCount);
+	printf("  pipelines        %llu rebinds, texture resident from mip %u\n", (unsigned long long)rebinds, textureStreamer.GetResidentMip(streamedTexture));
+
+	for (ID3D12PipelineState*& pso : scenePSOs) {
+		SAFE_RELEASE(pso);
+	}
+	for (ID3D12PipelineState*& pso : postPSOs) {
+		SAFE_RELEASE(pso);
+	}
+	textureCache.Release(sceneTexture);
+	textureCache.UnInit();
+	textureStreamer.UnInit();
+	uploader.UnInit();
+	resourceManager.UnInit();
+	frameScheduler.UnInit();
+	gpuTimeline.UnInit();
+	SAFE_RELEASE(commandQueue);
+	SAFE_RELEASE(geometryBuffer);
+	SAFE_RELEASE(backBuffer);
+	SAFE_RELEASE(constantBufferUploadHeap);
+	SAFE_RELEASE(commandList);
+	delete device;
+
+	return 0;
+}
\ No newline at end of file
@@ -16,7 +16,7 @@ cbuffer ConstantBuffer : register(b0)
     float4 lDir;
     float4 camPos;
     float3 dsa;
-    uint postP;
+    uint padding;
 };
 
 PS_INPUT main(VS_INPUT input)
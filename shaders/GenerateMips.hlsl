@@ -0,0 +1,21 @@
+Texture2D<float4> srcMip : register(t0);
+RWTexture2D<float4> dstMip : register(u0);
+SamplerState linearClamp : register(s0);
+
+cbuffer MipConstants : register(b0)
+{
+    uint2 dstSize;
+    float2 texelSize;
+};
+
+// One destination texel per thread, a bilinear tap at its centre averages the 2x2 texels above it
+[numthreads(8, 8, 1)]
+void main(uint3 id : SV_DispatchThreadID)
+{
+    if (id.x >= dstSize.x || id.y >= dstSize.y)
+    {
+        return;
+    }
+    float2 uv = (id.xy + 0.5f) * texelSize;
+    dstMip[id.xy] = srcMip.SampleLevel(linearClamp, uv, 0);
+}
\ No newline at end of file
@@ -2,14 +2,13 @@ Texture2D t1 : register(t1);
 Texture2D t2 : register(t2);
 SamplerState s1 : register(s0);
 
-#define BOX_BLUR float3x3(1, 1, 1, 1, 1, 1, 1, 1, 1) * 0.1111f
-#define GAUSSIAN_BLUR float3x3(1, 2, 1, 2, 4, 2, 1, 2, 1) * 0.0625f
+#define BOX_BLUR_KERNEL float3x3(1, 1, 1, 1, 1, 1, 1, 1, 1) * 0.1111f
+#define GAUSSIAN_BLUR_KERNEL float3x3(1, 2, 1, 2, 4, 2, 1, 2, 1) * 0.0625f
 
 struct VS_OUTPUT
 {
     float4 pos : SV_POSITION;
     float2 texCoord : TEXCOORD;
-    uint postPOption : OPTIONS;
 };
 
 // Adapted from the Shadertoy Example in the slides https://www.shadertoy.com/view/fd3Szs
@@ -33,32 +32,18 @@ float4 convolute(float2 uv, float3x3 kernel)
     return float4(blurColor, 1.0f);
 }
 
+// One variant per option, compiled with at most one of SHOW_SHADOW_MAP, BOX_BLUR and
+// GAUSSIAN_BLUR defined
 float4 main(VS_OUTPUT input) : SV_TARGET
 {
-    switch (input.postPOption)
-    {
-        // Normal
-        case 0:
-            return t1.Sample(s1, input.texCoord);
-            break;
-        
-        // Shadow Map
-        case 1:
-            float shadowColor = t2.Sample(s1, input.texCoord).r;
-            return float4(float3(shadowColor, shadowColor, shadowColor), 1.0f);
-            //break;
-        
-        // Box Blur
-        case 2:
-            return convolute(input.texCoord, BOX_BLUR);
-            break;
-        
-        // Gaussian Blur
-        case 3:
-            return convolute(input.texCoord, GAUSSIAN_BLUR);
-            break;
-    }
-    
-    // Normal if nothing is selected
+#if defined(SHOW_SHADOW_MAP)
+    float shadowColor = t2.Sample(s1, input.texCoord).r;
+    return float4(float3(shadowColor, shadowColor, shadowColor), 1.0f);
+#elif defined(BOX_BLUR)
+    return convolute(input.texCoord, BOX_BLUR_KERNEL);
+#elif defined(GAUSSIAN_BLUR)
+    return convolute(input.texCoord, GAUSSIAN_BLUR_KERNEL);
+#else
     return float4(t1.Sample(s1, input.texCoord).rgb, 1.0f);
+#endif
 }
\ No newline at end of file
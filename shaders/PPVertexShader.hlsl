@@ -8,7 +8,6 @@ struct VS_OUTPUT
 {
     float4 pos : SV_POSITION;
     float2 texCoord : TEXCOORD;
-    uint postPOption : OPTIONS;
 };
 
 cbuffer ConstantBuffer : register(b0)
@@ -19,7 +18,7 @@ cbuffer ConstantBuffer : register(b0)
     float4 lDir;
     float4 camPos;
     float3 dsa;
-    uint postP;
+    uint padding;
 };
 
 VS_OUTPUT main(VS_INPUT input)
@@ -27,6 +26,5 @@ VS_OUTPUT main(VS_INPUT input)
     VS_OUTPUT output;
     output.pos = float4(input.pos.x, input.pos.y, 0.0f, 1.0f);
     output.texCoord = input.texCoord;
-    output.postPOption = postP;
     return output;
 }
\ No newline at end of file
@@ -19,7 +19,8 @@ cbuffer ConstantBuffer : register(b0)
     float4 lDir;
     float4 camPos;
     float3 dsa;
-    uint postP;
+    uint padding;
+    float minLod;
 };
 
 float ShadowCalculation(float4 lightSpacePos, float bias)
@@ -39,13 +40,23 @@ float4 main(PS_INPUT input) : SV_TARGET
     float diffuseFactor = mul(0.5f, saturate(max(dot(normal, saturate(lDir.xyz)), 0.0f)));
     float3 toEye = normalize(camPos.xyz - input.worldPos.xyz);
     float3 halfway = normalize(saturate(lDir.xyz) + toEye);
+    // SPECULAR and SHADOWS are keywords, each combination compiles into its own variant
+#if defined(SPECULAR)
     float specularFactor = pow(max(dot(normal, halfway), 0.0f), 128);
+#else
+    float specularFactor = 0.0f;
+#endif
+#if defined(SHADOWS)
     float bias = max(mul(0.05, (1.0 - dot(normal, lDir.xyz))), 0.005);
     float shadow = ShadowCalculation(input.fragPosLightSpace, bias);
+#else
+    float shadow = 0.0f;
+#endif
     
     float3 lightColor = mul(saturate(mul(dsa.x, diffuseFactor) + mul(dsa.y, specularFactor)), _LightColor);
     lightColor += mul(_AmbientColor + (1.0f - shadow), dsa.z);
-    float3 objectColor = t1.Sample(s1, input.texCoord).rgb;
+    // Streamed levels finer than minLod may not be mapped yet
+    float3 objectColor = t1.Sample(s1, input.texCoord, int2(0, 0), minLod).rgb;
     float3 passColor = saturate(objectColor * lightColor);
     
     return float4(passColor, 1.0f);
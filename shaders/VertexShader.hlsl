@@ -1,7 +1,11 @@
 struct VS_INPUT
 {
     float4 pos : POSITION;
+#ifdef PACKED_VERTICES
+    float2 norm : NORMALS;
+#else
     float3 norm : NORMALS;
+#endif
     float2 texCoord : TEXCOORD;
 };
 
@@ -22,16 +26,32 @@ cbuffer ConstantBuffer : register(b0)
     float4 lDir;
     float4 camPos;
     float3 dsa;
-    uint postP;
+    uint padding;
 };
 
+#ifdef PACKED_VERTICES
+// Octahedral normal from two snorm16 values, matches DecodeOctahedral in vertexformat.cpp
+float3 DecodeNormal(float2 e)
+{
+    float3 n = float3(e, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.xy += n.xy >= 0.0f ? -t : t;
+    return normalize(n);
+}
+#else
+float3 DecodeNormal(float3 n)
+{
+    return n;
+}
+#endif
+
 PS_INPUT main(VS_INPUT input)
 {
     PS_INPUT output;
     output.worldPos = mul(input.pos, wMat);
     output.fragPosLightSpace = mul(output.worldPos, lMat);
     output.pos = mul(output.worldPos, vpMat);
-    output.norm = mul(transpose((float3x3)wMat), input.norm);
+    output.norm = mul(transpose((float3x3)wMat), DecodeNormal(input.norm));
     output.texCoord = input.texCoord;
     return output;
 }
\ No newline at end of file
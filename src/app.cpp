@@ -32,8 +32,6 @@ void Application::Create()
 
 void Application::Destroy()
 {
-	renderer->WaitForPreviousFrame();
-	renderer->CloseFenceEventHandle();
 	renderer->UnInit();
 
 	ImGui_ImplSDL3_Shutdown();
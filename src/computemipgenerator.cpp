@@ -0,0 +1,141 @@
+#include "computemipgenerator.h"
+
+#include <algorithm>
+
+ComputeMipGenerator::~ComputeMipGenerator()
+{
+	UnInit();
+}
+
+bool ComputeMipGenerator::Init(ID3D12Device* device, ShaderCache* shaderCache)
+{
+	HRESULT result;
+
+	if (pso) {
+		return true;
+	}
+
+	// Compile Shader
+	if (!shader.Init(L"shaders/GenerateMips.hlsl", "main", "cs_5_0", nullptr, shaderCache)) {
+		return false;
+	}
+
+	// Create Root Parameters: Level Constants, Source SRV, Destination UAV
+	CD3DX12_DESCRIPTOR_RANGE srvRange(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
+	CD3DX12_DESCRIPTOR_RANGE uavRange(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, 1, 0);
+	CD3DX12_ROOT_PARAMETER rootParameters[3];
+	rootParameters[0].InitAsConstants(4, 0);
+	rootParameters[1].InitAsDescriptorTable(1, &srvRange);
+	rootParameters[2].InitAsDescriptorTable(1, &uavRange);
+
+	// Create Static Sampler
+	CD3DX12_STATIC_SAMPLER_DESC sampler(0, D3D12_FILTER_MIN_MAG_LINEAR_MIP_POINT,
+		D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_CLAMP);
+
+	// Create Root Signature
+	CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	rootSignatureDesc.Init(_countof(rootParameters), rootParameters, 1, &sampler);
+	ID3DBlob* signature;
+	result = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, nullptr);
+	if (FAILED(result)) {
+		return false;
+	}
+	result = device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&rootSignature));
+	SAFE_RELEASE(signature);
+	if (FAILED(result)) {
+		return false;
+	}
+
+	// Create PSO
+	D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
+	psoDesc.pRootSignature = rootSignature;
+	psoDesc.CS = shader.GetBytecode();
+	result = device->CreateComputePipelineState(&psoDesc, IID_PPV_ARGS(&pso));
+	if (FAILED(result)) {
+		return false;
+	}
+
+	return true;
+}
+
+void ComputeMipGenerator::UnInit()
+{
+	SAFE_RELEASE(descriptorHeap);
+	SAFE_RELEASE(pso);
+	SAFE_RELEASE(rootSignature);
+}
+
+bool ComputeMipGenerator::Generate(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, ID3D12Resource* texture)
+{
+	HRESULT result;
+
+	D3D12_RESOURCE_DESC desc = texture->GetDesc();
+	if (!pso || desc.MipLevels < 2) {
+		return pso != nullptr;
+	}
+
+	// Create Descriptor Heap, a source SRV and destination UAV per generated level
+	SAFE_RELEASE(descriptorHeap);
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+	heapDesc.NumDescriptors = (desc.MipLevels - 1) * 2;
+	heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	result = device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&descriptorHeap));
+	if (FAILED(result)) {
+		return false;
+	}
+	UINT descriptorSize = device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	CD3DX12_CPU_DESCRIPTOR_HANDLE cpuHandle(descriptorHeap->GetCPUDescriptorHandleForHeapStart());
+	CD3DX12_GPU_DESCRIPTOR_HANDLE gpuHandle(descriptorHeap->GetGPUDescriptorHandleForHeapStart());
+
+	commandList->SetComputeRootSignature(rootSignature);
+	commandList->SetPipelineState(pso);
+	commandList->SetDescriptorHeaps(1, &descriptorHeap);
+
+	// Every level readable, then each one in turn becomes the UAV
+	CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(texture, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+	commandList->ResourceBarrier(1, &barrier);
+
+	for (UINT mip = 1; mip < desc.MipLevels; mip++)
+	{
+		// Create Source SRV & Destination UAV
+		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		srvDesc.Format = desc.Format;
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+		srvDesc.Texture2D.MostDetailedMip = mip - 1;
+		srvDesc.Texture2D.MipLevels = 1;
+		device->CreateShaderResourceView(texture, &srvDesc, cpuHandle);
+
+		D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+		uavDesc.Format = desc.Format;
+		uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+		uavDesc.Texture2D.MipSlice = mip;
+		device->CreateUnorderedAccessView(texture, nullptr, &uavDesc, CD3DX12_CPU_DESCRIPTOR_HANDLE(cpuHandle, 1, descriptorSize));
+
+		barrier = CD3DX12_RESOURCE_BARRIER::Transition(texture, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, mip);
+		commandList->ResourceBarrier(1, &barrier);
+
+		// Level Size & Texel Size
+		UINT width = (UINT)std::max<UINT64>(1, desc.Width >> mip);
+		UINT height = std::max<UINT>(1, desc.Height >> mip);
+		float texelSize[2] = { 1.0f / width, 1.0f / height };
+		UINT constants[4] = { width, height };
+		memcpy(&constants[2], texelSize, sizeof(texelSize));
+
+		commandList->SetComputeRoot32BitConstants(0, _countof(constants), constants, 0);
+		commandList->SetComputeRootDescriptorTable(1, gpuHandle);
+		commandList->SetComputeRootDescriptorTable(2, CD3DX12_GPU_DESCRIPTOR_HANDLE(gpuHandle, 1, descriptorSize));
+		commandList->Dispatch((width + 7) / 8, (height + 7) / 8, 1);
+
+		barrier = CD3DX12_RESOURCE_BARRIER::Transition(texture, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, mip);
+		commandList->ResourceBarrier(1, &barrier);
+
+		cpuHandle.Offset(2, descriptorSize);
+		gpuHandle.Offset(2, descriptorSize);
+	}
+
+	barrier = CD3DX12_RESOURCE_BARRIER::Transition(texture, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	commandList->ResourceBarrier(1, &barrier);
+	return true;
+}
\ No newline at end of file
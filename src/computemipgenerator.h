@@ -0,0 +1,28 @@
+#pragma once
+
+#include "gconst.h"
+#include "shader.h"
+
+// Fills the mip chain of an RGBA8 texture on the GPU, one compute dispatch per level that
+// samples the level above. Only used when MIP_GENERATION is COMPUTE, otherwise the chain is
+// built on the CPU while the image is decoded.
+class ComputeMipGenerator
+{
+public:
+
+	~ComputeMipGenerator();
+	bool Init(ID3D12Device* device, ShaderCache* shaderCache = nullptr);
+	void UnInit();
+
+	// The texture needs ALLOW_UNORDERED_ACCESS and level 0 resident. It starts in COMMON and
+	// ends in PIXEL_SHADER_RESOURCE. The descriptors live until the next Generate or UnInit.
+	bool Generate(ID3D12Device* device, ID3D12GraphicsCommandList* commandList, ID3D12Resource* texture);
+
+private:
+
+	Shader shader;
+	ID3D12RootSignature* rootSignature = nullptr;
+	ID3D12PipelineState* pso = nullptr;
+	ID3D12DescriptorHeap* descriptorHeap = nullptr;
+
+};
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "assetpackage.h"
+
+#include <d3dx12_property_format_table.h>
+#include <algorithm>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static UINT64 AlignUp(UINT64 value, UINT64 alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
+UINT64 GetPackedTextureLayout(const AssetTextureInfo& info, D3D12_PLACED_SUBRESOURCE_FOOTPRINT* layouts, UINT* numRows, UINT64* rowSizes)
+{
+	// Same rules the runtime applies for an upload heap footprint at offset 0
+	UINT bitsPerUnit = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetBitsPerUnit(info.format);
+	UINT blockWidth = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetWidthAlignment(info.format);
+	UINT blockHeight = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetHeightAlignment(info.format);
+	if (bitsPerUnit == 0 || info.mipLevels == 0 || info.mipLevels > D3D12_REQ_MIP_LEVELS) {
+		return 0;
+	}
+
+	UINT64 offset = 0;
+	for (UINT mip = 0; mip < info.mipLevels; mip++) {
+		UINT width = std::max<UINT>(1, info.width >> mip);
+		UINT height = std::max<UINT>(1, info.height >> mip);
+		UINT blocksHigh = (height + blockHeight - 1) / blockHeight;
+		UINT64 rowSize = (UINT64)((width + blockWidth - 1) / blockWidth) * bitsPerUnit / 8;
+		UINT rowPitch = (UINT)AlignUp(rowSize, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+
+		offset = AlignUp(offset, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+		if (layouts) {
+			layouts[mip].Offset = offset;
+			layouts[mip].Footprint = { info.format, width, height, 1, rowPitch };
+		}
+		if (numRows) numRows[mip] = blocksHigh;
+		if (rowSizes) rowSizes[mip] = rowSize;
+		offset += (UINT64)rowPitch * blocksHigh;
+	}
+	return offset;
+}
+
+AssetPackage::~AssetPackage()
+{
+	Close();
+}
+
+bool AssetPackage::Open(const std::filesystem::path& path)
+{
+	Close();
+
+	// Map The Whole File Read-Only
+#ifdef _WIN32
+	file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	LARGE_INTEGER fileSize;
+	if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+		Close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+	mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	base = mapping ? static_cast<const UINT8*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+	file = open(path.c_str(), O_RDONLY);
+	struct stat fileStat;
+	if (file < 0 || fstat(file, &fileStat) != 0 || fileStat.st_size == 0) {
+		Close();
+		return false;
+	}
+	size = (size_t)fileStat.st_size;
+	void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	base = view != MAP_FAILED ? static_cast<const UINT8*>(view) : nullptr;
+#endif
+	if (!base) {
+		Close();
+		return false;
+	}
+
+	// Validate Header & Table Of Contents
+	AssetPackageHeader header;
+	if (size < sizeof(header)) {
+		Close();
+		return false;
+	}
+	memcpy(&header, base, sizeof(header));
+	if (header.magic != ASSET_PACKAGE_MAGIC || header.version != ASSET_PACKAGE_VERSION ||
+		sizeof(header) + (UINT64)header.entryCount * sizeof(AssetEntry) > size) {
+		Close();
+		return false;
+	}
+	entries = std::span<const AssetEntry>(reinterpret_cast<const AssetEntry*>(base + sizeof(header)), header.entryCount);
+	for (const AssetEntry& entry : entries) {
+		if (entry.offset > size || entry.size > size - entry.offset || entry.name[ASSET_NAME_LENGTH - 1] != '\0') {
+			Close();
+			return false;
+		}
+	}
+	return true;
+}
+
+void AssetPackage::Close()
+{
+#ifdef _WIN32
+	if (base) UnmapViewOfFile(base);
+	if (mapping) CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+	mapping = nullptr;
+	file = INVALID_HANDLE_VALUE;
+#else
+	if (base) munmap(const_cast<UINT8*>(base), size);
+	if (file >= 0) close(file);
+	file = -1;
+#endif
+	base = nullptr;
+	size = 0;
+	entries = {};
+}
+
+const AssetEntry* AssetPackage::Find(std::string_view name, ASSET_TYPE type) const
+{
+	for (const AssetEntry& entry : entries) {
+		if (entry.type == (UINT32)type && name == entry.name) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+std::span<const Vertex> AssetPackage::GetVertices(const AssetEntry& entry) const
+{
+	if (entry.type != AT_MESH || (UINT64)entry.mesh.vertexCount * sizeof(Vertex) > entry.size) {
+		return {};
+	}
+	return { reinterpret_cast<const Vertex*>(base + entry.offset), entry.mesh.vertexCount };
+}
+
+std::span<const UINT32> AssetPackage::GetIndices(const AssetEntry& entry) const
+{
+	UINT64 vertexBytes = (UINT64)entry.mesh.vertexCount * sizeof(Vertex);
+	if (entry.type != AT_MESH || vertexBytes + (UINT64)entry.mesh.indexCount * sizeof(UINT32) > entry.size) {
+		return {};
+	}
+	return { reinterpret_cast<const UINT32*>(base + entry.offset + vertexBytes), entry.mesh.indexCount };
+}
+
+D3D12_RESOURCE_DESC AssetPackage::GetTextureDesc(const AssetEntry& entry) const
+{
+	D3D12_RESOURCE_DESC textureDesc = {};
+	textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	textureDesc.Width = entry.texture.width;
+	textureDesc.Height = entry.texture.height;
+	textureDesc.DepthOrArraySize = 1;
+	textureDesc.MipLevels = (UINT16)entry.texture.mipLevels;
+	textureDesc.Format = entry.texture.format;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+	return textureDesc;
+}
+
+UINT AssetPackage::GetSubresources(const AssetEntry& entry, D3D12_SUBRESOURCE_DATA* subresources) const
+{
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT layouts[D3D12_REQ_MIP_LEVELS];
+	UINT numRows[D3D12_REQ_MIP_LEVELS];
+	if (entry.type != AT_TEXTURE || GetPackedTextureLayout(entry.texture, layouts, numRows, nullptr) > entry.size) {
+		return 0;
+	}
+
+	for (UINT mip = 0; mip < entry.texture.mipLevels; mip++) {
+		subresources[mip].pData = base + entry.offset + layouts[mip].Offset;
+		subresources[mip].RowPitch = layouts[mip].Footprint.RowPitch;
+		subresources[mip].SlicePitch = (LONG_PTR)layouts[mip].Footprint.RowPitch * numRows[mip];
+	}
+	return entry.texture.mipLevels;
+}
+
+bool AssetPackageWriter::AddEntry(std::string_view name, ASSET_TYPE type, UINT64 size, AssetEntry** entry, UINT8** data)
+{
+	if (name.empty() || name.size() >= ASSET_NAME_LENGTH) {
+		return false;
+	}
+
+	// Offsets are relative to the blob area until Write() places it
+	AssetEntry newEntry = {};
+	memcpy(newEntry.name, name.data(), name.size());
+	newEntry.type = type;
+	newEntry.offset = AlignUp(blobs.size(), ASSET_PACKAGE_ALIGNMENT);
+	newEntry.size = size;
+	blobs.resize((size_t)(newEntry.offset + size));
+
+	entries.push_back(newEntry);
+	*entry = &entries.back();
+	*data = blobs.data() + newEntry.offset;
+	return true;
+}
+
+bool AssetPackageWriter::AddMesh(std::string_view name, std::span<const Vertex> vertices, std::span<const UINT32> indices)
+{
+	AssetEntry* entry;
+	UINT8* data;
+	if (!AddEntry(name, AT_MESH, vertices.size_bytes() + indices.size_bytes(), &entry, &data)) {
+		return false;
+	}
+	entry->mesh = { (UINT32)vertices.size(), (UINT32)indices.size() };
+	memcpy(data, vertices.data(), vertices.size_bytes());
+	memcpy(data + vertices.size_bytes(), indices.data(), indices.size_bytes());
+	return true;
+}
+
+bool AssetPackageWriter::AddTexture(std::string_view name, const AssetTextureInfo& info, const D3D12_SUBRESOURCE_DATA* subresources)
+{
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT layouts[D3D12_REQ_MIP_LEVELS];
+	UINT numRows[D3D12_REQ_MIP_LEVELS];
+	UINT64 rowSizes[D3D12_REQ_MIP_LEVELS];
+	UINT64 size = GetPackedTextureLayout(info, layouts, numRows, rowSizes);
+
+	AssetEntry* entry;
+	UINT8* data;
+	if (size == 0 || !AddEntry(name, AT_TEXTURE, size, &entry, &data)) {
+		return false;
+	}
+	entry->texture = info;
+
+	// Re-pitch every mip into its upload footprint
+	for (UINT mip = 0; mip < info.mipLevels; mip++) {
+		D3D12_MEMCPY_DEST dest = { data + layouts[mip].Offset, layouts[mip].Footprint.RowPitch, (SIZE_T)layouts[mip].Footprint.RowPitch * numRows[mip] };
+		MemcpySubresource(&dest, &subresources[mip], (SIZE_T)rowSizes[mip], numRows[mip], 1);
+	}
+	return true;
+}
+
+bool AssetPackageWriter::AddShader(std::string_view name, std::span<const UINT8> bytecode)
+{
+	AssetEntry* entry;
+	UINT8* data;
+	if (!AddEntry(name, AT_SHADER, bytecode.size(), &entry, &data)) {
+		return false;
+	}
+	memcpy(data, bytecode.data(), bytecode.size());
+	return true;
+}
+
+bool AssetPackageWriter::Write(const std::filesystem::path& path)
+{
+	AssetPackageHeader header = { ASSET_PACKAGE_MAGIC, ASSET_PACKAGE_VERSION, (UINT32)entries.size(), 0 };
+	UINT64 blobStart = AlignUp(sizeof(header) + entries.size() * sizeof(AssetEntry), ASSET_PACKAGE_ALIGNMENT);
+
+	std::vector<AssetEntry> placed(entries);
+	for (AssetEntry& entry : placed) {
+		entry.offset += blobStart;
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	std::vector<char> padding((size_t)(blobStart - sizeof(header) - placed.size() * sizeof(AssetEntry)), 0);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(placed.data()), placed.size() * sizeof(AssetEntry));
+	file.write(padding.data(), padding.size());
+	file.write(reinterpret_cast<const char*>(blobs.data()), blobs.size());
+	return (bool)file;
+}
\ No newline at end of file
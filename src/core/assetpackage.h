@@ -0,0 +1,107 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+#define ASSET_PACKAGE_MAGIC 0x4B434150 // "PACK"
+#define ASSET_PACKAGE_VERSION 1
+// Blobs start on texture placement boundaries, so pitched subresources copy as they are
+#define ASSET_PACKAGE_ALIGNMENT D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+#define ASSET_NAME_LENGTH 64
+
+enum ASSET_TYPE {
+	AT_MESH = 0,
+	AT_TEXTURE = 1,
+	AT_SHADER = 2
+};
+
+struct AssetPackageHeader {
+	UINT32 magic;
+	UINT32 version;
+	UINT32 entryCount;
+	UINT32 reserved;
+};
+
+// Meshes are the Vertex array followed by the UINT32 index array
+struct AssetMeshInfo {
+	UINT32 vertexCount;
+	UINT32 indexCount;
+};
+
+// Textures are every mip in the layout GetCopyableFootprints gives the upload heap:
+// 256 byte row pitch, 512 byte aligned subresources
+struct AssetTextureInfo {
+	UINT32 width;
+	UINT32 height;
+	UINT32 mipLevels;
+	DXGI_FORMAT format;
+};
+
+// The table of contents follows the header
+struct AssetEntry {
+	char name[ASSET_NAME_LENGTH];
+	UINT32 type;
+	UINT32 reserved;
+	UINT64 offset;
+	UINT64 size;
+	union {
+		AssetMeshInfo mesh;
+		AssetTextureInfo texture;
+	};
+};
+
+// Footprints of a packed texture relative to the start of its blob, returns the blob size
+UINT64 GetPackedTextureLayout(const AssetTextureInfo& info, D3D12_PLACED_SUBRESOURCE_FOOTPRINT* layouts, UINT* numRows, UINT64* rowSizes);
+
+// Maps a package read-only for the lifetime of the object. Everything handed out points
+// into the mapping, so uploads copy straight from the file pages into the upload ring.
+class AssetPackage {
+public:
+	~AssetPackage();
+
+	bool Open(const std::filesystem::path& path);
+	void Close();
+	bool IsOpen() { return base != nullptr; }
+
+	const AssetEntry* Find(std::string_view name, ASSET_TYPE type) const;
+	std::span<const AssetEntry> GetEntries() const { return entries; }
+	std::span<const UINT8> GetData(const AssetEntry& entry) const { return { base + entry.offset, (size_t)entry.size }; }
+
+	std::span<const Vertex> GetVertices(const AssetEntry& entry) const;
+	std::span<const UINT32> GetIndices(const AssetEntry& entry) const;
+	D3D12_RESOURCE_DESC GetTextureDesc(const AssetEntry& entry) const;
+	// One entry per mip, returns how many were filled (at most D3D12_REQ_MIP_LEVELS)
+	UINT GetSubresources(const AssetEntry& entry, D3D12_SUBRESOURCE_DATA* subresources) const;
+
+private:
+	const UINT8* base = nullptr;
+	size_t size = 0;
+	std::span<const AssetEntry> entries;
+
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int file = -1;
+#endif
+};
+
+// Builds a package in memory, used by the packer tool
+class AssetPackageWriter {
+public:
+	bool AddMesh(std::string_view name, std::span<const Vertex> vertices, std::span<const UINT32> indices);
+	// subresources holds one tightly or loosely pitched image per mip
+	bool AddTexture(std::string_view name, const AssetTextureInfo& info, const D3D12_SUBRESOURCE_DATA* subresources);
+	bool AddShader(std::string_view name, std::span<const UINT8> bytecode);
+
+	bool Write(const std::filesystem::path& path);
+
+private:
+	bool AddEntry(std::string_view name, ASSET_TYPE type, UINT64 size, AssetEntry** entry, UINT8** data);
+
+	std::vector<AssetEntry> entries;
+	std::vector<UINT8> blobs;
+};
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "asyncuploader.h"
+
+bool AsyncUploader::Init(ID3D12Device* device, UINT64 uploadRingSize, UINT64 batchSize)
+{
+	HRESULT result;
+
+	this->device = device;
+	this->batchSize = batchSize;
+	openBytes = 0;
+	stats = {};
+
+	// Create Copy Queue
+	D3D12_COMMAND_QUEUE_DESC cqDesc = {};
+	cqDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+	cqDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+	result = device->CreateCommandQueue(&cqDesc, IID_PPV_ARGS(&copyQueue));
+	if (FAILED(result)) {
+		return false;
+	}
+	copyQueue->SetName(L"Async Upload Copy Queue");
+
+	if (!timeline.Init(device, copyQueue) || !uploadRing.Init(device, &timeline, uploadRingSize)) {
+		return false;
+	}
+
+	// Create Copy Command List, closed until the first upload opens a batch
+	ID3D12CommandAllocator* allocator;
+	result = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&allocator));
+	if (FAILED(result)) {
+		return false;
+	}
+	allocators.push_back({ allocator, 0 });
+
+	result = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, allocator, nullptr, IID_PPV_ARGS(&commandList));
+	if (FAILED(result)) {
+		return false;
+	}
+	commandList->Close();
+
+	return true;
+}
+
+void AsyncUploader::UnInit()
+{
+	if (openAllocator) {
+		Flush();
+	}
+	timeline.WaitForIdle();
+
+	for (BatchAllocator& batchAllocator : allocators) {
+		SAFE_RELEASE(batchAllocator.allocator);
+	}
+	allocators.clear();
+	SAFE_RELEASE(commandList);
+	uploadRing.UnInit();
+	timeline.UnInit();
+	SAFE_RELEASE(copyQueue);
+}
+
+bool AsyncUploader::OpenBatch()
+{
+	if (openAllocator) {
+		return true;
+	}
+
+	// Reuse the oldest allocator once its batch has completed, otherwise grow the pool
+	if (!allocators.empty() && timeline.IsComplete(allocators.front().ticket)) {
+		openAllocator = allocators.front().allocator;
+		allocators.pop_front();
+		if (FAILED(openAllocator->Reset())) {
+			SAFE_RELEASE(openAllocator);
+			return false;
+		}
+	}
+	else if (FAILED(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&openAllocator)))) {
+		openAllocator = nullptr;
+		return false;
+	}
+
+	return SUCCEEDED(commandList->Reset(openAllocator, nullptr));
+}
+
+UINT64 AsyncUploader::CloseUpload(UINT64 bytes)
+{
+	// Everything recorded so far completes with the next signal on the copy timeline
+	UINT64 ticket = timeline.GetLastSubmitted() + 1;
+
+	stats.uploads++;
+	stats.bytes += bytes;
+	openBytes += bytes;
+	if (openBytes >= batchSize) {
+		Flush();
+	}
+	return ticket;
+}
+
+UINT64 AsyncUploader::UploadBuffer(const GpuAllocation& allocation, const void* data, UINT64 size, UINT64 dstOffset)
+{
+	return Stage(size, [&]() {
+		return uploadRing.UploadBuffer(commandList, allocation.resource, allocation.offset + dstOffset, data, size);
+	});
+}
+
+UINT64 AsyncUploader::UploadIndices(const GpuAllocation& allocation, std::span<const UINT32> indices, DXGI_FORMAT format, UINT64 dstOffset)
+{
+	return Stage(indices.size() * IndexSizeOf(format), [&]() {
+		return uploadRing.UploadIndices(commandList, allocation.resource, allocation.offset + dstOffset, indices, format);
+	});
+}
+
+UINT64 AsyncUploader::UploadVertices(const GpuAllocation& allocation, std::span<const Vertex> vertices, VERTEX_LAYOUT layout, UINT64 dstOffset)
+{
+	return Stage(vertices.size() * GetVertexFormat(layout).stride, [&]() {
+		return uploadRing.UploadVertices(commandList, allocation.resource, allocation.offset + dstOffset, vertices, layout);
+	});
+}
+
+UINT64 AsyncUploader::UploadTexture(const GpuAllocation& allocation, Texture* tex)
+{
+	D3D12_SUBRESOURCE_DATA subresources[D3D12_REQ_MIP_LEVELS];
+	UINT subresourceCount = tex->GetSubresources(subresources);
+	return UploadSubresources(allocation, 0, subresourceCount, subresources);
+}
+
+UINT64 AsyncUploader::UploadSubresources(const GpuAllocation& allocation, UINT firstSubresource, UINT numSubresources, const D3D12_SUBRESOURCE_DATA* data)
+{
+	UINT64 bytes = 0;
+	for (UINT i = 0; i < numSubresources; i++) {
+		bytes += data[i].SlicePitch;
+	}
+	return Stage(bytes, [&]() {
+		return uploadRing.UploadSubresources(commandList, allocation.resource, firstSubresource, numSubresources, data);
+	});
+}
+
+UINT64 AsyncUploader::UploadMesh(GeometryPool* pool, std::span<const Vertex> vertices, std::span<const UINT32> indices, MeshHandle* mesh)
+{
+	if (!pool->Reserve((UINT)vertices.size(), (UINT)indices.size(), mesh)) {
+		return 0;
+	}
+
+	// Both copies sit in the same batch unless the first one filled it
+	UINT64 vertexTicket = UploadVertices(pool->GetVertexBuffer(), vertices, pool->GetVertexLayout(), (UINT64)mesh->baseVertex * pool->GetVertexStride());
+	UINT64 indexTicket = UploadIndices(pool->GetIndexBuffer(mesh->indexFormat), indices, mesh->indexFormat, (UINT64)mesh->firstIndex * IndexSizeOf(mesh->indexFormat));
+	if (vertexTicket == 0 || indexTicket == 0) {
+		// A copy that did land only wrote the range given back here, and whatever mesh takes
+		// the range next records its copy after it on the same queue
+		pool->Release(mesh);
+		return 0;
+	}
+	return indexTicket;
+}
+
+UINT64 AsyncUploader::Flush()
+{
+	if (!openAllocator) {
+		return timeline.GetLastSubmitted();
+	}
+
+	// Execute Copy Command List
+	commandList->Close();
+	ID3D12CommandList* ppCommandLists[] = { commandList };
+	copyQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+
+	UINT64 ticket = timeline.Submit();
+	uploadRing.Close(ticket);
+	uploadRing.Reclaim();
+
+	allocators.push_back({ openAllocator, ticket });
+	openAllocator = nullptr;
+	openBytes = 0;
+	stats.batches++;
+	return ticket;
+}
+
+void AsyncUploader::WaitFor(UINT64 ticket)
+{
+	if (ticket > timeline.GetLastSubmitted()) {
+		Flush();
+	}
+	timeline.WaitFor(ticket);
+}
\ No newline at end of file
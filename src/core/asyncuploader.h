@@ -0,0 +1,94 @@
+#pragma once
+
+#include "coreconst.h"
+#include "texture.h"
+#include "gputimeline.h"
+#include "uploadring.h"
+#include "gpuallocator.h"
+#include "geometrypool.h"
+
+#include <deque>
+
+#define ASYNC_UPLOAD_BATCH_SIZE (4 * 1024 * 1024)
+
+struct AsyncUploaderStats {
+	UINT64 uploads = 0;
+	UINT64 bytes = 0;
+	UINT64 batches = 0;
+};
+
+// Uploads on a dedicated copy queue with its own upload ring and timeline. Uploads are
+// recorded into an open batch that goes out as one submission once it grows past the
+// batch size or on Flush(), and every upload returns the copy timeline ticket it lands with.
+// Destinations must be in COMMON: the copy queue promotes them to COPY_DEST and they decay
+// back to COMMON when the batch completes, ready to be promoted by any read on the direct queue.
+class AsyncUploader {
+public:
+	bool Init(ID3D12Device* device, UINT64 uploadRingSize = UPLOAD_RING_SIZE, UINT64 batchSize = ASYNC_UPLOAD_BATCH_SIZE);
+	void UnInit();
+
+	// Return the ticket the data is resident at, or 0 if it could not be staged
+	UINT64 UploadBuffer(const GpuAllocation& allocation, const void* data, UINT64 size, UINT64 dstOffset = 0);
+	UINT64 UploadTexture(const GpuAllocation& allocation, Texture* tex);
+	UINT64 UploadIndices(const GpuAllocation& allocation, std::span<const UINT32> indices, DXGI_FORMAT format, UINT64 dstOffset = 0);
+	UINT64 UploadSubresources(const GpuAllocation& allocation, UINT firstSubresource, UINT numSubresources, const D3D12_SUBRESOURCE_DATA* data);
+	UINT64 UploadVertices(const GpuAllocation& allocation, std::span<const Vertex> vertices, VERTEX_LAYOUT layout, UINT64 dstOffset = 0);
+	UINT64 UploadMesh(GeometryPool* pool, std::span<const Vertex> vertices, std::span<const UINT32> indices, MeshHandle* mesh);
+
+	// Submits the open batch, returns the last submitted ticket
+	UINT64 Flush();
+
+	bool IsComplete(UINT64 ticket) { return timeline.IsComplete(ticket); }
+	// Flushes first if the ticket belongs to the open batch
+	void WaitFor(UINT64 ticket);
+	// GPU side wait, the CPU keeps going
+	void QueueWait(ID3D12CommandQueue* queue, UINT64 ticket) { timeline.QueueWait(queue, ticket); }
+
+	ID3D12CommandQueue* GetCommandQueue() { return copyQueue; }
+	GpuTimeline* GetTimeline() { return &timeline; }
+	UploadRing* GetUploadRing() { return &uploadRing; }
+	const AsyncUploaderStats& GetStats() { return stats; }
+
+private:
+	struct BatchAllocator {
+		ID3D12CommandAllocator* allocator;
+		UINT64 ticket;
+	};
+
+	bool OpenBatch();
+	UINT64 CloseUpload(UINT64 bytes);
+
+	// Runs the recording, the ring only refuses space it could free by submitting,
+	// so submit the open batch and retry once
+	template <typename Recorder>
+	UINT64 Stage(UINT64 bytes, Recorder record)
+	{
+		if (!OpenBatch()) {
+			return 0;
+		}
+		if (!record()) {
+			if (openBytes == 0) {
+				return 0;
+			}
+			Flush();
+			if (!OpenBatch() || !record()) {
+				return 0;
+			}
+		}
+		return CloseUpload(bytes);
+	}
+
+	ID3D12Device* device = nullptr;
+	ID3D12CommandQueue* copyQueue = nullptr;
+	ID3D12GraphicsCommandList* commandList = nullptr;
+	GpuTimeline timeline;
+	UploadRing uploadRing;
+
+	// Allocators of submitted batches, oldest first
+	std::deque<BatchAllocator> allocators;
+	ID3D12CommandAllocator* openAllocator = nullptr;
+	UINT64 batchSize = 0;
+	UINT64 openBytes = 0;
+
+	AsyncUploaderStats stats;
+};
\ No newline at end of file
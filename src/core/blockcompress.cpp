@@ -0,0 +1,574 @@
+#include "blockcompress.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <climits>
+
+// Power iterations for a block's principal axis, then least squares endpoint refinements
+#define FIT_ITERATIONS 8
+#define REFINE_PASSES 2
+
+// BC7 interpolation weights of 4-bit indices, out of 64
+static const int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Weight of the first endpoint for each BC1 index in four colour mode
+static const float BC1_WEIGHTS[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+UINT GetBlockSize(DXGI_FORMAT format)
+{
+	switch (format) {
+	case DXGI_FORMAT_BC1_UNORM:
+		return 8;
+	case DXGI_FORMAT_BC3_UNORM:
+	case DXGI_FORMAT_BC5_UNORM:
+	case DXGI_FORMAT_BC7_UNORM:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+// Bits are packed from the lowest bit of the first byte up, as BC7 lays them out
+struct BlockBits {
+	UINT8* block;
+	UINT position = 0;
+
+	void Write(UINT value, UINT bits) {
+		for (UINT b = 0; b < bits; b++, position++) {
+			block[position >> 3] |= (UINT8)(((value >> b) & 1) << (position & 7));
+		}
+	}
+	UINT Read(UINT bits) {
+		UINT value = 0;
+		for (UINT b = 0; b < bits; b++, position++) {
+			value |= (UINT)((block[position >> 3] >> (position & 7)) & 1) << b;
+		}
+		return value;
+	}
+};
+
+// Mean and principal axis of the first channels of the block, with the projections of the
+// texels onto the axis spanning [low, high]
+static void FitAxis(const UINT8* rgba, UINT channels, float* mean, float* axis, float* low, float* high)
+{
+	float minimum[4] = { 255.0f, 255.0f, 255.0f, 255.0f }, maximum[4] = {};
+	for (UINT c = 0; c < channels; c++) {
+		mean[c] = 0.0f;
+	}
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		for (UINT c = 0; c < channels; c++) {
+			float v = rgba[i * 4 + c];
+			mean[c] += v;
+			minimum[c] = std::min<float>(minimum[c], v);
+			maximum[c] = std::max<float>(maximum[c], v);
+		}
+	}
+	for (UINT c = 0; c < channels; c++) {
+		mean[c] /= BC_BLOCK_TEXELS;
+	}
+
+	float covariance[4][4] = {};
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		for (UINT a = 0; a < channels; a++) {
+			for (UINT b = 0; b < channels; b++) {
+				covariance[a][b] += (rgba[i * 4 + a] - mean[a]) * (rgba[i * 4 + b] - mean[b]);
+			}
+		}
+	}
+
+	// Power iteration from the bounding box diagonal
+	float length = 0.0f;
+	for (UINT c = 0; c < channels; c++) {
+		axis[c] = maximum[c] - minimum[c];
+		length += axis[c] * axis[c];
+	}
+	for (UINT iteration = 0; iteration < FIT_ITERATIONS && length > 0.0f; iteration++) {
+		float next[4] = {};
+		for (UINT a = 0; a < channels; a++) {
+			for (UINT b = 0; b < channels; b++) {
+				next[a] += covariance[a][b] * axis[b];
+			}
+		}
+		float nextLength = 0.0f;
+		for (UINT c = 0; c < channels; c++) {
+			nextLength += next[c] * next[c];
+		}
+		if (nextLength <= 1e-12f) {
+			break;
+		}
+		for (UINT c = 0; c < channels; c++) {
+			axis[c] = next[c] / std::sqrt(nextLength);
+		}
+		length = 1.0f;
+	}
+	length = 0.0f;
+	for (UINT c = 0; c < channels; c++) {
+		length += axis[c] * axis[c];
+	}
+	for (UINT c = 0; c < channels; c++) {
+		axis[c] = length > 0.0f ? axis[c] / std::sqrt(length) : 1.0f / std::sqrt((float)channels);
+	}
+
+	*low = FLT_MAX;
+	*high = -FLT_MAX;
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		float t = 0.0f;
+		for (UINT c = 0; c < channels; c++) {
+			t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+		}
+		*low = std::min<float>(*low, t);
+		*high = std::max<float>(*high, t);
+	}
+}
+
+// Least squares endpoints for fixed interpolation weights, weights[i] is the share of the
+// first endpoint. Returns false when every texel uses the same weight.
+static bool SolveEndpoints(const UINT8* rgba, UINT channels, const float* weights, float* e0, float* e1)
+{
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[4] = {}, bx[4] = {};
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		float a = weights[i], b = 1.0f - weights[i];
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (UINT c = 0; c < channels; c++) {
+			ax[c] += a * rgba[i * 4 + c];
+			bx[c] += b * rgba[i * 4 + c];
+		}
+	}
+	float determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1e-6f) {
+		return false;
+	}
+	for (UINT c = 0; c < channels; c++) {
+		e0[c] = std::min<float>(std::max<float>((bb * ax[c] - ab * bx[c]) / determinant, 0.0f), 255.0f);
+		e1[c] = std::min<float>(std::max<float>((aa * bx[c] - ab * ax[c]) / determinant, 0.0f), 255.0f);
+	}
+	return true;
+}
+
+// BC1 Colour
+
+static UINT16 Pack565(const float* rgb)
+{
+	int r = (int)std::lround(rgb[0] * 31.0f / 255.0f);
+	int g = (int)std::lround(rgb[1] * 63.0f / 255.0f);
+	int b = (int)std::lround(rgb[2] * 31.0f / 255.0f);
+	return (UINT16)((std::clamp(r, 0, 31) << 11) | (std::clamp(g, 0, 63) << 5) | std::clamp(b, 0, 31));
+}
+
+static void Unpack565(UINT16 color, int* rgb)
+{
+	int r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Three colour mode leaves the last entry transparent black
+static void Bc1Palette(UINT16 c0, UINT16 c1, bool fourColor, int palette[4][4])
+{
+	Unpack565(c0, palette[0]);
+	Unpack565(c1, palette[1]);
+	palette[0][3] = palette[1][3] = palette[2][3] = 255;
+	for (UINT c = 0; c < 3; c++) {
+		if (fourColor) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+		}
+		else {
+			palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[3][3] = fourColor ? 255 : 0;
+}
+
+static void EncodeColor(const UINT8* rgba, UINT8* block)
+{
+	float mean[3], axis[3], low, high;
+	FitAxis(rgba, 3, mean, axis, &low, &high);
+	float e0[3], e1[3];
+	for (UINT c = 0; c < 3; c++) {
+		e0[c] = std::min<float>(std::max<float>(mean[c] + axis[c] * high, 0.0f), 255.0f);
+		e1[c] = std::min<float>(std::max<float>(mean[c] + axis[c] * low, 0.0f), 255.0f);
+	}
+
+	UINT16 best0 = 0, best1 = 0;
+	UINT8 bestIndices[BC_BLOCK_TEXELS] = {};
+	int bestError = INT_MAX;
+	for (UINT pass = 0; pass <= REFINE_PASSES; pass++)
+	{
+		// Four colour mode needs c0 > c1, equal endpoints use index 0 throughout
+		UINT16 c0 = Pack565(e0), c1 = Pack565(e1);
+		if (c0 < c1) {
+			std::swap(c0, c1);
+		}
+		int palette[4][4];
+		Bc1Palette(c0, c1, true, palette);
+		UINT8 indices[BC_BLOCK_TEXELS];
+		int error = 0;
+		for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+			int nearest = INT_MAX;
+			for (UINT j = 0; j < (c0 == c1 ? 1u : 4u); j++) {
+				int dr = rgba[i * 4] - palette[j][0], dg = rgba[i * 4 + 1] - palette[j][1], db = rgba[i * 4 + 2] - palette[j][2];
+				int distance = dr * dr + dg * dg + db * db;
+				if (distance < nearest) {
+					nearest = distance;
+					indices[i] = (UINT8)j;
+				}
+			}
+			error += nearest;
+		}
+		if (error < bestError) {
+			bestError = error;
+			best0 = c0;
+			best1 = c1;
+			memcpy(bestIndices, indices, sizeof(indices));
+		}
+
+		// Refit the endpoints to the chosen indices
+		float weights[BC_BLOCK_TEXELS];
+		for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+			weights[i] = BC1_WEIGHTS[indices[i]];
+		}
+		if (bestError == 0 || c0 == c1 || !SolveEndpoints(rgba, 3, weights, e0, e1)) {
+			break;
+		}
+	}
+
+	UINT32 indexBits = 0;
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		indexBits |= (UINT32)bestIndices[i] << (i * 2);
+	}
+	block[0] = (UINT8)best0;
+	block[1] = (UINT8)(best0 >> 8);
+	block[2] = (UINT8)best1;
+	block[3] = (UINT8)(best1 >> 8);
+	memcpy(block + 4, &indexBits, sizeof(indexBits));
+}
+
+static void DecodeColor(const UINT8* block, UINT8* rgba, bool allowThreeColor)
+{
+	UINT16 c0 = (UINT16)(block[0] | (block[1] << 8)), c1 = (UINT16)(block[2] | (block[3] << 8));
+	UINT32 indexBits;
+	memcpy(&indexBits, block + 4, sizeof(indexBits));
+	int palette[4][4];
+	Bc1Palette(c0, c1, !allowThreeColor || c0 > c1, palette);
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		const int* color = palette[(indexBits >> (i * 2)) & 3];
+		for (UINT c = 0; c < 4; c++) {
+			rgba[i * 4 + c] = (UINT8)color[c];
+		}
+	}
+}
+
+// BC4 Channel
+
+static void Bc4Palette(int a0, int a1, int palette[8])
+{
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1) {
+		for (int i = 2; i < 8; i++) {
+			palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+		}
+	}
+	else {
+		for (int i = 2; i < 6; i++) {
+			palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+static void EncodeChannel(const UINT8* rgba, UINT channel, UINT8* block)
+{
+	int minimum = 255, maximum = 0;
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		minimum = std::min<int>(minimum, rgba[i * 4 + channel]);
+		maximum = std::max<int>(maximum, rgba[i * 4 + channel]);
+	}
+
+	// Eight value mode across the channel's range
+	int palette[8];
+	Bc4Palette(maximum, minimum, palette);
+	UINT64 indexBits = 0;
+	for (UINT i = 0; i < BC_BLOCK_TEXELS && maximum > minimum; i++) {
+		UINT index = 0;
+		int nearest = INT_MAX;
+		for (UINT j = 0; j < 8; j++) {
+			int distance = std::abs(rgba[i * 4 + channel] - palette[j]);
+			if (distance < nearest) {
+				nearest = distance;
+				index = j;
+			}
+		}
+		indexBits |= (UINT64)index << (i * 3);
+	}
+	block[0] = (UINT8)maximum;
+	block[1] = (UINT8)minimum;
+	for (UINT b = 0; b < 6; b++) {
+		block[2 + b] = (UINT8)(indexBits >> (b * 8));
+	}
+}
+
+static void DecodeChannel(const UINT8* block, UINT channel, UINT8* rgba)
+{
+	int palette[8];
+	Bc4Palette(block[0], block[1], palette);
+	UINT64 indexBits = 0;
+	for (UINT b = 0; b < 6; b++) {
+		indexBits |= (UINT64)block[2 + b] << (b * 8);
+	}
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		rgba[i * 4 + channel] = (UINT8)palette[(indexBits >> (i * 3)) & 7];
+	}
+}
+
+// BC7 Mode 6
+
+// 7-bit endpoint plus a p-bit shared by its channels, picked for the smaller error
+static void QuantizeBc7Endpoint(const float* ideal, int* quantized, int* pbit)
+{
+	float bestError = FLT_MAX;
+	for (int p = 0; p < 2; p++) {
+		int candidate[4];
+		float error = 0.0f;
+		for (UINT c = 0; c < 4; c++) {
+			candidate[c] = std::clamp((int)std::lround((ideal[c] - p) / 2.0f), 0, 127);
+			float difference = (float)((candidate[c] << 1) | p) - ideal[c];
+			error += difference * difference;
+		}
+		if (error < bestError) {
+			bestError = error;
+			memcpy(quantized, candidate, sizeof(candidate));
+			*pbit = p;
+		}
+	}
+}
+
+static void Bc7Palette(const int* endpoint0, int pbit0, const int* endpoint1, int pbit1, int palette[16][4])
+{
+	for (UINT c = 0; c < 4; c++) {
+		int a = (endpoint0[c] << 1) | pbit0, b = (endpoint1[c] << 1) | pbit1;
+		for (UINT i = 0; i < 16; i++) {
+			palette[i][c] = ((64 - BC7_WEIGHTS4[i]) * a + BC7_WEIGHTS4[i] * b + 32) >> 6;
+		}
+	}
+}
+
+void EncodeBC7Block(const UINT8* rgba, UINT8* block)
+{
+	float mean[4], axis[4], low, high;
+	FitAxis(rgba, 4, mean, axis, &low, &high);
+	float e0[4], e1[4];
+	for (UINT c = 0; c < 4; c++) {
+		e0[c] = std::min<float>(std::max<float>(mean[c] + axis[c] * low, 0.0f), 255.0f);
+		e1[c] = std::min<float>(std::max<float>(mean[c] + axis[c] * high, 0.0f), 255.0f);
+	}
+
+	int best0[4] = {}, best1[4] = {}, bestP0 = 0, bestP1 = 0;
+	UINT8 bestIndices[BC_BLOCK_TEXELS] = {};
+	int bestError = INT_MAX;
+	for (UINT pass = 0; pass <= REFINE_PASSES; pass++)
+	{
+		int q0[4], q1[4], p0, p1;
+		QuantizeBc7Endpoint(e0, q0, &p0);
+		QuantizeBc7Endpoint(e1, q1, &p1);
+		int palette[16][4];
+		Bc7Palette(q0, p0, q1, p1, palette);
+
+		UINT8 indices[BC_BLOCK_TEXELS];
+		int error = 0;
+		for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+			int nearest = INT_MAX;
+			for (UINT j = 0; j < 16; j++) {
+				int distance = 0;
+				for (UINT c = 0; c < 4; c++) {
+					int difference = rgba[i * 4 + c] - palette[j][c];
+					distance += difference * difference;
+				}
+				if (distance < nearest) {
+					nearest = distance;
+					indices[i] = (UINT8)j;
+				}
+			}
+			error += nearest;
+		}
+		if (error < bestError) {
+			bestError = error;
+			memcpy(best0, q0, sizeof(q0));
+			memcpy(best1, q1, sizeof(q1));
+			bestP0 = p0;
+			bestP1 = p1;
+			memcpy(bestIndices, indices, sizeof(indices));
+		}
+
+		float weights[BC_BLOCK_TEXELS];
+		for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+			weights[i] = 1.0f - BC7_WEIGHTS4[indices[i]] / 64.0f;
+		}
+		if (bestError == 0 || !SolveEndpoints(rgba, 4, weights, e0, e1)) {
+			break;
+		}
+	}
+
+	// The first index drops its top bit, so it must point at the first half
+	if (bestIndices[0] & 8) {
+		std::swap(best0, best1);
+		std::swap(bestP0, bestP1);
+		for (UINT8& index : bestIndices) {
+			index = (UINT8)(15 - index);
+		}
+	}
+
+	memset(block, 0, 16);
+	BlockBits bits = { block };
+	bits.Write(1 << 6, 7);
+	for (UINT c = 0; c < 4; c++) {
+		bits.Write(best0[c], 7);
+		bits.Write(best1[c], 7);
+	}
+	bits.Write(bestP0, 1);
+	bits.Write(bestP1, 1);
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		bits.Write(bestIndices[i], i == 0 ? 3 : 4);
+	}
+}
+
+bool DecodeBC7Block(const UINT8* block, UINT8* rgba)
+{
+	if ((block[0] & 0x7F) != 0x40) {
+		memset(rgba, 0, BC_BLOCK_TEXELS * 4);
+		return false;
+	}
+	BlockBits bits = { const_cast<UINT8*>(block), 7 };
+	int endpoint0[4], endpoint1[4];
+	for (UINT c = 0; c < 4; c++) {
+		endpoint0[c] = (int)bits.Read(7);
+		endpoint1[c] = (int)bits.Read(7);
+	}
+	int pbit0 = (int)bits.Read(1), pbit1 = (int)bits.Read(1);
+	int palette[16][4];
+	Bc7Palette(endpoint0, pbit0, endpoint1, pbit1, palette);
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		const int* color = palette[bits.Read(i == 0 ? 3 : 4)];
+		for (UINT c = 0; c < 4; c++) {
+			rgba[i * 4 + c] = (UINT8)color[c];
+		}
+	}
+	return true;
+}
+
+// Blocks
+
+void EncodeBC1Block(const UINT8* rgba, UINT8* block)
+{
+	EncodeColor(rgba, block);
+}
+
+void EncodeBC3Block(const UINT8* rgba, UINT8* block)
+{
+	EncodeChannel(rgba, 3, block);
+	EncodeColor(rgba, block + 8);
+}
+
+void EncodeBC5Block(const UINT8* rgba, UINT8* block)
+{
+	EncodeChannel(rgba, 0, block);
+	EncodeChannel(rgba, 1, block + 8);
+}
+
+void DecodeBC1Block(const UINT8* block, UINT8* rgba)
+{
+	DecodeColor(block, rgba, true);
+}
+
+void DecodeBC3Block(const UINT8* block, UINT8* rgba)
+{
+	DecodeColor(block + 8, rgba, false);
+	DecodeChannel(block, 3, rgba);
+}
+
+void DecodeBC5Block(const UINT8* block, UINT8* rgba)
+{
+	DecodeChannel(block, 0, rgba);
+	DecodeChannel(block + 8, 1, rgba);
+	for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+		rgba[i * 4 + 2] = 0;
+		rgba[i * 4 + 3] = 255;
+	}
+}
+
+// Images
+
+bool CompressImage(const UINT8* rgba, UINT width, UINT height, DXGI_FORMAT format, UINT8* blocks, WorkerPool* pool)
+{
+	UINT blockSize = GetBlockSize(format);
+	void (*encode)(const UINT8*, UINT8*) = format == DXGI_FORMAT_BC1_UNORM ? EncodeBC1Block :
+		format == DXGI_FORMAT_BC3_UNORM ? EncodeBC3Block : format == DXGI_FORMAT_BC5_UNORM ? EncodeBC5Block : EncodeBC7Block;
+	if (blockSize == 0) {
+		return false;
+	}
+
+	UINT blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+	auto compressRow = [=](UINT blockRow) {
+		UINT8 texels[BC_BLOCK_TEXELS * 4];
+		for (UINT blockColumn = 0; blockColumn < blocksWide; blockColumn++) {
+			for (UINT y = 0; y < 4; y++) {
+				UINT sourceY = std::min<UINT>(blockRow * 4 + y, height - 1);
+				for (UINT x = 0; x < 4; x++) {
+					UINT sourceX = std::min<UINT>(blockColumn * 4 + x, width - 1);
+					memcpy(texels + (y * 4 + x) * 4, rgba + ((size_t)sourceY * width + sourceX) * 4, 4);
+				}
+			}
+			encode(texels, blocks + ((size_t)blockRow * blocksWide + blockColumn) * blockSize);
+		}
+	};
+
+	if (pool) {
+		for (UINT blockRow = 0; blockRow < blocksHigh; blockRow++) {
+			pool->Submit([&compressRow, blockRow](UINT) { compressRow(blockRow); });
+		}
+		pool->Wait();
+	}
+	else {
+		for (UINT blockRow = 0; blockRow < blocksHigh; blockRow++) {
+			compressRow(blockRow);
+		}
+	}
+	return true;
+}
+
+bool DecompressImage(const UINT8* blocks, UINT width, UINT height, DXGI_FORMAT format, UINT8* rgba)
+{
+	UINT blockSize = GetBlockSize(format);
+	if (blockSize == 0) {
+		return false;
+	}
+
+	UINT blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+	bool decoded = true;
+	UINT8 texels[BC_BLOCK_TEXELS * 4];
+	for (UINT blockRow = 0; blockRow < blocksHigh; blockRow++) {
+		for (UINT blockColumn = 0; blockColumn < blocksWide; blockColumn++) {
+			const UINT8* block = blocks + ((size_t)blockRow * blocksWide + blockColumn) * blockSize;
+			switch (format) {
+			case DXGI_FORMAT_BC1_UNORM: DecodeBC1Block(block, texels); break;
+			case DXGI_FORMAT_BC3_UNORM: DecodeBC3Block(block, texels); break;
+			case DXGI_FORMAT_BC5_UNORM: DecodeBC5Block(block, texels); break;
+			default: decoded = DecodeBC7Block(block, texels) && decoded; break;
+			}
+
+			// Edge blocks only write the texels inside the image
+			for (UINT y = 0; y < 4 && blockRow * 4 + y < height; y++) {
+				UINT columns = std::min<UINT>(4, width - blockColumn * 4);
+				memcpy(rgba + ((size_t)(blockRow * 4 + y) * width + blockColumn * 4) * 4, texels + y * 16, (size_t)columns * 4);
+			}
+		}
+	}
+	return decoded;
+}
\ No newline at end of file
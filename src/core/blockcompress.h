@@ -0,0 +1,36 @@
+#pragma once
+
+#include "coreconst.h"
+#include "workerpool.h"
+
+// Block compression of 8-bit RGBA images to BC1, BC3, BC5 and BC7 for offline cooking, and
+// the matching decoders so the encoder's quality can be measured. Blocks are 4x4 texels
+// given as 64 bytes of RGBA in row order.
+//
+// BC1 and BC3 colour fits the principal axis of the block and refines the endpoints with
+// least squares. BC4 style channels (BC3 alpha, both BC5 channels) span the channel's
+// range. BC7 writes single subset mode 6 blocks (RGBA 7.7.7.7 endpoints with a p-bit,
+// 16 weights), fitted like BC1 in four channels.
+
+#define BC_BLOCK_TEXELS 16
+
+// Bytes per 4x4 block, 0 for formats without an encoder
+UINT GetBlockSize(DXGI_FORMAT format);
+
+void EncodeBC1Block(const UINT8* rgba, UINT8* block);
+void EncodeBC3Block(const UINT8* rgba, UINT8* block);
+// Red and green only
+void EncodeBC5Block(const UINT8* rgba, UINT8* block);
+void EncodeBC7Block(const UINT8* rgba, UINT8* block);
+
+void DecodeBC1Block(const UINT8* block, UINT8* rgba);
+void DecodeBC3Block(const UINT8* block, UINT8* rgba);
+// Blue comes back 0 and alpha opaque
+void DecodeBC5Block(const UINT8* block, UINT8* rgba);
+// Only mode 6 is decoded, other modes return false
+bool DecodeBC7Block(const UINT8* block, UINT8* rgba);
+
+// Tightly packed rows in, block rows out. Edge blocks repeat the last row and column.
+// With a pool the block rows are spread over its workers.
+bool CompressImage(const UINT8* rgba, UINT width, UINT height, DXGI_FORMAT format, UINT8* blocks, WorkerPool* pool = nullptr);
+bool DecompressImage(const UINT8* blocks, UINT width, UINT height, DXGI_FORMAT format, UINT8* rgba);
\ No newline at end of file
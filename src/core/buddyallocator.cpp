@@ -0,0 +1,104 @@
+#include "buddyallocator.h"
+
+#include <cassert>
+
+void BuddyAllocator::Init(UINT64 capacity, UINT64 minBlockSize)
+{
+	assert(minBlockSize > 0 && (minBlockSize & (minBlockSize - 1)) == 0);
+	assert(capacity >= minBlockSize && (capacity & (capacity - 1)) == 0);
+
+	this->capacity = capacity;
+	this->minBlockSize = minBlockSize;
+	used = 0;
+
+	maxOrder = 0;
+	while ((minBlockSize << maxOrder) < capacity) {
+		maxOrder++;
+	}
+
+	// Start with one free block covering everything
+	freeBlocks.assign(maxOrder + 1, std::set<UINT64>());
+	freeBlocks[maxOrder].insert(0);
+}
+
+UINT BuddyAllocator::GetOrder(UINT64 size)
+{
+	UINT order = 0;
+	while ((minBlockSize << order) < size) {
+		order++;
+	}
+	return order;
+}
+
+UINT64 BuddyAllocator::GetBlockSize(UINT64 size)
+{
+	return minBlockSize << GetOrder(size);
+}
+
+bool BuddyAllocator::Allocate(UINT64 size, UINT64* offset)
+{
+	if (size == 0 || size > capacity) {
+		return false;
+	}
+
+	// Find the smallest free block that fits
+	UINT order = GetOrder(size);
+	UINT found = order;
+	while (found <= maxOrder && freeBlocks[found].empty()) {
+		found++;
+	}
+	if (found > maxOrder) {
+		return false;
+	}
+
+	UINT64 block = *freeBlocks[found].begin();
+	freeBlocks[found].erase(freeBlocks[found].begin());
+
+	// Split down to the requested order, keeping the upper halves free
+	while (found > order) {
+		found--;
+		freeBlocks[found].insert(block + (minBlockSize << found));
+	}
+
+	used += minBlockSize << order;
+	*offset = block;
+	return true;
+}
+
+void BuddyAllocator::Free(UINT64 offset, UINT64 size)
+{
+	UINT order = GetOrder(size);
+	used -= minBlockSize << order;
+
+	// Merge with the buddy for as long as it is free too
+	while (order < maxOrder) {
+		UINT64 buddy = offset ^ (minBlockSize << order);
+		auto it = freeBlocks[order].find(buddy);
+		if (it == freeBlocks[order].end()) {
+			break;
+		}
+		freeBlocks[order].erase(it);
+		offset = offset < buddy ? offset : buddy;
+		order++;
+	}
+	freeBlocks[order].insert(offset);
+}
+
+UINT64 BuddyAllocator::GetLargestFreeBlock()
+{
+	for (int order = (int)maxOrder; order >= 0; order--) {
+		if (!freeBlocks[order].empty()) {
+			return minBlockSize << order;
+		}
+	}
+	return 0;
+}
+
+size_t BuddyAllocator::GetFreeBlockCount()
+{
+	size_t count = 0;
+	for (const std::set<UINT64>& blocks : freeBlocks) {
+		count += blocks.size();
+	}
+	return count;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <set>
+
+// Power of two buddy allocator over an abstract range of bytes. Blocks of order k are
+// minBlockSize << k bytes and naturally aligned to their size, so the offsets it hands
+// out can be used directly as placement offsets inside an ID3D12Heap or buffer.
+class BuddyAllocator {
+public:
+	void Init(UINT64 capacity, UINT64 minBlockSize);
+
+	bool Allocate(UINT64 size, UINT64* offset);
+	void Free(UINT64 offset, UINT64 size);
+
+	// Rounded up size a request actually occupies
+	UINT64 GetBlockSize(UINT64 size);
+	UINT64 GetCapacity() { return capacity; }
+	UINT64 GetUsed() { return used; }
+	UINT64 GetLargestFreeBlock();
+	size_t GetFreeBlockCount();
+	bool IsEmpty() { return used == 0; }
+
+private:
+	UINT GetOrder(UINT64 size);
+
+	UINT64 capacity = 0;
+	UINT64 minBlockSize = 0;
+	UINT maxOrder = 0;
+	UINT64 used = 0;
+	std::vector<std::set<UINT64>> freeBlocks;
+};
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "colorconvert.h"
+
+#include <utility>
+
+#if defined(IMAGE_SIMD_AVX2)
+#include <immintrin.h>
+#define IMAGE_SIMD_SSE2
+#elif defined(IMAGE_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+// Fixed point YCbCr weights: luma is scaled by 16 and chroma by 256, so a signed 16-bit
+// high multiply by these leaves the chroma term in luma units. The scalar path applies
+// the same arithmetic so every instruction set rounds identically.
+#define YCC_CR_R 5742  // 1.402 * 4096
+#define YCC_CB_G -1410 // -0.344136 * 4096
+#define YCC_CR_G -2925 // -0.714136 * 4096
+#define YCC_CB_B 7258  // 1.772 * 4096
+
+static inline UINT8 ClampByte(int value) { return (UINT8)(value < 0 ? 0 : (value > 255 ? 255 : value)); }
+
+static inline void ConvertYCbCrPixel(int y, int cb, int cr, UINT8* dst, bool bgra)
+{
+	int luma = y << 4;
+	int blue = (cb - 128) * 256;
+	int red = (cr - 128) * 256;
+	UINT8 r = ClampByte((luma + ((red * YCC_CR_R) >> 16) + 8) >> 4);
+	UINT8 g = ClampByte((luma + ((blue * YCC_CB_G) >> 16) + ((red * YCC_CR_G) >> 16) + 8) >> 4);
+	UINT8 b = ClampByte((luma + ((blue * YCC_CB_B) >> 16) + 8) >> 4);
+	dst[0] = bgra ? b : r;
+	dst[1] = g;
+	dst[2] = bgra ? r : b;
+	dst[3] = 255;
+}
+
+void ConvertYCbCrToRgbaScalar(const UINT8* y, const UINT8* cb, const UINT8* cr, UINT8* dst, UINT count, bool bgra)
+{
+	for (UINT i = 0; i < count; i++) {
+		ConvertYCbCrPixel(y[i], cb[i], cr[i], dst + i * 4, bgra);
+	}
+}
+
+#ifdef IMAGE_SIMD_SSE2
+// Eight pixels in 16-bit lanes to 8-bit channel values in the low half
+static inline void ConvertYCbCr8(__m128i y, __m128i cb, __m128i cr, __m128i* r, __m128i* g, __m128i* b)
+{
+	const __m128i bias = _mm_set1_epi16(128);
+	const __m128i round = _mm_set1_epi16(8);
+	__m128i luma = _mm_slli_epi16(y, 4);
+	__m128i blue = _mm_slli_epi16(_mm_sub_epi16(cb, bias), 8);
+	__m128i red = _mm_slli_epi16(_mm_sub_epi16(cr, bias), 8);
+	*r = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(luma, _mm_mulhi_epi16(red, _mm_set1_epi16(YCC_CR_R))), round), 4);
+	*g = _mm_add_epi16(luma, _mm_add_epi16(_mm_mulhi_epi16(blue, _mm_set1_epi16(YCC_CB_G)), _mm_mulhi_epi16(red, _mm_set1_epi16(YCC_CR_G))));
+	*g = _mm_srai_epi16(_mm_add_epi16(*g, round), 4);
+	*b = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(luma, _mm_mulhi_epi16(blue, _mm_set1_epi16(YCC_CB_B))), round), 4);
+}
+#endif
+
+#ifdef IMAGE_SIMD_AVX2
+static inline void ConvertYCbCr16(__m256i y, __m256i cb, __m256i cr, __m256i* r, __m256i* g, __m256i* b)
+{
+	const __m256i bias = _mm256_set1_epi16(128);
+	const __m256i round = _mm256_set1_epi16(8);
+	__m256i luma = _mm256_slli_epi16(y, 4);
+	__m256i blue = _mm256_slli_epi16(_mm256_sub_epi16(cb, bias), 8);
+	__m256i red = _mm256_slli_epi16(_mm256_sub_epi16(cr, bias), 8);
+	*r = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(luma, _mm256_mulhi_epi16(red, _mm256_set1_epi16(YCC_CR_R))), round), 4);
+	*g = _mm256_add_epi16(luma, _mm256_add_epi16(_mm256_mulhi_epi16(blue, _mm256_set1_epi16(YCC_CB_G)), _mm256_mulhi_epi16(red, _mm256_set1_epi16(YCC_CR_G))));
+	*g = _mm256_srai_epi16(_mm256_add_epi16(*g, round), 4);
+	*b = _mm256_srai_epi16(_mm256_add_epi16(_mm256_add_epi16(luma, _mm256_mulhi_epi16(blue, _mm256_set1_epi16(YCC_CB_B))), round), 4);
+}
+#endif
+
+void ConvertYCbCrToRgba(const UINT8* y, const UINT8* cb, const UINT8* cr, UINT8* dst, UINT count, bool bgra)
+{
+	UINT i = 0;
+#ifdef IMAGE_SIMD_AVX2
+	const __m256i zero256 = _mm256_setzero_si256();
+	const __m256i alpha256 = _mm256_set1_epi8((char)0xFF);
+	for (; i + 32 <= count; i += 32)
+	{
+		__m256i y8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+		__m256i cb8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cb + i));
+		__m256i cr8 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cr + i));
+
+		// Unpacking and packing both stay within 128-bit lanes, so channel order survives
+		__m256i rLo, gLo, bLo, rHi, gHi, bHi;
+		ConvertYCbCr16(_mm256_unpacklo_epi8(y8, zero256), _mm256_unpacklo_epi8(cb8, zero256), _mm256_unpacklo_epi8(cr8, zero256), &rLo, &gLo, &bLo);
+		ConvertYCbCr16(_mm256_unpackhi_epi8(y8, zero256), _mm256_unpackhi_epi8(cb8, zero256), _mm256_unpackhi_epi8(cr8, zero256), &rHi, &gHi, &bHi);
+		__m256i r = _mm256_packus_epi16(rLo, rHi);
+		__m256i g = _mm256_packus_epi16(gLo, gHi);
+		__m256i b = _mm256_packus_epi16(bLo, bHi);
+		if (bgra) {
+			std::swap(r, b);
+		}
+
+		// Each lane holds pixels 0-15 and 16-31 of its half, put them back in order
+		__m256i rg = _mm256_unpacklo_epi8(r, g);
+		__m256i ba = _mm256_unpacklo_epi8(b, alpha256);
+		__m256i p0 = _mm256_unpacklo_epi16(rg, ba);
+		__m256i p1 = _mm256_unpackhi_epi16(rg, ba);
+		rg = _mm256_unpackhi_epi8(r, g);
+		ba = _mm256_unpackhi_epi8(b, alpha256);
+		__m256i p2 = _mm256_unpacklo_epi16(rg, ba);
+		__m256i p3 = _mm256_unpackhi_epi16(rg, ba);
+		__m256i* out = reinterpret_cast<__m256i*>(dst + i * 4);
+		_mm256_storeu_si256(out, _mm256_permute2x128_si256(p0, p1, 0x20));
+		_mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(p2, p3, 0x20));
+		_mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(p0, p1, 0x31));
+		_mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(p2, p3, 0x31));
+	}
+#endif
+#ifdef IMAGE_SIMD_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alpha = _mm_set1_epi8((char)0xFF);
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i));
+		__m128i cb8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cb + i));
+		__m128i cr8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cr + i));
+
+		__m128i rLo, gLo, bLo, rHi, gHi, bHi;
+		ConvertYCbCr8(_mm_unpacklo_epi8(y8, zero), _mm_unpacklo_epi8(cb8, zero), _mm_unpacklo_epi8(cr8, zero), &rLo, &gLo, &bLo);
+		ConvertYCbCr8(_mm_unpackhi_epi8(y8, zero), _mm_unpackhi_epi8(cb8, zero), _mm_unpackhi_epi8(cr8, zero), &rHi, &gHi, &bHi);
+		__m128i r = _mm_packus_epi16(rLo, rHi);
+		__m128i g = _mm_packus_epi16(gLo, gHi);
+		__m128i b = _mm_packus_epi16(bLo, bHi);
+		if (bgra) {
+			std::swap(r, b);
+		}
+
+		// Interleave the channels four pixels at a time
+		__m128i rg = _mm_unpacklo_epi8(r, g);
+		__m128i ba = _mm_unpacklo_epi8(b, alpha);
+		__m128i* out = reinterpret_cast<__m128i*>(dst + i * 4);
+		_mm_storeu_si128(out, _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(rg, ba));
+		rg = _mm_unpackhi_epi8(r, g);
+		ba = _mm_unpackhi_epi8(b, alpha);
+		_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(rg, ba));
+	}
+#endif
+	ConvertYCbCrToRgbaScalar(y + i, cb + i, cr + i, dst + i * 4, count - i, bgra);
+}
+
+void ConvertRgbToRgba(const UINT8* src, UINT8* dst, UINT count, bool bgra)
+{
+	int red = bgra ? 2 : 0;
+	for (UINT i = 0; i < count; i++, src += 3, dst += 4) {
+		dst[0] = src[red];
+		dst[1] = src[1];
+		dst[2] = src[2 - red];
+		dst[3] = 255;
+	}
+}
+
+void ConvertGrayToRgba(const UINT8* src, UINT8* dst, UINT count)
+{
+	for (UINT i = 0; i < count; i++, dst += 4) {
+		dst[0] = dst[1] = dst[2] = src[i];
+		dst[3] = 255;
+	}
+}
+
+void SwizzleRgbaScalar(const UINT8* src, UINT8* dst, UINT count)
+{
+	for (UINT i = 0; i < count; i++, src += 4, dst += 4) {
+		UINT8 red = src[0];
+		dst[0] = src[2];
+		dst[1] = src[1];
+		dst[2] = red;
+		dst[3] = src[3];
+	}
+}
+
+void SwizzleRgba(const UINT8* src, UINT8* dst, UINT count)
+{
+	UINT i = 0;
+#ifdef IMAGE_SIMD_AVX2
+	const __m256i greenAlpha256 = _mm256_set1_epi32((int)0xFF00FF00);
+	const __m256i low256 = _mm256_set1_epi32(0xFF);
+	for (; i + 8 <= count; i += 8) {
+		__m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+		__m256i swapped = _mm256_or_si256(_mm256_and_si256(pixels, greenAlpha256),
+			_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(pixels, 16), low256), _mm256_slli_epi32(_mm256_and_si256(pixels, low256), 16)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), swapped);
+	}
+#endif
+#ifdef IMAGE_SIMD_SSE2
+	const __m128i greenAlpha = _mm_set1_epi32((int)0xFF00FF00);
+	const __m128i low = _mm_set1_epi32(0xFF);
+	for (; i + 4 <= count; i += 4) {
+		__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+		__m128i swapped = _mm_or_si128(_mm_and_si128(pixels, greenAlpha),
+			_mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 16), low), _mm_slli_epi32(_mm_and_si128(pixels, low), 16)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), swapped);
+	}
+#endif
+	SwizzleRgbaScalar(src + i * 4, dst + i * 4, count - i);
+}
+
+const char* GetColorConvertPath()
+{
+#if defined(IMAGE_SIMD_AVX2)
+	return "AVX2";
+#elif defined(IMAGE_SIMD_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
\ No newline at end of file
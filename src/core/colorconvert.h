@@ -0,0 +1,22 @@
+#pragma once
+
+#include "coreconst.h"
+
+// Row converters from decoded image samples to 8-bit RGBA or BGRA. The instruction set is
+// picked at build time through IMAGE_SIMD (NONE, SSE2 or AVX2), every path produces the
+// same bytes as the scalar one.
+
+// Full resolution Y, Cb and Cr rows (JFIF, BT.601 full range)
+void ConvertYCbCrToRgba(const UINT8* y, const UINT8* cb, const UINT8* cr, UINT8* dst, UINT count, bool bgra);
+void ConvertYCbCrToRgbaScalar(const UINT8* y, const UINT8* cb, const UINT8* cr, UINT8* dst, UINT count, bool bgra);
+
+// Packed RGB rows, alpha becomes opaque
+void ConvertRgbToRgba(const UINT8* src, UINT8* dst, UINT count, bool bgra);
+void ConvertGrayToRgba(const UINT8* src, UINT8* dst, UINT count);
+
+// Swaps red and blue, src and dst may be the same row
+void SwizzleRgba(const UINT8* src, UINT8* dst, UINT count);
+void SwizzleRgbaScalar(const UINT8* src, UINT8* dst, UINT count);
+
+// Name of the conversion path this build uses
+const char* GetColorConvertPath();
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+// DirectX 12 (platform neutral)
+#ifndef _WIN32
+#include <wsl/winadapter.h>
+#endif
+#include <d3d12.h>
+#include "d3dx12.h"
+#ifndef _WIN32
+#include <dxguids/dxguids.h>
+#endif
+
+// Standard Library
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "coremath.h"
+
+#define SAFE_RELEASE(p) { if ( (p) ) { (p)->Release(); (p) = 0; } }
+
+#define DEFAULT_WINDOW_WIDTH 800
+#define DEFAULT_WINDOW_HEIGHT 600
+
+#define FRAME_BUFFER_COUNT 2
+
+// Frames the CPU may record ahead of the GPU, independent of the swap chain buffer count
+#ifndef FRAMES_IN_FLIGHT
+#define FRAMES_IN_FLIGHT 3
+#endif
+#define MAX_FRAMES_IN_FLIGHT 8
+
+#define UPLOAD_RING_SIZE (16 * 1024 * 1024)
+
+struct Vertex {
+	Vertex(float x, float y, float z, float u, float v) : pos(x, y, z), normals(x, y, z), texCoord(u, v) {}
+	Float3 pos;
+	Float3 normals;
+	Float2 texCoord;
+};
+
+// 16-bit indices whenever every vertex of the mesh can be addressed with them
+inline DXGI_FORMAT IndexFormatFor(size_t vertexCount) { return vertexCount <= 0x10000 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT; }
+inline UINT IndexSizeOf(DXGI_FORMAT format) { return format == DXGI_FORMAT_R16_UINT ? sizeof(UINT16) : sizeof(UINT32); }
\ No newline at end of file
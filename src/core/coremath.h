@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cmath>
+
+// Minimal row-major math matching the DirectXMath conventions used by the shaders
+// (row vectors, left handed), so the scene can be updated without DirectXMath.
+
+struct Float2 {
+	Float2() = default;
+	Float2(float _x, float _y) : x(_x), y(_y) {}
+	float x = 0.0f, y = 0.0f;
+};
+
+struct Float3 {
+	Float3() = default;
+	Float3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+	float x = 0.0f, y = 0.0f, z = 0.0f;
+};
+
+struct Float4 {
+	Float4() = default;
+	Float4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+	float x = 0.0f, y = 0.0f, z = 0.0f, w = 0.0f;
+};
+
+struct Float4x4 {
+	float m[4][4] = {};
+};
+
+inline Float3 Vec3Sub(const Float3& a, const Float3& b) { return Float3(a.x - b.x, a.y - b.y, a.z - b.z); }
+
+inline float Vec3Dot(const Float3& a, const Float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+inline Float3 Vec3Cross(const Float3& a, const Float3& b)
+{
+	return Float3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+
+inline Float3 Vec3Normalize(const Float3& v)
+{
+	float length = std::sqrt(Vec3Dot(v, v));
+	if (length <= 0.0f) return v;
+	return Float3(v.x / length, v.y / length, v.z / length);
+}
+
+inline Float4x4 MatrixIdentity()
+{
+	Float4x4 r;
+	r.m[0][0] = r.m[1][1] = r.m[2][2] = r.m[3][3] = 1.0f;
+	return r;
+}
+
+inline Float4x4 MatrixMultiply(const Float4x4& a, const Float4x4& b)
+{
+	Float4x4 r;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			r.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] + a.m[i][2] * b.m[2][j] + a.m[i][3] * b.m[3][j];
+		}
+	}
+	return r;
+}
+
+inline Float4x4 MatrixTranspose(const Float4x4& a)
+{
+	Float4x4 r;
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			r.m[i][j] = a.m[j][i];
+		}
+	}
+	return r;
+}
+
+inline Float4x4 MatrixTranslation(float x, float y, float z)
+{
+	Float4x4 r = MatrixIdentity();
+	r.m[3][0] = x;
+	r.m[3][1] = y;
+	r.m[3][2] = z;
+	return r;
+}
+
+inline Float4x4 MatrixScaling(float x, float y, float z)
+{
+	Float4x4 r = MatrixIdentity();
+	r.m[0][0] = x;
+	r.m[1][1] = y;
+	r.m[2][2] = z;
+	return r;
+}
+
+inline Float4x4 MatrixRotationX(float angle)
+{
+	float s = std::sin(angle), c = std::cos(angle);
+	Float4x4 r = MatrixIdentity();
+	r.m[1][1] = c; r.m[1][2] = s;
+	r.m[2][1] = -s; r.m[2][2] = c;
+	return r;
+}
+
+inline Float4x4 MatrixRotationY(float angle)
+{
+	float s = std::sin(angle), c = std::cos(angle);
+	Float4x4 r = MatrixIdentity();
+	r.m[0][0] = c; r.m[0][2] = -s;
+	r.m[2][0] = s; r.m[2][2] = c;
+	return r;
+}
+
+inline Float4x4 MatrixRotationZ(float angle)
+{
+	float s = std::sin(angle), c = std::cos(angle);
+	Float4x4 r = MatrixIdentity();
+	r.m[0][0] = c; r.m[0][1] = s;
+	r.m[1][0] = -s; r.m[1][1] = c;
+	return r;
+}
+
+inline Float4x4 MatrixLookAtLH(const Float3& eye, const Float3& focus, const Float3& up)
+{
+	Float3 zAxis = Vec3Normalize(Vec3Sub(focus, eye));
+	Float3 xAxis = Vec3Normalize(Vec3Cross(up, zAxis));
+	Float3 yAxis = Vec3Cross(zAxis, xAxis);
+
+	Float4x4 r = MatrixIdentity();
+	r.m[0][0] = xAxis.x; r.m[0][1] = yAxis.x; r.m[0][2] = zAxis.x;
+	r.m[1][0] = xAxis.y; r.m[1][1] = yAxis.y; r.m[1][2] = zAxis.y;
+	r.m[2][0] = xAxis.z; r.m[2][1] = yAxis.z; r.m[2][2] = zAxis.z;
+	r.m[3][0] = -Vec3Dot(xAxis, eye);
+	r.m[3][1] = -Vec3Dot(yAxis, eye);
+	r.m[3][2] = -Vec3Dot(zAxis, eye);
+	return r;
+}
+
+inline Float4x4 MatrixPerspectiveFovLH(float fovY, float aspect, float nearZ, float farZ)
+{
+	float height = 1.0f / std::tan(0.5f * fovY);
+	float range = farZ / (farZ - nearZ);
+
+	Float4x4 r;
+	r.m[0][0] = height / aspect;
+	r.m[1][1] = height;
+	r.m[2][2] = range;
+	r.m[2][3] = 1.0f;
+	r.m[3][2] = -range * nearZ;
+	return r;
+}
+
+inline Float4x4 MatrixOrthographicLH(float width, float height, float nearZ, float farZ)
+{
+	float range = 1.0f / (farZ - nearZ);
+
+	Float4x4 r;
+	r.m[0][0] = 2.0f / width;
+	r.m[1][1] = 2.0f / height;
+	r.m[2][2] = range;
+	r.m[3][2] = -range * nearZ;
+	r.m[3][3] = 1.0f;
+	return r;
+}
+
+inline Float3 ToFloat3(const Float4& v) { return Float3(v.x, v.y, v.z); }
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "ddsfile.h"
+#include "mipgenerator.h"
+
+#include <fstream>
+
+#define DDSD_CAPS 0x1
+#define DDSD_HEIGHT 0x2
+#define DDSD_WIDTH 0x4
+#define DDSD_PIXELFORMAT 0x1000
+#define DDSD_MIPMAPCOUNT 0x20000
+#define DDSD_LINEARSIZE 0x80000
+#define DDPF_FOURCC 0x4
+#define DDPF_RGB 0x40
+#define DDSCAPS_COMPLEX 0x8
+#define DDSCAPS_TEXTURE 0x1000
+#define DDSCAPS_MIPMAP 0x400000
+#define DDSCAPS2_CUBEMAP 0x200
+#define DDSCAPS2_VOLUME 0x200000
+
+static bool IsSupportedFormat(DXGI_FORMAT format)
+{
+	switch (format) {
+	case DXGI_FORMAT_R8G8B8A8_UNORM:
+	case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+	case DXGI_FORMAT_B8G8R8A8_UNORM:
+	case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+	case DXGI_FORMAT_BC1_UNORM:
+	case DXGI_FORMAT_BC1_UNORM_SRGB:
+	case DXGI_FORMAT_BC2_UNORM:
+	case DXGI_FORMAT_BC2_UNORM_SRGB:
+	case DXGI_FORMAT_BC3_UNORM:
+	case DXGI_FORMAT_BC3_UNORM_SRGB:
+	case DXGI_FORMAT_BC4_UNORM:
+	case DXGI_FORMAT_BC4_SNORM:
+	case DXGI_FORMAT_BC5_UNORM:
+	case DXGI_FORMAT_BC5_SNORM:
+	case DXGI_FORMAT_BC6H_UF16:
+	case DXGI_FORMAT_BC6H_SF16:
+	case DXGI_FORMAT_BC7_UNORM:
+	case DXGI_FORMAT_BC7_UNORM_SRGB:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static DXGI_FORMAT GetLegacyFormat(const DdsPixelFormat& pixelFormat)
+{
+	if (pixelFormat.flags & DDPF_FOURCC) {
+		switch (pixelFormat.fourCC) {
+		case DDS_FOURCC('D', 'X', 'T', '1'): return DXGI_FORMAT_BC1_UNORM;
+		case DDS_FOURCC('D', 'X', 'T', '3'): return DXGI_FORMAT_BC2_UNORM;
+		case DDS_FOURCC('D', 'X', 'T', '5'): return DXGI_FORMAT_BC3_UNORM;
+		case DDS_FOURCC('A', 'T', 'I', '1'):
+		case DDS_FOURCC('B', 'C', '4', 'U'): return DXGI_FORMAT_BC4_UNORM;
+		case DDS_FOURCC('A', 'T', 'I', '2'):
+		case DDS_FOURCC('B', 'C', '5', 'U'): return DXGI_FORMAT_BC5_UNORM;
+		default: return DXGI_FORMAT_UNKNOWN;
+		}
+	}
+	if ((pixelFormat.flags & DDPF_RGB) && pixelFormat.rgbBitCount == 32) {
+		if (pixelFormat.rBitMask == 0x000000FF && pixelFormat.gBitMask == 0x0000FF00 && pixelFormat.bBitMask == 0x00FF0000) {
+			return DXGI_FORMAT_R8G8B8A8_UNORM;
+		}
+		if (pixelFormat.rBitMask == 0x00FF0000 && pixelFormat.gBitMask == 0x0000FF00 && pixelFormat.bBitMask == 0x000000FF) {
+			return DXGI_FORMAT_B8G8R8A8_UNORM;
+		}
+	}
+	return DXGI_FORMAT_UNKNOWN;
+}
+
+bool ReadDdsInfo(std::span<const UINT8> data, DdsInfo* info)
+{
+	// Magic & Header
+	UINT32 magic;
+	DdsHeader header;
+	if (data.size() < sizeof(magic) + sizeof(header)) {
+		return false;
+	}
+	memcpy(&magic, data.data(), sizeof(magic));
+	memcpy(&header, data.data() + sizeof(magic), sizeof(header));
+	if (magic != DDS_MAGIC || header.size != sizeof(DdsHeader) || header.pixelFormat.size != sizeof(DdsPixelFormat)) {
+		return false;
+	}
+	if ((header.caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) || header.width == 0 || header.height == 0) {
+		return false;
+	}
+
+	// Format From The DX10 Header Or The Legacy Pixel Format
+	UINT64 offset = sizeof(magic) + sizeof(header);
+	DXGI_FORMAT format;
+	if ((header.pixelFormat.flags & DDPF_FOURCC) && header.pixelFormat.fourCC == DDS_FOURCC('D', 'X', '1', '0')) {
+		DdsHeaderDX10 extension;
+		if (data.size() < offset + sizeof(extension)) {
+			return false;
+		}
+		memcpy(&extension, data.data() + offset, sizeof(extension));
+		offset += sizeof(extension);
+		if (extension.resourceDimension != D3D12_RESOURCE_DIMENSION_TEXTURE2D || extension.arraySize != 1 || (extension.miscFlag & 0x4)) {
+			return false;
+		}
+		format = (DXGI_FORMAT)extension.dxgiFormat;
+	}
+	else {
+		format = GetLegacyFormat(header.pixelFormat);
+	}
+	if (!IsSupportedFormat(format)) {
+		return false;
+	}
+
+	UINT mipLevels = header.mipMapCount ? header.mipMapCount : 1;
+	if (mipLevels > GetMipLevelCount(header.width, header.height) || mipLevels > D3D12_REQ_MIP_LEVELS) {
+		return false;
+	}
+	MipLevel levels[D3D12_REQ_MIP_LEVELS];
+	UINT64 size = GetMipChainLayout(header.width, header.height, mipLevels, levels, format);
+	if (data.size() < offset + size) {
+		return false;
+	}
+
+	info->width = header.width;
+	info->height = header.height;
+	info->mipLevels = mipLevels;
+	info->format = format;
+	info->dataOffset = offset;
+	info->dataSize = size;
+	return true;
+}
+
+bool WriteDds(const std::filesystem::path& path, UINT width, UINT height, UINT mipLevels, DXGI_FORMAT format, std::span<const UINT8> chain)
+{
+	MipLevel levels[D3D12_REQ_MIP_LEVELS];
+	if (!IsSupportedFormat(format) || mipLevels == 0 || mipLevels > D3D12_REQ_MIP_LEVELS ||
+		GetMipChainLayout(width, height, mipLevels, levels, format) != chain.size()) {
+		return false;
+	}
+
+	// Create Headers
+	UINT32 magic = DDS_MAGIC;
+	DdsHeader header = {};
+	header.size = sizeof(DdsHeader);
+	header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+	header.height = height;
+	header.width = width;
+	header.pitchOrLinearSize = (UINT32)(levels[0].rowPitch * levels[0].rows);
+	header.mipMapCount = mipLevels;
+	header.pixelFormat.size = sizeof(DdsPixelFormat);
+	header.pixelFormat.flags = DDPF_FOURCC;
+	header.pixelFormat.fourCC = DDS_FOURCC('D', 'X', '1', '0');
+	header.caps = DDSCAPS_TEXTURE | (mipLevels > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+	DdsHeaderDX10 extension = {};
+	extension.dxgiFormat = format;
+	extension.resourceDimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	extension.arraySize = 1;
+
+	// Write The Whole File
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(&extension), sizeof(extension));
+	file.write(reinterpret_cast<const char*>(chain.data()), chain.size());
+	return (bool)file;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <filesystem>
+#include <span>
+
+#define DDS_MAGIC 0x20534444 // "DDS "
+#define DDS_FOURCC(a, b, c, d) ((UINT32)(UINT8)(a) | ((UINT32)(UINT8)(b) << 8) | ((UINT32)(UINT8)(c) << 16) | ((UINT32)(UINT8)(d) << 24))
+
+// On disk layout, the same structures DirectXTK's DDSTextureLoader reads
+struct DdsPixelFormat {
+	UINT32 size;
+	UINT32 flags;
+	UINT32 fourCC;
+	UINT32 rgbBitCount;
+	UINT32 rBitMask;
+	UINT32 gBitMask;
+	UINT32 bBitMask;
+	UINT32 aBitMask;
+};
+
+struct DdsHeader {
+	UINT32 size;
+	UINT32 flags;
+	UINT32 height;
+	UINT32 width;
+	UINT32 pitchOrLinearSize;
+	UINT32 depth;
+	UINT32 mipMapCount;
+	UINT32 reserved1[11];
+	DdsPixelFormat pixelFormat;
+	UINT32 caps;
+	UINT32 caps2;
+	UINT32 caps3;
+	UINT32 caps4;
+	UINT32 reserved2;
+};
+
+struct DdsHeaderDX10 {
+	UINT32 dxgiFormat;
+	UINT32 resourceDimension;
+	UINT32 miscFlag;
+	UINT32 arraySize;
+	UINT32 miscFlags2;
+};
+
+// Where the texels of a DDS file are, every level tightly packed after the one above as
+// GetMipChainLayout describes them
+struct DdsInfo {
+	UINT width = 0;
+	UINT height = 0;
+	UINT mipLevels = 0;
+	DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+	UINT64 dataOffset = 0;
+	UINT64 dataSize = 0;
+};
+
+// Single 2D textures only, no arrays, cube maps or volumes. Formats come from the DX10
+// header or the legacy DXT1/DXT3/DXT5/ATI1/ATI2/BC4U/BC5U FourCCs and 32-bit RGBA/BGRA masks.
+// Fails when the file is too short for the whole chain.
+bool ReadDdsInfo(std::span<const UINT8> data, DdsInfo* info);
+// Always writes the DX10 header
+bool WriteDds(const std::filesystem::path& path, UINT width, UINT height, UINT mipLevels, DXGI_FORMAT format, std::span<const UINT8> chain);
\ No newline at end of file
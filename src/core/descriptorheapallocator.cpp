@@ -0,0 +1,40 @@
+#include "descriptorheapallocator.h"
+
+#include <cassert>
+
+void DescriptorHeapAllocator::Create(ID3D12Device* device, ID3D12DescriptorHeap* heap)
+{
+	assert(Heap == nullptr && FreeIndices.empty());
+	Heap = heap;
+	D3D12_DESCRIPTOR_HEAP_DESC desc = heap->GetDesc();
+	HeapType = desc.Type;
+	HeapStartCpu = Heap->GetCPUDescriptorHandleForHeapStart();
+	HeapStartGpu = Heap->GetGPUDescriptorHandleForHeapStart();
+	HeapHandleIncrement = device->GetDescriptorHandleIncrementSize(HeapType);
+	FreeIndices.reserve((int)desc.NumDescriptors);
+	for (int n = desc.NumDescriptors; n > 0; n--) {
+		FreeIndices.push_back(n - 1);
+	}
+}
+
+void DescriptorHeapAllocator::Destroy()
+{
+	Heap = nullptr;
+	FreeIndices.clear();
+}
+
+void DescriptorHeapAllocator::Alloc(D3D12_CPU_DESCRIPTOR_HANDLE* out_cpu_desc_handle, D3D12_GPU_DESCRIPTOR_HANDLE* out_gpu_desc_handle)
+{
+	assert(FreeIndices.size() > 0);
+	int idx = FreeIndices.back();
+	FreeIndices.pop_back();
+	out_cpu_desc_handle->ptr = HeapStartCpu.ptr + (idx * HeapHandleIncrement);
+	out_gpu_desc_handle->ptr = HeapStartGpu.ptr + (idx * HeapHandleIncrement);
+}
+
+void DescriptorHeapAllocator::Free(D3D12_CPU_DESCRIPTOR_HANDLE out_cpu_desc_handle, [[maybe_unused]] D3D12_GPU_DESCRIPTOR_HANDLE out_gpu_desc_handle)
+{
+	int cpu_idx = (int)((out_cpu_desc_handle.ptr - HeapStartCpu.ptr) / HeapHandleIncrement);
+	assert(cpu_idx == (int)((out_gpu_desc_handle.ptr - HeapStartGpu.ptr) / HeapHandleIncrement));
+	FreeIndices.push_back(cpu_idx);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "framerecorder.h"
+
+void FrameRecorder::RecordPasses(ID3D12GraphicsCommandList* commandList, D3D12_GPU_VIRTUAL_ADDRESS constantBuffer, UINT constantBufferStride, D3D12_CPU_DESCRIPTOR_HANDLE backBufferRtv, bool texturesReady)
+{
+	ID3D12DescriptorHeap* descriptorHeaps[] = { bindings.srvDescriptorHeap };
+	commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
+
+	commandList->SetGraphicsRootSignature(bindings.rootSignature);
+	commandList->SetGraphicsRootDescriptorTable(1, bindings.srvTable);
+
+	// Bind the geometry pool once for every pass, index buffers follow the meshes' formats
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	commandList->IASetVertexBuffers(0, 1, &bindings.vertexBufferView);
+	boundIndexFormat = DXGI_FORMAT_UNKNOWN;
+
+	// Shadow Map Pass
+	commandList->RSSetViewports(1, &bindings.smViewport);
+	commandList->RSSetScissorRects(1, &bindings.smScissorRect);
+
+	commandList->OMSetRenderTargets(0, nullptr, FALSE, &bindings.shadowMapDsv);
+	commandList->ClearDepthStencilView(bindings.shadowMapDsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+	commandList->SetPipelineState(bindings.shadowPSO);
+	DrawScene(commandList, constantBuffer, constantBufferStride, true, true);
+
+	// Scene Pass
+	commandList->RSSetViewports(1, &bindings.viewport);
+	commandList->RSSetScissorRects(1, &bindings.scissorRect);
+
+	commandList->OMSetRenderTargets(1, &bindings.renderTextureRtv, FALSE, &bindings.depthStencilDsv);
+	const float newClearColor[] = {0.2f, 0.1f, 0.3f, 1.0f};
+	commandList->ClearRenderTargetView(bindings.renderTextureRtv, newClearColor, 0, nullptr);
+	commandList->ClearDepthStencilView(bindings.depthStencilDsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+	commandList->SetPipelineState(bindings.scenePSO);
+	DrawScene(commandList, constantBuffer, constantBufferStride, texturesReady, texturesReady);
+
+	// Post Process Pass
+	commandList->OMSetRenderTargets(1, &backBufferRtv, FALSE, nullptr);
+	const float newerClearColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
+	commandList->ClearRenderTargetView(backBufferRtv, newerClearColor, 0, nullptr);
+	commandList->SetPipelineState(bindings.postPSO);
+	DrawMesh(commandList, bindings.renderTri);
+}
+
+void FrameRecorder::DrawScene(ID3D12GraphicsCommandList* commandList, D3D12_GPU_VIRTUAL_ADDRESS constantBuffer, UINT constantBufferStride, bool drawCube, bool drawPlane)
+{
+	if (drawCube) {
+		commandList->SetGraphicsRootConstantBufferView(0, constantBuffer);
+		DrawMesh(commandList, bindings.cube);
+	}
+	if (drawPlane) {
+		commandList->SetGraphicsRootConstantBufferView(0, constantBuffer + constantBufferStride);
+		DrawMesh(commandList, bindings.plane);
+	}
+}
+
+void FrameRecorder::DrawMesh(ID3D12GraphicsCommandList* commandList, const MeshHandle& mesh)
+{
+	if (mesh.indexFormat != boundIndexFormat) {
+		commandList->IASetIndexBuffer(mesh.indexFormat == DXGI_FORMAT_R16_UINT ? &bindings.indexBufferView16 : &bindings.indexBufferView32);
+		boundIndexFormat = mesh.indexFormat;
+	}
+	commandList->DrawIndexedInstanced(mesh.indexCount, 1, mesh.firstIndex, mesh.baseVertex, 0);
+}
\ No newline at end of file
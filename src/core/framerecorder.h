@@ -0,0 +1,50 @@
+#pragma once
+
+#include "coreconst.h"
+#include "geometrypool.h"
+
+// Everything the shadow, scene and post process passes bind, filled once by the renderer
+struct FrameBindings {
+	// Root Signature & Pipeline State Objects
+	ID3D12RootSignature* rootSignature = nullptr;
+	ID3D12PipelineState* scenePSO = nullptr;
+	ID3D12PipelineState* postPSO = nullptr;
+	ID3D12PipelineState* shadowPSO = nullptr;
+
+	// Descriptors
+	ID3D12DescriptorHeap* srvDescriptorHeap = nullptr;
+	D3D12_GPU_DESCRIPTOR_HANDLE srvTable = {};
+	D3D12_CPU_DESCRIPTOR_HANDLE renderTextureRtv = {};
+	D3D12_CPU_DESCRIPTOR_HANDLE depthStencilDsv = {};
+	D3D12_CPU_DESCRIPTOR_HANDLE shadowMapDsv = {};
+
+	// Geometry, every mesh lives in the same pooled buffers
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
+	D3D12_INDEX_BUFFER_VIEW indexBufferView16 = {};
+	D3D12_INDEX_BUFFER_VIEW indexBufferView32 = {};
+	MeshHandle cube;
+	MeshHandle plane;
+	MeshHandle renderTri;
+
+	// Viewports
+	D3D12_VIEWPORT viewport = {};
+	D3D12_RECT scissorRect = {};
+	D3D12_VIEWPORT smViewport = {};
+	D3D12_RECT smScissorRect = {};
+};
+
+class FrameRecorder {
+public:
+	void SetBindings(const FrameBindings& frameBindings) { bindings = frameBindings; }
+
+	// Records the shadow map, scene and post process passes for one frame,
+	// the scene pass only clears until the textures it samples have arrived
+	void RecordPasses(ID3D12GraphicsCommandList* commandList, D3D12_GPU_VIRTUAL_ADDRESS constantBuffer, UINT constantBufferStride, D3D12_CPU_DESCRIPTOR_HANDLE backBufferRtv, bool texturesReady);
+
+private:
+	void DrawScene(ID3D12GraphicsCommandList* commandList, D3D12_GPU_VIRTUAL_ADDRESS constantBuffer, UINT constantBufferStride, bool drawCube, bool drawPlane);
+	void DrawMesh(ID3D12GraphicsCommandList* commandList, const MeshHandle& mesh);
+
+	FrameBindings bindings;
+	DXGI_FORMAT boundIndexFormat = DXGI_FORMAT_UNKNOWN;
+};
\ No newline at end of file
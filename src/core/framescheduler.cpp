@@ -0,0 +1,49 @@
+#include "framescheduler.h"
+
+#include <cassert>
+
+bool FrameScheduler::Init(ID3D12Device* device, GpuTimeline* timeline, int framesInFlight)
+{
+	HRESULT result;
+
+	assert(framesInFlight > 0 && framesInFlight <= MAX_FRAMES_IN_FLIGHT);
+	this->framesInFlight = framesInFlight;
+	this->timeline = timeline;
+
+	// Create one allocator per frame slot
+	for (int i = 0; i < framesInFlight; i++) {
+		result = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator[i]));
+		if (FAILED(result)) {
+			return false;
+		}
+		retireTicket[i] = 0;
+	}
+
+	return true;
+}
+
+void FrameScheduler::UnInit()
+{
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+		SAFE_RELEASE(commandAllocator[i]);
+	}
+}
+
+int FrameScheduler::BeginFrame()
+{
+	frameSlot = (int)(frameNumber % framesInFlight);
+
+	// Only block if the GPU has not finished the frame that last used this slot
+	timeline->WaitFor(retireTicket[frameSlot]);
+	timeline->ReleaseCompleted();
+
+	return frameSlot;
+}
+
+UINT64 FrameScheduler::EndFrame()
+{
+	retireTicket[frameSlot] = timeline->Submit();
+	frameNumber++;
+
+	return retireTicket[frameSlot];
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "coreconst.h"
+#include "gputimeline.h"
+
+// Lets the CPU record up to framesInFlight frames ahead of the GPU.
+// Each frame slot (command allocator + constant buffer slice) remembers the timeline
+// ticket its frame was submitted with and is only reused once that ticket completes.
+class FrameScheduler {
+public:
+	bool Init(ID3D12Device* device, GpuTimeline* timeline, int framesInFlight);
+	void UnInit();
+
+	// Waits until the slot for the next frame has retired and returns it
+	int BeginFrame();
+	// Submits to the timeline and returns the ticket that retires the current frame
+	UINT64 EndFrame();
+
+	int GetFrameSlot() { return frameSlot; }
+	int GetFramesInFlight() { return framesInFlight; }
+	ID3D12CommandAllocator* GetCommandAllocator(int slot) { return commandAllocator[slot]; }
+
+private:
+	GpuTimeline* timeline = nullptr;
+
+	// Frame Slots
+	int framesInFlight = 0;
+	int frameSlot = 0;
+	UINT64 frameNumber = 0;
+	ID3D12CommandAllocator* commandAllocator[MAX_FRAMES_IN_FLIGHT] = {};
+	UINT64 retireTicket[MAX_FRAMES_IN_FLIGHT] = {};
+};
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "frameupdater.h"
+
+void FrameUpdater::SetTargets(const FrameTargets& frameTargets)
+{
+	targets = frameTargets;
+	litMask = targets.scene->GetLightingMask();
+	postMask = targets.scene->GetPostMask();
+}
+
+bool FrameUpdater::Update(float dt)
+{
+	Scene* scene = targets.scene;
+
+	// Wait only until the GPU has retired the frame that last used this slot
+	frameSlot = targets.frameScheduler->BeginFrame();
+
+	scene->Update(dt);
+	bool variantsChanged = scene->GetLightingMask() != litMask || scene->GetPostMask() != postMask;
+	litMask = scene->GetLightingMask();
+	postMask = scene->GetPostMask();
+
+	// Upload textures whose decode finished and evict down to the budget
+	if (targets.textureCache) {
+		targets.textureCache->Update();
+	}
+
+	// Both draws report how large they appear, then shaders are clamped to the levels resident
+	if (targets.textureStreamer && targets.streamedTexture != STREAMED_TEXTURE_INVALID)
+	{
+		TextureStreamer* streamer = targets.textureStreamer;
+		const Float4x4& view = scene->GetViewMatrix();
+		const Float4x4& proj = scene->GetProjectionMatrix();
+		// Bounding spheres of the unit cube (the model is scaled to it) and the 4x4 plane
+		streamer->Request(targets.streamedTexture, TextureStreamer::GetScreenSize(view, proj, scene->GetCubePosition(), 0.87f, targets.viewportHeight));
+		streamer->Request(targets.streamedTexture, TextureStreamer::GetScreenSize(view, proj, scene->GetPlanePosition(), 2.83f, targets.viewportHeight));
+		streamer->Update();
+		scene->SetTextureMinLod((float)streamer->GetResidentMip(targets.streamedTexture));
+	}
+
+	// copy the scene constants to this frame's slice of the constant buffer
+	constantBytes = scene->WriteConstants(targets.constantBuffer + frameSlot * targets.constantBufferSliceSize, targets.constantBufferStride);
+	return variantsChanged;
+}
\ No newline at end of file
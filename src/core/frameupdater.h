@@ -0,0 +1,51 @@
+#pragma once
+
+#include "coreconst.h"
+#include "framescheduler.h"
+#include "scene.h"
+#include "texturecache.h"
+#include "texturestreamer.h"
+
+// Everything the per frame CPU update touches, filled once by the renderer. The texture cache
+// and streamer are optional, streaming is skipped without a streamed texture.
+struct FrameTargets {
+	FrameScheduler* frameScheduler = nullptr;
+	Scene* scene = nullptr;
+
+	// Textures
+	TextureCache* textureCache = nullptr;
+	TextureStreamer* textureStreamer = nullptr;
+	UINT32 streamedTexture = STREAMED_TEXTURE_INVALID;
+	float viewportHeight = 0.0f;
+
+	// Constant Buffer, one slice per frame in flight
+	UINT8* constantBuffer = nullptr;
+	UINT constantBufferSliceSize = 0;
+	UINT constantBufferStride = 0;
+};
+
+class FrameUpdater {
+public:
+	// Takes the scene's current variant masks as the bound ones
+	void SetTargets(const FrameTargets& frameTargets);
+
+	// The CPU side of one frame before recording: waits until the next frame slot has retired,
+	// steps the scene, uploads finished texture loads, streams the levels the draws need and
+	// copies the constants to the slot's slice. True if the scene's options now select other
+	// shader variants, the caller then rebinds its pipelines for the new masks.
+	bool Update(float dt);
+
+	int GetFrameSlot() { return frameSlot; }
+	UINT32 GetLightingMask() { return litMask; }
+	UINT32 GetPostMask() { return postMask; }
+	// Bytes the last Update copied to the constant buffer
+	size_t GetConstantBytes() { return constantBytes; }
+
+private:
+	FrameTargets targets;
+	int frameSlot = 0;
+	size_t constantBytes = 0;
+	// Masks of the variants currently bound
+	UINT32 litMask = 0;
+	UINT32 postMask = 0;
+};
\ No newline at end of file
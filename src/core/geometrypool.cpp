@@ -0,0 +1,110 @@
+#include "geometrypool.h"
+
+bool GeometryPool::Init(ResourceManager* resourceManager, UINT vertexCapacity, UINT indexCapacity, UINT wideIndexCapacity, VERTEX_LAYOUT layout)
+{
+	this->resourceManager = resourceManager;
+	this->layout = layout;
+	this->vertexCapacity = vertexCapacity;
+	vertexCount = meshCount = 0;
+
+	// Create Shared Vertex Buffer
+	if (!resourceManager->GetGpuAllocator()->CreateBuffer((UINT64)vertexCapacity * GetVertexStride(), D3D12_RESOURCE_STATE_COMMON, L"Geometry Pool Vertex Buffer", &vertexBuffer)) {
+		return false;
+	}
+
+	// Create VBV
+	vertexBufferView.BufferLocation = vertexBuffer.GetGPUVirtualAddress();
+	vertexBufferView.StrideInBytes = GetVertexStride();
+	vertexBufferView.SizeInBytes = vertexCapacity * GetVertexStride();
+
+	// Create Shared 16-bit & 32-bit Index Buffers
+	return CreateIndexBuffer(DXGI_FORMAT_R16_UINT, indexCapacity, L"Geometry Pool 16-bit Index Buffer") &&
+		CreateIndexBuffer(DXGI_FORMAT_R32_UINT, wideIndexCapacity, L"Geometry Pool 32-bit Index Buffer");
+}
+
+bool GeometryPool::CreateIndexBuffer(DXGI_FORMAT format, UINT capacity, LPCWSTR name)
+{
+	IndexBuffer& indexBuffer = indexBuffers[IndexSlot(format)];
+	indexBuffer.capacity = capacity;
+	indexBuffer.count = 0;
+
+	// Buffers can't be empty, keep one 64KB block even when the format is unused
+	UINT64 size = (UINT64)capacity * IndexSizeOf(format);
+	if (!resourceManager->GetGpuAllocator()->CreateBuffer(size > 0 ? size : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT, D3D12_RESOURCE_STATE_COMMON, name, &indexBuffer.allocation)) {
+		return false;
+	}
+
+	// Create Index Buffer View
+	indexBuffer.view.BufferLocation = indexBuffer.allocation.GetGPUVirtualAddress();
+	indexBuffer.view.Format = format;
+	indexBuffer.view.SizeInBytes = (UINT)size;
+	return true;
+}
+
+void GeometryPool::UnInit()
+{
+	resourceManager->FreeResource(&vertexBuffer);
+	for (IndexBuffer& indexBuffer : indexBuffers) {
+		resourceManager->FreeResource(&indexBuffer.allocation);
+	}
+}
+
+bool GeometryPool::Reserve(UINT vertexCount, UINT indexCount, MeshHandle* mesh)
+{
+	DXGI_FORMAT format = IndexFormatFor(vertexCount);
+	IndexBuffer& indexBuffer = indexBuffers[IndexSlot(format)];
+	if (this->vertexCount + vertexCount > vertexCapacity || indexBuffer.count + indexCount > indexBuffer.capacity) {
+		return false;
+	}
+
+	mesh->baseVertex = this->vertexCount;
+	mesh->firstIndex = indexBuffer.count;
+	mesh->indexCount = indexCount;
+	mesh->vertexCount = vertexCount;
+	mesh->indexFormat = format;
+
+	this->vertexCount += vertexCount;
+	indexBuffer.count += indexCount;
+	meshCount++;
+	return true;
+}
+
+bool GeometryPool::Release(MeshHandle* mesh)
+{
+	IndexBuffer& indexBuffer = indexBuffers[IndexSlot(mesh->indexFormat)];
+	if (mesh->baseVertex + mesh->vertexCount != vertexCount || mesh->firstIndex + mesh->indexCount != indexBuffer.count) {
+		return false;
+	}
+
+	vertexCount -= mesh->vertexCount;
+	indexBuffer.count -= mesh->indexCount;
+	meshCount--;
+	*mesh = MeshHandle();
+	return true;
+}
+
+bool GeometryPool::AddMesh(ID3D12GraphicsCommandList* commandList, std::span<const Vertex> vertices, std::span<const UINT32> indices, MeshHandle* mesh)
+{
+	if (!Reserve((UINT)vertices.size(), (UINT)indices.size(), mesh)) {
+		return false;
+	}
+
+	// Indices stay relative to the mesh, the draw adds baseVertex
+	if (!resourceManager->UploadVertexBuffer(commandList, vertexBuffer, vertices, layout, (UINT64)mesh->baseVertex * GetVertexStride()) ||
+		!resourceManager->UploadIndexBuffer(commandList, GetIndexBuffer(mesh->indexFormat), indices, mesh->indexFormat, (UINT64)mesh->firstIndex * IndexSizeOf(mesh->indexFormat)))
+	{
+		Release(mesh);
+		return false;
+	}
+	return true;
+}
+
+UINT64 GeometryPool::GetIndexBytes()
+{
+	return (UINT64)indexBuffers[0].count * sizeof(UINT16) + (UINT64)indexBuffers[1].count * sizeof(UINT32);
+}
+
+UINT64 GeometryPool::GetWideIndexBytes()
+{
+	return ((UINT64)indexBuffers[0].count + indexBuffers[1].count) * sizeof(UINT32);
+}
\ No newline at end of file
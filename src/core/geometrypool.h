@@ -0,0 +1,74 @@
+#pragma once
+
+#include "coreconst.h"
+#include "resourcemanager.h"
+
+#define GEOMETRY_POOL_VERTEX_CAPACITY (256 * 1024)
+#define GEOMETRY_POOL_INDEX_CAPACITY (1024 * 1024)
+#define GEOMETRY_POOL_WIDE_INDEX_CAPACITY (256 * 1024)
+
+// Where a mesh lives inside the pool's shared buffers, firstIndex counts in indexFormat sized
+// indices inside the index buffer of that format
+struct MeshHandle {
+	UINT baseVertex = 0;
+	UINT firstIndex = 0;
+	UINT indexCount = 0;
+	UINT vertexCount = 0;
+	DXGI_FORMAT indexFormat = DXGI_FORMAT_R32_UINT;
+};
+
+// One vertex buffer that every mesh is appended into, plus a 16-bit and a 32-bit index buffer.
+// Indices are relative to the mesh, so any mesh under 65536 vertices goes in the 16-bit buffer
+// regardless of where it lands in the vertex buffer. Vertices are encoded into the pool's
+// layout as they are staged, callers always hand in full Vertex data. A frame binds the vertex buffer once and
+// switches index buffers only when the format changes between draws.
+// All buffers stay in COMMON and rely on implicit promotion, so appends need no barriers
+// but must be submitted before the draws that use them.
+class GeometryPool {
+public:
+	bool Init(ResourceManager* resourceManager, UINT vertexCapacity = GEOMETRY_POOL_VERTEX_CAPACITY, UINT indexCapacity = GEOMETRY_POOL_INDEX_CAPACITY, UINT wideIndexCapacity = GEOMETRY_POOL_WIDE_INDEX_CAPACITY, VERTEX_LAYOUT layout = DEFAULT_VERTEX_LAYOUT);
+	void UnInit();
+
+	// Hands out the vertex and index range for a mesh the caller uploads itself
+	bool Reserve(UINT vertexCount, UINT indexCount, MeshHandle* mesh);
+	// Gives back a reservation whose upload failed and clears the handle. The pool only appends,
+	// so only the newest reservation can be given back, false for any other.
+	bool Release(MeshHandle* mesh);
+	// Records the copies for the mesh, returns false when the pool is full
+	bool AddMesh(ID3D12GraphicsCommandList* commandList, std::span<const Vertex> vertices, std::span<const UINT32> indices, MeshHandle* mesh);
+
+	const D3D12_VERTEX_BUFFER_VIEW& GetVertexBufferView() { return vertexBufferView; }
+	const D3D12_INDEX_BUFFER_VIEW& GetIndexBufferView(DXGI_FORMAT format) { return indexBuffers[IndexSlot(format)].view; }
+	const GpuAllocation& GetVertexBuffer() { return vertexBuffer; }
+	const GpuAllocation& GetIndexBuffer(DXGI_FORMAT format) { return indexBuffers[IndexSlot(format)].allocation; }
+	VERTEX_LAYOUT GetVertexLayout() { return layout; }
+	UINT GetVertexStride() { return GetVertexFormat(layout).stride; }
+	UINT GetMeshCount() { return meshCount; }
+	UINT GetVertexCount() { return vertexCount; }
+	UINT GetIndexCount(DXGI_FORMAT format) { return indexBuffers[IndexSlot(format)].count; }
+	// Bytes of index data appended so far, and what it would take with only 32-bit indices
+	UINT64 GetIndexBytes();
+	UINT64 GetWideIndexBytes();
+
+private:
+	struct IndexBuffer {
+		GpuAllocation allocation;
+		D3D12_INDEX_BUFFER_VIEW view = {};
+		UINT capacity = 0;
+		UINT count = 0;
+	};
+
+	static int IndexSlot(DXGI_FORMAT format) { return format == DXGI_FORMAT_R16_UINT ? 0 : 1; }
+	bool CreateIndexBuffer(DXGI_FORMAT format, UINT capacity, LPCWSTR name);
+
+	ResourceManager* resourceManager = nullptr;
+	VERTEX_LAYOUT layout = VL_FULL;
+
+	GpuAllocation vertexBuffer;
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
+	IndexBuffer indexBuffers[2];
+
+	UINT vertexCapacity = 0;
+	UINT vertexCount = 0;
+	UINT meshCount = 0;
+};
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "gpuallocator.h"
+
+bool GpuAllocator::Init(ID3D12Device* device, UINT64 heapBlockSize)
+{
+	this->device = device;
+	this->heapBlockSize = heapBlockSize;
+	return true;
+}
+
+void GpuAllocator::UnInit()
+{
+	for (SmallBufferPage& page : smallBufferPages) {
+		SAFE_RELEASE(page.backing.resource);
+	}
+	smallBufferPages.clear();
+
+	for (int pool = 0; pool < GPU_POOL_COUNT; pool++) {
+		for (HeapBlock& block : heapBlocks[pool]) {
+			SAFE_RELEASE(block.heap);
+		}
+		heapBlocks[pool].clear();
+	}
+}
+
+bool GpuAllocator::CreateBuffer(UINT64 size, D3D12_RESOURCE_STATES initialState, LPCWSTR name, GpuAllocation* allocation)
+{
+	CD3DX12_RESOURCE_DESC resoDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+	return PlaceResource(GPU_POOL_BUFFERS, resoDesc, initialState, name, allocation);
+}
+
+bool GpuAllocator::CreateTexture(const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES initialState, LPCWSTR name, GpuAllocation* allocation)
+{
+	return PlaceResource(GPU_POOL_TEXTURES, desc, initialState, name, allocation);
+}
+
+bool GpuAllocator::AllocateSmallBuffer(UINT64 size, GpuAllocation* allocation)
+{
+	if (size == 0 || size > SMALL_BUFFER_PAGE_SIZE) {
+		return false;
+	}
+
+	// Find a page with room, or start a new one
+	UINT64 offset = 0;
+	int page = -1;
+	for (int i = 0; i < (int)smallBufferPages.size(); i++) {
+		if (smallBufferPages[i].buddy.Allocate(size, &offset)) {
+			page = i;
+			break;
+		}
+	}
+	if (page < 0) {
+		SmallBufferPage newPage;
+		if (!CreateBuffer(SMALL_BUFFER_PAGE_SIZE, D3D12_RESOURCE_STATE_COMMON, L"Small Buffer Page", &newPage.backing)) {
+			return false;
+		}
+		newPage.buddy.Init(SMALL_BUFFER_PAGE_SIZE, SMALL_BUFFER_ALIGNMENT);
+		newPage.buddy.Allocate(size, &offset);
+		smallBufferPages.push_back(newPage);
+		page = (int)smallBufferPages.size() - 1;
+	}
+
+	*allocation = {};
+	allocation->resource = smallBufferPages[page].backing.resource;
+	allocation->offset = offset;
+	allocation->size = size;
+	allocation->shared = true;
+	allocation->pool = GPU_POOL_BUFFERS;
+	allocation->block = page;
+
+	smallBuffers++;
+	smallBufferBytes += size;
+	return true;
+}
+
+void GpuAllocator::Free(GpuAllocation* allocation)
+{
+	if (!allocation->resource) {
+		return;
+	}
+
+	if (allocation->shared) {
+		smallBufferPages[allocation->block].buddy.Free(allocation->offset, allocation->size);
+		smallBuffers--;
+		smallBufferBytes -= allocation->size;
+	}
+	else if (allocation->block < 0) {
+		allocation->resource->Release();
+		committedResources--;
+	}
+	else {
+		allocation->resource->Release();
+		heapBlocks[allocation->pool][allocation->block].buddy.Free(allocation->blockOffset, allocation->blockSize);
+		placedResources--;
+	}
+
+	*allocation = {};
+}
+
+bool GpuAllocator::PlaceResource(GpuPool pool, const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES initialState, LPCWSTR name, GpuAllocation* allocation)
+{
+	HRESULT result;
+
+	*allocation = {};
+	allocation->pool = pool;
+
+	D3D12_RESOURCE_ALLOCATION_INFO info = device->GetResourceAllocationInfo(0, 1, &desc);
+
+	if (info.SizeInBytes > heapBlockSize || info.Alignment > heapBlockSize) {
+		// Too big for a block, give it its own committed allocation
+		CD3DX12_HEAP_PROPERTIES dHeapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		result = device->CreateCommittedResource(&dHeapProp, D3D12_HEAP_FLAG_NONE, &desc, initialState, nullptr, IID_PPV_ARGS(&allocation->resource));
+		if (FAILED(result)) {
+			return false;
+		}
+		allocation->size = info.SizeInBytes;
+		committedResources++;
+	}
+	else {
+		// Buddy blocks are aligned to their size, so ask for at least the alignment
+		UINT64 request = info.SizeInBytes > info.Alignment ? info.SizeInBytes : info.Alignment;
+		UINT64 offset = 0;
+		int block = -1;
+		for (int i = 0; i < (int)heapBlocks[pool].size(); i++) {
+			if (heapBlocks[pool][i].buddy.Allocate(request, &offset)) {
+				block = i;
+				break;
+			}
+		}
+		if (block < 0) {
+			if (!CreateHeapBlock(pool) || !heapBlocks[pool].back().buddy.Allocate(request, &offset)) {
+				return false;
+			}
+			block = (int)heapBlocks[pool].size() - 1;
+		}
+
+		result = device->CreatePlacedResource(heapBlocks[pool][block].heap, offset, &desc, initialState, nullptr, IID_PPV_ARGS(&allocation->resource));
+		if (FAILED(result)) {
+			heapBlocks[pool][block].buddy.Free(offset, request);
+			return false;
+		}
+		allocation->size = info.SizeInBytes;
+		allocation->block = block;
+		allocation->blockOffset = offset;
+		allocation->blockSize = request;
+		placedResources++;
+	}
+
+	allocation->resource->SetName(name);
+	return true;
+}
+
+bool GpuAllocator::CreateHeapBlock(GpuPool pool)
+{
+	HRESULT result;
+
+	D3D12_HEAP_DESC heapDesc = {};
+	heapDesc.SizeInBytes = heapBlockSize;
+	heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	heapDesc.Flags = pool == GPU_POOL_BUFFERS ? D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS : D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+
+	HeapBlock block;
+	result = device->CreateHeap(&heapDesc, IID_PPV_ARGS(&block.heap));
+	if (FAILED(result)) {
+		return false;
+	}
+	block.heap->SetName(pool == GPU_POOL_BUFFERS ? L"Buffer Heap Block" : L"Texture Heap Block");
+	block.buddy.Init(heapBlockSize, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+	heapBlocks[pool].push_back(block);
+	return true;
+}
+
+GpuAllocatorStats GpuAllocator::GetStats()
+{
+	GpuAllocatorStats stats;
+	UINT64 freeBytes = 0;
+	UINT64 largestFreeBytes = 0;
+
+	for (int pool = 0; pool < GPU_POOL_COUNT; pool++) {
+		for (HeapBlock& block : heapBlocks[pool]) {
+			stats.heapCount++;
+			stats.heapBytes += block.buddy.GetCapacity();
+			stats.usedBytes += block.buddy.GetUsed();
+			stats.freeBlockCount += block.buddy.GetFreeBlockCount();
+			freeBytes += block.buddy.GetCapacity() - block.buddy.GetUsed();
+
+			UINT64 largest = block.buddy.GetLargestFreeBlock();
+			largestFreeBytes += largest;
+			stats.largestFreeBlock = largest > stats.largestFreeBlock ? largest : stats.largestFreeBlock;
+		}
+	}
+
+	stats.placedResources = placedResources;
+	stats.committedResources = committedResources;
+	stats.smallBufferPages = smallBufferPages.size();
+	stats.smallBuffers = smallBuffers;
+	stats.smallBufferBytes = smallBufferBytes;
+	stats.fragmentation = freeBytes > 0 ? 1.0f - (float)largestFreeBytes / (float)freeBytes : 0.0f;
+
+	return stats;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "coreconst.h"
+#include "buddyallocator.h"
+
+#define GPU_HEAP_BLOCK_SIZE (16 * 1024 * 1024)
+#define SMALL_BUFFER_PAGE_SIZE (1024 * 1024)
+#define SMALL_BUFFER_ALIGNMENT 256
+
+// Resource heap tier 1 cannot mix buffers and textures in one heap
+enum GpuPool {
+	GPU_POOL_BUFFERS,
+	GPU_POOL_TEXTURES,
+	GPU_POOL_COUNT
+};
+
+struct GpuAllocation {
+	ID3D12Resource* resource = nullptr;
+	UINT64 offset = 0; // Only non zero for small buffers sharing a page
+	UINT64 size = 0;
+	bool shared = false;
+
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const { return resource->GetGPUVirtualAddress() + offset; }
+
+	// Where the memory came from, block -1 is a committed fallback
+	int pool = -1;
+	int block = -1;
+	UINT64 blockOffset = 0;
+	UINT64 blockSize = 0;
+};
+
+struct GpuAllocatorStats {
+	UINT64 heapCount = 0;
+	UINT64 heapBytes = 0;
+	UINT64 usedBytes = 0;
+	UINT64 placedResources = 0;
+	UINT64 committedResources = 0;
+	UINT64 smallBufferPages = 0;
+	UINT64 smallBuffers = 0;
+	UINT64 smallBufferBytes = 0;
+	UINT64 largestFreeBlock = 0;
+	UINT64 freeBlockCount = 0;
+	// 0 when each heap's free memory is one block, approaching 1 as it splinters
+	float fragmentation = 0.0f;
+};
+
+// Places default heap resources into large ID3D12Heap blocks carved up by buddy allocators,
+// and packs buffers smaller than the 64KB placement alignment into shared buffer pages.
+class GpuAllocator {
+public:
+	bool Init(ID3D12Device* device, UINT64 heapBlockSize = GPU_HEAP_BLOCK_SIZE);
+	void UnInit();
+
+	bool CreateBuffer(UINT64 size, D3D12_RESOURCE_STATES initialState, LPCWSTR name, GpuAllocation* allocation);
+	bool CreateTexture(const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES initialState, LPCWSTR name, GpuAllocation* allocation);
+	// Sub-range of a shared buffer kept in COMMON, relying on implicit state promotion and decay
+	bool AllocateSmallBuffer(UINT64 size, GpuAllocation* allocation);
+	// The GPU must be done with the allocation
+	void Free(GpuAllocation* allocation);
+
+	GpuAllocatorStats GetStats();
+
+private:
+	struct HeapBlock {
+		ID3D12Heap* heap;
+		BuddyAllocator buddy;
+	};
+
+	struct SmallBufferPage {
+		GpuAllocation backing;
+		BuddyAllocator buddy;
+	};
+
+	bool PlaceResource(GpuPool pool, const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES initialState, LPCWSTR name, GpuAllocation* allocation);
+	bool CreateHeapBlock(GpuPool pool);
+
+	ID3D12Device* device = nullptr;
+	UINT64 heapBlockSize = 0;
+	std::vector<HeapBlock> heapBlocks[GPU_POOL_COUNT];
+	std::vector<SmallBufferPage> smallBufferPages;
+
+	UINT64 placedResources = 0;
+	UINT64 committedResources = 0;
+	UINT64 smallBuffers = 0;
+	UINT64 smallBufferBytes = 0;
+};
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "gputimeline.h"
+
+#include <algorithm>
+
+bool GpuTimeline::Init(ID3D12Device* device, ID3D12CommandQueue* queue)
+{
+	HRESULT result;
+
+	commandQueue = queue;
+
+	// Create Fence & Fence Event Handle
+	result = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
+	if (FAILED(result)) {
+		return false;
+	}
+	lastSubmitted = 0;
+	lastCompleted = 0;
+
+#ifdef _WIN32
+	fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	if (fenceEvent == nullptr) {
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+void GpuTimeline::UnInit()
+{
+	if (fence) {
+		WaitForIdle();
+		ReleaseCompleted();
+	}
+	SAFE_RELEASE(fence);
+
+#ifdef _WIN32
+	if (fenceEvent) {
+		CloseHandle(fenceEvent);
+		fenceEvent = nullptr;
+	}
+#endif
+}
+
+UINT64 GpuTimeline::Submit()
+{
+	lastSubmitted++;
+	commandQueue->Signal(fence, lastSubmitted);
+	return lastSubmitted;
+}
+
+UINT64 GpuTimeline::GetCompletedValue()
+{
+	lastCompleted = fence->GetCompletedValue();
+	return lastCompleted;
+}
+
+bool GpuTimeline::IsComplete(UINT64 ticket)
+{
+	// Only touch the fence when the cached value is not enough
+	if (ticket <= lastCompleted) {
+		return true;
+	}
+	return ticket <= GetCompletedValue();
+}
+
+void GpuTimeline::WaitFor(UINT64 ticket)
+{
+	if (IsComplete(ticket)) {
+		return;
+	}
+
+#ifdef _WIN32
+	// Reuse the one event for every wait
+	if (SUCCEEDED(fence->SetEventOnCompletion(ticket, fenceEvent))) {
+		WaitForSingleObject(fenceEvent, INFINITE);
+	}
+#else
+	// Without an event the call blocks until the fence reaches the value
+	fence->SetEventOnCompletion(ticket, nullptr);
+#endif
+
+	GetCompletedValue();
+}
+
+void GpuTimeline::QueueWait(ID3D12CommandQueue* queue, UINT64 ticket)
+{
+	// Nothing to order against once the CPU has seen the ticket complete
+	if (IsComplete(ticket)) {
+		return;
+	}
+	queue->Wait(fence, ticket);
+}
+
+void GpuTimeline::ReleaseAfter(IUnknown* object, UINT64 ticket)
+{
+	if (!object) {
+		return;
+	}
+	if (IsComplete(ticket)) {
+		object->Release();
+		return;
+	}
+	// Kept in ticket order, an older ticket may be passed in after a newer one
+	auto position = std::upper_bound(pendingReleases.begin(), pendingReleases.end(), ticket,
+		[](UINT64 value, const PendingRelease& release) { return value < release.ticket; });
+	pendingReleases.insert(position, { object, ticket });
+}
+
+void GpuTimeline::ReleaseCompleted()
+{
+	// Tickets complete in order, so stop at the first one still in flight
+	while (!pendingReleases.empty() && IsComplete(pendingReleases.front().ticket)) {
+		pendingReleases.front().object->Release();
+		pendingReleases.pop_front();
+	}
+}
\ No newline at end of file
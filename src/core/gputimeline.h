@@ -0,0 +1,45 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <deque>
+
+// One fence on a queue, signaled with a 64-bit counter. Every Submit() hands out a
+// ticket (the fence value it signaled) that can be polled or waited on, and objects
+// the GPU may still be reading are released once their ticket has completed.
+class GpuTimeline {
+public:
+	bool Init(ID3D12Device* device, ID3D12CommandQueue* queue);
+	void UnInit();
+
+	// Signals the queue, everything executed before this call completes with the ticket
+	UINT64 Submit();
+	bool IsComplete(UINT64 ticket);
+	void WaitFor(UINT64 ticket);
+	void WaitForIdle() { WaitFor(lastSubmitted); }
+	// GPU side wait, work submitted to the other queue afterwards starts once the ticket completes
+	void QueueWait(ID3D12CommandQueue* queue, UINT64 ticket);
+
+	// Deferred release, keyed by the ticket of the last submission that uses the object, in any order
+	void ReleaseAfter(IUnknown* object, UINT64 ticket);
+	void ReleaseCompleted();
+
+	ID3D12CommandQueue* GetCommandQueue() { return commandQueue; }
+	UINT64 GetLastSubmitted() { return lastSubmitted; }
+	UINT64 GetCompletedValue();
+	size_t GetPendingReleaseCount() { return pendingReleases.size(); }
+
+private:
+	struct PendingRelease {
+		IUnknown* object;
+		UINT64 ticket;
+	};
+
+	ID3D12CommandQueue* commandQueue = nullptr;
+	ID3D12Fence* fence = nullptr;
+	HANDLE fenceEvent = nullptr;
+	UINT64 lastSubmitted = 0;
+	UINT64 lastCompleted = 0;
+
+	std::deque<PendingRelease> pendingReleases;
+};
\ No newline at end of file
@@ -0,0 +1,849 @@
+#include "imagedecoder.h"
+#include "colorconvert.h"
+#include "inflate.h"
+
+#include <algorithm>
+#include <fstream>
+
+static const UINT8 pngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+static UINT32 ReadBigEndian32(const UINT8* p) { return ((UINT32)p[0] << 24) | ((UINT32)p[1] << 16) | ((UINT32)p[2] << 8) | p[3]; }
+static UINT16 ReadBigEndian16(const UINT8* p) { return (UINT16)((p[0] << 8) | p[1]); }
+
+static bool IsPng(std::span<const UINT8> data) { return data.size() >= 33 && memcmp(data.data(), pngSignature, sizeof(pngSignature)) == 0; }
+static bool IsJpeg(std::span<const UINT8> data) { return data.size() >= 4 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF; }
+
+// Frame markers other than DHT (C4), JPG (C8) and DAC (CC)
+static bool IsJpegFrameMarker(UINT8 marker) { return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC; }
+static bool IsJpegRestartMarker(UINT8 marker) { return marker >= 0xD0 && marker <= 0xD7; }
+
+bool ImageDecoder::ReadInfo(std::span<const UINT8> data, ImageInfo* info)
+{
+	if (IsPng(data))
+	{
+		// IHDR is always the first chunk
+		if (memcmp(data.data() + 12, "IHDR", 4) != 0) {
+			return false;
+		}
+		info->width = ReadBigEndian32(data.data() + 16);
+		info->height = ReadBigEndian32(data.data() + 20);
+		return info->width > 0 && info->height > 0;
+	}
+
+	if (IsJpeg(data))
+	{
+		// Walk the marker segments up to the frame header
+		size_t pos = 2;
+		while (pos + 4 <= data.size() && data[pos] == 0xFF)
+		{
+			UINT8 marker = data[pos + 1];
+			if (marker == 0xFF) {
+				pos++;
+				continue;
+			}
+			UINT length = ReadBigEndian16(data.data() + pos + 2);
+			if (IsJpegFrameMarker(marker)) {
+				if (length < 7 || pos + 4 + length > data.size()) {
+					return false;
+				}
+				info->height = ReadBigEndian16(data.data() + pos + 5);
+				info->width = ReadBigEndian16(data.data() + pos + 7);
+				return info->width > 0 && info->height > 0;
+			}
+			pos += 2 + length;
+		}
+	}
+	return false;
+}
+
+bool ImageDecoder::Decode(std::span<const UINT8> data, DXGI_FORMAT format, UINT8* dst, UINT64 rowPitch)
+{
+	ImageInfo info;
+	if (!IsSupportedFormat(format) || !ReadInfo(data, &info) || rowPitch < (UINT64)info.width * 4) {
+		return false;
+	}
+	bool bgra = format == DXGI_FORMAT_B8G8R8A8_UNORM;
+	return IsPng(data) ? DecodePng(data, bgra, dst, rowPitch) : DecodeJpeg(data, bgra, dst, rowPitch);
+}
+
+bool ImageDecoder::Load(const std::filesystem::path& path, DXGI_FORMAT format, ImageData* image)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	fileData.resize((size_t)file.tellg());
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char*>(fileData.data()), fileData.size())) {
+		return false;
+	}
+
+	ImageInfo info;
+	if (!ReadInfo(fileData, &info)) {
+		return false;
+	}
+	image->width = info.width;
+	image->height = info.height;
+	image->format = format;
+	image->pixels.resize((size_t)info.width * info.height * 4);
+	return Decode(fileData, format, image->pixels.data(), (UINT64)info.width * 4);
+}
+
+// PNG
+
+// Adam7 pass origins and steps, a non-interlaced image is the single full pass
+struct PngPass {
+	UINT x0, y0, dx, dy;
+};
+static const PngPass adam7Passes[7] = { {0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2} };
+static const PngPass fullPass = { 0, 0, 1, 1 };
+
+struct PngHeader {
+	UINT width = 0;
+	UINT height = 0;
+	UINT bitDepth = 0;
+	UINT colorType = 0;
+	UINT interlace = 0;
+	UINT channels = 0;
+	// RGBA entries, tRNS fills in alpha
+	UINT8 palette[256][4] = {};
+	UINT paletteSize = 0;
+	// tRNS colour key for gray and RGB images, compared at the stored bit depth
+	bool hasKey = false;
+	UINT16 key[3] = {};
+
+	size_t RowBytes(UINT width) const { return ((size_t)width * channels * bitDepth + 7) / 8; }
+	size_t PixelBytes() const { return std::max<size_t>(1, channels * bitDepth / 8); }
+};
+
+static UINT ReadPngSample(const UINT8* line, size_t index, UINT bitDepth)
+{
+	if (bitDepth == 16) return ReadBigEndian16(line + index * 2);
+	if (bitDepth == 8) return line[index];
+	size_t bit = index * bitDepth;
+	return (line[bit >> 3] >> (8 - bitDepth - (bit & 7))) & ((1u << bitDepth) - 1);
+}
+
+static UINT8 ScalePngSample(UINT sample, UINT bitDepth)
+{
+	if (bitDepth == 16) return (UINT8)(sample >> 8);
+	if (bitDepth == 8) return (UINT8)sample;
+	return (UINT8)(sample * 255 / ((1u << bitDepth) - 1));
+}
+
+static int PaethPredictor(int a, int b, int c)
+{
+	int p = a + b - c;
+	int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+	if (pa <= pb && pa <= pc) return a;
+	return pb <= pc ? b : c;
+}
+
+// Reverses the row filter in place, prev is the previous unfiltered row of the pass or null
+static bool UnfilterPngRow(UINT8 filter, UINT8* line, const UINT8* prev, size_t rowBytes, size_t pixelBytes)
+{
+	switch (filter) {
+	case 0:
+		return true;
+	case 1:
+		for (size_t i = pixelBytes; i < rowBytes; i++) {
+			line[i] = (UINT8)(line[i] + line[i - pixelBytes]);
+		}
+		return true;
+	case 2:
+		for (size_t i = 0; prev && i < rowBytes; i++) {
+			line[i] = (UINT8)(line[i] + prev[i]);
+		}
+		return true;
+	case 3:
+		for (size_t i = 0; i < rowBytes; i++) {
+			int left = i >= pixelBytes ? line[i - pixelBytes] : 0;
+			int up = prev ? prev[i] : 0;
+			line[i] = (UINT8)(line[i] + ((left + up) >> 1));
+		}
+		return true;
+	case 4:
+		for (size_t i = 0; i < rowBytes; i++) {
+			int left = i >= pixelBytes ? line[i - pixelBytes] : 0;
+			int up = prev ? prev[i] : 0;
+			int upLeft = prev && i >= pixelBytes ? prev[i - pixelBytes] : 0;
+			line[i] = (UINT8)(line[i] + PaethPredictor(left, up, upLeft));
+		}
+		return true;
+	}
+	return false;
+}
+
+static void ExpandPngRow(const PngHeader& header, const UINT8* line, UINT width, bool bgra, UINT8* out)
+{
+	// 8-bit layouts without a colour key convert a whole row at once
+	if (header.bitDepth == 8 && !header.hasKey)
+	{
+		if (header.colorType == 6) {
+			if (bgra) SwizzleRgba(line, out, width);
+			else memcpy(out, line, (size_t)width * 4);
+			return;
+		}
+		if (header.colorType == 2) {
+			ConvertRgbToRgba(line, out, width, bgra);
+			return;
+		}
+		if (header.colorType == 0) {
+			ConvertGrayToRgba(line, out, width);
+			return;
+		}
+	}
+
+	int red = bgra ? 2 : 0;
+	for (UINT x = 0; x < width; x++, out += 4)
+	{
+		UINT8 r, g, b, a = 255;
+		if (header.colorType == 3)
+		{
+			const UINT8* entry = header.palette[ReadPngSample(line, x, header.bitDepth)];
+			r = entry[0]; g = entry[1]; b = entry[2]; a = entry[3];
+		}
+		else if (header.colorType == 0 || header.colorType == 4)
+		{
+			UINT gray = ReadPngSample(line, (size_t)x * header.channels, header.bitDepth);
+			r = g = b = ScalePngSample(gray, header.bitDepth);
+			if (header.colorType == 4) a = ScalePngSample(ReadPngSample(line, (size_t)x * 2 + 1, header.bitDepth), header.bitDepth);
+			if (header.hasKey && gray == header.key[0]) a = 0;
+		}
+		else
+		{
+			UINT samples[4] = {};
+			for (UINT c = 0; c < header.channels; c++) {
+				samples[c] = ReadPngSample(line, (size_t)x * header.channels + c, header.bitDepth);
+			}
+			r = ScalePngSample(samples[0], header.bitDepth);
+			g = ScalePngSample(samples[1], header.bitDepth);
+			b = ScalePngSample(samples[2], header.bitDepth);
+			if (header.colorType == 6) a = ScalePngSample(samples[3], header.bitDepth);
+			if (header.hasKey && samples[0] == header.key[0] && samples[1] == header.key[1] && samples[2] == header.key[2]) a = 0;
+		}
+		out[red] = r;
+		out[1] = g;
+		out[2 - red] = b;
+		out[3] = a;
+	}
+}
+
+bool ImageDecoder::DecodePng(std::span<const UINT8> data, bool bgra, UINT8* dst, UINT64 rowPitch)
+{
+	// Walk The Chunks
+	PngHeader header;
+	for (UINT i = 0; i < 256; i++) {
+		header.palette[i][3] = 255;
+	}
+	compressed.clear();
+	bool ended = false;
+	size_t pos = sizeof(pngSignature);
+	while (!ended && pos + 12 <= data.size())
+	{
+		UINT32 length = ReadBigEndian32(data.data() + pos);
+		const UINT8* type = data.data() + pos + 4;
+		const UINT8* body = data.data() + pos + 8;
+		if (length > data.size() - pos - 12) {
+			return false;
+		}
+
+		if (memcmp(type, "IHDR", 4) == 0) {
+			if (length < 13 || body[10] != 0 || body[11] != 0 || body[12] > 1) {
+				return false;
+			}
+			header.width = ReadBigEndian32(body);
+			header.height = ReadBigEndian32(body + 4);
+			header.bitDepth = body[8];
+			header.colorType = body[9];
+			header.interlace = body[12];
+		}
+		else if (memcmp(type, "PLTE", 4) == 0) {
+			header.paletteSize = std::min<UINT>(length / 3, 256);
+			for (UINT i = 0; i < header.paletteSize; i++) {
+				memcpy(header.palette[i], body + i * 3, 3);
+			}
+		}
+		else if (memcmp(type, "tRNS", 4) == 0) {
+			if (header.colorType == 3) {
+				for (UINT i = 0; i < length && i < 256; i++) {
+					header.palette[i][3] = body[i];
+				}
+			}
+			else if (length >= 2) {
+				header.hasKey = true;
+				for (UINT c = 0; c < 3 && c * 2 + 2 <= length; c++) {
+					header.key[c] = ReadBigEndian16(body + c * 2);
+				}
+			}
+		}
+		else if (memcmp(type, "IDAT", 4) == 0) {
+			compressed.insert(compressed.end(), body, body + length);
+		}
+		else if (memcmp(type, "IEND", 4) == 0) {
+			ended = true;
+		}
+		else if (!(type[0] & 0x20)) {
+			// Unknown critical chunk
+			return false;
+		}
+		pos += 12 + (size_t)length;
+	}
+
+	// Validate Colour Type & Bit Depth
+	const UINT channelCounts[7] = { 1, 0, 3, 1, 2, 0, 4 };
+	header.channels = header.colorType < 7 ? channelCounts[header.colorType] : 0;
+	UINT depth = header.bitDepth;
+	bool depthValid = depth == 8 || depth == 16 || (depth < 8 && (depth == 1 || depth == 2 || depth == 4) && (header.colorType == 0 || header.colorType == 3));
+	if (!ended || header.channels == 0 || !depthValid || (header.colorType == 3 && (depth == 16 || header.paletteSize == 0)) || compressed.empty()) {
+		return false;
+	}
+
+	// Inflate Every Pass At Once
+	const PngPass* passes = header.interlace ? adam7Passes : &fullPass;
+	UINT passCount = header.interlace ? 7 : 1;
+	size_t filteredSize = 0;
+	for (UINT i = 0; i < passCount; i++) {
+		UINT passWidth = (header.width - passes[i].x0 + passes[i].dx - 1) / passes[i].dx;
+		UINT passHeight = (header.height - passes[i].y0 + passes[i].dy - 1) / passes[i].dy;
+		if (header.width > passes[i].x0 && header.height > passes[i].y0) {
+			filteredSize += (header.RowBytes(passWidth) + 1) * passHeight;
+		}
+	}
+	filtered.resize(filteredSize);
+	size_t written = 0;
+	if (!ZlibInflate(compressed.data(), compressed.size(), filtered.data(), filteredSize, &written) || written != filteredSize) {
+		return false;
+	}
+
+	// Unfilter & Expand To RGBA
+	rowPixels.resize((size_t)header.width * 4);
+	UINT8* row = filtered.data();
+	for (UINT i = 0; i < passCount; i++)
+	{
+		const PngPass& pass = passes[i];
+		if (header.width <= pass.x0 || header.height <= pass.y0) {
+			continue;
+		}
+		UINT passWidth = (header.width - pass.x0 + pass.dx - 1) / pass.dx;
+		UINT passHeight = (header.height - pass.y0 + pass.dy - 1) / pass.dy;
+		size_t rowBytes = header.RowBytes(passWidth);
+		const UINT8* prev = nullptr;
+		for (UINT y = 0; y < passHeight; y++, row += rowBytes + 1)
+		{
+			UINT8* line = row + 1;
+			if (!UnfilterPngRow(row[0], line, prev, rowBytes, header.PixelBytes())) {
+				return false;
+			}
+			prev = line;
+
+			if (!header.interlace) {
+				ExpandPngRow(header, line, passWidth, bgra, dst + (UINT64)y * rowPitch);
+				continue;
+			}
+			ExpandPngRow(header, line, passWidth, bgra, rowPixels.data());
+			UINT8* out = dst + (UINT64)(pass.y0 + y * pass.dy) * rowPitch;
+			for (UINT x = 0; x < passWidth; x++) {
+				memcpy(out + (size_t)(pass.x0 + x * pass.dx) * 4, rowPixels.data() + (size_t)x * 4, 4);
+			}
+		}
+	}
+	return true;
+}
+
+// JPEG
+
+static const UINT8 jpegZigZag[64] = {
+	0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5,
+	12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+	35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+	58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+};
+
+#define JPEG_FAST_BITS 9
+
+// Canonical Huffman table with a lookup for codes up to JPEG_FAST_BITS long
+struct JpegHuffman {
+	UINT8 fastLength[1 << JPEG_FAST_BITS];
+	UINT8 fastValue[1 << JPEG_FAST_BITS];
+	// Codes of each length are below maxCode, their value is values[code + valueOffset]
+	int maxCode[17];
+	int valueOffset[17];
+	UINT8 values[256];
+	bool defined = false;
+
+	bool Build(const UINT8* counts, const UINT8* symbols, UINT total)
+	{
+		memcpy(values, symbols, total);
+		memset(fastLength, 0, sizeof(fastLength));
+		int code = 0;
+		UINT k = 0;
+		for (int length = 1; length <= 16; length++)
+		{
+			valueOffset[length] = (int)k - code;
+			for (UINT i = 0; i < counts[length - 1]; i++, code++, k++) {
+				if (length <= JPEG_FAST_BITS) {
+					int first = code << (JPEG_FAST_BITS - length);
+					for (int j = 0; j < (1 << (JPEG_FAST_BITS - length)); j++) {
+						fastLength[first + j] = (UINT8)length;
+						fastValue[first + j] = values[k];
+					}
+				}
+			}
+			if (code > (1 << length)) {
+				return false;
+			}
+			maxCode[length] = code;
+			code <<= 1;
+		}
+		defined = true;
+		return true;
+	}
+};
+
+// Entropy coded data with byte stuffing removed, reads zeros once a marker is reached
+struct JpegBitReader {
+	const UINT8* data;
+	size_t size;
+	size_t pos;
+	UINT32 bits = 0;
+	int count = 0;
+	bool marker = false;
+
+	void Fill()
+	{
+		while (count <= 24) {
+			UINT32 byte = 0;
+			if (!marker && pos < size) {
+				byte = data[pos];
+				if (byte != 0xFF) {
+					pos++;
+				}
+				else if (pos + 1 < size && data[pos + 1] == 0x00) {
+					pos += 2;
+				}
+				else {
+					marker = true;
+					byte = 0;
+				}
+			}
+			bits |= byte << (24 - count);
+			count += 8;
+		}
+	}
+
+	void Skip(int n) { bits <<= n; count -= n; }
+
+	int Receive(int n)
+	{
+		if (n == 0) return 0;
+		Fill();
+		int value = (int)(bits >> (32 - n));
+		Skip(n);
+		return value;
+	}
+
+	int Decode(const JpegHuffman& table)
+	{
+		Fill();
+		UINT fast = bits >> (32 - JPEG_FAST_BITS);
+		if (table.fastLength[fast]) {
+			int value = table.fastValue[fast];
+			Skip(table.fastLength[fast]);
+			return value;
+		}
+		for (int length = JPEG_FAST_BITS + 1; length <= 16; length++) {
+			int code = (int)(bits >> (32 - length));
+			if (code < table.maxCode[length]) {
+				Skip(length);
+				return table.values[code + table.valueOffset[length]];
+			}
+		}
+		return -1;
+	}
+
+	void Restart(size_t position)
+	{
+		pos = position;
+		bits = 0;
+		count = 0;
+		marker = false;
+	}
+};
+
+static int ExtendJpegValue(int value, int bits) { return value < (1 << (bits - 1)) ? value - (1 << bits) + 1 : value; }
+
+struct JpegComponent {
+	UINT8 id;
+	UINT h, v;
+	UINT quant;
+	UINT dcTable, acTable;
+	int dcPrediction;
+	UINT planeWidth, planeHeight;
+	size_t planeOffset;
+};
+
+struct JpegFrame {
+	UINT16 quant[4][64];
+	bool quantDefined[4] = {};
+	JpegHuffman huffman[2][4];
+	JpegComponent components[3];
+	UINT componentCount = 0;
+	UINT width = 0, height = 0;
+	UINT hMax = 1, vMax = 1;
+	UINT mcusX = 0, mcusY = 0;
+	UINT restartInterval = 0;
+};
+
+// Integer inverse DCT (the accurate LL&M variant libjpeg calls islow): columns, then rows
+// with the level shift, 13 fraction bits for the constants and 2 extra between passes
+#define IDCT_CONST_BITS 13
+#define IDCT_PASS1_BITS 2
+#define IDCT_FIX(x) ((int)((x) * (1 << IDCT_CONST_BITS) + 0.5))
+
+static inline void InverseDct1D(const int* in, int stride, int* out, int outStride, int shift, int bias)
+{
+	int z2 = in[2 * stride], z3 = in[6 * stride];
+	int z1 = (z2 + z3) * IDCT_FIX(0.541196100);
+	int tmp2 = z1 + z3 * -IDCT_FIX(1.847759065);
+	int tmp3 = z1 + z2 * IDCT_FIX(0.765366865);
+	int tmp0 = (in[0] + in[4 * stride]) * (1 << IDCT_CONST_BITS);
+	int tmp1 = (in[0] - in[4 * stride]) * (1 << IDCT_CONST_BITS);
+	int tmp10 = tmp0 + tmp3, tmp13 = tmp0 - tmp3;
+	int tmp11 = tmp1 + tmp2, tmp12 = tmp1 - tmp2;
+
+	tmp0 = in[7 * stride]; tmp1 = in[5 * stride]; tmp2 = in[3 * stride]; tmp3 = in[1 * stride];
+	z1 = tmp0 + tmp3; z2 = tmp1 + tmp2; z3 = tmp0 + tmp2;
+	int z4 = tmp1 + tmp3;
+	int z5 = (z3 + z4) * IDCT_FIX(1.175875602);
+	tmp0 *= IDCT_FIX(0.298631336); tmp1 *= IDCT_FIX(2.053119869);
+	tmp2 *= IDCT_FIX(3.072711026); tmp3 *= IDCT_FIX(1.501321110);
+	z1 *= -IDCT_FIX(0.899976223); z2 *= -IDCT_FIX(2.562915447);
+	z3 = z3 * -IDCT_FIX(1.961570560) + z5; z4 = z4 * -IDCT_FIX(0.390180644) + z5;
+	tmp0 += z1 + z3; tmp1 += z2 + z4; tmp2 += z2 + z3; tmp3 += z1 + z4;
+
+	int round = (1 << (shift - 1)) + bias;
+	out[0] = (tmp10 + tmp3 + round) >> shift;
+	out[7 * outStride] = (tmp10 - tmp3 + round) >> shift;
+	out[1 * outStride] = (tmp11 + tmp2 + round) >> shift;
+	out[6 * outStride] = (tmp11 - tmp2 + round) >> shift;
+	out[2 * outStride] = (tmp12 + tmp1 + round) >> shift;
+	out[5 * outStride] = (tmp12 - tmp1 + round) >> shift;
+	out[3 * outStride] = (tmp13 + tmp0 + round) >> shift;
+	out[4 * outStride] = (tmp13 - tmp0 + round) >> shift;
+}
+
+static void InverseDct(const int* coefficients, UINT8* out, size_t stride)
+{
+	int workspace[64], rowValues[8];
+	for (int x = 0; x < 8; x++) {
+		InverseDct1D(coefficients + x, 8, workspace + x, 8, IDCT_CONST_BITS - IDCT_PASS1_BITS, 0);
+	}
+	for (int y = 0; y < 8; y++, out += stride) {
+		InverseDct1D(workspace + y * 8, 1, rowValues, 1, IDCT_CONST_BITS + IDCT_PASS1_BITS + 3, 128 << (IDCT_CONST_BITS + IDCT_PASS1_BITS + 3));
+		for (int x = 0; x < 8; x++) {
+			out[x] = (UINT8)std::clamp(rowValues[x], 0, 255);
+		}
+	}
+}
+
+static bool DecodeJpegBlock(JpegBitReader& reader, const JpegFrame& frame, JpegComponent& component, UINT8* out, size_t stride)
+{
+	int coefficients[64] = {};
+	const UINT16* quant = frame.quant[component.quant];
+
+	int size = reader.Decode(frame.huffman[0][component.dcTable]);
+	if (size < 0 || size > 11) {
+		return false;
+	}
+	component.dcPrediction += size ? ExtendJpegValue(reader.Receive(size), size) : 0;
+	coefficients[0] = component.dcPrediction * quant[0];
+
+	const JpegHuffman& ac = frame.huffman[1][component.acTable];
+	for (int k = 1; k < 64;)
+	{
+		int runSize = reader.Decode(ac);
+		if (runSize < 0) {
+			return false;
+		}
+		int run = runSize >> 4;
+		size = runSize & 15;
+		if (size == 0) {
+			// End of block, or a run of 16 zeros
+			if (run != 15) break;
+			k += 16;
+			continue;
+		}
+		k += run;
+		if (k > 63) {
+			return false;
+		}
+		coefficients[jpegZigZag[k]] = ExtendJpegValue(reader.Receive(size), size) * quant[k];
+		k++;
+	}
+
+	InverseDct(coefficients, out, stride);
+	return true;
+}
+
+// Decodes the entropy coded segment after a scan header, pos ends on the next marker
+static bool DecodeJpegScan(JpegFrame& frame, const UINT8* header, UINT headerSize, std::span<const UINT8> data, size_t* pos, UINT8* planes)
+{
+	UINT scanCount = headerSize > 0 ? header[0] : 0;
+	if (scanCount == 0 || scanCount > frame.componentCount || headerSize < 4 + 2 * scanCount) {
+		return false;
+	}
+	JpegComponent* scanComponents[3];
+	for (UINT i = 0; i < scanCount; i++)
+	{
+		UINT8 id = header[1 + i * 2];
+		UINT8 tables = header[2 + i * 2];
+		scanComponents[i] = nullptr;
+		for (UINT c = 0; c < frame.componentCount; c++) {
+			if (frame.components[c].id == id) scanComponents[i] = &frame.components[c];
+		}
+		JpegComponent* component = scanComponents[i];
+		if (!component || (tables >> 4) > 3 || (tables & 15) > 3 || !frame.quantDefined[component->quant] ||
+			!frame.huffman[0][tables >> 4].defined || !frame.huffman[1][tables & 15].defined) {
+			return false;
+		}
+		component->dcTable = tables >> 4;
+		component->acTable = tables & 15;
+		component->dcPrediction = 0;
+	}
+
+	// Sequential scans cover the whole spectrum without successive approximation
+	const UINT8* spectral = header + 1 + scanCount * 2;
+	if (spectral[0] != 0 || spectral[1] != 63 || spectral[2] != 0) {
+		return false;
+	}
+
+	// A single component scan is not interleaved, its MCU is one block
+	UINT unitsX = frame.mcusX, unitsY = frame.mcusY;
+	if (scanCount == 1) {
+		JpegComponent* component = scanComponents[0];
+		unitsX = ((frame.width * component->h + frame.hMax - 1) / frame.hMax + 7) / 8;
+		unitsY = ((frame.height * component->v + frame.vMax - 1) / frame.vMax + 7) / 8;
+	}
+
+	JpegBitReader reader = { data.data(), data.size(), *pos };
+	UINT restartsLeft = frame.restartInterval;
+	UINT nextRestart = 0;
+	for (UINT unitY = 0; unitY < unitsY; unitY++)
+	{
+		for (UINT unitX = 0; unitX < unitsX; unitX++)
+		{
+			// Restart Interval
+			if (frame.restartInterval && restartsLeft == 0)
+			{
+				size_t markerPos = reader.pos;
+				while (markerPos + 1 < data.size() && !(data[markerPos] == 0xFF && data[markerPos + 1] != 0x00 && data[markerPos + 1] != 0xFF)) {
+					markerPos++;
+				}
+				if (markerPos + 1 >= data.size() || data[markerPos + 1] != 0xD0 + nextRestart) {
+					return false;
+				}
+				nextRestart = (nextRestart + 1) & 7;
+				reader.Restart(markerPos + 2);
+				for (UINT i = 0; i < scanCount; i++) {
+					scanComponents[i]->dcPrediction = 0;
+				}
+				restartsLeft = frame.restartInterval;
+			}
+
+			for (UINT i = 0; i < scanCount; i++)
+			{
+				JpegComponent* component = scanComponents[i];
+				UINT blocksX = scanCount == 1 ? 1 : component->h;
+				UINT blocksY = scanCount == 1 ? 1 : component->v;
+				for (UINT by = 0; by < blocksY; by++) {
+					for (UINT bx = 0; bx < blocksX; bx++) {
+						size_t row = (size_t)(unitY * blocksY + by) * 8;
+						size_t column = (size_t)(unitX * blocksX + bx) * 8;
+						UINT8* out = planes + component->planeOffset + row * component->planeWidth + column;
+						if (!DecodeJpegBlock(reader, frame, *component, out, component->planeWidth)) {
+							return false;
+						}
+					}
+				}
+			}
+			restartsLeft--;
+		}
+	}
+
+	// Skip trailing padding to the next marker
+	size_t next = reader.pos;
+	while (next + 1 < data.size() && !(data[next] == 0xFF && data[next + 1] != 0x00 && !IsJpegRestartMarker(data[next + 1]))) {
+		next++;
+	}
+	*pos = next;
+	return true;
+}
+
+bool ImageDecoder::DecodeJpeg(std::span<const UINT8> data, bool bgra, UINT8* dst, UINT64 rowPitch)
+{
+	JpegFrame frame;
+	bool frameRead = false, scanned = false;
+	size_t pos = 2;
+	while (true)
+	{
+		// Markers may be preceded by any number of fill bytes
+		if (pos >= data.size() || data[pos] != 0xFF) {
+			return false;
+		}
+		while (pos < data.size() && data[pos] == 0xFF) {
+			pos++;
+		}
+		if (pos >= data.size()) {
+			return false;
+		}
+		UINT8 marker = data[pos++];
+		if (marker == 0xD9) {
+			break;
+		}
+		if (marker == 0xD8 || IsJpegRestartMarker(marker)) {
+			continue;
+		}
+
+		if (pos + 2 > data.size()) {
+			return false;
+		}
+		UINT length = ReadBigEndian16(data.data() + pos);
+		if (length < 2 || pos + length > data.size()) {
+			return false;
+		}
+		const UINT8* body = data.data() + pos + 2;
+		UINT bodySize = length - 2;
+		pos += length;
+
+		if (marker == 0xDB)
+		{
+			// Quantization tables, stored in zig-zag order
+			for (UINT i = 0; i < bodySize;) {
+				UINT precision = body[i] >> 4, id = body[i] & 15;
+				UINT tableSize = 1 + 64 * (precision ? 2 : 1);
+				if (id > 3 || precision > 1 || i + tableSize > bodySize) {
+					return false;
+				}
+				for (UINT k = 0; k < 64; k++) {
+					frame.quant[id][k] = precision ? ReadBigEndian16(body + i + 1 + k * 2) : body[i + 1 + k];
+				}
+				frame.quantDefined[id] = true;
+				i += tableSize;
+			}
+		}
+		else if (marker == 0xC4)
+		{
+			// Huffman tables
+			for (UINT i = 0; i < bodySize;) {
+				UINT tableClass = body[i] >> 4, id = body[i] & 15;
+				if (tableClass > 1 || id > 3 || i + 17 > bodySize) {
+					return false;
+				}
+				UINT total = 0;
+				for (UINT k = 0; k < 16; k++) {
+					total += body[i + 1 + k];
+				}
+				if (total > 256 || i + 17 + total > bodySize || !frame.huffman[tableClass][id].Build(body + i + 1, body + i + 17, total)) {
+					return false;
+				}
+				i += 17 + total;
+			}
+		}
+		else if (marker == 0xDD)
+		{
+			if (bodySize < 2) {
+				return false;
+			}
+			frame.restartInterval = ReadBigEndian16(body);
+		}
+		else if (marker == 0xC0 || marker == 0xC1)
+		{
+			// Baseline & Extended Huffman Frame
+			if (frameRead || bodySize < 6 || body[0] != 8) {
+				return false;
+			}
+			frame.height = ReadBigEndian16(body + 1);
+			frame.width = ReadBigEndian16(body + 3);
+			frame.componentCount = body[5];
+			if (frame.width == 0 || frame.height == 0 || (frame.componentCount != 1 && frame.componentCount != 3) || bodySize < 6 + 3 * frame.componentCount) {
+				return false;
+			}
+			for (UINT c = 0; c < frame.componentCount; c++) {
+				JpegComponent& component = frame.components[c];
+				component.id = body[6 + c * 3];
+				component.h = body[7 + c * 3] >> 4;
+				component.v = body[7 + c * 3] & 15;
+				component.quant = body[8 + c * 3];
+				if (component.h < 1 || component.h > 4 || component.v < 1 || component.v > 4 || component.quant > 3) {
+					return false;
+				}
+				frame.hMax = std::max<UINT>(frame.hMax, component.h);
+				frame.vMax = std::max<UINT>(frame.vMax, component.v);
+			}
+
+			// Planes cover whole MCUs so edge blocks need no clipping
+			frame.mcusX = (frame.width + frame.hMax * 8 - 1) / (frame.hMax * 8);
+			frame.mcusY = (frame.height + frame.vMax * 8 - 1) / (frame.vMax * 8);
+			size_t planeBytes = 0;
+			for (UINT c = 0; c < frame.componentCount; c++) {
+				JpegComponent& component = frame.components[c];
+				component.planeWidth = frame.mcusX * component.h * 8;
+				component.planeHeight = frame.mcusY * component.v * 8;
+				component.planeOffset = planeBytes;
+				planeBytes += (size_t)component.planeWidth * component.planeHeight;
+			}
+			planes.assign(planeBytes, 0);
+			frameRead = true;
+		}
+		else if (IsJpegFrameMarker(marker))
+		{
+			// Progressive, lossless and arithmetic coded frames
+			return false;
+		}
+		else if (marker == 0xDA)
+		{
+			if (!frameRead || !DecodeJpegScan(frame, body, bodySize, data, &pos, planes.data())) {
+				return false;
+			}
+			scanned = true;
+		}
+		// Everything else (APPn, COM, ...) carries nothing needed for the pixels
+	}
+	if (!scanned) {
+		return false;
+	}
+
+	// Upsample & Colour Convert
+	const JpegComponent* components = frame.components;
+	if (frame.componentCount == 1)
+	{
+		for (UINT y = 0; y < frame.height; y++) {
+			ConvertGrayToRgba(planes.data() + components[0].planeOffset + (size_t)y * components[0].planeWidth, dst + y * rowPitch, frame.width);
+		}
+		return true;
+	}
+
+	upsampled.resize((size_t)frame.width * 3);
+	for (UINT y = 0; y < frame.height; y++)
+	{
+		const UINT8* rows[3];
+		for (UINT c = 0; c < 3; c++)
+		{
+			const JpegComponent& component = components[c];
+			const UINT8* source = planes.data() + component.planeOffset + (size_t)(y * component.v / frame.vMax) * component.planeWidth;
+			if (component.h == frame.hMax) {
+				rows[c] = source;
+				continue;
+			}
+			// Subsampled chroma is replicated across the samples it covers
+			UINT8* row = upsampled.data() + (size_t)c * frame.width;
+			for (UINT x = 0; x < frame.width; x++) {
+				row[x] = source[x * component.h / frame.hMax];
+			}
+			rows[c] = row;
+		}
+		ConvertYCbCrToRgba(rows[0], rows[1], rows[2], dst + y * rowPitch, frame.width, bgra);
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <filesystem>
+#include <span>
+
+struct ImageInfo {
+	UINT width = 0;
+	UINT height = 0;
+};
+
+// Decoded pixels, rows are tightly packed at width * 4 bytes
+struct ImageData {
+	UINT width = 0;
+	UINT height = 0;
+	DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+	std::vector<UINT8> pixels;
+};
+
+// Platform neutral PNG and baseline JPEG decoding to R8G8B8A8 or B8G8R8A8 UNORM, picked by
+// the file's signature rather than its extension. Pixels are written straight into the
+// caller's memory, the decoder only keeps scratch buffers that are reused between images,
+// so one decoder per thread can work through many files without reallocating.
+//
+// PNG: every colour type and bit depth, palettes, tRNS and Adam7 interlacing (16-bit
+// samples keep their high byte). JPEG: baseline and extended Huffman, 8-bit samples,
+// grayscale or YCbCr with any subsampling and restart intervals. Progressive and
+// arithmetic coded JPEGs are rejected.
+class ImageDecoder {
+public:
+	// Reads the dimensions from the header without decoding anything
+	static bool ReadInfo(std::span<const UINT8> data, ImageInfo* info);
+	static bool IsSupportedFormat(DXGI_FORMAT format) { return format == DXGI_FORMAT_R8G8B8A8_UNORM || format == DXGI_FORMAT_B8G8R8A8_UNORM; }
+
+	// dst holds ReadInfo's height rows of rowPitch bytes
+	bool Decode(std::span<const UINT8> data, DXGI_FORMAT format, UINT8* dst, UINT64 rowPitch);
+	bool Load(const std::filesystem::path& path, DXGI_FORMAT format, ImageData* image);
+
+private:
+	bool DecodePng(std::span<const UINT8> data, bool bgra, UINT8* dst, UINT64 rowPitch);
+	bool DecodeJpeg(std::span<const UINT8> data, bool bgra, UINT8* dst, UINT64 rowPitch);
+
+	std::vector<UINT8> fileData;
+	// PNG
+	std::vector<UINT8> compressed;
+	std::vector<UINT8> filtered;
+	std::vector<UINT8> rowPixels;
+	// JPEG component planes at their own resolution, then upsampled rows
+	std::vector<UINT8> planes;
+	std::vector<UINT8> upsampled;
+};
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include "inflate.h"
+
+#define INFLATE_MAX_BITS 15
+#define INFLATE_MAX_LENGTH_CODES 286
+#define INFLATE_MAX_DISTANCE_CODES 30
+#define INFLATE_FIXED_LENGTH_CODES 288
+
+// Canonical Huffman code stored as the number of codes per length and the symbols in code order
+struct HuffmanTable {
+	INT16 count[INFLATE_MAX_BITS + 1];
+	INT16 symbol[INFLATE_FIXED_LENGTH_CODES];
+};
+
+struct InflateState {
+	const UINT8* in;
+	size_t inSize;
+	size_t inPos;
+	UINT32 bitBuffer;
+	int bitCount;
+
+	UINT8* out;
+	size_t outSize;
+	size_t outPos;
+
+	bool error;
+};
+
+static const UINT16 lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const UINT16 lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const UINT16 distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const UINT16 distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static UINT32 ReadBits(InflateState& s, int count)
+{
+	while (s.bitCount < count) {
+		if (s.inPos >= s.inSize) {
+			s.error = true;
+			return 0;
+		}
+		s.bitBuffer |= (UINT32)s.in[s.inPos++] << s.bitCount;
+		s.bitCount += 8;
+	}
+	UINT32 value = s.bitBuffer & ((1u << count) - 1);
+	s.bitBuffer >>= count;
+	s.bitCount -= count;
+	return value;
+}
+
+// Returns false for over-subscribed code lengths, incomplete codes are allowed (single distance codes)
+static bool BuildHuffmanTable(HuffmanTable& table, const UINT8* lengths, int symbolCount)
+{
+	memset(table.count, 0, sizeof(table.count));
+	for (int i = 0; i < symbolCount; i++) {
+		table.count[lengths[i]]++;
+	}
+	if (table.count[0] == symbolCount) {
+		return true;
+	}
+
+	int left = 1;
+	for (int length = 1; length <= INFLATE_MAX_BITS; length++) {
+		left = (left << 1) - table.count[length];
+		if (left < 0) {
+			return false;
+		}
+	}
+
+	INT16 offsets[INFLATE_MAX_BITS + 1];
+	offsets[1] = 0;
+	for (int length = 1; length < INFLATE_MAX_BITS; length++) {
+		offsets[length + 1] = offsets[length] + table.count[length];
+	}
+	for (int i = 0; i < symbolCount; i++) {
+		if (lengths[i] != 0) {
+			table.symbol[offsets[lengths[i]]++] = (INT16)i;
+		}
+	}
+	return true;
+}
+
+static int DecodeSymbol(InflateState& s, const HuffmanTable& table)
+{
+	// Walk the code one bit at a time, codes of each length are consecutive integers
+	int code = 0, first = 0, index = 0;
+	for (int length = 1; length <= INFLATE_MAX_BITS; length++) {
+		code |= (int)ReadBits(s, 1);
+		int count = table.count[length];
+		if (code - count < first) {
+			return table.symbol[index + (code - first)];
+		}
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+	s.error = true;
+	return -1;
+}
+
+static bool InflateStored(InflateState& s)
+{
+	// Stored blocks start on a byte boundary
+	s.bitBuffer = 0;
+	s.bitCount = 0;
+	if (s.inPos + 4 > s.inSize) {
+		return false;
+	}
+	UINT32 length = s.in[s.inPos] | (s.in[s.inPos + 1] << 8);
+	UINT32 check = s.in[s.inPos + 2] | (s.in[s.inPos + 3] << 8);
+	s.inPos += 4;
+	if (length != (~check & 0xFFFF) || s.inPos + length > s.inSize || s.outPos + length > s.outSize) {
+		return false;
+	}
+	memcpy(s.out + s.outPos, s.in + s.inPos, length);
+	s.inPos += length;
+	s.outPos += length;
+	return true;
+}
+
+static bool InflateCodes(InflateState& s, const HuffmanTable& lengthCodes, const HuffmanTable& distanceCodes)
+{
+	for (;;) {
+		int symbol = DecodeSymbol(s, lengthCodes);
+		if (s.error) {
+			return false;
+		}
+		if (symbol < 256) {
+			if (s.outPos >= s.outSize) {
+				return false;
+			}
+			s.out[s.outPos++] = (UINT8)symbol;
+			continue;
+		}
+		if (symbol == 256) {
+			return true;
+		}
+
+		// Length & distance back reference, overlapping copies repeat the pattern
+		symbol -= 257;
+		if (symbol >= 29) {
+			return false;
+		}
+		size_t length = lengthBase[symbol] + ReadBits(s, lengthExtra[symbol]);
+		int distanceSymbol = DecodeSymbol(s, distanceCodes);
+		if (s.error || distanceSymbol < 0 || distanceSymbol >= 30) {
+			return false;
+		}
+		size_t distance = distanceBase[distanceSymbol] + ReadBits(s, distanceExtra[distanceSymbol]);
+		if (s.error || distance > s.outPos || s.outPos + length > s.outSize) {
+			return false;
+		}
+		UINT8* dst = s.out + s.outPos;
+		const UINT8* src = dst - distance;
+		for (size_t i = 0; i < length; i++) {
+			dst[i] = src[i];
+		}
+		s.outPos += length;
+	}
+}
+
+static bool InflateFixed(InflateState& s)
+{
+	static HuffmanTable lengthCodes, distanceCodes;
+	static bool built = [] {
+		UINT8 lengths[INFLATE_FIXED_LENGTH_CODES];
+		int i = 0;
+		for (; i < 144; i++) lengths[i] = 8;
+		for (; i < 256; i++) lengths[i] = 9;
+		for (; i < 280; i++) lengths[i] = 7;
+		for (; i < INFLATE_FIXED_LENGTH_CODES; i++) lengths[i] = 8;
+		BuildHuffmanTable(lengthCodes, lengths, INFLATE_FIXED_LENGTH_CODES);
+		memset(lengths, 5, INFLATE_MAX_DISTANCE_CODES);
+		BuildHuffmanTable(distanceCodes, lengths, INFLATE_MAX_DISTANCE_CODES);
+		return true;
+	}();
+	(void)built;
+
+	return InflateCodes(s, lengthCodes, distanceCodes);
+}
+
+static bool InflateDynamic(InflateState& s)
+{
+	static const UINT8 order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	int lengthCount = (int)ReadBits(s, 5) + 257;
+	int distanceCount = (int)ReadBits(s, 5) + 1;
+	int codeCount = (int)ReadBits(s, 4) + 4;
+	if (s.error || lengthCount > INFLATE_MAX_LENGTH_CODES || distanceCount > INFLATE_MAX_DISTANCE_CODES) {
+		return false;
+	}
+
+	// Code length code, then the literal/length and distance code lengths it encodes
+	UINT8 lengths[INFLATE_MAX_LENGTH_CODES + INFLATE_MAX_DISTANCE_CODES] = {};
+	for (int i = 0; i < codeCount; i++) {
+		lengths[order[i]] = (UINT8)ReadBits(s, 3);
+	}
+	HuffmanTable codeLengthCodes;
+	if (s.error || !BuildHuffmanTable(codeLengthCodes, lengths, 19)) {
+		return false;
+	}
+
+	int index = 0;
+	while (index < lengthCount + distanceCount) {
+		int symbol = DecodeSymbol(s, codeLengthCodes);
+		if (s.error) {
+			return false;
+		}
+		if (symbol < 16) {
+			lengths[index++] = (UINT8)symbol;
+			continue;
+		}
+
+		UINT8 repeated = 0;
+		int repeat;
+		if (symbol == 16) {
+			if (index == 0) {
+				return false;
+			}
+			repeated = lengths[index - 1];
+			repeat = 3 + (int)ReadBits(s, 2);
+		}
+		else if (symbol == 17) {
+			repeat = 3 + (int)ReadBits(s, 3);
+		}
+		else {
+			repeat = 11 + (int)ReadBits(s, 7);
+		}
+		if (s.error || index + repeat > lengthCount + distanceCount) {
+			return false;
+		}
+		memset(lengths + index, repeated, repeat);
+		index += repeat;
+	}
+
+	// The end of block code has to be reachable
+	if (lengths[256] == 0) {
+		return false;
+	}
+	HuffmanTable lengthCodes, distanceCodes;
+	if (!BuildHuffmanTable(lengthCodes, lengths, lengthCount) || !BuildHuffmanTable(distanceCodes, lengths + lengthCount, distanceCount)) {
+		return false;
+	}
+	return InflateCodes(s, lengthCodes, distanceCodes);
+}
+
+bool Inflate(const UINT8* src, size_t srcSize, UINT8* dst, size_t dstSize, size_t* written, size_t* consumed)
+{
+	InflateState s = {};
+	s.in = src;
+	s.inSize = srcSize;
+	s.out = dst;
+	s.outSize = dstSize;
+
+	bool last = false;
+	while (!last) {
+		last = ReadBits(s, 1) != 0;
+		UINT32 type = ReadBits(s, 2);
+		if (s.error) {
+			return false;
+		}
+
+		bool decoded = false;
+		switch (type) {
+		case 0: decoded = InflateStored(s); break;
+		case 1: decoded = InflateFixed(s); break;
+		case 2: decoded = InflateDynamic(s); break;
+		default: break;
+		}
+		if (!decoded || s.error) {
+			return false;
+		}
+	}
+
+	if (written) {
+		*written = s.outPos;
+	}
+	if (consumed) {
+		*consumed = s.inPos;
+	}
+	return true;
+}
+
+bool ZlibInflate(const UINT8* src, size_t srcSize, UINT8* dst, size_t dstSize, size_t* written)
+{
+	// Deflate method, no preset dictionary, header check bits
+	if (srcSize < 6 || (src[0] & 0x0F) != 8 || (src[1] & 0x20) != 0 || ((src[0] << 8) | src[1]) % 31 != 0) {
+		return false;
+	}
+
+	size_t outSize, consumed;
+	if (!Inflate(src + 2, srcSize - 2, dst, dstSize, &outSize, &consumed)) {
+		return false;
+	}
+
+	// Adler-32 of the output follows the deflate stream, big endian
+	const UINT8* trailer = src + 2 + consumed;
+	if (trailer + 4 > src + srcSize) {
+		return false;
+	}
+	UINT32 a = 1, b = 0;
+	for (size_t i = 0; i < outSize; i++) {
+		a = (a + dst[i]) % 65521;
+		b = (b + a) % 65521;
+	}
+	UINT32 expected = ((UINT32)trailer[0] << 24) | ((UINT32)trailer[1] << 16) | ((UINT32)trailer[2] << 8) | trailer[3];
+	if (((b << 16) | a) != expected) {
+		return false;
+	}
+
+	if (written) {
+		*written = outSize;
+	}
+	return true;
+}
\ No newline at end of file
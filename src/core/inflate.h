@@ -0,0 +1,11 @@
+#pragma once
+
+#include "coreconst.h"
+
+// Decompresses a raw DEFLATE stream (RFC 1951) into a buffer of known size, returns false on
+// corrupt input or when the output doesn't fit. consumed reports how many input bytes were used.
+bool Inflate(const UINT8* src, size_t srcSize, UINT8* dst, size_t dstSize, size_t* written, size_t* consumed = nullptr);
+
+// Same for a zlib wrapped stream (RFC 1950) as stored in FBX arrays and PNG IDAT chunks,
+// the trailing Adler-32 is verified
+bool ZlibInflate(const UINT8* src, size_t srcSize, UINT8* dst, size_t dstSize, size_t* written = nullptr);
\ No newline at end of file
@@ -0,0 +1,547 @@
+#include "meshimporter.h"
+#include "meshoptimizer.h"
+#include "inflate.h"
+
+#include <charconv>
+#include <fstream>
+#include <string_view>
+
+// Binary FBX: a tree of named records, each holding typed properties and child records
+struct FbxProperty {
+	char type = 0;
+	const UINT8* data = nullptr;
+	UINT32 size = 0;
+	// Array properties only
+	UINT32 arrayLength = 0;
+	UINT32 encoding = 0;
+};
+
+struct FbxNode {
+	std::string_view name;
+	std::vector<FbxProperty> properties;
+	std::vector<FbxNode> children;
+
+	const FbxNode* Find(std::string_view childName) const
+	{
+		for (const FbxNode& child : children) {
+			if (child.name == childName) {
+				return &child;
+			}
+		}
+		return nullptr;
+	}
+};
+
+#define FBX_HEADER_SIZE 27
+#define FBX_WIDE_OFFSETS_VERSION 7500
+
+struct FbxReader {
+	std::span<const UINT8> data;
+	bool wideOffsets;
+
+	UINT64 ReadOffset(size_t& pos) const
+	{
+		UINT64 value = 0;
+		memcpy(&value, data.data() + pos, wideOffsets ? 8 : 4);
+		pos += wideOffsets ? 8 : 4;
+		return value;
+	}
+
+	size_t RecordHeaderSize() const { return wideOffsets ? 25 : 13; }
+
+	bool ReadProperty(size_t& pos, FbxProperty* property) const
+	{
+		if (pos >= data.size()) {
+			return false;
+		}
+		property->type = (char)data[pos++];
+		UINT32 fixedSize = 0;
+		switch (property->type) {
+		case 'C': fixedSize = 1; break;
+		case 'Y': fixedSize = 2; break;
+		case 'I': case 'F': fixedSize = 4; break;
+		case 'D': case 'L': fixedSize = 8; break;
+		case 'f': case 'd': case 'l': case 'i': case 'b':
+			if (pos + 12 > data.size()) {
+				return false;
+			}
+			memcpy(&property->arrayLength, data.data() + pos, 4);
+			memcpy(&property->encoding, data.data() + pos + 4, 4);
+			memcpy(&property->size, data.data() + pos + 8, 4);
+			pos += 12;
+			break;
+		case 'S': case 'R':
+			if (pos + 4 > data.size()) {
+				return false;
+			}
+			memcpy(&property->size, data.data() + pos, 4);
+			pos += 4;
+			break;
+		default:
+			return false;
+		}
+		if (fixedSize) {
+			property->size = fixedSize;
+		}
+		if (pos + property->size > data.size()) {
+			return false;
+		}
+		property->data = data.data() + pos;
+		pos += property->size;
+		return true;
+	}
+
+	// Returns false on malformed records, sets *end to 0 for the null record closing a list
+	bool ReadNode(size_t& pos, FbxNode* node, UINT64* end) const
+	{
+		if (pos + RecordHeaderSize() > data.size()) {
+			return false;
+		}
+		size_t start = pos;
+		*end = ReadOffset(pos);
+		UINT64 propertyCount = ReadOffset(pos);
+		UINT64 propertyBytes = ReadOffset(pos);
+		UINT8 nameLength = data[pos++];
+		if (*end == 0) {
+			pos = start + RecordHeaderSize();
+			return true;
+		}
+		if (*end > data.size() || *end <= start || pos + nameLength + propertyBytes > *end) {
+			return false;
+		}
+		node->name = std::string_view(reinterpret_cast<const char*>(data.data() + pos), nameLength);
+		pos += nameLength;
+
+		size_t propertiesEnd = pos + (size_t)propertyBytes;
+		node->properties.resize((size_t)propertyCount);
+		for (FbxProperty& property : node->properties) {
+			if (!ReadProperty(pos, &property) || pos > propertiesEnd) {
+				return false;
+			}
+		}
+
+		// Children run until the null record or the end of this record
+		pos = propertiesEnd;
+		while (pos < *end) {
+			FbxNode child;
+			UINT64 childEnd;
+			if (!ReadNode(pos, &child, &childEnd)) {
+				return false;
+			}
+			if (childEnd == 0) {
+				break;
+			}
+			node->children.push_back(std::move(child));
+		}
+		pos = (size_t)*end;
+		return true;
+	}
+};
+
+static std::string_view FbxString(const FbxNode* node, size_t index = 0)
+{
+	if (!node || index >= node->properties.size() || node->properties[index].type != 'S') {
+		return {};
+	}
+	const FbxProperty& property = node->properties[index];
+	return std::string_view(reinterpret_cast<const char*>(property.data), property.size);
+}
+
+// Expands an array property, inflating it if it was stored compressed, converting to T
+template <typename T>
+static bool ReadFbxArray(const FbxNode* node, std::vector<T>* values)
+{
+	if (!node || node->properties.empty()) {
+		return false;
+	}
+	const FbxProperty& property = node->properties[0];
+	size_t elementSize;
+	switch (property.type) {
+	case 'd': case 'l': elementSize = 8; break;
+	case 'f': case 'i': elementSize = 4; break;
+	case 'b': elementSize = 1; break;
+	default: return false;
+	}
+
+	size_t bytes = (size_t)property.arrayLength * elementSize;
+	std::vector<UINT8> inflated;
+	const UINT8* src = property.data;
+	if (property.encoding == 1) {
+		inflated.resize(bytes);
+		size_t written;
+		if (!ZlibInflate(property.data, property.size, inflated.data(), bytes, &written) || written != bytes) {
+			return false;
+		}
+		src = inflated.data();
+	}
+	else if (property.encoding != 0 || property.size < bytes) {
+		return false;
+	}
+
+	values->resize(property.arrayLength);
+	for (size_t i = 0; i < property.arrayLength; i++) {
+		const UINT8* element = src + i * elementSize;
+		switch (property.type) {
+		case 'd': { double v; memcpy(&v, element, 8); (*values)[i] = (T)v; break; }
+		case 'f': { float v; memcpy(&v, element, 4); (*values)[i] = (T)v; break; }
+		case 'l': { INT64 v; memcpy(&v, element, 8); (*values)[i] = (T)v; break; }
+		case 'i': { INT32 v; memcpy(&v, element, 4); (*values)[i] = (T)v; break; }
+		case 'b': (*values)[i] = (T)element[0]; break;
+		}
+	}
+	return true;
+}
+
+// A LayerElementNormal/UV: values plus how corners map onto them
+struct FbxLayerElement {
+	std::vector<double> values;
+	std::vector<int> indices;
+	UINT32 components = 0;
+	bool byControlPoint = false;
+	bool byPolygon = false;
+	bool allSame = false;
+	bool indexed = false;
+
+	bool Load(const FbxNode* element, const char* valuesName, const char* indicesName, UINT32 componentCount)
+	{
+		if (!element || !ReadFbxArray(element->Find(valuesName), &values)) {
+			return false;
+		}
+		components = componentCount;
+		std::string_view mapping = FbxString(element->Find("MappingInformationType"));
+		byControlPoint = mapping == "ByVertice" || mapping == "ByVertex" || mapping == "ByControlPoint";
+		byPolygon = mapping == "ByPolygon";
+		allSame = mapping == "AllSame";
+		indexed = FbxString(element->Find("ReferenceInformationType")) == "IndexToDirect";
+		return !indexed || ReadFbxArray(element->Find(indicesName), &indices);
+	}
+
+	// Returns the first component for a corner, or nullptr if the element doesn't cover it
+	const double* Get(size_t corner, int controlPoint, size_t polygon) const
+	{
+		size_t index = allSame ? 0 : byControlPoint ? (size_t)controlPoint : byPolygon ? polygon : corner;
+		if (indexed) {
+			if (index >= indices.size() || indices[index] < 0) {
+				return nullptr;
+			}
+			index = (size_t)indices[index];
+		}
+		return (index + 1) * components <= values.size() ? &values[index * components] : nullptr;
+	}
+};
+
+size_t MeshImporter::VertexHash::operator()(const Vertex& vertex) const
+{
+	// FNV-1a over the vertex bytes
+	const UINT8* bytes = reinterpret_cast<const UINT8*>(&vertex);
+	UINT64 hash = 14695981039346656037ull;
+	for (size_t i = 0; i < sizeof(Vertex); i++) {
+		hash = (hash ^ bytes[i]) * 1099511628211ull;
+	}
+	return (size_t)hash;
+}
+
+void MeshImporter::AddCorner(const Vertex& vertex, MeshData* mesh)
+{
+	auto inserted = vertexLookup.try_emplace(vertex, (UINT32)mesh->vertices.size());
+	if (inserted.second) {
+		mesh->vertices.push_back(vertex);
+	}
+	mesh->indices.push_back(inserted.first->second);
+}
+
+bool MeshImporter::ImportFbx(std::span<const UINT8> data, MeshData* mesh)
+{
+	static const char magic[] = "Kaydara FBX Binary  ";
+	if (data.size() < FBX_HEADER_SIZE || memcmp(data.data(), magic, sizeof(magic)) != 0) {
+		return false;
+	}
+	UINT32 version;
+	memcpy(&version, data.data() + 23, sizeof(version));
+
+	// Parse the top level records
+	FbxReader reader = { data, version >= FBX_WIDE_OFFSETS_VERSION };
+	FbxNode root;
+	size_t pos = FBX_HEADER_SIZE;
+	while (pos < data.size()) {
+		FbxNode node;
+		UINT64 end;
+		if (!reader.ReadNode(pos, &node, &end)) {
+			return false;
+		}
+		if (end == 0) {
+			break;
+		}
+		root.children.push_back(std::move(node));
+	}
+
+	const FbxNode* objects = root.Find("Objects");
+	if (!objects) {
+		return false;
+	}
+
+	mesh->vertices.clear();
+	mesh->indices.clear();
+	vertexLookup.clear();
+	bool hasNormals = true;
+
+	// Every mesh geometry is merged into one
+	for (const FbxNode& geometry : objects->children) {
+		if (geometry.name != "Geometry" || FbxString(&geometry, 2) != "Mesh") {
+			continue;
+		}
+		std::vector<double> positions;
+		std::vector<int> polygonVertices;
+		if (!ReadFbxArray(geometry.Find("Vertices"), &positions) || !ReadFbxArray(geometry.Find("PolygonVertexIndex"), &polygonVertices)) {
+			return false;
+		}
+
+		FbxLayerElement normals, texCoords;
+		bool geometryHasNormals = normals.Load(geometry.Find("LayerElementNormal"), "Normals", "NormalsIndex", 3);
+		hasNormals = hasNormals && geometryHasNormals;
+		texCoords.Load(geometry.Find("LayerElementUV"), "UV", "UVIndex", 2);
+
+		// Polygons end at a negative (bitwise negated) index, fan them into triangles
+		size_t polygonStart = 0, polygon = 0;
+		for (size_t corner = 0; corner < polygonVertices.size(); corner++) {
+			if (polygonVertices[corner] >= 0) {
+				continue;
+			}
+
+			auto makeVertex = [&](size_t c) {
+				int controlPoint = polygonVertices[c] < 0 ? ~polygonVertices[c] : polygonVertices[c];
+				const double* p = (size_t)(controlPoint + 1) * 3 <= positions.size() ? &positions[controlPoint * 3] : nullptr;
+				const double* uv = texCoords.Get(c, controlPoint, polygon);
+				const double* n = geometryHasNormals ? normals.Get(c, controlPoint, polygon) : nullptr;
+
+				// Right handed to left handed: mirror z, UVs start at the top
+				Vertex vertex(p ? (float)p[0] : 0.0f, p ? (float)p[1] : 0.0f, p ? -(float)p[2] : 0.0f, uv ? (float)uv[0] : 0.0f, uv ? 1.0f - (float)uv[1] : 0.0f);
+				vertex.normals = n ? Float3((float)n[0], (float)n[1], -(float)n[2]) : Float3();
+				return vertex;
+			};
+			for (size_t k = polygonStart + 1; k + 1 <= corner; k++) {
+				// Mirroring flips the winding, swap two corners to keep fronts clockwise
+				AddCorner(makeVertex(polygonStart), mesh);
+				AddCorner(makeVertex(k + 1), mesh);
+				AddCorner(makeVertex(k), mesh);
+			}
+			polygonStart = corner + 1;
+			polygon++;
+		}
+	}
+
+	if (!hasNormals) {
+		GenerateNormals(mesh);
+	}
+	return !mesh->indices.empty();
+}
+
+bool MeshImporter::ImportObj(std::span<const UINT8> data, MeshData* mesh)
+{
+	std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+	std::vector<Float3> positions, normals;
+	std::vector<Float2> texCoords;
+
+	mesh->vertices.clear();
+	mesh->indices.clear();
+	vertexLookup.clear();
+	bool hasNormals = true;
+
+	auto skipSpaces = [](std::string_view& s) {
+		while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+	};
+	auto readFloat = [&](std::string_view& s) {
+		skipSpaces(s);
+		float value = 0.0f;
+		auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+		s.remove_prefix(result.ptr - s.data());
+		return value;
+	};
+	auto readIndex = [](std::string_view& s, size_t count) {
+		// 1-based, negative counts back from the end, 0 means absent
+		int value = 0;
+		auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+		s.remove_prefix(result.ptr - s.data());
+		int index = value > 0 ? value - 1 : value < 0 ? (int)count + value : -1;
+		return index >= 0 && (size_t)index < count ? index : -1;
+	};
+
+	std::vector<Vertex> polygon;
+	while (!text.empty()) {
+		size_t lineEnd = text.find('\n');
+		std::string_view line = text.substr(0, lineEnd);
+		text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+		skipSpaces(line);
+
+		if (line.starts_with("v ")) {
+			line.remove_prefix(2);
+			float x = readFloat(line), y = readFloat(line), z = readFloat(line);
+			positions.push_back(Float3(x, y, -z));
+		}
+		else if (line.starts_with("vn ")) {
+			line.remove_prefix(3);
+			float x = readFloat(line), y = readFloat(line), z = readFloat(line);
+			normals.push_back(Float3(x, y, -z));
+		}
+		else if (line.starts_with("vt ")) {
+			line.remove_prefix(3);
+			float u = readFloat(line), v = readFloat(line);
+			texCoords.push_back(Float2(u, 1.0f - v));
+		}
+		else if (line.starts_with("f ")) {
+			// Corners are v, v/vt, v//vn or v/vt/vn
+			line.remove_prefix(2);
+			polygon.clear();
+			for (skipSpaces(line); !line.empty() && line.front() != '\r'; skipSpaces(line)) {
+				int p = readIndex(line, positions.size()), t = -1, n = -1;
+				if (!line.empty() && line.front() == '/') {
+					line.remove_prefix(1);
+					if (!line.empty() && line.front() != '/') {
+						t = readIndex(line, texCoords.size());
+					}
+					if (!line.empty() && line.front() == '/') {
+						line.remove_prefix(1);
+						n = readIndex(line, normals.size());
+					}
+				}
+				if (p < 0) {
+					return false;
+				}
+				Vertex vertex(positions[p].x, positions[p].y, positions[p].z, t >= 0 ? texCoords[t].x : 0.0f, t >= 0 ? texCoords[t].y : 0.0f);
+				vertex.normals = n >= 0 ? normals[n] : Float3();
+				hasNormals = hasNormals && n >= 0;
+				polygon.push_back(vertex);
+			}
+			for (size_t k = 1; k + 1 < polygon.size(); k++) {
+				AddCorner(polygon[0], mesh);
+				AddCorner(polygon[k + 1], mesh);
+				AddCorner(polygon[k], mesh);
+			}
+		}
+	}
+
+	if (!hasNormals) {
+		GenerateNormals(mesh);
+	}
+	return !mesh->indices.empty();
+}
+
+void MeshImporter::GenerateNormals(MeshData* mesh)
+{
+	// Vertices split by UV seams still share a position, accumulate per position
+	struct PositionHash {
+		size_t operator()(const Float3& p) const { return std::hash<float>()(p.x) ^ (std::hash<float>()(p.y) << 1) ^ (std::hash<float>()(p.z) << 2); }
+	};
+	struct PositionEqual {
+		bool operator()(const Float3& a, const Float3& b) const { return a.x == b.x && a.y == b.y && a.z == b.z; }
+	};
+	std::unordered_map<Float3, Float3, PositionHash, PositionEqual> accumulated;
+
+	for (size_t i = 0; i + 2 < mesh->indices.size(); i += 3) {
+		const Float3& a = mesh->vertices[mesh->indices[i]].pos;
+		const Float3& b = mesh->vertices[mesh->indices[i + 1]].pos;
+		const Float3& c = mesh->vertices[mesh->indices[i + 2]].pos;
+		// Clockwise fronts, the cross product's length weights by area
+		Float3 faceNormal = Vec3Cross(Vec3Sub(b, a), Vec3Sub(c, a));
+		for (const Float3* p : { &a, &b, &c }) {
+			Float3& sum = accumulated[*p];
+			sum = Float3(sum.x + faceNormal.x, sum.y + faceNormal.y, sum.z + faceNormal.z);
+		}
+	}
+	for (Vertex& vertex : mesh->vertices) {
+		vertex.normals = Vec3Normalize(accumulated[vertex.pos]);
+	}
+}
+
+bool MeshImporter::LoadCooked(const std::filesystem::path& path, MeshData* mesh)
+{
+	// One read for the whole blob
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	std::vector<UINT8> blob((size_t)file.tellg());
+	file.seekg(0);
+	if (blob.size() < sizeof(CookedMeshHeader) || !file.read(reinterpret_cast<char*>(blob.data()), blob.size())) {
+		return false;
+	}
+
+	CookedMeshHeader header;
+	memcpy(&header, blob.data(), sizeof(header));
+	size_t vertexBytes = (size_t)header.vertexCount * sizeof(Vertex);
+	size_t indexBytes = (size_t)header.indexCount * sizeof(UINT32);
+	if (header.magic != COOKED_MESH_MAGIC || header.version != COOKED_MESH_VERSION || header.vertexStride != sizeof(Vertex) ||
+		blob.size() != sizeof(header) + vertexBytes + indexBytes) {
+		return false;
+	}
+
+	const Vertex* vertices = reinterpret_cast<const Vertex*>(blob.data() + sizeof(header));
+	const UINT32* indices = reinterpret_cast<const UINT32*>(blob.data() + sizeof(header) + vertexBytes);
+	mesh->vertices.assign(vertices, vertices + header.vertexCount);
+	mesh->indices.assign(indices, indices + header.indexCount);
+	return true;
+}
+
+bool MeshImporter::WriteCooked(const std::filesystem::path& path, const MeshData& mesh)
+{
+	CookedMeshHeader header = { COOKED_MESH_MAGIC, COOKED_MESH_VERSION, sizeof(Vertex), (UINT32)mesh.vertices.size(), (UINT32)mesh.indices.size() };
+
+	// Write beside the final name and rename, so a crash never leaves a truncated blob
+	std::filesystem::path temporary = std::filesystem::path(path) += ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(mesh.vertices.data()), mesh.vertices.size() * sizeof(Vertex));
+		file.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size() * sizeof(UINT32));
+		if (!file) {
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(temporary, path, error);
+	return !error;
+}
+
+bool MeshImporter::Load(const std::filesystem::path& source, MeshData* mesh)
+{
+	// Skip parsing entirely while the cooked blob is current
+	std::filesystem::path cooked = CookedPath(source);
+	std::error_code sourceError, cookedError;
+	auto sourceTime = std::filesystem::last_write_time(source, sourceError);
+	auto cookedTime = std::filesystem::last_write_time(cooked, cookedError);
+	loadedFromCache = !cookedError && (sourceError || cookedTime >= sourceTime) && LoadCooked(cooked, mesh);
+	if (loadedFromCache) {
+		return true;
+	}
+
+	if (!Import(source, mesh)) {
+		return false;
+	}
+	WriteCooked(cooked, *mesh);
+	return true;
+}
+
+bool MeshImporter::Import(const std::filesystem::path& source, MeshData* mesh)
+{
+	std::ifstream file(source, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	std::vector<UINT8> data((size_t)file.tellg());
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char*>(data.data()), data.size())) {
+		return false;
+	}
+
+	std::filesystem::path extension = source.extension();
+	bool imported = extension == ".fbx" || extension == ".FBX" ? ImportFbx(data, mesh) : ImportObj(data, mesh);
+	if (!imported) {
+		return false;
+	}
+
+	// Reorder for the GPU once, before it is cooked or packed
+	MeshOptimizer optimizer;
+	MeshOptimizeReport report = optimizer.Optimize(mesh->vertices, mesh->indices);
+	mesh->vertices.erase(mesh->vertices.begin() + report.vertexCount, mesh->vertices.end());
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <filesystem>
+#include <span>
+#include <unordered_map>
+
+#define COOKED_MESH_MAGIC 0x4853454D // "MESH"
+#define COOKED_MESH_VERSION 1
+#define COOKED_MESH_EXTENSION ".mesh"
+
+// Cooked blobs are the header followed by the raw Vertex and UINT32 index arrays
+struct CookedMeshHeader {
+	UINT32 magic;
+	UINT32 version;
+	UINT32 vertexStride;
+	UINT32 vertexCount;
+	UINT32 indexCount;
+};
+
+struct MeshData {
+	std::vector<Vertex> vertices;
+	std::vector<UINT32> indices;
+};
+
+// Imports binary FBX (7.x) and OBJ meshes into indexed, left handed Vertex data with clockwise
+// front faces like the hand-typed meshes. Geometry stays in mesh space, node transforms are not
+// applied. Load() cooks the result into a blob next to the source so later runs skip parsing.
+class MeshImporter {
+public:
+	// Reads the cooked blob when it is at least as new as the source, otherwise imports,
+	// optimizes and cooks the source. A cook that can't be written still returns the mesh.
+	bool Load(const std::filesystem::path& source, MeshData* mesh);
+	bool LoadedFromCache() { return loadedFromCache; }
+	// Parses the source by extension and optimizes it, without touching the cache
+	bool Import(const std::filesystem::path& source, MeshData* mesh);
+
+	bool ImportFbx(std::span<const UINT8> data, MeshData* mesh);
+	bool ImportObj(std::span<const UINT8> data, MeshData* mesh);
+
+	static std::filesystem::path CookedPath(const std::filesystem::path& source) { return std::filesystem::path(source) += COOKED_MESH_EXTENSION; }
+	static bool LoadCooked(const std::filesystem::path& path, MeshData* mesh);
+	static bool WriteCooked(const std::filesystem::path& path, const MeshData& mesh);
+
+private:
+	struct VertexHash {
+		size_t operator()(const Vertex& vertex) const;
+	};
+	struct VertexEqual {
+		bool operator()(const Vertex& a, const Vertex& b) const { return memcmp(&a, &b, sizeof(Vertex)) == 0; }
+	};
+
+	// Appends a triangle corner, reusing an identical vertex if one was already emitted
+	void AddCorner(const Vertex& vertex, MeshData* mesh);
+	// Smooth, area weighted normals for sources that don't carry any
+	static void GenerateNormals(MeshData* mesh);
+
+	std::unordered_map<Vertex, UINT32, VertexHash, VertexEqual> vertexLookup;
+	bool loadedFromCache = false;
+};
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "meshoptimizer.h"
+
+#include <algorithm>
+
+MeshOptimizeReport MeshOptimizer::Optimize(std::span<Vertex> vertices, std::span<UINT32> indices)
+{
+	MeshOptimizeReport report;
+	report.before = AnalyzeVertexCache(indices, vertices.size());
+
+	OptimizeVertexCache(indices, vertices.size());
+	report.clusterCount = OptimizeOverdraw(indices, vertices);
+	report.vertexCount = OptimizeVertexFetch(vertices, indices);
+
+	report.after = AnalyzeVertexCache(indices, report.vertexCount);
+	return report;
+}
+
+float MeshOptimizer::VertexScore(int cachePosition, UINT liveTriangles)
+{
+	// Vertices nobody needs any more must never pull a triangle forward
+	if (liveTriangles == 0) {
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+	if (cachePosition >= 0) {
+		// The last triangle's vertices score a fixed amount so strips don't bounce back and forth
+		if (cachePosition < 3) {
+			score = 0.75f;
+		}
+		else {
+			float scale = 1.0f / (VERTEX_CACHE_SCORE_SIZE - 3);
+			score = powf(1.0f - (cachePosition - 3) * scale, 1.5f);
+		}
+	}
+
+	// Favour vertices with few triangles left so they get finished instead of left stranded
+	return score + 2.0f * powf((float)liveTriangles, -0.5f);
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::span<UINT32> indices, size_t vertexCount)
+{
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	// Build Vertex to Triangle Adjacency
+	liveTriangles.assign(vertexCount, 0);
+	for (UINT32 index : indices) {
+		liveTriangles[index]++;
+	}
+	adjacencyOffsets.assign(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++) {
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+	}
+	adjacency.resize(indices.size());
+	adjacencyFill.assign(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (size_t t = 0; t < triangleCount; t++) {
+		for (int k = 0; k < 3; k++) {
+			adjacency[adjacencyFill[indices[t * 3 + k]]++] = (UINT)t;
+		}
+	}
+
+	// Initial Scores
+	cachePositions.assign(vertexCount, -1);
+	vertexScores.resize(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		vertexScores[v] = VertexScore(-1, liveTriangles[v]);
+	}
+	triangleScores.resize(triangleCount);
+	triangleEmitted.assign(triangleCount, false);
+	for (size_t t = 0; t < triangleCount; t++) {
+		triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+	}
+
+	// Cache holds the scored entries plus room for the three pushed in by the next triangle
+	UINT32 cache[VERTEX_CACHE_SCORE_SIZE + 3];
+	UINT32 newCache[VERTEX_CACHE_SCORE_SIZE + 3];
+	size_t cacheCount = 0;
+
+	reordered.resize(indices.size());
+	size_t emitted = 0;
+	size_t scanCursor = 0;
+	size_t bestTriangle = 0;
+	for (size_t t = 1; t < triangleCount; t++) {
+		if (triangleScores[t] > triangleScores[bestTriangle]) {
+			bestTriangle = t;
+		}
+	}
+
+	while (true)
+	{
+		// Emit Best Triangle
+		triangleEmitted[bestTriangle] = true;
+		UINT32 a = indices[bestTriangle * 3], b = indices[bestTriangle * 3 + 1], c = indices[bestTriangle * 3 + 2];
+		reordered[emitted * 3] = a;
+		reordered[emitted * 3 + 1] = b;
+		reordered[emitted * 3 + 2] = c;
+		emitted++;
+		if (emitted == triangleCount) {
+			break;
+		}
+
+		// Drop it from its vertices' live lists
+		for (UINT32 v : { a, b, c }) {
+			UINT* first = &adjacency[adjacencyOffsets[v]];
+			UINT* last = first + liveTriangles[v];
+			*std::find(first, last, (UINT)bestTriangle) = *(last - 1);
+			liveTriangles[v]--;
+		}
+
+		// Move the triangle's vertices to the front of the LRU cache
+		size_t newCount = 0;
+		newCache[newCount++] = a;
+		if (b != a) {
+			newCache[newCount++] = b;
+		}
+		if (c != a && c != b) {
+			newCache[newCount++] = c;
+		}
+		for (size_t i = 0; i < cacheCount; i++) {
+			UINT32 v = cache[i];
+			if (v != a && v != b && v != c) {
+				newCache[newCount++] = v;
+			}
+		}
+
+		// Rescore everything that moved, including vertices pushed out of the cache
+		for (size_t i = 0; i < newCount; i++) {
+			UINT32 v = newCache[i];
+			int position = i < VERTEX_CACHE_SCORE_SIZE ? (int)i : -1;
+			cachePositions[v] = position;
+			float score = VertexScore(position, liveTriangles[v]);
+			float delta = score - vertexScores[v];
+			vertexScores[v] = score;
+			for (UINT j = 0; j < liveTriangles[v]; j++) {
+				triangleScores[adjacency[adjacencyOffsets[v] + j]] += delta;
+			}
+		}
+		cacheCount = std::min<size_t>(newCount, VERTEX_CACHE_SCORE_SIZE);
+		std::copy(newCache, newCache + cacheCount, cache);
+
+		// Best candidate among triangles touching the cache
+		float bestScore = -1.0f;
+		bool found = false;
+		for (size_t i = 0; i < cacheCount; i++) {
+			UINT32 v = cache[i];
+			for (UINT j = 0; j < liveTriangles[v]; j++) {
+				UINT t = adjacency[adjacencyOffsets[v] + j];
+				if (triangleScores[t] > bestScore) {
+					bestScore = triangleScores[t];
+					bestTriangle = t;
+					found = true;
+				}
+			}
+		}
+
+		// Nothing connected left in the cache, continue with the next untouched triangle
+		if (!found) {
+			while (triangleEmitted[scanCursor]) {
+				scanCursor++;
+			}
+			bestTriangle = scanCursor;
+		}
+	}
+
+	std::copy(reordered.begin(), reordered.end(), indices.begin());
+}
+
+UINT MeshOptimizer::OptimizeOverdraw(std::span<UINT32> indices, std::span<const Vertex> vertices, float threshold)
+{
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return 0;
+	}
+	VertexCacheStats original = AnalyzeVertexCache(indices, vertices.size());
+
+	// Grow each cluster from a cold cache and close it as soon as its own ACMR is within the
+	// threshold, so the clusters can go in any order without the total exceeding it
+	float targetAcmr = original.acmr * threshold;
+	clusters.clear();
+	clusters.push_back({ 0, 0, 0.0f });
+	cacheTimestamps.assign(vertices.size(), 0);
+	UINT timestamp = VERTEX_CACHE_FIFO_SIZE + 1;
+	UINT misses = 0;
+	for (size_t t = 0; t < triangleCount; t++) {
+		for (int k = 0; k < 3; k++) {
+			UINT32 v = indices[t * 3 + k];
+			if (timestamp - cacheTimestamps[v] > VERTEX_CACHE_FIFO_SIZE) {
+				cacheTimestamps[v] = timestamp++;
+				misses++;
+			}
+		}
+
+		Cluster& cluster = clusters.back();
+		cluster.triangleCount++;
+		if (t + 1 < triangleCount && misses <= targetAcmr * cluster.triangleCount) {
+			clusters.push_back({ t + 1, 0, 0.0f });
+			misses = 0;
+			timestamp += VERTEX_CACHE_FIFO_SIZE + 1;
+		}
+	}
+	if (clusters.size() < 2) {
+		return (UINT)clusters.size();
+	}
+
+	// Mesh Centroid
+	Float3 meshCenter;
+	for (const Vertex& vertex : vertices) {
+		meshCenter.x += vertex.pos.x;
+		meshCenter.y += vertex.pos.y;
+		meshCenter.z += vertex.pos.z;
+	}
+	float invCount = 1.0f / vertices.size();
+	meshCenter = Float3(meshCenter.x * invCount, meshCenter.y * invCount, meshCenter.z * invCount);
+
+	// Outward facing clusters first, they are the likeliest to hide the rest
+	for (Cluster& cluster : clusters) {
+		Float3 center, normal;
+		float area = 0.0f;
+		for (size_t t = cluster.firstTriangle; t < cluster.firstTriangle + cluster.triangleCount; t++) {
+			const Float3& p0 = vertices[indices[t * 3]].pos;
+			const Float3& p1 = vertices[indices[t * 3 + 1]].pos;
+			const Float3& p2 = vertices[indices[t * 3 + 2]].pos;
+			Float3 faceNormal = Vec3Cross(Vec3Sub(p1, p0), Vec3Sub(p2, p0));
+			float faceArea = sqrtf(Vec3Dot(faceNormal, faceNormal));
+			center.x += (p0.x + p1.x + p2.x) * faceArea;
+			center.y += (p0.y + p1.y + p2.y) * faceArea;
+			center.z += (p0.z + p1.z + p2.z) * faceArea;
+			normal.x += faceNormal.x;
+			normal.y += faceNormal.y;
+			normal.z += faceNormal.z;
+			area += faceArea;
+		}
+		float invArea = area > 0.0f ? 1.0f / (area * 3.0f) : 0.0f;
+		center = Float3(center.x * invArea, center.y * invArea, center.z * invArea);
+		cluster.sortKey = Vec3Dot(Vec3Sub(center, meshCenter), Vec3Normalize(normal));
+	}
+	std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+	reordered.resize(indices.size());
+	size_t written = 0;
+	for (const Cluster& cluster : clusters) {
+		std::copy(indices.begin() + cluster.firstTriangle * 3, indices.begin() + (cluster.firstTriangle + cluster.triangleCount) * 3, reordered.begin() + written);
+		written += cluster.triangleCount * 3;
+	}
+
+	// Keep the cache order if the sort cost more than the threshold allows
+	VertexCacheStats sorted = AnalyzeVertexCache(reordered, vertices.size());
+	if (sorted.acmr > original.acmr * threshold) {
+		return 1;
+	}
+	std::copy(reordered.begin(), reordered.end(), indices.begin());
+	return (UINT)clusters.size();
+}
+
+size_t MeshOptimizer::OptimizeVertexFetch(std::span<Vertex> vertices, std::span<UINT32> indices)
+{
+	// Number vertices in the order the index buffer first reaches them
+	const UINT32 unused = ~0u;
+	remap.assign(vertices.size(), unused);
+	UINT32 next = 0;
+	for (UINT32& index : indices) {
+		if (remap[index] == unused) {
+			remap[index] = next++;
+		}
+		index = remap[index];
+	}
+
+	vertexScratch.assign(vertices.begin(), vertices.end());
+	for (size_t v = 0; v < vertexScratch.size(); v++) {
+		if (remap[v] != unused) {
+			vertices[remap[v]] = vertexScratch[v];
+		}
+	}
+
+	// Unreferenced vertices trail behind the used ones
+	size_t tail = next;
+	for (size_t v = 0; v < vertexScratch.size(); v++) {
+		if (remap[v] == unused) {
+			vertices[tail++] = vertexScratch[v];
+		}
+	}
+	return next;
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(std::span<const UINT32> indices, size_t vertexCount, UINT cacheSize)
+{
+	VertexCacheStats stats;
+	if (indices.empty() || vertexCount == 0) {
+		return stats;
+	}
+
+	// FIFO cache, a vertex hits while fewer than cacheSize misses happened since it was loaded
+	std::vector<UINT> timestamps(vertexCount, 0);
+	UINT timestamp = cacheSize + 1;
+	for (UINT32 index : indices) {
+		if (timestamp - timestamps[index] > cacheSize) {
+			timestamps[index] = timestamp++;
+			stats.transformedVertices++;
+		}
+	}
+
+	stats.acmr = (float)stats.transformedVertices / (indices.size() / 3);
+	stats.atvr = (float)stats.transformedVertices / vertexCount;
+	return stats;
+}
\ No newline at end of file
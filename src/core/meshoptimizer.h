@@ -0,0 +1,70 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <span>
+
+// Cache size the Forsyth scoring assumes, and the FIFO size the statistics simulate
+#define VERTEX_CACHE_SCORE_SIZE 32
+#define VERTEX_CACHE_FIFO_SIZE 16
+// How much worse than the cache-optimized order the overdraw order may make the ACMR
+#define OVERDRAW_ACMR_THRESHOLD 1.05f
+
+struct VertexCacheStats {
+	UINT transformedVertices = 0;
+	// Transformed vertices per triangle, 0.5 is the floor for large regular meshes
+	float acmr = 0.0f;
+	// Transformed vertices per vertex, 1 means every vertex is shaded exactly once
+	float atvr = 0.0f;
+};
+
+struct MeshOptimizeReport {
+	VertexCacheStats before;
+	VertexCacheStats after;
+	// Vertices still referenced, they are packed at the front of the vertex span
+	size_t vertexCount = 0;
+	UINT clusterCount = 0;
+};
+
+// Reorders an indexed triangle list for the GPU: triangles for the post-transform vertex
+// cache (Forsyth), then clusters of them front to back for overdraw (Sander et al.), then
+// vertices in first-use order for fetch locality. Scratch memory is kept between meshes.
+class MeshOptimizer {
+public:
+	// Runs every stage in place and reports the FIFO cache statistics before and after
+	MeshOptimizeReport Optimize(std::span<Vertex> vertices, std::span<UINT32> indices);
+
+	void OptimizeVertexCache(std::span<UINT32> indices, size_t vertexCount);
+	// Expects cache-optimized input, returns the number of clusters it sorted
+	UINT OptimizeOverdraw(std::span<UINT32> indices, std::span<const Vertex> vertices, float threshold = OVERDRAW_ACMR_THRESHOLD);
+	// Returns the number of vertices still referenced
+	size_t OptimizeVertexFetch(std::span<Vertex> vertices, std::span<UINT32> indices);
+
+	static VertexCacheStats AnalyzeVertexCache(std::span<const UINT32> indices, size_t vertexCount, UINT cacheSize = VERTEX_CACHE_FIFO_SIZE);
+
+private:
+	struct Cluster {
+		size_t firstTriangle;
+		size_t triangleCount;
+		float sortKey;
+	};
+
+	float VertexScore(int cachePosition, UINT liveTriangles);
+
+	// Vertex cache scratch
+	std::vector<UINT> liveTriangles;
+	std::vector<UINT> adjacencyOffsets;
+	std::vector<UINT> adjacency;
+	std::vector<UINT> adjacencyFill;
+	std::vector<int> cachePositions;
+	std::vector<float> vertexScores;
+	std::vector<float> triangleScores;
+	std::vector<bool> triangleEmitted;
+	std::vector<UINT32> reordered;
+
+	// Overdraw and fetch scratch
+	std::vector<Cluster> clusters;
+	std::vector<UINT> cacheTimestamps;
+	std::vector<UINT32> remap;
+	std::vector<Vertex> vertexScratch;
+};
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "mipgenerator.h"
+
+#include <d3dx12_property_format_table.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined(IMAGE_SIMD_SSE2) || defined(IMAGE_SIMD_AVX2)
+#include <emmintrin.h>
+#define MIP_SIMD_SSE2
+#endif
+
+// The Kaiser kernel spans this many destination texels either side of the centre
+#define KAISER_RADIUS 3
+#define KAISER_BETA 4.0
+
+UINT GetMipLevelCount(UINT width, UINT height)
+{
+	UINT count = 1;
+	while ((width > 1 || height > 1) && count < D3D12_REQ_MIP_LEVELS) {
+		width = std::max<UINT>(1, width / 2);
+		height = std::max<UINT>(1, height / 2);
+		count++;
+	}
+	return count;
+}
+
+UINT64 GetMipChainLayout(UINT width, UINT height, UINT mipLevels, MipLevel* levels, DXGI_FORMAT format)
+{
+	UINT bitsPerUnit = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetBitsPerUnit(format);
+	UINT blockWidth = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetWidthAlignment(format);
+	UINT blockHeight = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetHeightAlignment(format);
+
+	UINT64 offset = 0;
+	for (UINT mip = 0; mip < mipLevels; mip++) {
+		levels[mip].width = width;
+		levels[mip].height = height;
+		levels[mip].offset = offset;
+		levels[mip].rowPitch = (UINT64)((width + blockWidth - 1) / blockWidth) * bitsPerUnit / 8;
+		levels[mip].rows = (height + blockHeight - 1) / blockHeight;
+		offset += levels[mip].rowPitch * levels[mip].rows;
+		width = std::max<UINT>(1, width / 2);
+		height = std::max<UINT>(1, height / 2);
+	}
+	return offset;
+}
+
+void GenerateMipChain(UINT8* chain, UINT width, UINT height, UINT mipLevels, MIP_FILTER filter)
+{
+	if (filter == MF_NONE) {
+		return;
+	}
+	MipLevel levels[D3D12_REQ_MIP_LEVELS];
+	GetMipChainLayout(width, height, mipLevels, levels);
+	for (UINT mip = 1; mip < mipLevels; mip++) {
+		const MipLevel& src = levels[mip - 1];
+		if (filter == MF_KAISER) DownsampleKaiser(chain + src.offset, src.width, src.height, chain + levels[mip].offset);
+		else DownsampleBox(chain + src.offset, src.width, src.height, chain + levels[mip].offset);
+	}
+}
+
+// Box
+
+// Texels [x0, x1] of rows a and b, rounded to nearest
+static inline void BoxTexel(const UINT8* a, const UINT8* b, UINT x0, UINT x1, UINT8* dst)
+{
+	for (UINT c = 0; c < 4; c++) {
+		dst[c] = (UINT8)((a[x0 * 4 + c] + a[x1 * 4 + c] + b[x0 * 4 + c] + b[x1 * 4 + c] + 2) >> 2);
+	}
+}
+
+void DownsampleBoxScalar(const UINT8* src, UINT srcWidth, UINT srcHeight, UINT8* dst)
+{
+	UINT dstWidth = std::max<UINT>(1, srcWidth / 2), dstHeight = std::max<UINT>(1, srcHeight / 2);
+	for (UINT y = 0; y < dstHeight; y++) {
+		const UINT8* a = src + (size_t)(y * 2) * srcWidth * 4;
+		const UINT8* b = src + (size_t)std::min<UINT>(y * 2 + 1, srcHeight - 1) * srcWidth * 4;
+		for (UINT x = 0; x < dstWidth; x++) {
+			BoxTexel(a, b, x * 2, std::min<UINT>(x * 2 + 1, srcWidth - 1), dst + ((size_t)y * dstWidth + x) * 4);
+		}
+	}
+}
+
+void DownsampleBox(const UINT8* src, UINT srcWidth, UINT srcHeight, UINT8* dst)
+{
+#ifdef MIP_SIMD_SSE2
+	UINT dstWidth = std::max<UINT>(1, srcWidth / 2), dstHeight = std::max<UINT>(1, srcHeight / 2);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi16(2);
+	for (UINT y = 0; y < dstHeight; y++) {
+		const UINT8* a = src + (size_t)(y * 2) * srcWidth * 4;
+		const UINT8* b = src + (size_t)std::min<UINT>(y * 2 + 1, srcHeight - 1) * srcWidth * 4;
+		UINT8* row = dst + (size_t)y * dstWidth * 4;
+
+		// Four destination texels from eight source texels of each row, the sums fit 16 bits
+		UINT x = 0;
+		for (; x + 4 <= dstWidth; x += 4) {
+			__m128i a0 = _mm_loadu_si128((const __m128i*)(a + x * 8));
+			__m128i a1 = _mm_loadu_si128((const __m128i*)(a + x * 8 + 16));
+			__m128i b0 = _mm_loadu_si128((const __m128i*)(b + x * 8));
+			__m128i b1 = _mm_loadu_si128((const __m128i*)(b + x * 8 + 16));
+			__m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+			__m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+			__m128i s45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+			__m128i s67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+			// Even texels plus odd texels
+			__m128i lo = _mm_add_epi16(_mm_unpacklo_epi64(s01, s23), _mm_unpackhi_epi64(s01, s23));
+			__m128i hi = _mm_add_epi16(_mm_unpacklo_epi64(s45, s67), _mm_unpackhi_epi64(s45, s67));
+			lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 2);
+			hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 2);
+			_mm_storeu_si128((__m128i*)(row + x * 4), _mm_packus_epi16(lo, hi));
+		}
+		for (; x < dstWidth; x++) {
+			BoxTexel(a, b, x * 2, std::min<UINT>(x * 2 + 1, srcWidth - 1), row + x * 4);
+		}
+	}
+#else
+	DownsampleBoxScalar(src, srcWidth, srcHeight, dst);
+#endif
+}
+
+// Kaiser
+
+// Source texels and weights for every destination texel along one axis, tapCount each.
+// Taps past the edge are clamped onto it, so the weights always sum to one.
+struct KaiserTaps {
+	UINT tapCount = 0;
+	std::vector<UINT> indices;
+	std::vector<float> weights;
+};
+
+static double BesselI0(double x)
+{
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32 && term > sum * 1e-12; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+static void BuildKaiserTaps(UINT srcSize, UINT dstSize, KaiserTaps* taps)
+{
+	double scale = (double)srcSize / dstSize;
+	double support = KAISER_RADIUS * scale;
+	taps->tapCount = (UINT)std::ceil(support * 2.0) + 1;
+	taps->indices.resize((size_t)dstSize * taps->tapCount);
+	taps->weights.resize((size_t)dstSize * taps->tapCount);
+
+	const double pi = 3.14159265358979323846;
+	double windowScale = 1.0 / BesselI0(KAISER_BETA);
+	for (UINT d = 0; d < dstSize; d++) {
+		double center = (d + 0.5) * scale - 0.5;
+		int first = (int)std::ceil(center - support);
+		double total = 0.0;
+		std::vector<double> weights(taps->tapCount);
+		for (UINT t = 0; t < taps->tapCount; t++) {
+			// Sinc low pass at the destination rate, windowed over the kernel radius
+			double x = (first + (int)t - center) / scale;
+			double window = std::abs(x) < KAISER_RADIUS ? BesselI0(KAISER_BETA * std::sqrt(1.0 - (x / KAISER_RADIUS) * (x / KAISER_RADIUS))) * windowScale : 0.0;
+			double sinc = x == 0.0 ? 1.0 : std::sin(pi * x) / (pi * x);
+			weights[t] = sinc * window;
+			total += weights[t];
+		}
+		for (UINT t = 0; t < taps->tapCount; t++) {
+			int index = std::min<int>(std::max<int>(first + (int)t, 0), (int)srcSize - 1);
+			taps->indices[(size_t)d * taps->tapCount + t] = (UINT)index;
+			taps->weights[(size_t)d * taps->tapCount + t] = (float)(weights[t] / total);
+		}
+	}
+}
+
+static inline UINT8 ToByte(float value) { return (UINT8)(int)std::min<float>(std::max<float>(value + 0.5f, 0.0f), 255.0f); }
+
+void DownsampleKaiserScalar(const UINT8* src, UINT srcWidth, UINT srcHeight, UINT8* dst)
+{
+	UINT dstWidth = std::max<UINT>(1, srcWidth / 2), dstHeight = std::max<UINT>(1, srcHeight / 2);
+	KaiserTaps columns, rows;
+	BuildKaiserTaps(srcWidth, dstWidth, &columns);
+	BuildKaiserTaps(srcHeight, dstHeight, &rows);
+
+	// Horizontal Pass Over Every Source Row
+	std::vector<float> filtered((size_t)srcHeight * dstWidth * 4);
+	for (UINT y = 0; y < srcHeight; y++) {
+		for (UINT x = 0; x < dstWidth; x++) {
+			float acc[4] = {};
+			for (UINT t = 0; t < columns.tapCount; t++) {
+				size_t tap = (size_t)x * columns.tapCount + t;
+				const UINT8* texel = src + ((size_t)y * srcWidth + columns.indices[tap]) * 4;
+				for (UINT c = 0; c < 4; c++) {
+					acc[c] = acc[c] + (float)texel[c] * columns.weights[tap];
+				}
+			}
+			memcpy(&filtered[((size_t)y * dstWidth + x) * 4], acc, sizeof(acc));
+		}
+	}
+
+	// Vertical Pass
+	for (UINT y = 0; y < dstHeight; y++) {
+		for (UINT x = 0; x < dstWidth; x++) {
+			float acc[4] = {};
+			for (UINT t = 0; t < rows.tapCount; t++) {
+				size_t tap = (size_t)y * rows.tapCount + t;
+				const float* texel = &filtered[((size_t)rows.indices[tap] * dstWidth + x) * 4];
+				for (UINT c = 0; c < 4; c++) {
+					acc[c] = acc[c] + texel[c] * rows.weights[tap];
+				}
+			}
+			for (UINT c = 0; c < 4; c++) {
+				dst[((size_t)y * dstWidth + x) * 4 + c] = ToByte(acc[c]);
+			}
+		}
+	}
+}
+
+void DownsampleKaiser(const UINT8* src, UINT srcWidth, UINT srcHeight, UINT8* dst)
+{
+#ifdef MIP_SIMD_SSE2
+	UINT dstWidth = std::max<UINT>(1, srcWidth / 2), dstHeight = std::max<UINT>(1, srcHeight / 2);
+	KaiserTaps columns, rows;
+	BuildKaiserTaps(srcWidth, dstWidth, &columns);
+	BuildKaiserTaps(srcHeight, dstHeight, &rows);
+	const __m128i zero = _mm_setzero_si128();
+
+	// Horizontal Pass, one texel's four channels per register
+	std::vector<float> filtered((size_t)srcHeight * dstWidth * 4);
+	for (UINT y = 0; y < srcHeight; y++) {
+		const UINT8* row = src + (size_t)y * srcWidth * 4;
+		for (UINT x = 0; x < dstWidth; x++) {
+			__m128 acc = _mm_setzero_ps();
+			for (UINT t = 0; t < columns.tapCount; t++) {
+				size_t tap = (size_t)x * columns.tapCount + t;
+				int packed;
+				memcpy(&packed, row + (size_t)columns.indices[tap] * 4, sizeof(packed));
+				__m128i texel = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+				acc = _mm_add_ps(acc, _mm_mul_ps(_mm_cvtepi32_ps(texel), _mm_set1_ps(columns.weights[tap])));
+			}
+			_mm_storeu_ps(&filtered[((size_t)y * dstWidth + x) * 4], acc);
+		}
+	}
+
+	// Vertical Pass
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 maximum = _mm_set1_ps(255.0f);
+	for (UINT y = 0; y < dstHeight; y++) {
+		for (UINT x = 0; x < dstWidth; x++) {
+			__m128 acc = _mm_setzero_ps();
+			for (UINT t = 0; t < rows.tapCount; t++) {
+				size_t tap = (size_t)y * rows.tapCount + t;
+				__m128 texel = _mm_loadu_ps(&filtered[((size_t)rows.indices[tap] * dstWidth + x) * 4]);
+				acc = _mm_add_ps(acc, _mm_mul_ps(texel, _mm_set1_ps(rows.weights[tap])));
+			}
+			acc = _mm_min_ps(_mm_max_ps(_mm_add_ps(acc, half), _mm_setzero_ps()), maximum);
+			__m128i channels = _mm_cvttps_epi32(acc);
+			channels = _mm_packus_epi16(_mm_packs_epi32(channels, channels), zero);
+			int packed = _mm_cvtsi128_si32(channels);
+			memcpy(dst + ((size_t)y * dstWidth + x) * 4, &packed, sizeof(packed));
+		}
+	}
+#else
+	DownsampleKaiserScalar(src, srcWidth, srcHeight, dst);
+#endif
+}
+
+const char* GetMipGeneratorPath()
+{
+#ifdef MIP_SIMD_SSE2
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
\ No newline at end of file
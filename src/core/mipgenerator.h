@@ -0,0 +1,40 @@
+#pragma once
+
+#include "coreconst.h"
+
+// Mip chains for 8-bit four channel textures (RGBA or BGRA), built on the CPU once level 0
+// is decoded. The levels sit back to back with tightly packed rows, level 0 first, so a
+// whole chain is one allocation and each level is one subresource. The instruction set
+// follows IMAGE_SIMD, every path produces the same bytes as the scalar one.
+
+enum MIP_FILTER {
+	MF_NONE = 0,   // Level 0 only
+	MF_BOX = 1,    // 2x2 average, an odd last row or column is dropped
+	MF_KAISER = 2  // Kaiser windowed sinc, sharper and keeps odd edges, for offline cooking
+};
+
+struct MipLevel {
+	UINT width;
+	UINT height;
+	UINT64 offset;
+	UINT64 rowPitch;
+	// Rows of texels, or of 4x4 blocks for block compressed formats
+	UINT rows;
+};
+
+// Levels down to 1x1
+UINT GetMipLevelCount(UINT width, UINT height);
+// Fills one MipLevel per level and returns the size of the whole chain in bytes. Any format
+// lays out the same way, block compressed levels are whole blocks wide and high (as in DDS).
+UINT64 GetMipChainLayout(UINT width, UINT height, UINT mipLevels, MipLevel* levels, DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM);
+// Level 0 must already be at the start of chain, fills every level after it from the one above
+void GenerateMipChain(UINT8* chain, UINT width, UINT height, UINT mipLevels, MIP_FILTER filter);
+
+// One level from the level above, the destination is max(1, size / 2) in each direction
+void DownsampleBox(const UINT8* src, UINT srcWidth, UINT srcHeight, UINT8* dst);
+void DownsampleBoxScalar(const UINT8* src, UINT srcWidth, UINT srcHeight, UINT8* dst);
+void DownsampleKaiser(const UINT8* src, UINT srcWidth, UINT srcHeight, UINT8* dst);
+void DownsampleKaiserScalar(const UINT8* src, UINT srcWidth, UINT srcHeight, UINT8* dst);
+
+// Name of the filter path this build uses
+const char* GetMipGeneratorPath();
\ No newline at end of file
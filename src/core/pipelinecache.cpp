@@ -0,0 +1,460 @@
+#include "pipelinecache.h"
+
+#include <chrono>
+#include <fstream>
+#include <string>
+
+#define PIPELINE_CACHE_MAGIC 0x434F5350 // "PSOC"
+
+// The payload is a serialized pipeline library, or a list of {key, size, blob}
+enum PIPELINE_CACHE_KIND {
+	PCK_BLOBS = 0,
+	PCK_LIBRARY = 1,
+};
+
+struct PipelineCacheHeader {
+	UINT32 magic;
+	UINT32 version;
+	UINT32 kind;
+	UINT32 count;
+	UINT64 size;
+	UINT64 checksum;
+};
+
+static const UINT64 FNV_OFFSET = 0xcbf29ce484222325ull;
+static const UINT64 FNV_PRIME = 0x100000001b3ull;
+
+static UINT64 HashBytes(UINT64 hash, const void* data, size_t size)
+{
+	const UINT8* bytes = static_cast<const UINT8*>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ bytes[i]) * FNV_PRIME;
+	}
+	return hash;
+}
+
+// Only for structs without padding, the rest are hashed a field at a time
+template <class T>
+static UINT64 HashValue(UINT64 hash, const T& value)
+{
+	return HashBytes(hash, &value, sizeof(value));
+}
+
+static UINT64 HashString(UINT64 hash, const char* text)
+{
+	return HashBytes(hash, text ? text : "", (text ? strlen(text) : 0) + 1);
+}
+
+static UINT64 HashShader(UINT64 hash, const D3D12_SHADER_BYTECODE& shader)
+{
+	hash = HashValue(hash, (UINT64)shader.BytecodeLength);
+	return HashBytes(hash, shader.pShaderBytecode, shader.pShaderBytecode ? shader.BytecodeLength : 0);
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Library entries are named by their key
+static std::wstring GetPipelineName(UINT64 key)
+{
+	static const wchar_t digits[] = L"0123456789abcdef";
+	std::wstring name(16, L'0');
+	for (int i = 15; i >= 0; i--, key >>= 4) {
+		name[i] = digits[key & 0xF];
+	}
+	return name;
+}
+
+// The payload of a file this build wrote, false if it is missing, truncated or corrupt
+static bool ReadCacheFile(const std::filesystem::path& path, PipelineCacheHeader* header, std::vector<UINT8>* payload)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file || !file.read(reinterpret_cast<char*>(header), sizeof(*header))) {
+		return false;
+	}
+	if (header->magic != PIPELINE_CACHE_MAGIC || header->version != PIPELINE_CACHE_VERSION) {
+		return false;
+	}
+	// A damaged size must not allocate more than the file holds
+	std::error_code error;
+	UINT64 fileSize = std::filesystem::file_size(path, error);
+	if (error || header->size != fileSize - sizeof(*header)) {
+		return false;
+	}
+	payload->resize((size_t)header->size);
+	if (!file.read(reinterpret_cast<char*>(payload->data()), payload->size()) || HashBytes(FNV_OFFSET, payload->data(), payload->size()) != header->checksum) {
+		payload->clear();
+		return false;
+	}
+	return true;
+}
+
+bool PipelineCache::Init(ID3D12Device* device, const std::filesystem::path& file)
+{
+	UnInit();
+	this->device = device;
+	this->file = file;
+
+	PipelineCacheHeader header = {};
+	std::vector<UINT8> payload;
+	bool valid = ReadCacheFile(file, &header, &payload);
+	if (!valid && std::filesystem::exists(file)) {
+		stats.rejected++;
+	}
+
+	// Create Pipeline Library
+	ID3D12Device1* device1 = nullptr;
+	if (SUCCEEDED(device->QueryInterface(IID_PPV_ARGS(&device1))))
+	{
+		if (valid && header.kind == PCK_LIBRARY)
+		{
+			libraryBlob = std::move(payload);
+			if (FAILED(device1->CreatePipelineLibrary(libraryBlob.data(), libraryBlob.size(), IID_PPV_ARGS(&library)))) {
+				// Written by another driver or adapter
+				library = nullptr;
+				libraryBlob.clear();
+				stats.rejected++;
+			}
+			else {
+				stats.bytesLoaded += libraryBlob.size();
+			}
+		}
+		if (!library && FAILED(device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&library)))) {
+			library = nullptr;
+		}
+		device1->Release();
+	}
+
+	// Without A Library, Read The Cached Blobs
+	if (!library && valid && header.kind == PCK_BLOBS)
+	{
+		size_t offset = 0;
+		for (UINT32 i = 0; i < header.count; i++)
+		{
+			UINT64 entry[2];
+			if (payload.size() - offset < sizeof(entry)) {
+				break;
+			}
+			memcpy(entry, payload.data() + offset, sizeof(entry));
+			offset += sizeof(entry);
+			if (payload.size() - offset < entry[1]) {
+				break;
+			}
+			blobs[entry[0]].assign(payload.begin() + offset, payload.begin() + offset + (size_t)entry[1]);
+			offset += (size_t)entry[1];
+		}
+		stats.bytesLoaded += offset;
+	}
+
+	// A file of the other kind is replaced by the first Save
+	dirty = valid && header.kind != (library ? PCK_LIBRARY : PCK_BLOBS);
+	return true;
+}
+
+void PipelineCache::UnInit()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto& [processKey, entry] : entries) {
+		SAFE_RELEASE(entry.pso);
+	}
+	entries.clear();
+	SAFE_RELEASE(library);
+	libraryBlob.clear();
+	blobs.clear();
+	stats = {};
+	dirty = false;
+	rebuildLibrary = false;
+	device = nullptr;
+}
+
+UINT64 PipelineCache::GetKey(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+	UINT64 hash = FNV_OFFSET;
+	UINT32 version = PIPELINE_CACHE_VERSION;
+	hash = HashValue(hash, version);
+
+	// Shaders
+	hash = HashShader(hash, desc.VS);
+	hash = HashShader(hash, desc.PS);
+	hash = HashShader(hash, desc.DS);
+	hash = HashShader(hash, desc.HS);
+	hash = HashShader(hash, desc.GS);
+
+	// Stream Output
+	hash = HashValue(hash, desc.StreamOutput.NumEntries);
+	for (UINT i = 0; i < desc.StreamOutput.NumEntries; i++)
+	{
+		const D3D12_SO_DECLARATION_ENTRY& entry = desc.StreamOutput.pSODeclaration[i];
+		hash = HashValue(hash, entry.Stream);
+		hash = HashString(hash, entry.SemanticName);
+		hash = HashValue(hash, entry.SemanticIndex);
+		hash = HashValue(hash, entry.StartComponent);
+		hash = HashValue(hash, entry.ComponentCount);
+		hash = HashValue(hash, entry.OutputSlot);
+	}
+	hash = HashValue(hash, desc.StreamOutput.NumStrides);
+	hash = HashBytes(hash, desc.StreamOutput.pBufferStrides, desc.StreamOutput.NumStrides * sizeof(UINT));
+	hash = HashValue(hash, desc.StreamOutput.RasterizedStream);
+
+	// Blend State
+	hash = HashValue(hash, desc.BlendState.AlphaToCoverageEnable);
+	hash = HashValue(hash, desc.BlendState.IndependentBlendEnable);
+	for (const D3D12_RENDER_TARGET_BLEND_DESC& target : desc.BlendState.RenderTarget)
+	{
+		hash = HashValue(hash, target.BlendEnable);
+		hash = HashValue(hash, target.LogicOpEnable);
+		hash = HashValue(hash, target.SrcBlend);
+		hash = HashValue(hash, target.DestBlend);
+		hash = HashValue(hash, target.BlendOp);
+		hash = HashValue(hash, target.SrcBlendAlpha);
+		hash = HashValue(hash, target.DestBlendAlpha);
+		hash = HashValue(hash, target.BlendOpAlpha);
+		hash = HashValue(hash, target.LogicOp);
+		hash = HashValue(hash, target.RenderTargetWriteMask);
+	}
+	hash = HashValue(hash, desc.SampleMask);
+
+	// Rasterizer And Depth State
+	hash = HashValue(hash, desc.RasterizerState);
+	hash = HashValue(hash, desc.DepthStencilState.DepthEnable);
+	hash = HashValue(hash, desc.DepthStencilState.DepthWriteMask);
+	hash = HashValue(hash, desc.DepthStencilState.DepthFunc);
+	hash = HashValue(hash, desc.DepthStencilState.StencilEnable);
+	hash = HashValue(hash, desc.DepthStencilState.StencilReadMask);
+	hash = HashValue(hash, desc.DepthStencilState.StencilWriteMask);
+	hash = HashValue(hash, desc.DepthStencilState.FrontFace);
+	hash = HashValue(hash, desc.DepthStencilState.BackFace);
+
+	// Input Layout
+	hash = HashValue(hash, desc.InputLayout.NumElements);
+	for (UINT i = 0; i < desc.InputLayout.NumElements; i++)
+	{
+		const D3D12_INPUT_ELEMENT_DESC& element = desc.InputLayout.pInputElementDescs[i];
+		hash = HashString(hash, element.SemanticName);
+		hash = HashValue(hash, element.SemanticIndex);
+		hash = HashValue(hash, element.Format);
+		hash = HashValue(hash, element.InputSlot);
+		hash = HashValue(hash, element.AlignedByteOffset);
+		hash = HashValue(hash, element.InputSlotClass);
+		hash = HashValue(hash, element.InstanceDataStepRate);
+	}
+
+	// Topology And Formats
+	hash = HashValue(hash, desc.IBStripCutValue);
+	hash = HashValue(hash, desc.PrimitiveTopologyType);
+	hash = HashValue(hash, desc.NumRenderTargets);
+	hash = HashValue(hash, desc.RTVFormats);
+	hash = HashValue(hash, desc.DSVFormat);
+	hash = HashValue(hash, desc.SampleDesc);
+	hash = HashValue(hash, desc.NodeMask);
+	hash = HashValue(hash, desc.Flags);
+	return hash;
+}
+
+ID3D12PipelineState* PipelineCache::Acquire(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+	UINT64 key = GetKey(desc);
+	UINT64 processKey = HashValue(key, desc.pRootSignature);
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto found = entries.find(processKey);
+		if (found != entries.end())
+		{
+			stats.hits++;
+			found->second.pso->AddRef();
+			return found->second.pso;
+		}
+	}
+
+	// Driver compiles run outside the lock, two threads asking for the same pipeline may
+	// both create it and the second one keeps the first
+	PipelineCacheStats acquireStats;
+	ID3D12PipelineState* pso = Create(desc, key, &acquireStats);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	stats.loaded += acquireStats.loaded;
+	stats.created += acquireStats.created;
+	stats.rejected += acquireStats.rejected;
+	stats.failures += acquireStats.failures;
+	stats.loadMs += acquireStats.loadMs;
+	stats.createMs += acquireStats.createMs;
+	if (!pso) {
+		return nullptr;
+	}
+	auto [found, inserted] = entries.emplace(processKey, Entry{ pso, key });
+	if (!inserted) {
+		pso->Release();
+		pso = found->second.pso;
+	}
+	pso->AddRef();
+	return pso;
+}
+
+ID3D12PipelineState* PipelineCache::Create(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT64 key, PipelineCacheStats* acquireStats)
+{
+	ID3D12PipelineState* pso = nullptr;
+	std::wstring name = GetPipelineName(key);
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC cachedDesc = desc;
+	cachedDesc.CachedPSO = {};
+
+	// Load From The Library Or A Cached Blob
+	auto start = std::chrono::steady_clock::now();
+	std::vector<UINT8> blob;
+	if (library)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (FAILED(library->LoadGraphicsPipeline(name.c_str(), &cachedDesc, IID_PPV_ARGS(&pso)))) {
+			pso = nullptr;
+		}
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto found = blobs.find(key);
+		if (found != blobs.end()) {
+			blob = found->second;
+		}
+	}
+	if (!blob.empty())
+	{
+		cachedDesc.CachedPSO.pCachedBlob = blob.data();
+		cachedDesc.CachedPSO.CachedBlobSizeInBytes = blob.size();
+		if (FAILED(device->CreateGraphicsPipelineState(&cachedDesc, IID_PPV_ARGS(&pso)))) {
+			// Written by another driver or adapter
+			pso = nullptr;
+			acquireStats->rejected++;
+		}
+		cachedDesc.CachedPSO = {};
+	}
+	if (pso)
+	{
+		acquireStats->loaded++;
+		acquireStats->loadMs += MillisecondsSince(start);
+		return pso;
+	}
+
+	// Create PSO
+	start = std::chrono::steady_clock::now();
+	if (FAILED(device->CreateGraphicsPipelineState(&cachedDesc, IID_PPV_ARGS(&pso))))
+	{
+		acquireStats->failures++;
+		return nullptr;
+	}
+	acquireStats->created++;
+	acquireStats->createMs += MillisecondsSince(start);
+
+	// Store What The Driver Compiled
+	std::lock_guard<std::mutex> lock(mutex);
+	if (library)
+	{
+		// The name is taken when the stored pipeline no longer matches, a changed root signature
+		if (FAILED(library->StorePipeline(name.c_str(), pso))) {
+			acquireStats->rejected++;
+			rebuildLibrary = true;
+		}
+		dirty = true;
+	}
+	else
+	{
+		ID3DBlob* cachedBlob = nullptr;
+		if (SUCCEEDED(pso->GetCachedBlob(&cachedBlob)) && cachedBlob)
+		{
+			const UINT8* data = static_cast<const UINT8*>(cachedBlob->GetBufferPointer());
+			blobs[key].assign(data, data + cachedBlob->GetBufferSize());
+			cachedBlob->Release();
+			dirty = true;
+		}
+	}
+	return pso;
+}
+
+bool PipelineCache::RebuildLibrary()
+{
+	ID3D12Device1* device1 = nullptr;
+	if (FAILED(device->QueryInterface(IID_PPV_ARGS(&device1)))) {
+		return false;
+	}
+	ID3D12PipelineLibrary* rebuilt = nullptr;
+	HRESULT result = device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&rebuilt));
+	device1->Release();
+	if (FAILED(result)) {
+		return false;
+	}
+
+	// Only this run's pipelines, the ones stored by earlier runs are dropped with the old library
+	for (auto& [processKey, entry] : entries) {
+		rebuilt->StorePipeline(GetPipelineName(entry.key).c_str(), entry.pso);
+	}
+	SAFE_RELEASE(library);
+	libraryBlob.clear();
+	library = rebuilt;
+	rebuildLibrary = false;
+	return true;
+}
+
+bool PipelineCache::Save()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!dirty) {
+		return true;
+	}
+
+	PipelineCacheHeader header = {};
+	header.magic = PIPELINE_CACHE_MAGIC;
+	header.version = PIPELINE_CACHE_VERSION;
+	std::vector<UINT8> payload;
+	if (library)
+	{
+		if (rebuildLibrary && !RebuildLibrary()) {
+			return false;
+		}
+		header.kind = PCK_LIBRARY;
+		payload.resize(library->GetSerializedSize());
+		if (FAILED(library->Serialize(payload.data(), payload.size()))) {
+			return false;
+		}
+	}
+	else
+	{
+		header.kind = PCK_BLOBS;
+		header.count = (UINT32)blobs.size();
+		for (auto& [key, blob] : blobs)
+		{
+			UINT64 entry[2] = { key, blob.size() };
+			const UINT8* bytes = reinterpret_cast<const UINT8*>(entry);
+			payload.insert(payload.end(), bytes, bytes + sizeof(entry));
+			payload.insert(payload.end(), blob.begin(), blob.end());
+		}
+	}
+	header.size = payload.size();
+	header.checksum = HashBytes(FNV_OFFSET, payload.data(), payload.size());
+
+	std::error_code error;
+	std::filesystem::create_directories(file.parent_path(), error);
+	std::filesystem::path tempPath = file;
+	tempPath += ".tmp";
+	std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+	out.close();
+	if (out.fail()) {
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	std::filesystem::rename(tempPath, file, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	stats.bytesStored += payload.size();
+	dirty = false;
+	return true;
+}
+
+PipelineCacheStats PipelineCache::GetStats()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+// Bump when the file layout or the key changes, older files then just miss
+#define PIPELINE_CACHE_VERSION 1
+
+struct PipelineCacheStats {
+	// Descriptions already created this run
+	UINT64 hits = 0;
+	// Created from a driver blob stored by an earlier run
+	UINT64 loaded = 0;
+	UINT64 created = 0;
+	// Stored blobs the driver refused, a new driver or adapter, or a changed root signature
+	UINT64 rejected = 0;
+	UINT64 failures = 0;
+	UINT64 bytesLoaded = 0;
+	UINT64 bytesStored = 0;
+	double loadMs = 0.0;
+	double createMs = 0.0;
+};
+
+// Graphics pipelines keyed by a hash of their whole description: shader bytecode, input
+// layout, rasterizer, blend and depth state, topology and formats. A description seen before
+// in this run returns the same pipeline. The driver's compiled pipelines are kept in one file
+// between runs, an ID3D12PipelineLibrary when the device has one and otherwise each
+// pipeline's cached blob, so later launches skip the driver compile. Acquire may be called
+// from several threads at once.
+class PipelineCache {
+public:
+	// Reads the file if there is one, a missing or damaged file just starts empty
+	bool Init(ID3D12Device* device, const std::filesystem::path& file);
+	// Releases the cache's references, pipelines handed out stay alive until released
+	void UnInit();
+
+	// The pipeline for the description, with a reference for the caller. The CachedPSO field
+	// is ignored, stored blobs are looked up by key. nullptr if the driver could not create it.
+	ID3D12PipelineState* Acquire(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+	// Writes the file if anything was created since Init, temporary file first
+	bool Save();
+
+	// Same for the same description across runs, the root signature is not part of it
+	static UINT64 GetKey(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+	bool HasLibrary() { return library != nullptr; }
+	PipelineCacheStats GetStats();
+
+private:
+	struct Entry {
+		ID3D12PipelineState* pso = nullptr;
+		UINT64 key = 0;
+	};
+
+	// A stored blob first if there is one, stores what the driver compiled
+	ID3D12PipelineState* Create(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT64 key, PipelineCacheStats* acquireStats);
+	bool RebuildLibrary();
+
+	ID3D12Device* device = nullptr;
+	std::filesystem::path file;
+
+	std::mutex mutex;
+	// Keyed by the description and the root signature it was created with
+	std::unordered_map<UINT64, Entry> entries;
+	PipelineCacheStats stats;
+	bool dirty = false;
+
+	// The library reads its blob in place, so it is kept for as long as the library
+	ID3D12PipelineLibrary* library = nullptr;
+	std::vector<UINT8> libraryBlob;
+	// A stored pipeline that no longer loads cannot be replaced, the library is rebuilt on Save
+	bool rebuildLibrary = false;
+	// Cached blobs by key, without a library
+	std::map<UINT64, std::vector<UINT8>> blobs;
+};
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "resourcemanager.h"
+
+bool ResourceManager::Init(ID3D12Device* device, GpuTimeline* timeline, UINT64 uploadRingSize)
+{
+	this->device = device;
+	if (!gpuAllocator.Init(device)) {
+		return false;
+	}
+	return uploadRing.Init(device, timeline, uploadRingSize);
+}
+
+void ResourceManager::UnInit()
+{
+	uploadRing.UnInit();
+	gpuAllocator.UnInit();
+}
+
+bool ResourceManager::CreateVIBuffer(LPCWSTR resourceName, int bufferSize, GpuAllocation* allocation)
+{
+	if (bufferSize < D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT) {
+		return gpuAllocator.AllocateSmallBuffer(bufferSize, allocation);
+	}
+	return gpuAllocator.CreateBuffer(bufferSize, D3D12_RESOURCE_STATE_COPY_DEST, resourceName, allocation);
+}
+
+bool ResourceManager::UploadVertices(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, std::span<const Vertex> vertices)
+{
+	if (!Upload(commandList, allocation, vertices)) {
+		return false;
+	}
+
+	// Shared pages decay back to COMMON after the submission, no barrier needed
+	if (!allocation.shared) {
+		pendingBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(allocation.resource, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER));
+	}
+	return true;
+}
+
+bool ResourceManager::UploadIndices(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, std::span<const UINT32> indices, DXGI_FORMAT format)
+{
+	if (!UploadIndexBuffer(commandList, allocation, indices, format)) {
+		return false;
+	}
+
+	if (!allocation.shared) {
+		pendingBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(allocation.resource, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_INDEX_BUFFER));
+	}
+	return true;
+}
+
+bool ResourceManager::CreateTexture(Texture* tex, LPCWSTR resourceName, GpuAllocation* allocation, D3D12_RESOURCE_STATES initialState)
+{
+	return gpuAllocator.CreateTexture(tex->GetDesc(), initialState, resourceName, allocation);
+}
+
+bool ResourceManager::UploadTextureResources(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, Texture* tex)
+{
+	D3D12_SUBRESOURCE_DATA subresources[D3D12_REQ_MIP_LEVELS];
+	UINT subresourceCount = tex->GetSubresources(subresources);
+	if (!UploadSubresources(commandList, allocation.resource, 0, subresourceCount, subresources)) {
+		return false;
+	}
+
+	pendingBarriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(allocation.resource, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+	return true;
+}
+
+void ResourceManager::FlushBarriers(ID3D12GraphicsCommandList* commandList)
+{
+	if (pendingBarriers.empty()) {
+		return;
+	}
+	commandList->ResourceBarrier((UINT)pendingBarriers.size(), pendingBarriers.data());
+	pendingBarriers.clear();
+}
+
+bool ResourceManager::UploadBuffer(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, const void* data, UINT64 size, UINT64 dstOffset)
+{
+	return uploadRing.UploadBuffer(commandList, allocation.resource, allocation.offset + dstOffset, data, size);
+}
+
+bool ResourceManager::UploadIndexBuffer(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, std::span<const UINT32> indices, DXGI_FORMAT format, UINT64 dstOffset)
+{
+	return uploadRing.UploadIndices(commandList, allocation.resource, allocation.offset + dstOffset, indices, format);
+}
+
+bool ResourceManager::UploadVertexBuffer(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, std::span<const Vertex> vertices, VERTEX_LAYOUT layout, UINT64 dstOffset)
+{
+	return uploadRing.UploadVertices(commandList, allocation.resource, allocation.offset + dstOffset, vertices, layout);
+}
+
+bool ResourceManager::UploadSubresources(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, UINT firstSubresource, UINT numSubresources, const D3D12_SUBRESOURCE_DATA* data)
+{
+	return uploadRing.UploadSubresources(commandList, resource, firstSubresource, numSubresources, data);
+}
\ No newline at end of file
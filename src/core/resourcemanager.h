@@ -0,0 +1,57 @@
+#pragma once
+
+#include "coreconst.h"
+#include "texture.h"
+#include "gputimeline.h"
+#include "uploadring.h"
+#include "gpuallocator.h"
+
+#include <span>
+
+class ResourceManager {
+
+public:
+	bool Init(ID3D12Device* device, GpuTimeline* timeline, UINT64 uploadRingSize = UPLOAD_RING_SIZE);
+	void UnInit();
+
+	// Buffers under the 64KB placement alignment share pages, larger ones are placed in heap blocks
+	bool CreateVIBuffer(LPCWSTR resourceName, int bufferSize, GpuAllocation* allocation);
+	// Copies sized from the span, the transition to the read state is queued for FlushBarriers()
+	bool UploadVertices(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, std::span<const Vertex> vertices);
+	// Narrows to 16-bit while staging when the format is R16_UINT
+	bool UploadIndices(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, std::span<const UINT32> indices, DXGI_FORMAT format);
+
+	// Textures filled on the copy queue have to start in COMMON
+	bool CreateTexture(Texture* tex, LPCWSTR resourceName, GpuAllocation* allocation, D3D12_RESOURCE_STATES initialState = D3D12_RESOURCE_STATE_COPY_DEST);
+	bool UploadTextureResources(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, Texture* tex);
+
+	// The GPU must be done with the resource
+	void FreeResource(GpuAllocation* allocation) { gpuAllocator.Free(allocation); }
+
+	// Records every transition queued by the uploads in a single barrier call
+	void FlushBarriers(ID3D12GraphicsCommandList* commandList);
+
+	// Stages data through the upload ring and records the copies, resources stay in COPY_DEST
+	template <typename T>
+	bool Upload(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, std::span<const T> data, UINT64 dstOffset = 0)
+	{
+		return UploadBuffer(commandList, allocation, data.data(), data.size_bytes(), dstOffset);
+	}
+	bool UploadBuffer(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, const void* data, UINT64 size, UINT64 dstOffset = 0);
+	bool UploadIndexBuffer(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, std::span<const UINT32> indices, DXGI_FORMAT format, UINT64 dstOffset = 0);
+	bool UploadVertexBuffer(ID3D12GraphicsCommandList* commandList, const GpuAllocation& allocation, std::span<const Vertex> vertices, VERTEX_LAYOUT layout, UINT64 dstOffset = 0);
+	bool UploadSubresources(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, UINT firstSubresource, UINT numSubresources, const D3D12_SUBRESOURCE_DATA* data);
+
+	// Call once the command list holding the recorded uploads has been submitted
+	void FinishUploads(UINT64 ticket) { uploadRing.Close(ticket); }
+	UploadRing* GetUploadRing() { return &uploadRing; }
+	GpuAllocator* GetGpuAllocator() { return &gpuAllocator; }
+
+private:
+
+	ID3D12Device* device = nullptr;
+	UploadRing uploadRing;
+	GpuAllocator gpuAllocator;
+	std::vector<D3D12_RESOURCE_BARRIER> pendingBarriers;
+
+};
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "scene.h"
+
+void Scene::Init(float width, float height)
+{
+	// build projection matrix
+	cameraProjMat = MatrixPerspectiveFovLH(60.0f * (3.14f / 180.0f), width / height, 0.1f, 1000.0f);
+
+	// set starting camera state
+	cameraPosition = Float4(0.0f, 2.0f, -2.0f, 0.0f);
+	cameraTarget = Float4(0.0f, 0.0f, 0.0f, 0.0f);
+	cameraUp = Float4(0.0f, 1.0f, 0.0f, 0.0f);
+
+	// build view matrix
+	cameraViewMat = MatrixLookAtLH(ToFloat3(cameraPosition), ToFloat3(cameraTarget), ToFloat3(cameraUp));
+
+	cubePosition = Float4(0.0f, 0.0f, 0.0f, 0.0f);
+	cubeDefaultRotMat = MatrixIdentity();
+	cubeRotMat = MatrixIdentity();
+	cubeWorldMat = MatrixTranslation(cubePosition.x, cubePosition.y, cubePosition.z);
+
+	planePosition = Float4(0.0f, -0.5f, 0.0f, 0.0f);
+	planeWorldMat = MatrixTranslation(planePosition.x, planePosition.y, planePosition.z);
+
+	cubeConstants = {};
+	planeConstants = {};
+}
+
+void Scene::Update(float dt)
+{
+	// add rotation to cube1's rotation matrix and store it
+	Float4x4 rotMat = cubeRotMat;
+	if (settings.rotateX) {
+		rotMat = MatrixMultiply(rotMat, MatrixRotationX(settings.rotateSpeed * 0.002f * dt));
+	}
+	if (settings.rotateY) {
+		rotMat = MatrixMultiply(rotMat, MatrixRotationY(settings.rotateSpeed * 0.002f * dt));
+	}
+	if (settings.rotateZ) {
+		rotMat = MatrixMultiply(rotMat, MatrixRotationZ(settings.rotateSpeed * 0.002f * dt));
+	}
+	if (settings.resetCube) {
+		settings.rotateX = false;
+		settings.rotateY = false;
+		settings.rotateZ = false;
+		rotMat = cubeDefaultRotMat;
+	}
+	cubeRotMat = rotMat;
+
+	// create cube1's world matrix by first rotating the cube, then positioning the rotated cube
+	cubeWorldMat = MatrixMultiply(rotMat, MatrixTranslation(cubePosition.x, cubePosition.y, cubePosition.z));
+	if (settings.showModel) {
+		cubeWorldMat = MatrixMultiply(MatrixScaling(settings.modelScale, settings.modelScale, settings.modelScale), cubeWorldMat);
+	}
+
+	// create the view projection matrix
+	Float4x4 vpMat = MatrixMultiply(cameraViewMat, cameraProjMat);
+
+	// light matrix for the shadow map pass
+	Float4x4 lightView = MatrixLookAtLH(ToFloat3(settings.lightPosition), ToFloat3(cameraTarget), ToFloat3(cameraUp));
+	Float4x4 lightProj = MatrixOrthographicLH(20, 20, settings.nearPlane, settings.farPlane);
+	Float4x4 lightMat = MatrixMultiply(lightView, lightProj);
+
+	// update constant buffer for cube1 (shaders expect transposed matrices)
+	cubeConstants.wMat = MatrixTranspose(cubeWorldMat);
+	cubeConstants.vpMat = MatrixTranspose(vpMat);
+	cubeConstants.lMat = MatrixTranspose(lightMat);
+	cubeConstants.lDir = settings.lightPosition;
+	cubeConstants.camPos = cameraPosition;
+	cubeConstants.dsaMod = settings.dsaModifiers;
+
+	// plane shares everything but the world matrix
+	planeWorldMat = MatrixTranslation(planePosition.x, planePosition.y, planePosition.z);
+	planeConstants = cubeConstants;
+	planeConstants.wMat = MatrixTranspose(planeWorldMat);
+}
+
+size_t Scene::WriteConstants(UINT8* cbvAddress, int alignedSize)
+{
+	// copy our ConstantBuffer instances to the mapped constant buffer resource
+	memcpy(cbvAddress, &cubeConstants, sizeof(cubeConstants));
+	memcpy(cbvAddress + alignedSize, &planeConstants, sizeof(planeConstants));
+	return sizeof(cubeConstants) + sizeof(planeConstants);
+}
+
+UINT32 Scene::GetPostMask()
+{
+	static const UINT32 postMasks[] = { 0, PK_SHOW_SHADOW_MAP, PK_BOX_BLUR, PK_GAUSSIAN_BLUR };
+	return settings.ppOption < _countof(postMasks) ? postMasks[settings.ppOption] : 0;
+}
+
+UINT32 Scene::GetLightingMask()
+{
+	return (settings.specular ? LK_SPECULAR : 0) | (settings.shadows ? LK_SHADOWS : 0);
+}
\ No newline at end of file
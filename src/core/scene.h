@@ -0,0 +1,93 @@
+#pragma once
+
+#include "coreconst.h"
+
+struct ConstantBufferPerObject {
+	Float4x4 wMat;
+	Float4x4 vpMat;
+	Float4x4 lMat;
+	Float4 lDir;
+	Float4 camPos;
+
+	Float3 dsaMod;
+	// Keeps minLod in the register after dsaMod
+	UINT32 padding;
+	// Finest mip the streamed texture has resident
+	float minLod;
+};
+
+// Keywords of the post process pixel shader, bit i of its variant mask
+enum POST_KEYWORD {
+	PK_SHOW_SHADOW_MAP = 1 << 0,
+	PK_BOX_BLUR = 1 << 1,
+	PK_GAUSSIAN_BLUR = 1 << 2
+};
+
+// Keywords of the lit pixel shader, bit i of its variant mask
+enum LIGHTING_KEYWORD {
+	LK_SPECULAR = 1 << 0,
+	LK_SHADOWS = 1 << 1
+};
+
+// Values edited through the ImGui menu
+struct SceneSettings {
+	Float3 dsaModifiers = {1.0f, 1.0f, 1.0f};
+	bool specular = true, shadows = true;
+	// None, shadow map, box blur or gaussian blur
+	UINT32 ppOption = 0;
+	bool rotateX = false, rotateY = false, rotateZ = false;
+	float rotateSpeed = 1.0f;
+	bool resetCube = false;
+	// Draw the imported model in the cube's place, scaled to the cube's size
+	bool showModel = false;
+	float modelScale = 1.0f;
+	Float4 lightPosition = {2.0f, 2.0f, -2.0f, 0.0f};
+	float nearPlane = 1.0f, farPlane = 7.5f;
+};
+
+class Scene {
+public:
+	void Init(float width, float height);
+	void Update(float dt);
+	// Returns the number of bytes copied into the constant buffer
+	size_t WriteConstants(UINT8* cbvAddress, int alignedSize);
+
+	SceneSettings& GetSettings() { return settings; }
+	// Variant masks of the pixel shaders for the current settings
+	UINT32 GetPostMask();
+	UINT32 GetLightingMask();
+	const ConstantBufferPerObject& GetCubeConstants() { return cubeConstants; }
+	const ConstantBufferPerObject& GetPlaneConstants() { return planeConstants; }
+
+	const Float4x4& GetViewMatrix() { return cameraViewMat; }
+	const Float4x4& GetProjectionMatrix() { return cameraProjMat; }
+	Float3 GetCubePosition() { return ToFloat3(cubePosition); }
+	Float3 GetPlanePosition() { return ToFloat3(planePosition); }
+	// Kept across updates, both draws sample the same texture
+	void SetTextureMinLod(float lod) { cubeConstants.minLod = lod; planeConstants.minLod = lod; }
+
+private:
+
+	SceneSettings settings;
+
+	ConstantBufferPerObject cubeConstants;
+	ConstantBufferPerObject planeConstants;
+
+	// Camera
+	Float4x4 cameraProjMat;
+	Float4x4 cameraViewMat;
+	Float4 cameraPosition;
+	Float4 cameraTarget;
+	Float4 cameraUp;
+
+	// Cube
+	Float4x4 cubeWorldMat;
+	Float4x4 cubeDefaultRotMat;
+	Float4x4 cubeRotMat;
+	Float4 cubePosition;
+
+	// Plane
+	Float4x4 planeWorldMat;
+	Float4 planePosition;
+
+};
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include "shaderbytecode.h"
+
+std::string GetShaderVariantName(const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines)
+{
+	std::string name = path.stem().string() + "." + entry + "." + target;
+	for (const D3D_SHADER_MACRO* define = defines; define && define->Name; define++) {
+		name += std::string(".") + define->Name + "=" + (define->Definition ? define->Definition : "");
+	}
+	return name;
+}
+
+const ShaderBytecodeEntry* FindShaderBytecode(std::span<const ShaderBytecodeEntry> table, const std::string& name)
+{
+	for (const ShaderBytecodeEntry& entry : table)
+	{
+		if (name == entry.name) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
\ No newline at end of file
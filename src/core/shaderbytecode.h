@@ -0,0 +1,22 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <filesystem>
+#include <span>
+#include <string>
+
+// One shader variant compiled at build time and linked into the executable
+struct ShaderBytecodeEntry {
+	const char* name;
+	const UINT8* data;
+	size_t size;
+};
+
+// Name a variant is compiled and looked up under: the file's stem, the entry point, the target
+// profile and each define as NAME=VALUE, joined by dots ("VertexShader.main.vs_5_0.PACKED_VERTICES=1").
+// compile_shader() in the root CMakeLists.txt builds the same names.
+std::string GetShaderVariantName(const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines);
+
+// Null if the variant was not compiled into the table
+const ShaderBytecodeEntry* FindShaderBytecode(std::span<const ShaderBytecodeEntry> table, const std::string& name);
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "shadercache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+#define SHADER_CACHE_MAGIC 0x43485353 // "SSHC"
+
+struct ShaderCacheHeader {
+	UINT32 magic;
+	UINT32 version;
+	UINT64 key;
+	UINT64 size;
+	UINT64 checksum;
+};
+
+static const UINT64 FNV_OFFSET = 0xcbf29ce484222325ull;
+static const UINT64 FNV_PRIME = 0x100000001b3ull;
+
+static UINT64 HashBytes(UINT64 hash, const void* data, size_t size)
+{
+	const UINT8* bytes = static_cast<const UINT8*>(data);
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ bytes[i]) * FNV_PRIME;
+	}
+	return hash;
+}
+
+// Strings are hashed with their terminator, so "ab" + "c" and "a" + "bc" differ
+static UINT64 HashString(UINT64 hash, const char* text)
+{
+	return HashBytes(hash, text ? text : "", (text ? strlen(text) : 0) + 1);
+}
+
+static bool ReadFile(const std::filesystem::path& path, std::string* contents)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	contents->resize((size_t)file.tellg());
+	file.seekg(0);
+	file.read(contents->data(), contents->size());
+	return (bool)file;
+}
+
+// Hashes the file, then every #include it names in the order they appear, resolved next to
+// the including file as the standard include handler does. Each file is hashed once.
+static bool HashSource(const std::filesystem::path& path, std::set<std::filesystem::path>* visited, UINT64* hash)
+{
+	std::filesystem::path normal = path.lexically_normal();
+	if (!visited->insert(normal).second) {
+		return true;
+	}
+	std::string source;
+	if (!ReadFile(normal, &source)) {
+		return false;
+	}
+	*hash = HashString(*hash, normal.generic_string().c_str());
+	*hash = HashBytes(*hash, source.data(), source.size());
+
+	size_t lineStart = 0;
+	while (lineStart < source.size())
+	{
+		size_t lineEnd = source.find('\n', lineStart);
+		if (lineEnd == std::string::npos) {
+			lineEnd = source.size();
+		}
+		size_t pos = source.find_first_not_of(" \t", lineStart);
+		if (pos < lineEnd && source.compare(pos, 8, "#include") == 0)
+		{
+			size_t open = source.find_first_of("\"<", pos + 8);
+			size_t close = open < lineEnd ? source.find_first_of("\">", open + 1) : std::string::npos;
+			if (close < lineEnd && !HashSource(normal.parent_path() / source.substr(open + 1, close - open - 1), visited, hash)) {
+				return false;
+			}
+		}
+		lineStart = lineEnd + 1;
+	}
+	return true;
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool ShaderCache::Init(const std::filesystem::path& directory, ShaderCompileFunc compile, const std::string& compilerTag)
+{
+	this->directory = directory;
+	this->compile = compile;
+	this->compilerTag = compilerTag;
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats = {};
+
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	return std::filesystem::is_directory(directory, error);
+}
+
+UINT64 ShaderCache::GetKey(const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines)
+{
+	UINT64 hash = FNV_OFFSET;
+	UINT32 version = SHADER_CACHE_VERSION;
+	hash = HashBytes(hash, &version, sizeof(version));
+	hash = HashString(hash, compilerTag.c_str());
+	hash = HashString(hash, entry);
+	hash = HashString(hash, target);
+	for (const D3D_SHADER_MACRO* define = defines; define && define->Name; define++) {
+		hash = HashString(hash, define->Name);
+		hash = HashString(hash, define->Definition);
+	}
+
+	std::set<std::filesystem::path> visited;
+	if (!HashSource(path, &visited, &hash)) {
+		return 0;
+	}
+	// 0 is reserved for failure
+	return hash ? hash : 1;
+}
+
+std::filesystem::path ShaderCache::GetEntryPath(UINT64 key)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.cso", (unsigned long long)key);
+	return directory / name;
+}
+
+bool ShaderCache::Load(const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines,
+	std::vector<UINT8>* bytecode, std::string* errors)
+{
+	ShaderCacheStats loadStats;
+	auto start = std::chrono::steady_clock::now();
+	UINT64 key = GetKey(path, entry, target, defines);
+	loadStats.hashMs = MillisecondsSince(start);
+
+	// Missing sources go to the compiler too, for its error message
+	bool succeeded = false;
+	if (key != 0)
+	{
+		start = std::chrono::steady_clock::now();
+		succeeded = ReadEntry(key, bytecode, &loadStats);
+		loadStats.loadMs = MillisecondsSince(start);
+	}
+	if (succeeded)
+	{
+		loadStats.hits = 1;
+		loadStats.bytesLoaded = bytecode->size();
+	}
+	else
+	{
+		loadStats.misses = 1;
+		std::string compileErrors;
+		start = std::chrono::steady_clock::now();
+		succeeded = compile && compile(path, entry, target, defines, bytecode, &compileErrors);
+		loadStats.compileMs = MillisecondsSince(start);
+		if (!succeeded) {
+			loadStats.compileFailures = 1;
+			if (errors) {
+				*errors = compileErrors;
+			}
+		}
+		else if (key != 0 && WriteEntry(key, *bytecode)) {
+			loadStats.bytesStored = bytecode->size();
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.hits += loadStats.hits;
+	stats.misses += loadStats.misses;
+	stats.compileFailures += loadStats.compileFailures;
+	stats.rejected += loadStats.rejected;
+	stats.bytesLoaded += loadStats.bytesLoaded;
+	stats.bytesStored += loadStats.bytesStored;
+	stats.hashMs += loadStats.hashMs;
+	stats.loadMs += loadStats.loadMs;
+	stats.compileMs += loadStats.compileMs;
+	return succeeded;
+}
+
+ShaderCacheStats ShaderCache::GetStats()
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	return stats;
+}
+
+bool ShaderCache::ReadEntry(UINT64 key, std::vector<UINT8>* bytecode, ShaderCacheStats* loadStats)
+{
+	std::filesystem::path entryPath = GetEntryPath(key);
+	std::ifstream file(entryPath, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	ShaderCacheHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+		loadStats->rejected++;
+		return false;
+	}
+	if (header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION || header.key != key) {
+		loadStats->rejected++;
+		return false;
+	}
+	// A damaged size must not allocate more than the file holds
+	std::error_code error;
+	UINT64 fileSize = std::filesystem::file_size(entryPath, error);
+	if (error || header.size != fileSize - sizeof(header)) {
+		loadStats->rejected++;
+		return false;
+	}
+
+	bytecode->resize((size_t)header.size);
+	if (!file.read(reinterpret_cast<char*>(bytecode->data()), bytecode->size()) || HashBytes(FNV_OFFSET, bytecode->data(), bytecode->size()) != header.checksum) {
+		bytecode->clear();
+		loadStats->rejected++;
+		return false;
+	}
+	return true;
+}
+
+bool ShaderCache::WriteEntry(UINT64 key, const std::vector<UINT8>& bytecode)
+{
+	ShaderCacheHeader header = {};
+	header.magic = SHADER_CACHE_MAGIC;
+	header.version = SHADER_CACHE_VERSION;
+	header.key = key;
+	header.size = bytecode.size();
+	header.checksum = HashBytes(FNV_OFFSET, bytecode.data(), bytecode.size());
+
+	std::filesystem::path entryPath = GetEntryPath(key);
+	std::filesystem::path tempPath = entryPath;
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), ".%llu.tmp", (unsigned long long)writeCount++);
+	tempPath += suffix;
+	std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(bytecode.data()), bytecode.size());
+	file.close();
+
+	std::error_code error;
+	if (file.fail()) {
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	std::filesystem::rename(tempPath, entryPath, error);
+	if (error) {
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
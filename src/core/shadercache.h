@@ -0,0 +1,66 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// Bump when the file layout or the key changes, older entries then just miss
+#define SHADER_CACHE_VERSION 1
+
+// Compiles one entry point, errors are only read when it fails
+typedef std::function<bool(const std::filesystem::path& path, const char* entry, const char* target,
+	const D3D_SHADER_MACRO* defines, std::vector<UINT8>* bytecode, std::string* errors)> ShaderCompileFunc;
+
+struct ShaderCacheStats {
+	UINT64 hits = 0;
+	UINT64 misses = 0;
+	UINT64 compileFailures = 0;
+	// Entries that were on disk but truncated or did not match their key
+	UINT64 rejected = 0;
+	UINT64 bytesLoaded = 0;
+	UINT64 bytesStored = 0;
+	double hashMs = 0.0;
+	double loadMs = 0.0;
+	double compileMs = 0.0;
+};
+
+// Compiled shader bytecode kept on disk between launches. Entries are keyed by a hash of
+// the source, every file it includes, the defines, the entry point, the target profile and
+// a tag naming the compiler and its flags, so editing any of them just misses and compiles
+// again. Entries are written to a temporary file and renamed into place, a launch killed
+// mid write never leaves a torn entry behind. Load may be called from several threads at
+// once, as long as the compiler can be.
+class ShaderCache {
+public:
+	// The directory is created if missing. compilerTag should change whenever the compiler's
+	// output would, a different compiler version or different flags.
+	bool Init(const std::filesystem::path& directory, ShaderCompileFunc compile, const std::string& compilerTag);
+
+	// Bytecode from disk, or compiled and stored on a miss. False if the source is missing
+	// or does not compile, the compiler's errors are then in errors.
+	bool Load(const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines,
+		std::vector<UINT8>* bytecode, std::string* errors = nullptr);
+
+	// 0 if the source or an include could not be read
+	UINT64 GetKey(const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines);
+	std::filesystem::path GetEntryPath(UINT64 key);
+
+	ShaderCacheStats GetStats();
+
+private:
+	bool ReadEntry(UINT64 key, std::vector<UINT8>* bytecode, ShaderCacheStats* loadStats);
+	bool WriteEntry(UINT64 key, const std::vector<UINT8>& bytecode);
+
+	std::filesystem::path directory;
+	ShaderCompileFunc compile;
+	std::string compilerTag;
+	// Numbers temporary files, so threads storing the same variant never share one
+	std::atomic<UINT64> writeCount = 0;
+
+	std::mutex statsMutex;
+	ShaderCacheStats stats;
+};
\ No newline at end of file
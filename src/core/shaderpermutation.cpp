@@ -0,0 +1,97 @@
+#include "shaderpermutation.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+
+void ShaderPermutation::Init(const std::string& name, std::initializer_list<const char*> keywords)
+{
+	this->name = name;
+	this->keywords.assign(keywords.begin(), keywords.end());
+	this->keywords.resize(std::min<size_t>(this->keywords.size(), MAX_SHADER_KEYWORDS));
+	exclusiveGroups.clear();
+	variants.assign(GetMaskCount(), VariantStats());
+}
+
+void ShaderPermutation::AddExclusiveGroup(UINT32 bits)
+{
+	exclusiveGroups.push_back(bits);
+}
+
+bool ShaderPermutation::IsValid(UINT32 mask)
+{
+	if (mask >= GetMaskCount()) {
+		return false;
+	}
+	for (UINT32 group : exclusiveGroups)
+	{
+		if (std::popcount(mask & group) > 1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::vector<UINT32> ShaderPermutation::GetMasks()
+{
+	std::vector<UINT32> masks;
+	for (UINT32 mask = 0; mask < GetMaskCount(); mask++)
+	{
+		if (IsValid(mask)) {
+			masks.push_back(mask);
+		}
+	}
+	return masks;
+}
+
+std::vector<D3D_SHADER_MACRO> ShaderPermutation::GetDefines(UINT32 mask, const D3D_SHADER_MACRO* baseDefines)
+{
+	std::vector<D3D_SHADER_MACRO> defines;
+	for (const D3D_SHADER_MACRO* define = baseDefines; define && define->Name; define++) {
+		defines.push_back(*define);
+	}
+	for (size_t i = 0; i < keywords.size(); i++)
+	{
+		if (mask & (1u << i)) {
+			defines.push_back({ keywords[i].c_str(), "1" });
+		}
+	}
+	defines.push_back({ nullptr, nullptr });
+	return defines;
+}
+
+std::string ShaderPermutation::GetVariantLabel(UINT32 mask)
+{
+	std::string label;
+	for (size_t i = 0; i < keywords.size(); i++)
+	{
+		if (mask & (1u << i)) {
+			label += (label.empty() ? "" : "+") + keywords[i];
+		}
+	}
+	return label.empty() ? "default" : label;
+}
+
+void ShaderPermutation::SetVariantStats(UINT32 mask, double compileMs, size_t bytecodeSize)
+{
+	variants[mask].compileMs = compileMs;
+	variants[mask].bytecodeSize = bytecodeSize;
+}
+
+std::string ShaderPermutation::FormatReport()
+{
+	std::string report;
+	char line[256];
+	double totalMs = 0.0;
+	size_t totalSize = 0;
+	std::vector<UINT32> masks = GetMasks();
+	for (UINT32 mask : masks)
+	{
+		snprintf(line, sizeof(line), "  %-40s %8.3f ms %8zu bytes\n", GetVariantLabel(mask).c_str(), variants[mask].compileMs, variants[mask].bytecodeSize);
+		report += line;
+		totalMs += variants[mask].compileMs;
+		totalSize += variants[mask].bytecodeSize;
+	}
+	snprintf(line, sizeof(line), "%s: %zu variants, %.3f ms, %zu bytes\n", name.c_str(), masks.size(), totalMs, totalSize);
+	return line + report;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <initializer_list>
+#include <string>
+
+#define MAX_SHADER_KEYWORDS 8
+
+// Keyword defines of one shader. Bit i of a variant mask defines keywords[i] as 1, every valid
+// mask is compiled up front and draws pick their variant by mask, so an option costs a pipeline
+// switch instead of a branch in every pixel. Keywords in an exclusive group never combine, the
+// blur kernels for example, which keeps the variant count down.
+class ShaderPermutation {
+public:
+	void Init(const std::string& name, std::initializer_list<const char*> keywords);
+	// At most one of the keywords in bits may be set at once
+	void AddExclusiveGroup(UINT32 bits);
+
+	bool IsValid(UINT32 mask);
+	// Every valid mask, 0 first
+	std::vector<UINT32> GetMasks();
+	// One past the largest mask, for tables indexed by mask
+	UINT32 GetMaskCount() { return 1u << keywords.size(); }
+	// Null terminated, the base defines first and then the keywords in bit order
+	std::vector<D3D_SHADER_MACRO> GetDefines(UINT32 mask, const D3D_SHADER_MACRO* baseDefines = nullptr);
+	// The keywords joined by '+', "default" for mask 0
+	std::string GetVariantLabel(UINT32 mask);
+
+	// Filled in once a variant is compiled
+	void SetVariantStats(UINT32 mask, double compileMs, size_t bytecodeSize);
+	// One line per variant with its compile time and bytecode size, then the totals
+	std::string FormatReport();
+
+private:
+	struct VariantStats {
+		double compileMs = 0.0;
+		size_t bytecodeSize = 0;
+	};
+
+	std::string name;
+	std::vector<std::string> keywords;
+	std::vector<UINT32> exclusiveGroups;
+	// Indexed by mask
+	std::vector<VariantStats> variants;
+};
\ No newline at end of file
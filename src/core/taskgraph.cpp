@@ -0,0 +1,115 @@
+#include "taskgraph.h"
+
+#include <cstdio>
+
+static double MillisecondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+	return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+TaskId TaskGraph::Add(const std::string& name, std::function<bool()> work, std::initializer_list<TaskId> dependencies)
+{
+	TaskId id = (TaskId)tasks.size();
+	tasks.emplace_back();
+	tasks.back().work = std::move(work);
+	tasks.back().dependencyCount = (UINT)dependencies.size();
+	for (TaskId dependency : dependencies) {
+		tasks[dependency].dependents.push_back(id);
+	}
+	timings.emplace_back();
+	timings.back().name = name;
+	return id;
+}
+
+bool TaskGraph::Run(WorkerPool* pool)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	start = std::chrono::steady_clock::now();
+	finishedCount = 0;
+	waitingOn.resize(tasks.size());
+	for (TaskId id = 0; id < (TaskId)tasks.size(); id++) {
+		waitingOn[id] = tasks[id].dependencyCount;
+		timings[id].succeeded = false;
+		timings[id].skipped = false;
+	}
+
+	// Roots First, The Rest Are Submitted By The Tasks They Wait On
+	for (TaskId id = 0; id < (TaskId)tasks.size(); id++)
+	{
+		if (waitingOn[id] == 0) {
+			Submit(pool, id);
+		}
+	}
+	finished.wait(lock, [this]() { return finishedCount == (UINT)tasks.size(); });
+	wallMs = MillisecondsBetween(start, std::chrono::steady_clock::now());
+
+	bool succeeded = true;
+	for (const TaskTiming& timing : timings) {
+		succeeded = succeeded && timing.succeeded;
+	}
+	return succeeded;
+}
+
+void TaskGraph::Submit(WorkerPool* pool, TaskId id)
+{
+	pool->Submit([this, pool, id](UINT worker) {
+		auto taskStart = std::chrono::steady_clock::now();
+		bool succeeded = tasks[id].work();
+		auto taskEnd = std::chrono::steady_clock::now();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		TaskTiming& timing = timings[id];
+		timing.startMs = MillisecondsBetween(start, taskStart);
+		timing.durationMs = MillisecondsBetween(taskStart, taskEnd);
+		timing.worker = worker;
+		Finish(pool, id, succeeded);
+	});
+}
+
+void TaskGraph::Finish(WorkerPool* pool, TaskId id, bool succeeded)
+{
+	timings[id].succeeded = succeeded;
+	for (TaskId dependent : tasks[id].dependents)
+	{
+		if (!succeeded)
+		{
+			// Skipped once, by the first dependency to fail
+			if (!timings[dependent].skipped) {
+				timings[dependent].skipped = true;
+				Finish(pool, dependent, false);
+			}
+			continue;
+		}
+		if (--waitingOn[dependent] == 0 && !timings[dependent].skipped) {
+			Submit(pool, dependent);
+		}
+	}
+	finishedCount++;
+	if (finishedCount == (UINT)tasks.size()) {
+		finished.notify_all();
+	}
+}
+
+double TaskGraph::GetSerialMs()
+{
+	double serialMs = 0.0;
+	for (const TaskTiming& timing : timings) {
+		serialMs += timing.durationMs;
+	}
+	return serialMs;
+}
+
+std::string TaskGraph::FormatReport()
+{
+	std::string report;
+	char line[256];
+	for (const TaskTiming& timing : timings)
+	{
+		const char* status = timing.skipped ? " skipped" : (timing.succeeded ? "" : " failed");
+		snprintf(line, sizeof(line), "  %-24s start %8.3f ms, took %8.3f ms on worker %u%s\n",
+			timing.name.c_str(), timing.startMs, timing.durationMs, timing.worker, status);
+		report += line;
+	}
+	snprintf(line, sizeof(line), "%u tasks in %.3f ms, %.3f ms of work\n", (UINT)timings.size(), wallMs, GetSerialMs());
+	return report + line;
+}
\ No newline at end of file
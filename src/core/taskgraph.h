@@ -0,0 +1,65 @@
+#pragma once
+
+#include "coreconst.h"
+#include "workerpool.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+
+typedef UINT32 TaskId;
+
+struct TaskTiming {
+	std::string name;
+	// Relative to the start of Run
+	double startMs = 0.0;
+	double durationMs = 0.0;
+	UINT worker = 0;
+	bool succeeded = false;
+	// Never ran because a dependency failed
+	bool skipped = false;
+};
+
+// Tasks with dependencies, run on a worker pool as soon as everything they depend on has
+// finished. Startup uses it to compile every shader at once and create each pipeline as
+// soon as its shaders are ready. A task that fails skips everything depending on it.
+class TaskGraph {
+public:
+	// Dependencies must have been added before the task
+	TaskId Add(const std::string& name, std::function<bool()> work, std::initializer_list<TaskId> dependencies = {});
+
+	// Blocks until every task finished or was skipped, true if all of them succeeded. The
+	// pool may be running other jobs too, Run only waits for its own tasks.
+	bool Run(WorkerPool* pool);
+
+	const std::vector<TaskTiming>& GetTimings() { return timings; }
+	double GetWallMs() { return wallMs; }
+	// Sum of the task durations, what Run would take on one thread
+	double GetSerialMs();
+	// One line per task with its start, duration and worker, then the totals
+	std::string FormatReport();
+
+private:
+	struct Task {
+		std::function<bool()> work;
+		std::vector<TaskId> dependents;
+		UINT dependencyCount = 0;
+	};
+
+	void Submit(WorkerPool* pool, TaskId id);
+	// Called with the lock held once a task finished, failed tasks skip their dependents
+	void Finish(WorkerPool* pool, TaskId id, bool succeeded);
+
+	std::vector<Task> tasks;
+	std::vector<TaskTiming> timings;
+	double wallMs = 0.0;
+
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::vector<UINT> waitingOn;
+	UINT finishedCount = 0;
+	std::chrono::steady_clock::time_point start;
+};
\ No newline at end of file
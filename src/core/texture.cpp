@@ -0,0 +1,22 @@
+#include "texture.h"
+#include "mipgenerator.h"
+
+void Texture::CleanObsoleteTextureData()
+{
+	if (textureData) {
+		free(textureData);
+		textureData = nullptr;
+	}
+}
+
+UINT Texture::GetSubresources(D3D12_SUBRESOURCE_DATA* subresources)
+{
+	MipLevel levels[D3D12_REQ_MIP_LEVELS];
+	GetMipChainLayout((UINT)textureDesc.Width, textureDesc.Height, textureDesc.MipLevels, levels, textureDesc.Format);
+	for (UINT mip = 0; mip < textureDesc.MipLevels; mip++) {
+		subresources[mip].pData = textureData + levels[mip].offset;
+		subresources[mip].RowPitch = (LONG_PTR)levels[mip].rowPitch;
+		subresources[mip].SlicePitch = (LONG_PTR)(levels[mip].rowPitch * levels[mip].rows);
+	}
+	return textureDesc.MipLevels;
+}
\ No newline at end of file
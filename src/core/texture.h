@@ -0,0 +1,41 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <atomic>
+
+enum TEXTURE_STATE {
+	TS_PENDING = 0,
+	TS_DECODED = 1,
+	TS_FAILED = 2
+};
+
+class Texture {
+
+public:
+
+	void CleanObsoleteTextureData();
+
+	D3D12_RESOURCE_DESC GetDesc() { return textureDesc; }
+	int GetBytesPerRow() { return bytesPerRow; }
+	BYTE* GetData() { return textureData; }
+	int GetSize() { return textureSize; }
+	// One entry per mip level of the chain in GetData, returns the level count
+	UINT GetSubresources(D3D12_SUBRESOURCE_DATA* subresources);
+	// Textures queued for decoding stay pending until a worker is done with them
+	TEXTURE_STATE GetState() { return state; }
+	// Hash of the description and the whole chain, equal for identical images from different files
+	UINT64 GetContentHash() { return contentHash; }
+
+private:
+
+	D3D12_RESOURCE_DESC textureDesc = {};
+	int bytesPerRow = 0;
+	BYTE* textureData = nullptr;
+	int textureSize = 0;
+	UINT64 contentHash = 0;
+	std::atomic<TEXTURE_STATE> state = TS_PENDING;
+
+	friend class TextureLoader;
+
+};
\ No newline at end of file
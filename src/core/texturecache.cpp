@@ -0,0 +1,301 @@
+#include "texturecache.h"
+#include "mipgenerator.h"
+
+#include <algorithm>
+#include <cwctype>
+
+bool TextureCache::Init(ResourceManager* resourceManager, AsyncUploader* uploader, GpuTimeline* timeline, UINT64 budget,
+	UINT decodeThreads, MIP_FILTER mipFilter, bool gpuMips)
+{
+	UnInit();
+	this->resourceManager = resourceManager;
+	this->uploader = uploader;
+	this->timeline = timeline;
+	this->budget = budget;
+	this->gpuMips = gpuMips;
+	return loader.Init(decodeThreads, mipFilter);
+}
+
+void TextureCache::UnInit()
+{
+	// Workers may still be writing into queued textures
+	Texture* decodedTex;
+	while (loader.PopDecoded(&decodedTex, true)) {}
+	loader.UnInit();
+
+	for (Entry& entry : entries)
+	{
+		if (entry.texture) {
+			entry.texture->CleanObsoleteTextureData();
+			delete entry.texture;
+			entry.texture = nullptr;
+		}
+		if (resourceManager) {
+			resourceManager->FreeResource(&entry.allocation);
+		}
+	}
+	entries.clear();
+	pathLookup.clear();
+	contentLookup.clear();
+	decoding.clear();
+	lru.clear();
+	stats = {};
+	resourceManager = nullptr;
+}
+
+std::wstring TextureCache::NormalizePath(const std::filesystem::path& path)
+{
+	std::error_code error;
+	std::filesystem::path absolute = std::filesystem::absolute(path, error);
+	std::wstring normalized = (error ? path : absolute).lexically_normal().generic_wstring();
+#ifdef _WIN32
+	std::transform(normalized.begin(), normalized.end(), normalized.begin(), [](wchar_t c) { return (wchar_t)std::towlower(c); });
+#endif
+	return normalized;
+}
+
+TextureHandle TextureCache::Acquire(const std::filesystem::path& path)
+{
+	std::wstring key = NormalizePath(path);
+	auto found = pathLookup.find(key);
+	TextureHandle handle;
+	if (found != pathLookup.end()) {
+		handle.index = found->second;
+	}
+	else {
+		handle.index = (UINT32)entries.size();
+		entries.emplace_back();
+		entries.back().path = key;
+		pathLookup.emplace(key, handle.index);
+	}
+
+	Entry& entry = entries[handle.index];
+	if (entry.refCount++ == 0 && entry.shared != TEXTURE_HANDLE_INVALID) {
+		entries[entry.shared].sharers++;
+	}
+
+	// Anything not resident or on its way goes back on the decode workers
+	if (entry.state == CS_UNLOADED) {
+		entry.texture = new Texture();
+		entry.state = CS_DECODING;
+		decoding.emplace(entry.texture, handle.index);
+		loader.Queue(entry.texture, entry.path);
+		stats.misses++;
+	}
+	else {
+		stats.hits++;
+	}
+	return handle;
+}
+
+void TextureCache::Release(TextureHandle handle)
+{
+	Entry& entry = entries[handle.index];
+	if (entry.refCount == 0 || --entry.refCount > 0) {
+		return;
+	}
+	if (entry.shared != TEXTURE_HANDLE_INVALID) {
+		entries[entry.shared].sharers--;
+	}
+	// Failed loads are retried by the next Acquire
+	if (entry.state == CS_FAILED) {
+		entry.state = CS_UNLOADED;
+	}
+}
+
+TextureHandle TextureCache::Find(const std::filesystem::path& path)
+{
+	TextureHandle handle;
+	auto found = pathLookup.find(NormalizePath(path));
+	if (found != pathLookup.end()) {
+		handle.index = found->second;
+	}
+	return handle;
+}
+
+TextureCache::Entry& TextureCache::Owner(TextureHandle handle)
+{
+	Entry& entry = entries[handle.index];
+	return entry.shared != TEXTURE_HANDLE_INVALID ? entries[entry.shared] : entry;
+}
+
+void TextureCache::MarkUsed(TextureHandle handle, UINT64 ticket)
+{
+	Entry& owner = Owner(handle);
+	if (owner.state != CS_RESIDENT) {
+		return;
+	}
+	owner.lastUsed = std::max<UINT64>(owner.lastUsed, ticket);
+	lru.splice(lru.begin(), lru, owner.lruPosition);
+}
+
+void TextureCache::Update()
+{
+	// Textures finished mid frame go out in one copy batch
+	UINT64 residentCount = stats.residentCount;
+	Texture* tex;
+	while (loader.PopDecoded(&tex, false)) {
+		Decoded(tex);
+	}
+	if (stats.residentCount != residentCount) {
+		uploader->Flush();
+	}
+	Evict(0);
+}
+
+bool TextureCache::WaitForResident(TextureHandle handle)
+{
+	while (entries[handle.index].state == CS_DECODING)
+	{
+		Texture* tex;
+		if (!loader.PopDecoded(&tex, true)) {
+			return false;
+		}
+		Decoded(tex);
+	}
+	return entries[handle.index].state == CS_RESIDENT;
+}
+
+// Guards the content hash against a collision between differently sized images
+static bool SameShape(const D3D12_RESOURCE_DESC& a, const D3D12_RESOURCE_DESC& b)
+{
+	return a.Format == b.Format && a.Width == b.Width && a.Height == b.Height;
+}
+
+void TextureCache::Decoded(Texture* tex)
+{
+	auto found = decoding.find(tex);
+	UINT32 index = found->second;
+	decoding.erase(found);
+
+	Entry& entry = entries[index];
+	entry.contentHash = tex->GetContentHash();
+	auto match = tex->GetState() == TS_DECODED ? contentLookup.find(entry.contentHash) : contentLookup.end();
+	if (match != contentLookup.end() && !SameShape(entries[match->second].desc, tex->GetDesc())) {
+		match = contentLookup.end();
+	}
+	if (match != contentLookup.end())
+	{
+		// Same image as a resident texture, share its memory and drop the decoded copy
+		Entry& owner = entries[match->second];
+		entry.shared = match->second;
+		entry.state = CS_RESIDENT;
+		owner.sharers += entry.refCount > 0 ? 1 : 0;
+		lru.splice(lru.begin(), lru, owner.lruPosition);
+		stats.deduplicated++;
+	}
+	else if (tex->GetState() != TS_DECODED || !MakeResident(index))
+	{
+		entry.state = entry.refCount > 0 ? CS_FAILED : CS_UNLOADED;
+	}
+
+	entry.texture = nullptr;
+	tex->CleanObsoleteTextureData();
+	delete tex;
+}
+
+bool TextureCache::MakeResident(UINT32 index)
+{
+	Entry& entry = entries[index];
+	Texture* tex = entry.texture;
+	Evict((UINT64)tex->GetSize());
+
+	entry.desc = tex->GetDesc();
+	if (gpuMips) {
+		entry.desc.MipLevels = (UINT16)GetMipLevelCount((UINT)entry.desc.Width, entry.desc.Height);
+		entry.desc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+	}
+
+	// Filled on the copy queue, so it starts in COMMON
+	if (!resourceManager->GetGpuAllocator()->CreateTexture(entry.desc, D3D12_RESOURCE_STATE_COMMON, L"Cached Texture Resource Heap", &entry.allocation)) {
+		return false;
+	}
+	entry.uploadTicket = uploader->UploadTexture(entry.allocation, tex);
+	if (entry.uploadTicket == 0) {
+		resourceManager->FreeResource(&entry.allocation);
+		return false;
+	}
+
+	entry.state = CS_RESIDENT;
+	entry.lastUsed = 0;
+	contentLookup[entry.contentHash] = index;
+	lru.push_front(index);
+	entry.lruPosition = lru.begin();
+	stats.residentBytes += entry.allocation.size;
+	stats.residentCount++;
+
+	// The new texture is still uploading, so only the others can make room
+	Evict(0);
+	return true;
+}
+
+void TextureCache::Evict(UINT64 incoming)
+{
+	auto it = lru.end();
+	while (stats.residentBytes + incoming > budget && it != lru.begin())
+	{
+		--it;
+		Entry& entry = entries[*it];
+		if (entry.refCount > 0 || entry.sharers > 0 || !timeline->IsComplete(entry.lastUsed) || !uploader->IsComplete(entry.uploadTicket)) {
+			continue;
+		}
+		UINT32 index = *it;
+		it = lru.erase(it);
+		Unload(index);
+		stats.evictions++;
+	}
+	if (stats.residentBytes + incoming > budget) {
+		stats.overBudget++;
+	}
+}
+
+void TextureCache::Unload(UINT32 index)
+{
+	Entry& entry = entries[index];
+	stats.residentBytes -= entry.allocation.size;
+	stats.residentCount--;
+	resourceManager->FreeResource(&entry.allocation);
+	contentLookup.erase(entry.contentHash);
+	entry.state = CS_UNLOADED;
+
+	// Entries sharing the memory are unreferenced, or this one would have been pinned
+	for (Entry& other : entries)
+	{
+		if (other.shared == index) {
+			other.shared = TEXTURE_HANDLE_INVALID;
+			other.state = CS_UNLOADED;
+		}
+	}
+}
+
+ID3D12Resource* TextureCache::GetResource(TextureHandle handle)
+{
+	Entry& owner = Owner(handle);
+	return owner.state == CS_RESIDENT ? owner.allocation.resource : nullptr;
+}
+
+D3D12_RESOURCE_DESC TextureCache::GetDesc(TextureHandle handle)
+{
+	return Owner(handle).desc;
+}
+
+UINT64 TextureCache::GetUploadTicket(TextureHandle handle)
+{
+	return Owner(handle).uploadTicket;
+}
+
+bool TextureCache::IsFailed(TextureHandle handle)
+{
+	return entries[handle.index].state == CS_FAILED;
+}
+
+UINT TextureCache::GetRefCount(TextureHandle handle)
+{
+	return entries[handle.index].refCount;
+}
+
+void TextureCache::SetBudget(UINT64 bytes)
+{
+	budget = bytes;
+	Evict(0);
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "coreconst.h"
+#include "texture.h"
+#include "textureloader.h"
+#include "resourcemanager.h"
+#include "asyncuploader.h"
+#include "gputimeline.h"
+
+#include <filesystem>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#define TEXTURE_CACHE_BUDGET (256 * 1024 * 1024)
+#define TEXTURE_HANDLE_INVALID 0xFFFFFFFF
+
+// One per distinct normalized path, stays valid for the lifetime of the cache
+struct TextureHandle {
+	UINT32 index = TEXTURE_HANDLE_INVALID;
+
+	bool IsValid() const { return index != TEXTURE_HANDLE_INVALID; }
+	bool operator==(const TextureHandle& other) const { return index == other.index; }
+};
+
+struct TextureCacheStats {
+	UINT64 hits = 0;
+	UINT64 misses = 0;
+	UINT64 deduplicated = 0;
+	UINT64 evictions = 0;
+	UINT64 residentBytes = 0;
+	UINT64 residentCount = 0;
+	// Times the referenced textures alone were over the budget
+	UINT64 overBudget = 0;
+};
+
+// Textures looked up by normalized path through a hash map and shared through refcounted
+// handles. Decoded images are hashed by content, so a file that decodes to a texture already
+// resident shares its GPU memory instead of uploading a second copy. Textures nobody holds
+// stay resident until the budget is exceeded, then the least recently used go first, once
+// the GPU has retired the last frame that used them.
+class TextureCache {
+public:
+	~TextureCache() { UnInit(); }
+
+	// The timeline is the one draws are submitted on. With gpuMips textures get room and UAV
+	// access for a full chain but only the decoded levels are uploaded, the rest is left to
+	// a compute pass.
+	bool Init(ResourceManager* resourceManager, AsyncUploader* uploader, GpuTimeline* timeline, UINT64 budget = TEXTURE_CACHE_BUDGET,
+		UINT decodeThreads = 0, MIP_FILTER mipFilter = MF_BOX, bool gpuMips = false);
+	// The GPU must be done with every texture
+	void UnInit();
+
+	// Adds a reference, queuing the decode if the texture is not resident yet
+	TextureHandle Acquire(const std::filesystem::path& path);
+	void Release(TextureHandle handle);
+	// No reference is added, invalid if the path was never acquired
+	TextureHandle Find(const std::filesystem::path& path);
+	// Keeps the texture alive until the ticket completes and moves it to the back of the eviction order
+	void MarkUsed(TextureHandle handle, UINT64 ticket);
+
+	// Creates and uploads every texture whose decode finished, then evicts down to the budget
+	void Update();
+	// Blocks until the texture's upload is recorded, false if it failed to load. The upload
+	// stays in the uploader's open batch until the caller flushes it.
+	bool WaitForResident(TextureHandle handle);
+
+	// Null until resident, handles of deduplicated files return the shared resource
+	ID3D12Resource* GetResource(TextureHandle handle);
+	D3D12_RESOURCE_DESC GetDesc(TextureHandle handle);
+	// Copy queue ticket the texture is uploaded at
+	UINT64 GetUploadTicket(TextureHandle handle);
+	bool IsResident(TextureHandle handle) { return GetResource(handle) != nullptr; }
+	bool IsFailed(TextureHandle handle);
+	UINT GetRefCount(TextureHandle handle);
+
+	UINT64 GetBudget() { return budget; }
+	void SetBudget(UINT64 bytes);
+	const TextureCacheStats& GetStats() { return stats; }
+
+	// Absolute, lexically normal and separated with '/', case folded on Windows
+	static std::wstring NormalizePath(const std::filesystem::path& path);
+
+private:
+	enum CACHE_STATE {
+		CS_UNLOADED = 0,
+		CS_DECODING = 1,
+		CS_RESIDENT = 2,
+		CS_FAILED = 3
+	};
+
+	struct Entry {
+		std::filesystem::path path;
+		CACHE_STATE state = CS_UNLOADED;
+		UINT refCount = 0;
+		// Referenced entries deduplicated onto this one, each pins it like a reference
+		UINT sharers = 0;
+		Texture* texture = nullptr;
+		// Set when the content matched another entry, which owns the GPU memory
+		UINT32 shared = TEXTURE_HANDLE_INVALID;
+		UINT64 contentHash = 0;
+		GpuAllocation allocation;
+		D3D12_RESOURCE_DESC desc = {};
+		UINT64 uploadTicket = 0;
+		UINT64 lastUsed = 0;
+		std::list<UINT32>::iterator lruPosition;
+	};
+
+	// Entry holding the GPU memory, the handle's own unless it was deduplicated
+	Entry& Owner(TextureHandle handle);
+	void Decoded(Texture* tex);
+	bool MakeResident(UINT32 index);
+	// Evicts unreferenced textures until another incoming bytes fit the budget
+	void Evict(UINT64 incoming);
+	void Unload(UINT32 index);
+
+	ResourceManager* resourceManager = nullptr;
+	AsyncUploader* uploader = nullptr;
+	GpuTimeline* timeline = nullptr;
+	UINT64 budget = 0;
+	bool gpuMips = false;
+
+	TextureLoader loader;
+	std::vector<Entry> entries;
+	std::unordered_map<std::wstring, UINT32> pathLookup;
+	std::unordered_map<UINT64, UINT32> contentLookup;
+	std::unordered_map<Texture*, UINT32> decoding;
+	// Resident owners, most recently used at the front
+	std::list<UINT32> lru;
+
+	TextureCacheStats stats;
+};
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "textureloader.h"
+
+#include <fstream>
+
+bool TextureLoader::Init(UINT threadCount, MIP_FILTER mipFilter)
+{
+	UnInit();
+	this->mipFilter = mipFilter;
+	if (!workers.Init(threadCount)) {
+		return false;
+	}
+	scratch.resize(workers.GetThreadCount() + 1);
+	return true;
+}
+
+void TextureLoader::UnInit()
+{
+	workers.UnInit();
+	scratch.clear();
+}
+
+// FNV-1a over 64-bit words, the description first so equal bytes in a different shape differ
+static UINT64 HashContent(const D3D12_RESOURCE_DESC& desc, const BYTE* data, size_t size)
+{
+	const UINT64 prime = 0x100000001b3ull;
+	UINT64 hash = 0xcbf29ce484222325ull;
+	UINT64 shape[] = { (UINT64)desc.Format, desc.Width, desc.Height, desc.MipLevels };
+	for (UINT64 value : shape) {
+		hash = (hash ^ value) * prime;
+	}
+	size_t words = size / sizeof(UINT64);
+	for (size_t i = 0; i < words; i++) {
+		UINT64 word;
+		memcpy(&word, data + i * sizeof(UINT64), sizeof(word));
+		hash = (hash ^ word) * prime;
+	}
+	for (size_t i = words * sizeof(UINT64); i < size; i++) {
+		hash = (hash ^ data[i]) * prime;
+	}
+	return hash;
+}
+
+bool TextureLoader::Decode(DecodeScratch* scratch, Texture* tex, const std::filesystem::path& path, MIP_FILTER mipFilter)
+{
+	// Read The Whole File
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	scratch->fileData.resize((size_t)file.tellg());
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char*>(scratch->fileData.data()), scratch->fileData.size())) {
+		return false;
+	}
+
+	// DDS Files Already Hold Their Chain, Possibly Block Compressed
+	DdsInfo dds;
+	if (ReadDdsInfo(scratch->fileData, &dds)) {
+		BYTE* data = (BYTE*)malloc((size_t)dds.dataSize);
+		if (!data) {
+			return false;
+		}
+		memcpy(data, scratch->fileData.data() + dds.dataOffset, (size_t)dds.dataSize);
+		MipLevel level;
+		GetMipChainLayout(dds.width, dds.height, 1, &level, dds.format);
+
+		tex->CleanObsoleteTextureData();
+		tex->textureData = data;
+		tex->bytesPerRow = (int)level.rowPitch;
+		tex->textureSize = (int)dds.dataSize;
+		tex->textureDesc = CD3DX12_RESOURCE_DESC::Tex2D(dds.format, dds.width, dds.height, 1, (UINT16)dds.mipLevels);
+		tex->contentHash = HashContent(tex->textureDesc, data, (size_t)dds.dataSize);
+		return true;
+	}
+
+	// Decode Straight Into Level 0 Of The Texture's Memory
+	ImageInfo info;
+	if (!ImageDecoder::ReadInfo(scratch->fileData, &info)) {
+		return false;
+	}
+	DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	UINT mipLevels = mipFilter == MF_NONE ? 1 : GetMipLevelCount(info.width, info.height);
+	MipLevel levels[D3D12_REQ_MIP_LEVELS];
+	UINT64 size = GetMipChainLayout(info.width, info.height, mipLevels, levels);
+	int bytesPerRow = (int)levels[0].rowPitch;
+	BYTE* data = (BYTE*)malloc((size_t)size);
+	if (!data || !scratch->decoder.Decode(scratch->fileData, format, data, bytesPerRow)) {
+		free(data);
+		return false;
+	}
+
+	// Fill The Rest Of The Chain
+	GenerateMipChain(data, info.width, info.height, mipLevels, mipFilter);
+
+	tex->CleanObsoleteTextureData();
+	tex->textureData = data;
+	tex->bytesPerRow = bytesPerRow;
+	tex->textureSize = (int)size;
+	tex->textureDesc = CD3DX12_RESOURCE_DESC::Tex2D(format, info.width, info.height, 1, (UINT16)mipLevels);
+	tex->contentHash = HashContent(tex->textureDesc, data, (size_t)size);
+	return true;
+}
+
+bool TextureLoader::Load(Texture* tex, const std::filesystem::path& path)
+{
+	bool loaded = Decode(&scratch.back(), tex, path, mipFilter);
+	tex->state = loaded ? TS_DECODED : TS_FAILED;
+	return loaded;
+}
+
+void TextureLoader::Queue(Texture* tex, const std::filesystem::path& path)
+{
+	tex->state = TS_PENDING;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		inFlight++;
+	}
+	workers.Submit([this, tex, path](UINT worker) {
+		bool loaded = Decode(&scratch[worker], tex, path, mipFilter);
+		std::lock_guard<std::mutex> lock(mutex);
+		tex->state = loaded ? TS_DECODED : TS_FAILED;
+		completed.push_back(tex);
+		decoded.notify_all();
+	});
+}
+
+bool TextureLoader::PopDecoded(Texture** tex, bool wait)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (wait) {
+		decoded.wait(lock, [this]() { return !completed.empty() || inFlight == 0; });
+	}
+	if (completed.empty()) {
+		return false;
+	}
+	*tex = completed.front();
+	completed.pop_front();
+	inFlight--;
+	return true;
+}
+
+UINT TextureLoader::GetPendingCount()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return inFlight;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "coreconst.h"
+#include "texture.h"
+#include "imagedecoder.h"
+#include "mipgenerator.h"
+#include "ddsfile.h"
+#include "workerpool.h"
+
+#include <filesystem>
+
+// Decodes image files into Textures, either on the calling thread or queued on a worker
+// pool. Queued textures are handed back in the order their decodes finish, so the caller
+// can create and upload each one while the rest are still decoding. DDS files are taken
+// as they are, block compressed formats and mip chains included.
+class TextureLoader {
+public:
+	~TextureLoader() { UnInit(); }
+
+	// 0 threads means one per hardware thread. Textures come with a full mip chain built
+	// with mipFilter, MF_NONE keeps level 0 only.
+	bool Init(UINT threadCount = 0, MIP_FILTER mipFilter = MF_BOX);
+	// Waits for the queued decodes, textures nobody popped stay decoded
+	void UnInit();
+
+	// Decodes on the calling thread
+	bool Load(Texture* tex, const std::filesystem::path& path);
+	// The texture stays TS_PENDING until a worker has decoded it
+	void Queue(Texture* tex, const std::filesystem::path& path);
+	// Next texture whose decode finished (or failed). Without wait it returns false when
+	// none is ready yet, with wait only once nothing is left in flight.
+	bool PopDecoded(Texture** tex, bool wait);
+
+	// Queued textures not handed back yet
+	UINT GetPendingCount();
+	UINT GetThreadCount() { return workers.GetThreadCount(); }
+
+private:
+	// Per thread decoder and file buffer, reused from one image to the next
+	struct DecodeScratch {
+		ImageDecoder decoder;
+		std::vector<UINT8> fileData;
+	};
+
+	static bool Decode(DecodeScratch* scratch, Texture* tex, const std::filesystem::path& path, MIP_FILTER mipFilter);
+
+	WorkerPool workers;
+	MIP_FILTER mipFilter = MF_BOX;
+	// One per worker, then one for the calling thread
+	std::vector<DecodeScratch> scratch;
+
+	std::mutex mutex;
+	std::condition_variable decoded;
+	std::deque<Texture*> completed;
+	UINT inFlight = 0;
+};
\ No newline at end of file
@@ -0,0 +1,403 @@
+#include "texturestreamer.h"
+
+#include <algorithm>
+#include <cfloat>
+
+bool TextureStreamer::Init(ID3D12Device* device, AsyncUploader* uploader, GpuTimeline* timeline, UINT64 budget, UINT64 uploadBudget)
+{
+	UnInit();
+
+	// Tier 1 is enough as long as shaders never sample an unmapped tile
+	D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+	if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))) ||
+		options.TiledResourcesTier == D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED) {
+		return false;
+	}
+
+	this->device = device;
+	this->uploader = uploader;
+	this->timeline = timeline;
+	this->uploadBudget = uploadBudget;
+	SetBudget(budget);
+	tilesPerHeap = STREAMING_HEAP_SIZE / D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES;
+	return true;
+}
+
+void TextureStreamer::UnInit()
+{
+	for (StreamedTexture& tex : textures)
+	{
+		SAFE_RELEASE(tex.resource);
+	}
+	for (ID3D12Heap*& heap : heaps)
+	{
+		SAFE_RELEASE(heap);
+	}
+	textures.clear();
+	heaps.clear();
+	freeTiles.clear();
+	pendingUnmaps.clear();
+	usedTiles = 0;
+	frame = 0;
+	stats = {};
+	device = nullptr;
+}
+
+UINT TextureStreamer::TileCount(const StreamedTexture& tex, UINT firstMip, UINT endMip)
+{
+	UINT count = 0;
+	for (UINT mip = firstMip; mip < endMip && mip < tex.standardMips; mip++) {
+		count += TileCount(tex, mip);
+	}
+	return count;
+}
+
+bool TextureStreamer::AllocateTiles(UINT count, std::vector<UINT>* out)
+{
+	if (usedTiles + count > budgetTiles) {
+		return false;
+	}
+
+	// Heaps are added as the pool grows, never past the budget
+	while (freeTiles.size() < count)
+	{
+		D3D12_HEAP_DESC heapDesc = {};
+		heapDesc.SizeInBytes = STREAMING_HEAP_SIZE;
+		heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+		heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+		heapDesc.Flags = D3D12_HEAP_FLAG_DENY_BUFFERS | D3D12_HEAP_FLAG_DENY_RT_DS_TEXTURES;
+
+		ID3D12Heap* heap;
+		if (FAILED(device->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap)))) {
+			return false;
+		}
+		heap->SetName(L"Streaming Tile Heap");
+
+		// Lowest tiles on top, so textures fill the first heaps before touching the next
+		UINT first = (UINT)heaps.size() * tilesPerHeap;
+		heaps.push_back(heap);
+		std::vector<UINT> added;
+		for (UINT tile = first + tilesPerHeap; tile > first; tile--) {
+			added.push_back(tile - 1);
+		}
+		freeTiles.insert(freeTiles.begin(), added.begin(), added.end());
+	}
+
+	out->assign(freeTiles.end() - count, freeTiles.end());
+	freeTiles.resize(freeTiles.size() - count);
+	usedTiles += count;
+	return true;
+}
+
+void TextureStreamer::MapTiles(StreamedTexture& tex, UINT mip, const std::vector<UINT>& mapped, bool map)
+{
+	ID3D12CommandQueue* queue = uploader->GetCommandQueue();
+	UINT count = TileCount(tex, mip);
+	bool packed = mip >= tex.standardMips;
+
+	std::vector<D3D12_TILED_RESOURCE_COORDINATE> coordinates(count);
+	for (UINT i = 0; i < count; i++)
+	{
+		if (packed) {
+			coordinates[i] = CD3DX12_TILED_RESOURCE_COORDINATE(i, 0, 0, tex.standardMips);
+		}
+		else {
+			UINT widthInTiles = tex.tilings[mip].WidthInTiles;
+			coordinates[i] = CD3DX12_TILED_RESOURCE_COORDINATE(i % widthInTiles, i / widthInTiles, 0, mip);
+		}
+	}
+	std::vector<D3D12_TILE_REGION_SIZE> sizes(count, CD3DX12_TILE_REGION_SIZE(1, FALSE, 0, 0, 0));
+
+	// Unmapping needs no heap, every tile goes back to NULL in one call
+	if (!map)
+	{
+		D3D12_TILE_RANGE_FLAGS flag = D3D12_TILE_RANGE_FLAG_NULL;
+		queue->UpdateTileMappings(tex.resource, count, coordinates.data(), sizes.data(), nullptr, 1, &flag, nullptr, &count, D3D12_TILE_MAPPING_FLAG_NONE);
+		return;
+	}
+
+	// One call per heap the level's tiles came from
+	for (UINT heap = 0; heap < (UINT)heaps.size(); heap++)
+	{
+		std::vector<D3D12_TILED_RESOURCE_COORDINATE> heapCoordinates;
+		std::vector<UINT> offsets;
+		for (UINT i = 0; i < count; i++)
+		{
+			if (mapped[i] / tilesPerHeap == heap) {
+				heapCoordinates.push_back(coordinates[i]);
+				offsets.push_back(mapped[i] % tilesPerHeap);
+			}
+		}
+		if (offsets.empty()) {
+			continue;
+		}
+
+		UINT ranges = (UINT)offsets.size();
+		std::vector<D3D12_TILE_RANGE_FLAGS> flags(ranges, D3D12_TILE_RANGE_FLAG_NONE);
+		std::vector<UINT> counts(ranges, 1);
+		queue->UpdateTileMappings(tex.resource, ranges, heapCoordinates.data(), sizes.data(), heaps[heap], ranges, flags.data(), offsets.data(), counts.data(), D3D12_TILE_MAPPING_FLAG_NONE);
+	}
+}
+
+UINT32 TextureStreamer::Register(const D3D12_RESOURCE_DESC& desc, const D3D12_SUBRESOURCE_DATA* subresources, LPCWSTR name)
+{
+	HRESULT result;
+
+	// Create Reserved Resource
+	StreamedTexture tex;
+	tex.desc = desc;
+	tex.desc.Layout = D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE;
+	result = device->CreateReservedResource(&tex.desc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&tex.resource));
+	if (FAILED(result)) {
+		return STREAMED_TEXTURE_INVALID;
+	}
+	tex.resource->SetName(name);
+
+	// Get Tile Layout
+	D3D12_PACKED_MIP_INFO packedInfo = {};
+	UINT tilingCount = desc.MipLevels;
+	tex.tilings.resize(tilingCount);
+	device->GetResourceTiling(tex.resource, nullptr, &packedInfo, nullptr, &tilingCount, 0, tex.tilings.data());
+	tex.standardMips = packedInfo.NumStandardMips;
+	tex.packedTiles = packedInfo.NumTilesForPackedMips;
+	tex.tilings.resize(tex.standardMips);
+	tex.tiles.resize(tex.standardMips + 1);
+	tex.source.assign(subresources, subresources + desc.MipLevels);
+
+	tex.residentMip = desc.MipLevels;
+	tex.mappedMip = tex.standardMips;
+	tex.desiredMip = tex.standardMips;
+
+	// Map And Upload The Packed Tail
+	if (tex.packedTiles > 0 && tex.standardMips < desc.MipLevels)
+	{
+		std::vector<UINT>& tail = tex.tiles[tex.standardMips];
+		if (!AllocateTiles(tex.packedTiles, &tail)) {
+			SAFE_RELEASE(tex.resource);
+			return STREAMED_TEXTURE_INVALID;
+		}
+		MapTiles(tex, tex.standardMips, tail, true);
+
+		GpuAllocation allocation;
+		allocation.resource = tex.resource;
+		tex.uploadTicket = uploader->UploadSubresources(allocation, tex.standardMips, desc.MipLevels - tex.standardMips, &tex.source[tex.standardMips]);
+		if (tex.uploadTicket == 0) {
+			freeTiles.insert(freeTiles.end(), tail.begin(), tail.end());
+			usedTiles -= (UINT)tail.size();
+			SAFE_RELEASE(tex.resource);
+			return STREAMED_TEXTURE_INVALID;
+		}
+		tex.tailTicket = tex.uploadTicket;
+	}
+
+	textures.push_back(std::move(tex));
+	stats.residentBytes = (UINT64)usedTiles * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES;
+	stats.peakResidentBytes = std::max<UINT64>(stats.peakResidentBytes, stats.residentBytes);
+	return (UINT32)textures.size() - 1;
+}
+
+void TextureStreamer::Request(UINT32 texture, float screenSize)
+{
+	StreamedTexture& tex = textures[texture];
+	UINT mip = GetMipForScreenSize(tex.desc.Width, tex.desc.Height, tex.desc.MipLevels, screenSize);
+	stats.requests++;
+	if (mip < tex.residentMip) {
+		stats.mipMisses++;
+	}
+	tex.desiredMip = std::min<UINT>(tex.desiredMip, mip);
+	tex.lastRequested = frame;
+}
+
+bool TextureStreamer::Promote(UINT32 texture, UINT mip, UINT64* uploadBytes)
+{
+	StreamedTexture& tex = textures[texture];
+	UINT endMip = tex.mappedMip;
+
+	std::vector<UINT> pool;
+	if (!AllocateTiles(TileCount(tex, mip, endMip), &pool)) {
+		return false;
+	}
+
+	// Split the tiles between the levels and map them ahead of the copy
+	UINT taken = 0;
+	for (UINT level = mip; level < endMip; level++)
+	{
+		UINT count = TileCount(tex, level);
+		tex.tiles[level].assign(pool.begin() + taken, pool.begin() + taken + count);
+		taken += count;
+		MapTiles(tex, level, tex.tiles[level], true);
+	}
+
+	GpuAllocation allocation;
+	allocation.resource = tex.resource;
+	UINT64 ticket = uploader->UploadSubresources(allocation, mip, endMip - mip, &tex.source[mip]);
+	if (ticket == 0)
+	{
+		for (UINT level = mip; level < endMip; level++) {
+			MapTiles(tex, level, tex.tiles[level], false);
+			tex.tiles[level].clear();
+		}
+		freeTiles.insert(freeTiles.end(), pool.begin(), pool.end());
+		usedTiles -= (UINT)pool.size();
+		return false;
+	}
+
+	UINT64 bytes = 0;
+	for (UINT level = mip; level < endMip; level++) {
+		bytes += tex.source[level].SlicePitch;
+	}
+	*uploadBytes += bytes;
+	stats.uploadedBytes += bytes;
+	stats.promotions++;
+
+	tex.mappedMip = mip;
+	tex.uploadTicket = ticket;
+	return true;
+}
+
+void TextureStreamer::Demote(UINT32 texture, UINT mip)
+{
+	StreamedTexture& tex = textures[texture];
+
+	// Frames already submitted may still sample the levels, so their tiles wait for them
+	UINT64 ticket = timeline->GetLastSubmitted();
+	for (UINT level = tex.mappedMip; level < mip; level++)
+	{
+		if (tex.tiles[level].empty()) {
+			continue;
+		}
+		PendingUnmap unmap;
+		unmap.texture = texture;
+		unmap.mip = level;
+		unmap.tiles = std::move(tex.tiles[level]);
+		unmap.ticket = ticket;
+		pendingUnmaps.push_back(std::move(unmap));
+		tex.tiles[level].clear();
+		tex.pendingUnmaps++;
+	}
+
+	tex.mappedMip = mip;
+	tex.residentMip = mip;
+	stats.demotions++;
+}
+
+void TextureStreamer::Update()
+{
+	frame++;
+
+	// Uploaded Levels Become Sampleable
+	for (StreamedTexture& tex : textures)
+	{
+		if (tex.mappedMip < tex.residentMip && uploader->IsComplete(tex.uploadTicket)) {
+			tex.residentMip = tex.mappedMip;
+		}
+	}
+
+	// Unmap Levels No Submitted Frame Samples Anymore
+	while (!pendingUnmaps.empty() && timeline->IsComplete(pendingUnmaps.front().ticket))
+	{
+		PendingUnmap& unmap = pendingUnmaps.front();
+		StreamedTexture& tex = textures[unmap.texture];
+		MapTiles(tex, unmap.mip, unmap.tiles, false);
+		freeTiles.insert(freeTiles.end(), unmap.tiles.begin(), unmap.tiles.end());
+		usedTiles -= (UINT)unmap.tiles.size();
+		tex.pendingUnmaps--;
+		pendingUnmaps.pop_front();
+	}
+
+	// Promote The Blurriest First
+	std::vector<UINT32> wanted;
+	for (UINT32 i = 0; i < (UINT32)textures.size(); i++)
+	{
+		StreamedTexture& tex = textures[i];
+		if (tex.desiredMip < tex.mappedMip && tex.mappedMip == tex.residentMip && tex.pendingUnmaps == 0) {
+			wanted.push_back(i);
+		}
+	}
+	std::sort(wanted.begin(), wanted.end(), [this](UINT32 a, UINT32 b) {
+		return textures[a].mappedMip - textures[a].desiredMip > textures[b].mappedMip - textures[b].desiredMip;
+	});
+
+	UINT64 uploadBytes = 0;
+	UINT stalledTiles = 0;
+	for (UINT32 i : wanted)
+	{
+		if (uploadBytes >= uploadBudget) {
+			break;
+		}
+		StreamedTexture& tex = textures[i];
+		UINT available = budgetTiles > usedTiles ? budgetTiles - usedTiles : 0;
+		UINT target = tex.desiredMip;
+		while (target < tex.mappedMip && TileCount(tex, target, tex.mappedMip) > available) {
+			target++;
+		}
+		if (target > tex.desiredMip) {
+			stalledTiles += TileCount(tex, tex.desiredMip, target);
+			stats.budgetStalls++;
+		}
+		if (target < tex.mappedMip) {
+			Promote(i, target, &uploadBytes);
+		}
+	}
+	if (uploadBytes > 0) {
+		uploader->Flush();
+	}
+
+	// Make Room, Least Recently Requested First
+	UINT overBudget = usedTiles > budgetTiles ? usedTiles - budgetTiles : 0;
+	if (stalledTiles > 0 || overBudget > 0)
+	{
+		std::vector<UINT32> surplus;
+		for (UINT32 i = 0; i < (UINT32)textures.size(); i++)
+		{
+			StreamedTexture& tex = textures[i];
+			if (tex.mappedMip < tex.desiredMip && tex.mappedMip == tex.residentMip) {
+				surplus.push_back(i);
+			}
+		}
+		std::sort(surplus.begin(), surplus.end(), [this](UINT32 a, UINT32 b) {
+			return textures[a].lastRequested < textures[b].lastRequested;
+		});
+
+		UINT needed = stalledTiles + overBudget;
+		UINT freed = 0;
+		for (UINT32 i : surplus)
+		{
+			if (freed >= needed) {
+				break;
+			}
+			StreamedTexture& tex = textures[i];
+			freed += TileCount(tex, tex.mappedMip, tex.desiredMip);
+			Demote(i, tex.desiredMip);
+		}
+	}
+
+	// Requests Start Over Next Frame
+	for (StreamedTexture& tex : textures)
+	{
+		tex.desiredMip = tex.standardMips;
+	}
+
+	stats.residentBytes = (UINT64)usedTiles * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES;
+	stats.peakResidentBytes = std::max<UINT64>(stats.peakResidentBytes, stats.residentBytes);
+}
+
+float TextureStreamer::GetScreenSize(const Float4x4& view, const Float4x4& proj, const Float3& center, float radius, float viewportHeight)
+{
+	// Row vectors, so view space z is the third column
+	float z = center.x * view.m[0][2] + center.y * view.m[1][2] + center.z * view.m[2][2] + view.m[3][2];
+	if (z <= radius) {
+		return FLT_MAX;
+	}
+	return radius * proj.m[1][1] / z * viewportHeight;
+}
+
+UINT TextureStreamer::GetMipForScreenSize(UINT64 width, UINT height, UINT mipLevels, float screenSize)
+{
+	if (screenSize <= 0.0f) {
+		return mipLevels - 1;
+	}
+	float texels = (float)std::max<UINT64>(width, height);
+	UINT mip = texels > screenSize ? (UINT)std::floor(std::log2(texels / screenSize)) : 0;
+	return std::min<UINT>(mip, mipLevels - 1);
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "coreconst.h"
+#include "asyncuploader.h"
+#include "gputimeline.h"
+
+#include <deque>
+
+#define STREAMING_BUDGET (64 * 1024 * 1024)
+#define STREAMING_HEAP_SIZE (16 * 1024 * 1024)
+#define STREAMING_UPLOAD_BUDGET (4 * 1024 * 1024)
+#define STREAMED_TEXTURE_INVALID 0xFFFFFFFF
+
+struct TextureStreamerStats {
+	UINT64 residentBytes = 0;
+	UINT64 peakResidentBytes = 0;
+	UINT64 promotions = 0;
+	UINT64 demotions = 0;
+	UINT64 uploadedBytes = 0;
+	// Draws that asked for a finer mip than the one resident
+	UINT64 requests = 0;
+	UINT64 mipMisses = 0;
+	// Promotions cut short because the budget was full
+	UINT64 budgetStalls = 0;
+};
+
+// Streams mip levels of reserved textures in and out of a pool of 64KB tiles. Registering a
+// texture maps and uploads only its packed tail, the low mips. Draws report how large they
+// appear on screen every frame, and Update maps and uploads the finer levels they need, most
+// blurry first, within a per frame upload budget. When the budget is full, levels finer than
+// anything asked for are unmapped, least recently requested first, once the frames that could
+// sample them have retired. Shaders clamp their LOD to GetResidentMip, so they never sample an
+// unmapped level and the resource and its descriptors never change.
+class TextureStreamer {
+public:
+	bool Init(ID3D12Device* device, AsyncUploader* uploader, GpuTimeline* timeline, UINT64 budget = STREAMING_BUDGET, UINT64 uploadBudget = STREAMING_UPLOAD_BUDGET);
+	// The GPU must be done with every texture
+	void UnInit();
+
+	// Creates the reserved texture and queues its tail, returns STREAMED_TEXTURE_INVALID if the
+	// tail does not fit. The source levels are read whenever a level streams in, so they must
+	// stay valid until UnInit (a mapped asset package).
+	UINT32 Register(const D3D12_RESOURCE_DESC& desc, const D3D12_SUBRESOURCE_DATA* subresources, LPCWSTR name);
+
+	// Feedback from one draw this frame, screenSize is how many pixels the texture spans
+	void Request(UINT32 texture, float screenSize);
+	// Call once per frame after the requests and before the draws are recorded
+	void Update();
+
+	ID3D12Resource* GetResource(UINT32 texture) { return textures[texture].resource; }
+	// Finest level shaders may sample, the mip count until the tail has landed
+	UINT GetResidentMip(UINT32 texture) { return textures[texture].residentMip; }
+	// Copy queue ticket of the tail upload
+	UINT64 GetTailTicket(UINT32 texture) { return textures[texture].tailTicket; }
+	bool IsReady(UINT32 texture) { return textures[texture].residentMip < textures[texture].desc.MipLevels; }
+
+	UINT64 GetBudget() { return budgetTiles * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES; }
+	void SetBudget(UINT64 bytes) { budgetTiles = (UINT)(bytes / D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES); }
+	const TextureStreamerStats& GetStats() { return stats; }
+
+	// Diameter in pixels of a bounding sphere, viewportHeight pixels covering the projection's height
+	static float GetScreenSize(const Float4x4& view, const Float4x4& proj, const Float3& center, float radius, float viewportHeight);
+	// Coarsest level that still has a texel per pixel across screenSize
+	static UINT GetMipForScreenSize(UINT64 width, UINT height, UINT mipLevels, float screenSize);
+
+private:
+	struct StreamedTexture {
+		ID3D12Resource* resource = nullptr;
+		D3D12_RESOURCE_DESC desc = {};
+		std::vector<D3D12_SUBRESOURCE_DATA> source;
+		// Levels below standardMips have their own tiles, the rest share the packed ones
+		UINT standardMips = 0;
+		std::vector<D3D12_SUBRESOURCE_TILING> tilings;
+		UINT packedTiles = 0;
+		// Pool tiles mapped to each standard level, the packed tail last
+		std::vector<std::vector<UINT>> tiles;
+		UINT residentMip = 0;
+		// Finer than residentMip while its levels upload
+		UINT mappedMip = 0;
+		UINT64 uploadTicket = 0;
+		UINT64 tailTicket = 0;
+		UINT desiredMip = 0;
+		UINT64 lastRequested = 0;
+		UINT pendingUnmaps = 0;
+	};
+
+	// Levels of a demoted texture, unmapped once the last frame that could sample them retires
+	struct PendingUnmap {
+		UINT32 texture;
+		UINT mip;
+		std::vector<UINT> tiles;
+		UINT64 ticket;
+	};
+
+	UINT TileCount(const StreamedTexture& tex, UINT mip) { return mip < tex.standardMips ? tex.tilings[mip].WidthInTiles * tex.tilings[mip].HeightInTiles : tex.packedTiles; }
+	UINT TileCount(const StreamedTexture& tex, UINT firstMip, UINT endMip);
+	bool AllocateTiles(UINT count, std::vector<UINT>* out);
+	// Maps (or with no tiles, unmaps) a level on the copy queue, ahead of any upload batched after it
+	void MapTiles(StreamedTexture& tex, UINT mip, const std::vector<UINT>& mapped, bool map);
+	bool Promote(UINT32 texture, UINT mip, UINT64* uploadBytes);
+	void Demote(UINT32 texture, UINT mip);
+
+	ID3D12Device* device = nullptr;
+	AsyncUploader* uploader = nullptr;
+	GpuTimeline* timeline = nullptr;
+	UINT budgetTiles = 0;
+	UINT64 uploadBudget = 0;
+	UINT64 frame = 0;
+
+	// Tile pool, tile i lives in heap i / tilesPerHeap
+	std::vector<ID3D12Heap*> heaps;
+	UINT tilesPerHeap = 0;
+	std::vector<UINT> freeTiles;
+	UINT usedTiles = 0;
+
+	std::vector<StreamedTexture> textures;
+	std::deque<PendingUnmap> pendingUnmaps;
+	TextureStreamerStats stats;
+};
\ No newline at end of file
@@ -0,0 +1,16 @@
+#include "timer.h"
+
+Timer::Timer()
+{
+    lastFrameTime = std::chrono::steady_clock::now();
+}
+
+float Timer::GetFrameDelta()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    frameDelta = std::chrono::duration<float, std::milli>(now - lastFrameTime).count();
+    if (frameDelta > 0)
+        fps = (int)(1000 / frameDelta);
+    lastFrameTime = now;
+    return frameDelta;
+}
\ No newline at end of file
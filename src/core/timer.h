@@ -1,6 +1,6 @@
 #pragma once
 
-#include "gconst.h"
+#include <chrono>
 
 class Timer
 {
@@ -8,9 +8,7 @@ public:
     Timer();
     float GetFrameDelta();
 private:
-    float timerFrequency = 0.0;
-    long long lastFrameTime = 0;
-    long long lastSecond = 0;
+    std::chrono::steady_clock::time_point lastFrameTime;
     float frameDelta = 0;
     int fps = 0;
 };
\ No newline at end of file
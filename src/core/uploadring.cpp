@@ -0,0 +1,207 @@
+#include "uploadring.h"
+
+bool UploadRing::Init(ID3D12Device* device, GpuTimeline* timeline, UINT64 capacity)
+{
+	HRESULT result;
+
+	this->device = device;
+	this->timeline = timeline;
+	this->capacity = capacity;
+	head = tail = closedHead = 0;
+	stats = {};
+	stats.capacity = capacity;
+
+	// Create Upload Heap
+	CD3DX12_HEAP_PROPERTIES uHeapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resoDesc = CD3DX12_RESOURCE_DESC::Buffer(capacity);
+	result = device->CreateCommittedResource(
+		&uHeapProp,
+		D3D12_HEAP_FLAG_NONE,
+		&resoDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&uploadHeap));
+	if (FAILED(result)) {
+		return false;
+	}
+	uploadHeap->SetName(L"Upload Ring Resource Heap");
+
+	// Map once, upload heaps can stay mapped for their whole lifetime
+	CD3DX12_RANGE readRange(0, 0);
+	result = uploadHeap->Map(0, &readRange, reinterpret_cast<void**>(&cpuBase));
+	if (FAILED(result)) {
+		return false;
+	}
+	gpuBase = uploadHeap->GetGPUVirtualAddress();
+
+	return true;
+}
+
+void UploadRing::UnInit()
+{
+	if (uploadHeap) {
+		uploadHeap->Unmap(0, nullptr);
+	}
+	SAFE_RELEASE(uploadHeap);
+	retiredRanges.clear();
+	cpuBase = nullptr;
+}
+
+bool UploadRing::Allocate(UINT64 size, UINT64 alignment, UploadAllocation* allocation)
+{
+	if (size == 0 || size > capacity) {
+		return false;
+	}
+	if (alignment == 0) {
+		alignment = 1;
+	}
+
+	while (true) {
+		// Align inside the ring, skipping to the start if the block would straddle the end
+		UINT64 offset = head % capacity;
+		UINT64 alignedOffset = (offset + alignment - 1) & ~(alignment - 1);
+		UINT64 padding = alignedOffset - offset;
+		if (alignedOffset + size > capacity) {
+			padding = capacity - offset;
+			alignedOffset = 0;
+		}
+
+		if (head + padding + size - tail <= capacity) {
+			if (alignedOffset == 0 && padding > 0) {
+				stats.wraps++;
+			}
+			head += padding + size;
+
+			allocation->resource = uploadHeap;
+			allocation->offset = alignedOffset;
+			allocation->cpuAddress = cpuBase + alignedOffset;
+			allocation->gpuAddress = gpuBase + alignedOffset;
+			allocation->size = size;
+
+			stats.allocations++;
+			stats.bytesAllocated += size;
+			stats.used = head - tail;
+			if (stats.used > stats.highWater) {
+				stats.highWater = stats.used;
+			}
+			return true;
+		}
+
+		// Full, free what the GPU is done with and only then stall on the oldest ticket
+		Reclaim();
+		if (head + padding + size - tail <= capacity) {
+			continue;
+		}
+		if (retiredRanges.empty()) {
+			// Everything left is still being recorded, the caller has to submit first
+			return false;
+		}
+		stats.stalls++;
+		timeline->WaitFor(retiredRanges.front().ticket);
+	}
+}
+
+void UploadRing::Close(UINT64 ticket)
+{
+	if (head == closedHead) {
+		return;
+	}
+	retiredRanges.push_back({ head, ticket });
+	closedHead = head;
+}
+
+void UploadRing::Reclaim()
+{
+	while (!retiredRanges.empty() && timeline->IsComplete(retiredRanges.front().ticket)) {
+		tail = retiredRanges.front().end;
+		retiredRanges.pop_front();
+	}
+	stats.used = head - tail;
+}
+
+bool UploadRing::UploadBuffer(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, UINT64 dstOffset, const void* data, UINT64 size)
+{
+	// Buffer copies only need 4 byte aligned offsets, 16 keeps the memcpy aligned too
+	UploadAllocation staging;
+	if (!Allocate(size, 16, &staging)) {
+		return false;
+	}
+
+	memcpy(staging.cpuAddress, data, (size_t)size);
+	commandList->CopyBufferRegion(resource, dstOffset, staging.resource, staging.offset, size);
+	return true;
+}
+
+bool UploadRing::UploadIndices(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, UINT64 dstOffset, std::span<const UINT32> indices, DXGI_FORMAT format)
+{
+	if (format == DXGI_FORMAT_R32_UINT) {
+		return UploadBuffer(commandList, resource, dstOffset, indices.data(), indices.size_bytes());
+	}
+
+	// Narrow straight into the staging memory, no intermediate copy
+	UINT64 size = indices.size() * sizeof(UINT16);
+	UploadAllocation staging;
+	if (!Allocate(size, 16, &staging)) {
+		return false;
+	}
+	UINT16* narrowed = reinterpret_cast<UINT16*>(staging.cpuAddress);
+	for (size_t i = 0; i < indices.size(); i++) {
+		narrowed[i] = (UINT16)indices[i];
+	}
+	commandList->CopyBufferRegion(resource, dstOffset, staging.resource, staging.offset, size);
+	return true;
+}
+
+bool UploadRing::UploadVertices(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, UINT64 dstOffset, std::span<const Vertex> vertices, VERTEX_LAYOUT layout)
+{
+	UINT64 size = vertices.size() * GetVertexFormat(layout).stride;
+	UploadAllocation staging;
+	if (!Allocate(size, 16, &staging)) {
+		return false;
+	}
+	WriteVertices(vertices, layout, staging.cpuAddress);
+	commandList->CopyBufferRegion(resource, dstOffset, staging.resource, staging.offset, size);
+	return true;
+}
+
+bool UploadRing::UploadSubresources(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, UINT firstSubresource, UINT numSubresources, const D3D12_SUBRESOURCE_DATA* data)
+{
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT layouts[D3D12_REQ_MIP_LEVELS];
+	UINT numRows[D3D12_REQ_MIP_LEVELS];
+	UINT64 rowSizes[D3D12_REQ_MIP_LEVELS];
+	UINT64 totalBytes;
+
+	if (numSubresources == 0 || numSubresources > D3D12_REQ_MIP_LEVELS) {
+		return false;
+	}
+
+	// Size the staging block from the footprints, then place the footprints inside it
+	D3D12_RESOURCE_DESC texDesc = resource->GetDesc();
+	device->GetCopyableFootprints(&texDesc, firstSubresource, numSubresources, 0, nullptr, nullptr, nullptr, &totalBytes);
+
+	UploadAllocation allocation;
+	if (!Allocate(totalBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, &allocation)) {
+		return false;
+	}
+	device->GetCopyableFootprints(&texDesc, firstSubresource, numSubresources, allocation.offset, layouts, numRows, rowSizes, nullptr);
+
+	for (UINT i = 0; i < numSubresources; i++) {
+		// Copy rows into the pitch aligned footprint, or all at once when the source is already pitched
+		D3D12_MEMCPY_DEST dest = {};
+		dest.pData = allocation.cpuAddress + (layouts[i].Offset - allocation.offset);
+		dest.RowPitch = layouts[i].Footprint.RowPitch;
+		dest.SlicePitch = (SIZE_T)layouts[i].Footprint.RowPitch * numRows[i];
+		if ((UINT64)data[i].RowPitch == dest.RowPitch && layouts[i].Footprint.Depth == 1) {
+			memcpy(dest.pData, data[i].pData, (size_t)dest.RowPitch * (numRows[i] - 1) + (size_t)rowSizes[i]);
+		}
+		else {
+			MemcpySubresource(&dest, &data[i], (SIZE_T)rowSizes[i], numRows[i], layouts[i].Footprint.Depth);
+		}
+
+		CD3DX12_TEXTURE_COPY_LOCATION dst(resource, firstSubresource + i);
+		CD3DX12_TEXTURE_COPY_LOCATION src(allocation.resource, layouts[i]);
+		commandList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "coreconst.h"
+#include "gputimeline.h"
+#include "vertexformat.h"
+
+#include <deque>
+#include <span>
+
+struct UploadAllocation {
+	ID3D12Resource* resource = nullptr;
+	UINT64 offset = 0;
+	UINT8* cpuAddress = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;
+	UINT64 size = 0;
+};
+
+struct UploadRingStats {
+	UINT64 capacity = 0;
+	UINT64 used = 0;
+	UINT64 highWater = 0;
+	UINT64 allocations = 0;
+	UINT64 bytesAllocated = 0;
+	UINT64 wraps = 0;
+	UINT64 stalls = 0;
+};
+
+// One persistently mapped upload heap handed out front to back. Allocations made since
+// the last Close() are tagged with the ticket of the submission that reads them, and the
+// space is reclaimed once the timeline reports that ticket complete.
+class UploadRing {
+public:
+	bool Init(ID3D12Device* device, GpuTimeline* timeline, UINT64 capacity);
+	void UnInit();
+
+	// Returns false if the request can never fit, or only fits after submitting open allocations
+	bool Allocate(UINT64 size, UINT64 alignment, UploadAllocation* allocation);
+	// Tags everything allocated since the last Close() with the ticket that retires it
+	void Close(UINT64 ticket);
+	// Frees space whose tickets have completed
+	void Reclaim();
+
+	// Stage data in the ring and record the copies into the destination
+	bool UploadBuffer(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, UINT64 dstOffset, const void* data, UINT64 size);
+	bool UploadSubresources(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, UINT firstSubresource, UINT numSubresources, const D3D12_SUBRESOURCE_DATA* data);
+	// Narrows to 16-bit while staging when the format is R16_UINT
+	bool UploadIndices(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, UINT64 dstOffset, std::span<const UINT32> indices, DXGI_FORMAT format);
+	// Encodes into the layout while staging
+	bool UploadVertices(ID3D12GraphicsCommandList* commandList, ID3D12Resource* resource, UINT64 dstOffset, std::span<const Vertex> vertices, VERTEX_LAYOUT layout);
+
+	ID3D12Resource* GetResource() { return uploadHeap; }
+	const UploadRingStats& GetStats() { return stats; }
+
+private:
+	struct RetiredRange {
+		UINT64 end;
+		UINT64 ticket;
+	};
+
+	ID3D12Device* device = nullptr;
+	GpuTimeline* timeline = nullptr;
+	ID3D12Resource* uploadHeap = nullptr;
+	UINT8* cpuBase = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS gpuBase = 0;
+
+	// Monotonic byte positions, the ring offset is position % capacity
+	UINT64 capacity = 0;
+	UINT64 head = 0;
+	UINT64 tail = 0;
+	UINT64 closedHead = 0;
+	std::deque<RetiredRange> retiredRanges;
+
+	UploadRingStats stats;
+};
\ No newline at end of file
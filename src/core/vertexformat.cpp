@@ -0,0 +1,172 @@
+#include "vertexformat.h"
+
+#include <algorithm>
+#include <cstddef>
+
+static const VertexFormat vertexFormats[] = {
+	// VL_FULL
+	{ VL_FULL, sizeof(Vertex), 3, {
+		{ "POSITION", DXGI_FORMAT_R32G32B32_FLOAT, offsetof(Vertex, pos) },
+		{ "NORMALS", DXGI_FORMAT_R32G32B32_FLOAT, offsetof(Vertex, normals) },
+		{ "TEXCOORD", DXGI_FORMAT_R32G32_FLOAT, offsetof(Vertex, texCoord) } } },
+	// VL_PACKED
+	{ VL_PACKED, sizeof(PackedVertex), 3, {
+		{ "POSITION", DXGI_FORMAT_R16G16B16A16_FLOAT, offsetof(PackedVertex, pos) },
+		{ "NORMALS", DXGI_FORMAT_R16G16_SNORM, offsetof(PackedVertex, normal) },
+		{ "TEXCOORD", DXGI_FORMAT_R16G16_FLOAT, offsetof(PackedVertex, texCoord) } } },
+};
+
+const VertexFormat& GetVertexFormat(VERTEX_LAYOUT layout)
+{
+	return vertexFormats[layout];
+}
+
+D3D12_INPUT_LAYOUT_DESC VertexFormat::GetInputLayout(D3D12_INPUT_ELEMENT_DESC* elements) const
+{
+	for (UINT i = 0; i < attributeCount; i++) {
+		elements[i] = { attributes[i].semantic, 0, attributes[i].format, 0, attributes[i].offset, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 };
+	}
+
+	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc = {};
+	inputLayoutDesc.NumElements = attributeCount;
+	inputLayoutDesc.pInputElementDescs = elements;
+	return inputLayoutDesc;
+}
+
+UINT16 FloatToHalf(float value)
+{
+	UINT32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	UINT16 sign = (UINT16)((bits >> 16) & 0x8000);
+	UINT32 magnitude = bits & 0x7FFFFFFF;
+
+	// Inf & NaN, then anything that rounds past the largest half (65504)
+	if (magnitude >= 0x7F800000) {
+		return sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x200 : 0);
+	}
+	if (magnitude >= 0x477FF000) {
+		return sign | 0x7C00;
+	}
+
+	// Below 2^-14 the half is denormal, its mantissa counts in steps of 2^-24
+	if (magnitude < 0x38800000) {
+		float f;
+		memcpy(&f, &magnitude, sizeof(f));
+		return sign | (UINT16)std::nearbyint(f * 16777216.0f);
+	}
+
+	// Rebias the exponent and round the dropped 13 mantissa bits to nearest even
+	UINT32 half = (magnitude - 0x38000000) >> 13;
+	UINT32 remainder = magnitude & 0x1FFF;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+		half++;
+	}
+	return sign | (UINT16)half;
+}
+
+float HalfToFloat(UINT16 value)
+{
+	UINT32 sign = (UINT32)(value & 0x8000) << 16;
+	UINT32 exponent = (value >> 10) & 0x1F;
+	UINT32 mantissa = value & 0x3FF;
+
+	if (exponent == 0) {
+		float f = (float)mantissa / 16777216.0f;
+		return sign ? -f : f;
+	}
+
+	UINT32 bits = exponent == 0x1F ? sign | 0x7F800000 | (mantissa << 13) : sign | ((exponent + 112) << 23) | (mantissa << 13);
+	float f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+static float SignNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+
+static INT16 ToSnorm16(float v) { return (INT16)std::nearbyint(std::clamp(v, -1.0f, 1.0f) * 32767.0f); }
+
+void EncodeOctahedral(const Float3& normal, INT16* encoded)
+{
+	// Project onto the octahedron, then fold the lower half over the diagonals
+	float l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+	if (l1 <= 0.0f) {
+		encoded[0] = encoded[1] = 0;
+		return;
+	}
+	float x = normal.x / l1, y = normal.y / l1;
+	if (normal.z < 0.0f) {
+		float foldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+		float foldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+		x = foldedX;
+		y = foldedY;
+	}
+	encoded[0] = ToSnorm16(x);
+	encoded[1] = ToSnorm16(y);
+}
+
+Float3 DecodeOctahedral(const INT16* encoded)
+{
+	// Matches the R16G16_SNORM fetch and the decode in VertexShader.hlsl
+	float x = std::max<float>(encoded[0] / 32767.0f, -1.0f);
+	float y = std::max<float>(encoded[1] / 32767.0f, -1.0f);
+	float z = 1.0f - std::fabs(x) - std::fabs(y);
+	float t = std::max<float>(-z, 0.0f);
+	x += x >= 0.0f ? -t : t;
+	y += y >= 0.0f ? -t : t;
+	return Vec3Normalize(Float3(x, y, z));
+}
+
+PackedVertex PackVertex(const Vertex& vertex)
+{
+	PackedVertex packed;
+	packed.pos[0] = FloatToHalf(vertex.pos.x);
+	packed.pos[1] = FloatToHalf(vertex.pos.y);
+	packed.pos[2] = FloatToHalf(vertex.pos.z);
+	packed.pos[3] = FloatToHalf(1.0f);
+	EncodeOctahedral(vertex.normals, packed.normal);
+	packed.texCoord[0] = FloatToHalf(vertex.texCoord.x);
+	packed.texCoord[1] = FloatToHalf(vertex.texCoord.y);
+	return packed;
+}
+
+Vertex UnpackVertex(const PackedVertex& packed)
+{
+	Vertex vertex(HalfToFloat(packed.pos[0]), HalfToFloat(packed.pos[1]), HalfToFloat(packed.pos[2]), HalfToFloat(packed.texCoord[0]), HalfToFloat(packed.texCoord[1]));
+	vertex.normals = DecodeOctahedral(packed.normal);
+	return vertex;
+}
+
+void WriteVertices(std::span<const Vertex> vertices, VERTEX_LAYOUT layout, void* dst)
+{
+	if (layout == VL_FULL) {
+		memcpy(dst, vertices.data(), vertices.size_bytes());
+		return;
+	}
+
+	PackedVertex* packed = reinterpret_cast<PackedVertex*>(dst);
+	for (size_t i = 0; i < vertices.size(); i++) {
+		packed[i] = PackVertex(vertices[i]);
+	}
+}
+
+VertexPackError MeasurePackError(std::span<const Vertex> vertices, std::span<const PackedVertex> packed)
+{
+	VertexPackError error;
+	for (size_t i = 0; i < vertices.size() && i < packed.size(); i++) {
+		const Vertex& source = vertices[i];
+		Vertex decoded = UnpackVertex(packed[i]);
+
+		error.position = std::max<float>({ error.position, std::fabs(decoded.pos.x - source.pos.x), std::fabs(decoded.pos.y - source.pos.y), std::fabs(decoded.pos.z - source.pos.z) });
+		error.texCoord = std::max<float>({ error.texCoord, std::fabs(decoded.texCoord.x - source.texCoord.x), std::fabs(decoded.texCoord.y - source.texCoord.y) });
+
+		// Zero normals have no direction to lose
+		Float3 normal = Vec3Normalize(source.normals);
+		if (Vec3Dot(normal, normal) > 0.0f) {
+			// atan2 keeps precision for tiny angles where acos of the dot product doesn't
+			Float3 cross = Vec3Cross(normal, decoded.normals);
+			float angle = std::atan2(std::sqrt(Vec3Dot(cross, cross)), Vec3Dot(normal, decoded.normals));
+			error.normalDegrees = std::max<float>(error.normalDegrees, angle * (180.0f / 3.14159265f));
+		}
+	}
+	return error;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <span>
+
+enum VERTEX_LAYOUT {
+	VL_FULL = 0,
+	VL_PACKED = 1
+};
+
+// Layout pooled geometry is stored in, picked at configure time
+#ifndef DEFAULT_VERTEX_LAYOUT
+#define DEFAULT_VERTEX_LAYOUT VL_FULL
+#endif
+
+#define MAX_VERTEX_ATTRIBUTES 4
+
+// 16 bytes: half position (w = 1), octahedral normal in two snorm16, half UV
+struct PackedVertex {
+	UINT16 pos[4];
+	INT16 normal[2];
+	UINT16 texCoord[2];
+};
+
+struct VertexAttribute {
+	LPCSTR semantic;
+	DXGI_FORMAT format;
+	UINT offset;
+};
+
+// Describes how a layout reaches the input assembler, the pipelines build their input layout
+// from this rather than repeating it
+struct VertexFormat {
+	VERTEX_LAYOUT layout;
+	UINT stride;
+	UINT attributeCount;
+	VertexAttribute attributes[MAX_VERTEX_ATTRIBUTES];
+
+	// elements must hold MAX_VERTEX_ATTRIBUTES entries and outlive the returned desc
+	D3D12_INPUT_LAYOUT_DESC GetInputLayout(D3D12_INPUT_ELEMENT_DESC* elements) const;
+};
+
+const VertexFormat& GetVertexFormat(VERTEX_LAYOUT layout);
+
+// Largest decode error over a set of packed vertices, normals are compared by direction
+struct VertexPackError {
+	float position = 0.0f;
+	float normalDegrees = 0.0f;
+	float texCoord = 0.0f;
+};
+
+UINT16 FloatToHalf(float value);
+float HalfToFloat(UINT16 value);
+void EncodeOctahedral(const Float3& normal, INT16* encoded);
+Float3 DecodeOctahedral(const INT16* encoded);
+
+PackedVertex PackVertex(const Vertex& vertex);
+Vertex UnpackVertex(const PackedVertex& packed);
+// Writes vertices in the given layout, dst must hold vertices.size() * stride bytes
+void WriteVertices(std::span<const Vertex> vertices, VERTEX_LAYOUT layout, void* dst);
+VertexPackError MeasurePackError(std::span<const Vertex> vertices, std::span<const PackedVertex> packed);
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "workerpool.h"
+
+#include <algorithm>
+
+bool WorkerPool::Init(UINT threadCount)
+{
+	UnInit();
+
+	if (threadCount == 0) {
+		threadCount = std::max<UINT>(1, std::thread::hardware_concurrency());
+	}
+	stopping = false;
+	for (UINT i = 0; i < threadCount; i++) {
+		threads.emplace_back(&WorkerPool::Run, this, i);
+	}
+	return true;
+}
+
+void WorkerPool::UnInit()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	jobQueued.notify_all();
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	threads.clear();
+}
+
+void WorkerPool::Submit(std::function<void(UINT worker)> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(std::move(job));
+	}
+	jobQueued.notify_one();
+}
+
+void WorkerPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	idle.wait(lock, [this]() { return jobs.empty() && busy == 0; });
+}
+
+void WorkerPool::Run(UINT worker)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		jobQueued.wait(lock, [this]() { return stopping || !jobs.empty(); });
+		if (jobs.empty()) {
+			return;
+		}
+
+		// Run The Job Unlocked
+		std::function<void(UINT)> job = std::move(jobs.front());
+		jobs.pop_front();
+		busy++;
+		lock.unlock();
+		job(worker);
+		lock.lock();
+		busy--;
+
+		if (jobs.empty() && busy == 0) {
+			idle.notify_all();
+		}
+	}
+}
\ No newline at end of file
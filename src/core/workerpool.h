@@ -0,0 +1,38 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Fixed set of threads working through a FIFO of jobs. Each job is told which worker runs
+// it, so callers can keep per-worker scratch state without locking.
+class WorkerPool {
+public:
+	~WorkerPool() { UnInit(); }
+
+	// 0 threads means one per hardware thread
+	bool Init(UINT threadCount = 0);
+	// Finishes the queued jobs, then joins the threads
+	void UnInit();
+
+	void Submit(std::function<void(UINT worker)> job);
+	// Blocks until the queue is empty and every worker is idle
+	void Wait();
+
+	UINT GetThreadCount() { return (UINT)threads.size(); }
+
+private:
+	void Run(UINT worker);
+
+	std::vector<std::thread> threads;
+	std::deque<std::function<void(UINT)>> jobs;
+	std::mutex mutex;
+	std::condition_variable jobQueued;
+	std::condition_variable idle;
+	UINT busy = 0;
+	bool stopping = false;
+};
\ No newline at end of file
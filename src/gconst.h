@@ -1,7 +1,6 @@
 #pragma once
 
-// WIC and DirectX 12
-#include <wincodec.h>
+// DirectX 12
 #include <d3d12.h>
 #include <dxgi1_4.h>
 #include <d3dcompiler.h>
@@ -17,16 +16,6 @@
 #include <imgui_impl_sdl3.h>
 
 #define IID_PPV_ARGS(ppType) __uuidof(**(ppType)), IID_PPV_ARGS_Helper(ppType)
-#define SAFE_RELEASE(p) { if ( (p) ) { (p)->Release(); (p) = 0; } }
 
-#define DEFAULT_WINDOW_WIDTH 800
-#define DEFAULT_WINDOW_HEIGHT 600
-
-#define FRAME_BUFFER_COUNT 2
-
-struct Vertex {
-	Vertex(float x, float y, float z, float u, float v) : pos(x, y, z), normals(x, y, z), texCoord(u, v) {}
-	DirectX::XMFLOAT3 pos;
-	DirectX::XMFLOAT3 normals;
-	DirectX::XMFLOAT2 texCoord;
-};
\ No newline at end of file
+// Platform Neutral Core
+#include "coreconst.h"
\ No newline at end of file
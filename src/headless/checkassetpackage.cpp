@@ -0,0 +1,105 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "mockcommandlist.h"
+#include "gputimeline.h"
+#include "resourcemanager.h"
+#include "geometrypool.h"
+#include "assetpackage.h"
+#include "texture.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+bool CheckAssetPackage(ResourceManager* resourceManager, GpuTimeline* timeline, MockCommandList* commandList)
+{
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "headless_assets.pak";
+
+	std::vector<Vertex> vertices;
+	for (int i = 0; i < 300; i++) {
+		vertices.push_back(Vertex((float)i, (float)(i % 13), 1.0f, (float)(i % 3), 0.5f));
+	}
+	std::vector<UINT32> indices;
+	for (UINT32 i = 0; i < 900; i++) {
+		indices.push_back((i * 7) % (UINT32)vertices.size());
+	}
+
+	// 37 texels per row is 148 bytes, the package stores 256 byte pitched rows
+	AssetTextureInfo textureInfo = { 37, 21, 2, DXGI_FORMAT_R8G8B8A8_UNORM };
+	std::vector<UINT8> texels[2];
+	D3D12_SUBRESOURCE_DATA source[2];
+	for (UINT mip = 0; mip < 2; mip++) {
+		UINT width = textureInfo.width >> mip, height = textureInfo.height >> mip;
+		texels[mip].resize(width * height * 4);
+		for (size_t i = 0; i < texels[mip].size(); i++) {
+			texels[mip][i] = (UINT8)(i * 31 + mip);
+		}
+		source[mip] = { texels[mip].data(), (LONG_PTR)width * 4, (LONG_PTR)(width * height * 4) };
+	}
+	const UINT8 bytecode[] = { 'D', 'X', 'B', 'C', 1, 2, 3 };
+
+	AssetPackageWriter writer;
+	bool valid = writer.AddMesh("Grid", vertices, indices) && writer.AddTexture("Noise", textureInfo, source) &&
+		writer.AddShader("Pixel", bytecode) && writer.Write(path);
+
+	AssetPackage package;
+	valid = valid && package.Open(path) && package.GetEntries().size() == 3;
+	const AssetEntry* mesh = valid ? package.Find("Grid", AT_MESH) : nullptr;
+	const AssetEntry* texture = valid ? package.Find("Noise", AT_TEXTURE) : nullptr;
+	const AssetEntry* shader = valid ? package.Find("Pixel", AT_SHADER) : nullptr;
+	valid = valid && mesh && texture && shader && !package.Find("Grid", AT_TEXTURE);
+	for (const AssetEntry& entry : valid ? package.GetEntries() : std::span<const AssetEntry>()) {
+		valid = valid && entry.offset % ASSET_PACKAGE_ALIGNMENT == 0;
+	}
+	if (!valid) {
+		std::error_code error;
+		std::filesystem::remove(path, error);
+		return false;
+	}
+
+	std::span<const Vertex> mappedVertices = package.GetVertices(*mesh);
+	std::span<const UINT32> mappedIndices = package.GetIndices(*mesh);
+	std::span<const UINT8> mappedBytecode = package.GetData(*shader);
+	valid = mappedVertices.size() == vertices.size() && memcmp(mappedVertices.data(), vertices.data(), vertices.size() * sizeof(Vertex)) == 0;
+	valid = valid && std::equal(mappedIndices.begin(), mappedIndices.end(), indices.begin(), indices.end());
+	valid = valid && std::equal(mappedBytecode.begin(), mappedBytecode.end(), std::begin(bytecode), std::end(bytecode));
+
+	// Rows come back pitched for the upload heap with the source texels in front
+	D3D12_SUBRESOURCE_DATA subresources[D3D12_REQ_MIP_LEVELS];
+	valid = valid && package.GetSubresources(*texture, subresources) == 2;
+	for (UINT mip = 0; mip < 2 && valid; mip++) {
+		valid = subresources[mip].RowPitch % D3D12_TEXTURE_DATA_PITCH_ALIGNMENT == 0;
+		for (UINT row = 0; row < (textureInfo.height >> mip) && valid; row++) {
+			valid = memcmp(static_cast<const UINT8*>(subresources[mip].pData) + row * subresources[mip].RowPitch,
+				texels[mip].data() + row * source[mip].RowPitch, (size_t)source[mip].RowPitch) == 0;
+		}
+	}
+
+	// Upload both straight from the mapping
+	GeometryPool pool;
+	GpuAllocation textureAllocation;
+	D3D12_RESOURCE_DESC textureDesc = package.GetTextureDesc(*texture);
+	commandList->Reset(nullptr, nullptr);
+	valid = valid && pool.Init(resourceManager, 1024, 1024, 0, VL_FULL);
+	MeshHandle handle;
+	valid = valid && pool.AddMesh(commandList, mappedVertices, mappedIndices, &handle);
+	valid = valid && resourceManager->GetGpuAllocator()->CreateTexture(textureDesc, D3D12_RESOURCE_STATE_COPY_DEST, L"Packaged Texture", &textureAllocation);
+	valid = valid && resourceManager->UploadSubresources(commandList, textureAllocation.resource, 0, 2, subresources);
+	const UINT8* staged = static_cast<MockResource*>(commandList->GetLastCopySource())->GetStorage() + commandList->GetLastCopySourceOffset();
+	valid = valid && memcmp(staged, subresources[1].pData, (size_t)subresources[1].SlicePitch) == 0;
+	ExecuteAndWait(resourceManager, timeline, commandList);
+	const UINT8* pooled = static_cast<MockResource*>(pool.GetVertexBuffer().resource)->GetStorage() + pool.GetVertexBuffer().offset;
+	valid = valid && memcmp(pooled + handle.baseVertex * sizeof(Vertex), vertices.data(), vertices.size() * sizeof(Vertex)) == 0;
+	commandList->Close();
+
+	printf("headless: asset package %zu entries, %llu bytes mapped, texture blob %llu bytes at offset %llu\n",
+		package.GetEntries().size(), (unsigned long long)std::filesystem::file_size(path),
+		(unsigned long long)texture->size, (unsigned long long)texture->offset);
+
+	resourceManager->FreeResource(&textureAllocation);
+	pool.UnInit();
+	package.Close();
+	std::error_code error;
+	std::filesystem::remove(path, error);
+	return valid;
+}
\ No newline at end of file
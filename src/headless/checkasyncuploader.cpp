@@ -0,0 +1,121 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "resourcemanager.h"
+#include "geometrypool.h"
+#include "asyncuploader.h"
+
+#include <cstdio>
+
+bool CheckAsyncUploader(HeadlessDevice* device, ResourceManager* resourceManager, ID3D12CommandQueue* directQueue)
+{
+	AsyncUploader uploader;
+	if (!uploader.Init(device, 1024 * 1024, 256 * 1024)) {
+		return false;
+	}
+	static_cast<MockCommandQueue*>(uploader.GetCommandQueue())->SetLatency(4);
+
+	GeometryPool pool;
+	if (!pool.Init(resourceManager, 1024, 1024)) {
+		return false;
+	}
+	std::vector<Vertex> vertices(24, Vertex(1.0f, 2.0f, 3.0f, 0.0f, 0.0f));
+	std::vector<UINT32> indices(36, 7);
+	MeshHandle mesh;
+	if (!uploader.UploadMesh(&pool, vertices, indices, &mesh)) {
+		return false;
+	}
+	UINT64 geometryTicket = uploader.Flush();
+
+	// Assets in COMMON, filled with their own index. Twelve of them do not fit the ring, so it
+	// wraps onto slots whose copies are still queued and has to wait on the copy timeline first
+	const int assetCount = 12;
+	const UINT64 assetSize = 96 * 1024;
+	std::vector<GpuAllocation> assets(assetCount);
+	std::vector<UINT64> tickets(assetCount);
+	std::vector<UINT8> data((size_t)assetSize);
+	int stagedBeforeWrap = 0;
+	for (int i = 0; i < assetCount; i++)
+	{
+		memset(data.data(), i + 1, data.size());
+		if (!resourceManager->GetGpuAllocator()->CreateBuffer(assetSize, D3D12_RESOURCE_STATE_COMMON, L"Async Asset", &assets[i])) {
+			return false;
+		}
+		tickets[i] = uploader.UploadBuffer(assets[i], data.data(), assetSize);
+		if (tickets[i] == 0) {
+			return false;
+		}
+		stagedBeforeWrap += uploader.GetUploadRing()->GetStats().wraps == 0 ? 1 : 0;
+	}
+	uploader.Flush();
+	const UploadRingStats ringStats = uploader.GetUploadRing()->GetStats();
+
+	// First frame: only the geometry is waited on, and only by the GPU
+	uploader.QueueWait(directQueue, geometryTicket);
+	directQueue->ExecuteCommandLists(0, nullptr);
+	int residentAtFirstFrame = 0;
+	for (int i = 0; i < assetCount; i++) {
+		residentAtFirstFrame += uploader.IsComplete(tickets[i]) ? 1 : 0;
+	}
+
+	// Every asset arrives whole, including the ones whose staging the wrap went on to reuse
+	uploader.WaitFor(tickets[assetCount - 1]);
+	bool valid = uploader.IsComplete(geometryTicket) && residentAtFirstFrame < assetCount;
+	valid = valid && stagedBeforeWrap > 0 && stagedBeforeWrap < assetCount && ringStats.stalls > 0;
+	for (int i = 0; i < assetCount && valid; i++)
+	{
+		memset(data.data(), i + 1, data.size());
+		const UINT8* copied = static_cast<MockResource*>(assets[i].resource)->GetStorage() + assets[i].offset;
+		valid = uploader.IsComplete(tickets[i]) && (i == 0 || tickets[i] >= tickets[i - 1]);
+		valid = valid && memcmp(copied, data.data(), data.size()) == 0;
+	}
+
+	const AsyncUploaderStats& stats = uploader.GetStats();
+	printf("headless: async uploads %llu uploads in %llu batches, first frame with %d of %d assets resident, ring wrapped after %d with %llu stalls\n",
+		(unsigned long long)stats.uploads, (unsigned long long)stats.batches, residentAtFirstFrame, assetCount,
+		stagedBeforeWrap, (unsigned long long)ringStats.stalls);
+	valid = valid && stats.batches < stats.uploads;
+
+	// A Batch That Outgrows The Ring Is Submitted And The Upload Retried
+	AsyncUploader retryUploader;
+	if (!retryUploader.Init(device, 256 * 1024, 1024 * 1024)) {
+		return false;
+	}
+	static_cast<MockCommandQueue*>(retryUploader.GetCommandQueue())->SetLatency(4);
+	UINT64 retryTickets[3] = {};
+	for (int i = 0; i < 3 && valid; i++)
+	{
+		memset(data.data(), 0x40 + i, data.size());
+		retryTickets[i] = retryUploader.UploadBuffer(assets[i], data.data(), assetSize);
+		valid = retryTickets[i] != 0;
+	}
+	valid = valid && retryTickets[0] == retryTickets[1] && retryTickets[2] > retryTickets[1] && retryUploader.GetStats().batches == 1;
+	valid = valid && retryUploader.GetUploadRing()->GetStats().stalls > 0;
+	retryUploader.WaitFor(retryTickets[2]);
+	for (int i = 0; i < 3 && valid; i++)
+	{
+		memset(data.data(), 0x40 + i, data.size());
+		valid = memcmp(static_cast<MockResource*>(assets[i].resource)->GetStorage() + assets[i].offset, data.data(), data.size()) == 0;
+	}
+	retryUploader.UnInit();
+
+	// A Mesh Whose Indices Do Not Fit The Ring Gives Its Range Back
+	AsyncUploader smallUploader;
+	GeometryPool smallPool;
+	valid = valid && smallUploader.Init(device, 64 * 1024, 256 * 1024) && smallPool.Init(resourceManager, 4096, 65536);
+	std::vector<Vertex> manyVertices(1000, Vertex(1.0f, 2.0f, 3.0f, 0.0f, 0.0f));
+	std::vector<UINT32> manyIndices(40000, 7);
+	MeshHandle failed;
+	valid = valid && smallUploader.UploadMesh(&smallPool, manyVertices, manyIndices, &failed) == 0;
+	valid = valid && smallPool.GetMeshCount() == 0 && smallPool.GetVertexCount() == 0 && smallPool.GetIndexCount(DXGI_FORMAT_R16_UINT) == 0 && failed.vertexCount == 0;
+	MeshHandle retried;
+	valid = valid && smallUploader.UploadMesh(&smallPool, vertices, indices, &retried) != 0 && retried.baseVertex == 0 && retried.firstIndex == 0;
+	smallUploader.UnInit();
+	smallPool.UnInit();
+
+	uploader.UnInit();
+	for (GpuAllocation& asset : assets) {
+		resourceManager->FreeResource(&asset);
+	}
+	pool.UnInit();
+	return valid;
+}
\ No newline at end of file
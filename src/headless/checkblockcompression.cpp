@@ -0,0 +1,124 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "mockcommandlist.h"
+#include "resourcemanager.h"
+#include "textureloader.h"
+#include "workerpool.h"
+#include "mipgenerator.h"
+#include "blockcompress.h"
+#include "ddsfile.h"
+#include "texture.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+
+bool CheckBlockCompression(ResourceManager* resourceManager, MockCommandList* commandList)
+{
+	const UINT width = 61, height = 35;
+	std::vector<UINT8> image((size_t)width * height * 4);
+	for (UINT y = 0; y < height; y++) {
+		for (UINT x = 0; x < width; x++) {
+			UINT8* texel = &image[((size_t)y * width + x) * 4];
+			texel[0] = (UINT8)(x * 255 / (width - 1));
+			texel[1] = (UINT8)(128 + 100 * std::sin(x * 0.2f + y * 0.1f));
+			texel[2] = (UINT8)(y * 255 / (height - 1));
+			texel[3] = (UINT8)(255 - (x + y) * 2);
+		}
+	}
+
+	struct Expected {
+		DXGI_FORMAT format;
+		UINT channelCount;
+		double minimumPsnr;
+		int solidTolerance;
+	};
+	const Expected formats[] = {
+		{ DXGI_FORMAT_BC1_UNORM, 3, 32.0, 4 },
+		{ DXGI_FORMAT_BC3_UNORM, 4, 33.0, 4 },
+		{ DXGI_FORMAT_BC5_UNORM, 2, 42.0, 0 },
+		{ DXGI_FORMAT_BC7_UNORM, 4, 35.0, 1 },
+	};
+
+	WorkerPool workers;
+	bool valid = workers.Init(3);
+	UINT blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+	for (const Expected& expected : formats)
+	{
+		std::vector<UINT8> blocks((size_t)blocksWide * blocksHigh * GetBlockSize(expected.format)), threaded(blocks.size());
+		std::vector<UINT8> decoded(image.size());
+		valid = valid && CompressImage(image.data(), width, height, expected.format, blocks.data());
+		valid = valid && CompressImage(image.data(), width, height, expected.format, threaded.data(), &workers) && blocks == threaded;
+		valid = valid && DecompressImage(blocks.data(), width, height, expected.format, decoded.data());
+
+		double squared = 0.0;
+		for (size_t i = 0; i < image.size(); i += 4) {
+			for (UINT c = 0; c < expected.channelCount; c++) {
+				double difference = (double)image[i + c] - decoded[i + c];
+				squared += difference * difference;
+			}
+		}
+		double psnr = squared == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 * (image.size() / 4) * expected.channelCount / squared);
+		valid = valid && psnr >= expected.minimumPsnr;
+
+		// Solid blocks of awkward colours
+		for (UINT32 color : { 0x00000000u, 0xFFFFFFFFu, 0x7F3A81C5u, 0x01FE7F80u }) {
+			UINT8 solid[BC_BLOCK_TEXELS * 4], block[16], texels[BC_BLOCK_TEXELS * 4];
+			for (UINT i = 0; i < BC_BLOCK_TEXELS; i++) {
+				memcpy(solid + i * 4, &color, 4);
+			}
+			valid = valid && CompressImage(solid, 4, 4, expected.format, block) && DecompressImage(block, 4, 4, expected.format, texels);
+			for (UINT i = 0; i < BC_BLOCK_TEXELS * 4 && valid; i++) {
+				valid = i % 4 >= expected.channelCount || std::abs((int)texels[i] - (int)solid[i]) <= expected.solidTolerance;
+			}
+		}
+		printf("headless: block compression DXGI format %u, PSNR %.2f dB\n", (UINT)expected.format, psnr);
+	}
+
+	// Only mode 6 decodes
+	UINT8 modeZero[16] = { 0x01 }, texels[BC_BLOCK_TEXELS * 4];
+	valid = valid && !DecodeBC7Block(modeZero, texels);
+
+	// BC7 Chain Through DDS, The Loader & The Upload
+	UINT mipLevels = GetMipLevelCount(width, height);
+	MipLevel levels[D3D12_REQ_MIP_LEVELS], blockLevels[D3D12_REQ_MIP_LEVELS];
+	std::vector<UINT8> chain((size_t)GetMipChainLayout(width, height, mipLevels, levels));
+	std::vector<UINT8> blocks((size_t)GetMipChainLayout(width, height, mipLevels, blockLevels, DXGI_FORMAT_BC7_UNORM));
+	memcpy(chain.data(), image.data(), image.size());
+	GenerateMipChain(chain.data(), width, height, mipLevels, MF_BOX);
+	for (UINT mip = 0; mip < mipLevels; mip++) {
+		valid = valid && CompressImage(chain.data() + levels[mip].offset, levels[mip].width, levels[mip].height, DXGI_FORMAT_BC7_UNORM, blocks.data() + blockLevels[mip].offset);
+	}
+	valid = valid && blockLevels[mipLevels - 1].rowPitch == 16 && blockLevels[mipLevels - 1].rows == 1;
+
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "headless_bc7.dds";
+	TextureLoader loader;
+	Texture texture;
+	valid = valid && WriteDds(path, width, height, mipLevels, DXGI_FORMAT_BC7_UNORM, blocks) && loader.Init(1) && loader.Load(&texture, path);
+	valid = valid && texture.GetDesc().Format == DXGI_FORMAT_BC7_UNORM && texture.GetDesc().MipLevels == mipLevels;
+	valid = valid && texture.GetSize() == (int)blocks.size() && memcmp(texture.GetData(), blocks.data(), blocks.size()) == 0;
+	D3D12_SUBRESOURCE_DATA subresources[D3D12_REQ_MIP_LEVELS];
+	valid = valid && texture.GetSubresources(subresources) == mipLevels && subresources[0].RowPitch == (LONG_PTR)blocksWide * 16 &&
+		subresources[0].SlicePitch == (LONG_PTR)blocksWide * blocksHigh * 16;
+
+	GpuAllocation allocation;
+	commandList->Reset(nullptr, nullptr);
+	UINT64 copies = commandList->GetCopyCount();
+	valid = valid && resourceManager->CreateTexture(&texture, L"BC7 Texture", &allocation);
+	valid = valid && resourceManager->UploadTextureResources(commandList, allocation, &texture);
+	valid = valid && commandList->GetCopyCount() - copies == mipLevels;
+	const UINT8* staged = static_cast<MockResource*>(commandList->GetLastCopySource())->GetStorage() + commandList->GetLastCopySourceOffset();
+	valid = valid && memcmp(staged, blocks.data() + blockLevels[mipLevels - 1].offset, 16) == 0;
+	resourceManager->FlushBarriers(commandList);
+	commandList->Close();
+
+	printf("headless: BC7 DDS %ux%u, %u levels, %zu bytes against %zu as RGBA8\n", width, height, mipLevels, blocks.size(), chain.size());
+
+	resourceManager->FreeResource(&allocation);
+	texture.CleanObsoleteTextureData();
+	loader.UnInit();
+	std::error_code error;
+	std::filesystem::remove(path, error);
+	return valid;
+}
\ No newline at end of file
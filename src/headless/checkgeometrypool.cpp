@@ -0,0 +1,78 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "gputimeline.h"
+#include "resourcemanager.h"
+#include "geometrypool.h"
+
+#include <cstdio>
+
+bool CheckGeometryPool(ResourceManager* resourceManager, GpuTimeline* timeline, ID3D12GraphicsCommandList* commandList)
+{
+	GeometryPool pool;
+	if (!pool.Init(resourceManager, 72000, 8192, 4096, VL_FULL)) {
+		return false;
+	}
+
+	std::vector<MeshHandle> meshes;
+	std::vector<Vertex> vertices;
+	std::vector<UINT32> indices;
+	for (UINT i = 0; ; i++)
+	{
+		UINT vertexCount = i == 0 ? 70000 : 3 + (i * 7) % 61;
+		vertices.assign(vertexCount, Vertex((float)i, 0.0f, 0.0f, 0.0f, 0.0f));
+		indices.resize(i == 0 ? 3000 : vertexCount * 2);
+		for (UINT j = 0; j < indices.size(); j++) {
+			indices[j] = (j * 40009 + i) % vertexCount;
+		}
+
+		// The large mesh would not fit the upload ring in one go, only its indices matter
+		MeshHandle mesh;
+		if (i == 0) {
+			if (!pool.Reserve(vertexCount, (UINT)indices.size(), &mesh) ||
+				!resourceManager->UploadIndexBuffer(commandList, pool.GetIndexBuffer(mesh.indexFormat), indices, mesh.indexFormat)) {
+				return false;
+			}
+		}
+		else if (!pool.AddMesh(commandList, vertices, indices, &mesh)) {
+			break;
+		}
+		meshes.push_back(mesh);
+	}
+	ExecuteAndWait(resourceManager, timeline, commandList);
+
+	// Handles pack back to back per index format and the copies landed where the handles say
+	auto storage = [](const GpuAllocation& allocation) {
+		return static_cast<MockResource*>(allocation.resource)->GetStorage() + allocation.offset;
+	};
+	const Vertex* pooledVertices = reinterpret_cast<const Vertex*>(storage(pool.GetVertexBuffer()));
+	const UINT16* pooledShortIndices = reinterpret_cast<const UINT16*>(storage(pool.GetIndexBuffer(DXGI_FORMAT_R16_UINT)));
+	const UINT32* pooledLongIndices = reinterpret_cast<const UINT32*>(storage(pool.GetIndexBuffer(DXGI_FORMAT_R32_UINT)));
+
+	bool valid = pool.GetMeshCount() == meshes.size() && meshes.size() > 1 && meshes[0].indexFormat == DXGI_FORMAT_R32_UINT;
+	UINT nextVertex = 0, nextShortIndex = 0, nextLongIndex = 0;
+	for (UINT i = 0; i < meshes.size() && valid; i++)
+	{
+		const MeshHandle& mesh = meshes[i];
+		bool shortIndices = mesh.indexFormat == DXGI_FORMAT_R16_UINT;
+		valid = mesh.baseVertex == nextVertex && mesh.firstIndex == (shortIndices ? nextShortIndex : nextLongIndex);
+		valid = valid && mesh.indexFormat == IndexFormatFor(mesh.vertexCount);
+		for (UINT j = 0; i > 0 && j < mesh.vertexCount && valid; j++) {
+			valid = pooledVertices[mesh.baseVertex + j].pos.x == (float)i;
+		}
+		for (UINT j = 0; j < mesh.indexCount && valid; j++) {
+			UINT32 index = shortIndices ? pooledShortIndices[mesh.firstIndex + j] : pooledLongIndices[mesh.firstIndex + j];
+			valid = index == (j * 40009 + i) % mesh.vertexCount;
+		}
+		nextVertex += mesh.vertexCount;
+		(shortIndices ? nextShortIndex : nextLongIndex) += mesh.indexCount;
+	}
+	valid = valid && nextVertex == pool.GetVertexCount();
+	valid = valid && nextShortIndex == pool.GetIndexCount(DXGI_FORMAT_R16_UINT) && nextLongIndex == pool.GetIndexCount(DXGI_FORMAT_R32_UINT);
+
+	printf("headless: geometry pool %u meshes, %u vertices, %u 16-bit and %u 32-bit indices, %llu index bytes instead of %llu\n",
+		pool.GetMeshCount(), pool.GetVertexCount(), pool.GetIndexCount(DXGI_FORMAT_R16_UINT), pool.GetIndexCount(DXGI_FORMAT_R32_UINT),
+		(unsigned long long)pool.GetIndexBytes(), (unsigned long long)pool.GetWideIndexBytes());
+
+	pool.UnInit();
+	return valid;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "gpuallocator.h"
+
+#include <cstdio>
+
+bool CheckGpuAllocator(HeadlessDevice* device)
+{
+	GpuAllocator allocator;
+	allocator.Init(device);
+
+	std::vector<GpuAllocation> allocations;
+	for (int i = 0; i < 64; i++)
+	{
+		GpuAllocation allocation;
+		bool created;
+		if (i % 4 == 0) {
+			CD3DX12_RESOURCE_DESC texDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 64u << (i % 3), 64u << (i % 3), 1, 1);
+			created = allocator.CreateTexture(texDesc, D3D12_RESOURCE_STATE_COPY_DEST, L"Check Texture", &allocation);
+		}
+		else if (i % 4 == 1) {
+			created = allocator.CreateBuffer(64 * 1024 * (1 + i % 5), D3D12_RESOURCE_STATE_COPY_DEST, L"Check Buffer", &allocation);
+		}
+		else {
+			created = allocator.AllocateSmallBuffer(96 + i * 40, &allocation);
+		}
+		if (!created) {
+			printf("headless: allocation %d failed\n", i);
+			return false;
+		}
+		allocations.push_back(allocation);
+	}
+
+	for (size_t i = 0; i < allocations.size(); i += 2) {
+		allocator.Free(&allocations[i]);
+	}
+	GpuAllocatorStats stats = allocator.GetStats();
+	printf("headless: gpu allocator %llu heaps, %llu of %llu bytes used, %llu placed, %llu small buffers in %llu pages, fragmentation %.2f\n",
+		(unsigned long long)stats.heapCount, (unsigned long long)stats.usedBytes, (unsigned long long)stats.heapBytes,
+		(unsigned long long)stats.placedResources, (unsigned long long)stats.smallBuffers, (unsigned long long)stats.smallBufferPages,
+		stats.fragmentation);
+
+	for (size_t i = 1; i < allocations.size(); i += 2) {
+		allocator.Free(&allocations[i]);
+	}
+	stats = allocator.GetStats();
+	allocator.UnInit();
+
+	// Only the small buffer pages themselves stay placed
+	return stats.smallBuffers == 0 && stats.placedResources == stats.smallBufferPages &&
+		stats.usedBytes == stats.smallBufferPages * SMALL_BUFFER_PAGE_SIZE;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "gputimeline.h"
+
+bool CheckGpuTimeline(HeadlessDevice* device)
+{
+	D3D12_COMMAND_QUEUE_DESC cqDesc = {};
+	ID3D12CommandQueue* commandQueue;
+	device->CreateCommandQueue(&cqDesc, IID_PPV_ARGS(&commandQueue));
+	static_cast<MockCommandQueue*>(commandQueue)->SetLatency(4);
+	GpuTimeline timeline;
+	if (!timeline.Init(device, commandQueue)) {
+		SAFE_RELEASE(commandQueue);
+		return false;
+	}
+
+	UINT64 first = timeline.Submit();
+	timeline.Submit();
+	UINT64 third = timeline.Submit();
+	MockBlob* newer = new MockBlob(nullptr, 0);
+	MockBlob* older = new MockBlob(nullptr, 0);
+	newer->AddRef();
+	older->AddRef();
+	timeline.ReleaseAfter(newer, third);
+	timeline.ReleaseAfter(older, first);
+
+	// Retire Only The First Ticket
+	static_cast<MockCommandQueue*>(commandQueue)->SetLatency(2);
+	timeline.ReleaseCompleted();
+	bool valid = timeline.IsComplete(first) && !timeline.IsComplete(third) && timeline.GetPendingReleaseCount() == 1;
+	valid = valid && older->Release() == 0;
+
+	timeline.WaitForIdle();
+	timeline.ReleaseCompleted();
+	valid = valid && timeline.GetPendingReleaseCount() == 0 && newer->Release() == 0;
+
+	timeline.UnInit();
+	SAFE_RELEASE(commandQueue);
+	return valid;
+}
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "checks.h"
+#include "imagedecoder.h"
+#include "colorconvert.h"
+#include "timer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+static UINT32 TestCrc32(const UINT8* data, size_t size, UINT32 crc = 0)
+{
+	crc = ~crc;
+	for (size_t i = 0; i < size; i++) {
+		crc ^= data[i];
+		for (int k = 0; k < 8; k++) {
+			crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+		}
+	}
+	return ~crc;
+}
+
+std::vector<UINT8> WriteTestPng(const TestPng& png)
+{
+	static const UINT adam7[7][4] = { {0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2} };
+	static const UINT single[1][4] = { {0, 0, 1, 1} };
+	const UINT (*passes)[4] = png.interlace ? adam7 : single;
+	UINT pixelBytes = std::max<UINT>(1, png.channels * png.bitDepth / 8);
+
+	std::vector<UINT8> raw;
+	UINT filterIndex = 0;
+	for (UINT p = 0; p < (png.interlace ? 7u : 1u); p++)
+	{
+		UINT x0 = passes[p][0], y0 = passes[p][1], dx = passes[p][2], dy = passes[p][3];
+		if (png.width <= x0 || png.height <= y0) {
+			continue;
+		}
+		UINT passWidth = (png.width - x0 + dx - 1) / dx;
+		size_t rowBytes = ((size_t)passWidth * png.channels * png.bitDepth + 7) / 8;
+		std::vector<UINT8> prev(rowBytes, 0), line(rowBytes);
+		for (UINT y = y0; y < png.height; y += dy, filterIndex++)
+		{
+			std::fill(line.begin(), line.end(), 0);
+			for (UINT x = 0; x < passWidth; x++) {
+				for (UINT c = 0; c < png.channels; c++) {
+					UINT value = png.sample(x0 + x * dx, y, c);
+					size_t bit = ((size_t)x * png.channels + c) * png.bitDepth;
+					if (png.bitDepth == 16) {
+						line[bit / 8] = (UINT8)(value >> 8);
+						line[bit / 8 + 1] = (UINT8)value;
+					}
+					else {
+						line[bit / 8] |= (UINT8)(value << (8 - png.bitDepth - bit % 8));
+					}
+				}
+			}
+			UINT8 filter = (UINT8)(filterIndex % 5);
+			raw.push_back(filter);
+			for (size_t i = 0; i < rowBytes; i++) {
+				int left = i >= pixelBytes ? line[i - pixelBytes] : 0;
+				int up = y >= y0 + dy ? prev[i] : 0;
+				int upLeft = y >= y0 + dy && i >= pixelBytes ? prev[i - pixelBytes] : 0;
+				int p = left + up - upLeft;
+				int paeth = std::abs(p - left) <= std::abs(p - up) && std::abs(p - left) <= std::abs(p - upLeft) ? left : (std::abs(p - up) <= std::abs(p - upLeft) ? up : upLeft);
+				const int predictions[5] = { 0, left, up, (left + up) >> 1, paeth };
+				raw.push_back((UINT8)(line[i] - predictions[filter]));
+			}
+			prev = line;
+		}
+	}
+
+	// zlib stream of stored blocks
+	std::vector<UINT8> zlib = { 0x78, 0x01 };
+	for (size_t offset = 0; offset < raw.size() || offset == 0; offset += 65535) {
+		size_t length = std::min<size_t>(65535, raw.size() - offset);
+		zlib.push_back(offset + length >= raw.size() ? 1 : 0);
+		zlib.insert(zlib.end(), { (UINT8)length, (UINT8)(length >> 8), (UINT8)~length, (UINT8)(~length >> 8) });
+		zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + length);
+		if (length == 0) break;
+	}
+	UINT32 a = 1, b = 0;
+	for (UINT8 byte : raw) {
+		a = (a + byte) % 65521;
+		b = (b + a) % 65521;
+	}
+	UINT32 adler = (b << 16) | a;
+	zlib.insert(zlib.end(), { (UINT8)(adler >> 24), (UINT8)(adler >> 16), (UINT8)(adler >> 8), (UINT8)adler });
+
+	std::vector<UINT8> file = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	auto chunk = [&file](const char* type, const std::vector<UINT8>& body) {
+		UINT32 length = (UINT32)body.size();
+		file.insert(file.end(), { (UINT8)(length >> 24), (UINT8)(length >> 16), (UINT8)(length >> 8), (UINT8)length });
+		size_t start = file.size();
+		file.insert(file.end(), type, type + 4);
+		file.insert(file.end(), body.begin(), body.end());
+		UINT32 crc = TestCrc32(file.data() + start, file.size() - start);
+		file.insert(file.end(), { (UINT8)(crc >> 24), (UINT8)(crc >> 16), (UINT8)(crc >> 8), (UINT8)crc });
+	};
+	chunk("IHDR", { (UINT8)(png.width >> 24), (UINT8)(png.width >> 16), (UINT8)(png.width >> 8), (UINT8)png.width,
+		(UINT8)(png.height >> 24), (UINT8)(png.height >> 16), (UINT8)(png.height >> 8), (UINT8)png.height,
+		(UINT8)png.bitDepth, (UINT8)png.colorType, 0, 0, (UINT8)(png.interlace ? 1 : 0) });
+	if (!png.palette.empty()) chunk("PLTE", png.palette);
+	if (!png.transparency.empty()) chunk("tRNS", png.transparency);
+	chunk("IDAT", zlib);
+	chunk("IEND", {});
+	return file;
+}
+
+bool CheckImageDecoder()
+{
+	ImageDecoder decoder;
+	ImageData rgba, bgra;
+	bool valid = true;
+	Timer timer;
+	float decodeMs = 0.0f;
+	for (const char* path : { ASSET_DIR "/gato.png", ASSET_DIR "/brick_color.jpg" })
+	{
+		timer.GetFrameDelta();
+		valid = valid && decoder.Load(path, DXGI_FORMAT_R8G8B8A8_UNORM, &rgba);
+		decodeMs += timer.GetFrameDelta();
+		valid = valid && decoder.Load(path, DXGI_FORMAT_B8G8R8A8_UNORM, &bgra) && bgra.pixels.size() == rgba.pixels.size();
+		for (size_t i = 0; i < rgba.pixels.size() && valid; i += 4) {
+			valid = rgba.pixels[i] == bgra.pixels[i + 2] && rgba.pixels[i + 1] == bgra.pixels[i + 1] &&
+				rgba.pixels[i + 2] == bgra.pixels[i] && rgba.pixels[i + 3] == 255;
+		}
+	}
+	valid = valid && decoder.Load(ASSET_DIR "/gato.png", DXGI_FORMAT_R8G8B8A8_UNORM, &rgba) && rgba.width == 720 && rgba.height == 740;
+	printf("headless: image decoder gato.png and brick_color.jpg in %.2f ms, %s colour conversion\n", decodeMs, GetColorConvertPath());
+
+	// Interlaced RGBA, a 4-bit palette with transparency, 16-bit gray with a colour key, RGB to BGRA
+	const UINT16 grayKey = 0x1234;
+	std::vector<TestPng> pngs = {
+		{ 13, 11, 6, 8, 4, true, [](UINT x, UINT y, UINT c) { return (x * 29 + y * 7 + c * 61) & 255; } },
+		{ 3, 2, 6, 8, 4, true, [](UINT x, UINT y, UINT c) { return (x * 80 + y * 40 + c) & 255; } },
+		{ 19, 7, 3, 4, 1, false, [](UINT x, UINT y, UINT) { return (x + y * 3) % 12; } },
+		{ 9, 5, 0, 16, 1, false, [grayKey](UINT x, UINT y, UINT) { return x == 4 && y == 2 ? grayKey : x * 7000 + y * 300; } },
+		{ 10, 4, 2, 8, 3, false, [](UINT x, UINT y, UINT c) { return (x * 25 + y * 60 + c * 90) & 255; } },
+	};
+	for (UINT i = 0; i < 12; i++) {
+		pngs[2].palette.insert(pngs[2].palette.end(), { (UINT8)(i * 20), (UINT8)(255 - i * 20), (UINT8)(i * 7) });
+		pngs[2].transparency.push_back((UINT8)(i * 21));
+	}
+	pngs[3].transparency = { (UINT8)(grayKey >> 8), (UINT8)grayKey };
+
+	for (size_t i = 0; i < pngs.size() && valid; i++)
+	{
+		const TestPng& png = pngs[i];
+		std::vector<UINT8> file = WriteTestPng(png);
+		DXGI_FORMAT format = png.colorType == 2 ? DXGI_FORMAT_B8G8R8A8_UNORM : DXGI_FORMAT_R8G8B8A8_UNORM;
+		// Rows land at the caller's pitch
+		UINT64 rowPitch = png.width * 4 + 12;
+		std::vector<UINT8> decoded(rowPitch * png.height);
+		valid = decoder.Decode(file, format, decoded.data(), rowPitch);
+		for (UINT y = 0; y < png.height && valid; y++) {
+			for (UINT x = 0; x < png.width && valid; x++) {
+				UINT8 expected[4] = { 0, 0, 0, 255 };
+				if (png.colorType == 3) {
+					UINT index = png.sample(x, y, 0);
+					memcpy(expected, &png.palette[index * 3], 3);
+					expected[3] = png.transparency[index];
+				}
+				else if (png.colorType == 0) {
+					UINT gray = png.sample(x, y, 0);
+					expected[0] = expected[1] = expected[2] = (UINT8)(gray >> 8);
+					expected[3] = gray == grayKey ? 0 : 255;
+				}
+				else {
+					for (UINT c = 0; c < png.channels; c++) {
+						expected[c] = (UINT8)png.sample(x, y, c);
+					}
+					if (format == DXGI_FORMAT_B8G8R8A8_UNORM) std::swap(expected[0], expected[2]);
+				}
+				valid = memcmp(decoded.data() + y * rowPitch + x * 4, expected, 4) == 0;
+			}
+		}
+	}
+
+	// SIMD paths against the scalar ones, with a tail that doesn't fill a vector
+	UINT32 seed = 99;
+	std::vector<UINT8> y(1000 + 13), cb(y.size()), cr(y.size());
+	for (size_t i = 0; i < y.size(); i++) {
+		seed = seed * 1664525u + 1013904223u;
+		y[i] = (UINT8)(seed >> 24); cb[i] = (UINT8)(seed >> 16); cr[i] = (UINT8)(seed >> 8);
+	}
+	std::vector<UINT8> converted(y.size() * 4), reference(y.size() * 4);
+	for (bool order : { false, true }) {
+		ConvertYCbCrToRgba(y.data(), cb.data(), cr.data(), converted.data(), (UINT)y.size(), order);
+		ConvertYCbCrToRgbaScalar(y.data(), cb.data(), cr.data(), reference.data(), (UINT)y.size(), order);
+		valid = valid && converted == reference;
+	}
+	SwizzleRgba(reference.data(), converted.data(), (UINT)y.size());
+	SwizzleRgbaScalar(reference.data(), reference.data(), (UINT)y.size());
+	valid = valid && converted == reference;
+
+	// Mid gray stays gray, pure JFIF red comes back red
+	UINT8 lumaGray = 128, chromaZero = 128, redY = 76, redCb = 85, redCr = 255, pixel[4];
+	ConvertYCbCrToRgba(&lumaGray, &chromaZero, &chromaZero, pixel, 1, false);
+	valid = valid && pixel[0] == 128 && pixel[1] == 128 && pixel[2] == 128;
+	ConvertYCbCrToRgba(&redY, &redCb, &redCr, pixel, 1, false);
+	valid = valid && pixel[0] >= 253 && pixel[1] <= 2 && pixel[2] <= 2;
+	return valid;
+}
\ No newline at end of file
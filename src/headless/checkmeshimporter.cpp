@@ -0,0 +1,67 @@
+#include "checks.h"
+#include "meshimporter.h"
+#include "timer.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+bool CheckMeshImporter()
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "headless_mesh_import";
+	std::filesystem::path source = directory / "Suzanne.fbx";
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	std::filesystem::remove(MeshImporter::CookedPath(source), error);
+	if (!std::filesystem::copy_file(ASSET_DIR "/Suzanne.fbx", source, std::filesystem::copy_options::overwrite_existing, error)) {
+		return false;
+	}
+
+	MeshImporter importer;
+	MeshData imported, cooked, reimported;
+	Timer timer;
+	bool valid = importer.Load(source, &imported) && !importer.LoadedFromCache();
+	float importMs = timer.GetFrameDelta();
+	valid = valid && importer.Load(source, &cooked) && importer.LoadedFromCache();
+	float cookedMs = timer.GetFrameDelta();
+	valid = valid && cooked.vertices.size() == imported.vertices.size() && cooked.indices == imported.indices;
+	valid = valid && memcmp(cooked.vertices.data(), imported.vertices.data(), imported.vertices.size() * sizeof(Vertex)) == 0;
+
+	// Clockwise fronts: the face normal from the winding agrees with the imported normals,
+	// allowing for the odd sliver whose smoothed normals lean past it
+	UINT facing = 0;
+	for (size_t i = 0; i + 2 < imported.indices.size(); i += 3) {
+		const Vertex& a = imported.vertices[imported.indices[i]];
+		const Vertex& b = imported.vertices[imported.indices[i + 1]];
+		const Vertex& c = imported.vertices[imported.indices[i + 2]];
+		Float3 faceNormal = Vec3Cross(Vec3Sub(b.pos, a.pos), Vec3Sub(c.pos, a.pos));
+		Float3 normal(a.normals.x + b.normals.x + c.normals.x, a.normals.y + b.normals.y + c.normals.y, a.normals.z + b.normals.z + c.normals.z);
+		facing += Vec3Dot(faceNormal, normal) > 0.0f ? 1 : 0;
+	}
+	UINT triangles = (UINT)imported.indices.size() / 3;
+	valid = valid && triangles == 968 && facing >= triangles * 99 / 100;
+
+	std::filesystem::last_write_time(source, std::filesystem::last_write_time(MeshImporter::CookedPath(source)) + std::chrono::seconds(2), error);
+	valid = valid && importer.Load(source, &reimported) && !importer.LoadedFromCache() && reimported.indices == imported.indices;
+
+	printf("headless: mesh import Suzanne %u triangles, %zu vertices, parsed in %.2f ms, cooked load %.3f ms\n",
+		triangles, imported.vertices.size(), importMs, cookedMs);
+
+	// A quad facing +z in right handed space faces -z here
+	const char obj[] =
+		"# quad\n"
+		"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+		"vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+		"f -4/1 -3/2 -2/3 -1/4\r\n";
+	MeshData quad;
+	valid = valid && importer.ImportObj(std::span<const UINT8>(reinterpret_cast<const UINT8*>(obj), sizeof(obj) - 1), &quad);
+	valid = valid && quad.vertices.size() == 4 && quad.indices.size() == 6;
+	for (size_t i = 0; i < quad.vertices.size() && valid; i++) {
+		const Vertex& vertex = quad.vertices[i];
+		valid = std::fabs(vertex.normals.z + 1.0f) < 1e-5f && vertex.texCoord.y == 1.0f - vertex.pos.y;
+	}
+
+	std::filesystem::remove_all(directory, error);
+	return valid;
+}
\ No newline at end of file
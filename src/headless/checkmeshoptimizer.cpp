@@ -0,0 +1,93 @@
+#include "checks.h"
+#include "meshoptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+bool CheckMeshOptimizer()
+{
+	const UINT gridSize = 100;
+	std::vector<Vertex> vertices;
+	for (UINT y = 0; y < gridSize; y++) {
+		for (UINT x = 0; x < gridSize; x++) {
+			// A gentle bump so clusters face different ways
+			float fx = (float)x / gridSize - 0.5f, fy = (float)y / gridSize - 0.5f;
+			vertices.push_back(Vertex(fx, 0.25f - (fx * fx + fy * fy), fy, fx + 0.5f, fy + 0.5f));
+		}
+	}
+	std::vector<std::array<UINT32, 3>> triangles;
+	for (UINT y = 0; y + 1 < gridSize; y++) {
+		for (UINT x = 0; x + 1 < gridSize; x++) {
+			UINT32 i = y * gridSize + x;
+			triangles.push_back({ i, i + gridSize, i + 1 });
+			triangles.push_back({ i + 1, i + gridSize, i + gridSize + 1 });
+		}
+	}
+
+	// Deterministic shuffle of both the triangle and the vertex order
+	UINT32 seed = 12345;
+	auto random = [&seed](size_t range) { seed = seed * 1664525u + 1013904223u; return (size_t)(seed >> 8) % range; };
+	for (size_t i = triangles.size() - 1; i > 0; i--) {
+		std::swap(triangles[i], triangles[random(i + 1)]);
+	}
+	std::vector<UINT32> shuffle(vertices.size());
+	for (size_t i = 0; i < shuffle.size(); i++) {
+		shuffle[i] = (UINT32)i;
+	}
+	for (size_t i = shuffle.size() - 1; i > 0; i--) {
+		std::swap(shuffle[i], shuffle[random(i + 1)]);
+	}
+	std::vector<Vertex> shuffledVertices(vertices);
+	for (size_t i = 0; i < vertices.size(); i++) {
+		shuffledVertices[shuffle[i]] = vertices[i];
+	}
+	std::vector<UINT32> indices;
+	for (const std::array<UINT32, 3>& triangle : triangles) {
+		for (UINT32 index : triangle) {
+			indices.push_back(shuffle[index]);
+		}
+	}
+
+	// Triangles as position triples, rotated to start at the smallest x+y*n so winding counts
+	auto canonical = [](const std::vector<Vertex>& vertexList, const std::vector<UINT32>& indexList) {
+		std::vector<std::array<float, 9>> result;
+		for (size_t t = 0; t < indexList.size(); t += 3) {
+			std::array<float, 9> triangle;
+			for (int k = 0; k < 3; k++) {
+				const Vertex& vertex = vertexList[indexList[t + k]];
+				triangle[k * 3] = vertex.pos.x;
+				triangle[k * 3 + 1] = vertex.pos.y;
+				triangle[k * 3 + 2] = vertex.pos.z;
+			}
+			int first = 0;
+			for (int k = 1; k < 3; k++) {
+				if (triangle[k * 3] + triangle[k * 3 + 2] * 1000.0f < triangle[first * 3] + triangle[first * 3 + 2] * 1000.0f) {
+					first = k;
+				}
+			}
+			std::rotate(triangle.begin(), triangle.begin() + first * 3, triangle.end());
+			result.push_back(triangle);
+		}
+		std::sort(result.begin(), result.end());
+		return result;
+	};
+	std::vector<std::array<float, 9>> original = canonical(shuffledVertices, indices);
+
+	MeshOptimizer optimizer;
+	MeshOptimizeReport report = optimizer.Optimize(shuffledVertices, indices);
+
+	// Vertex fetch order: each index is at most one past the largest seen so far
+	bool valid = report.vertexCount == vertices.size();
+	UINT32 nextVertex = 0;
+	for (size_t i = 0; i < indices.size() && valid; i++) {
+		valid = indices[i] <= nextVertex;
+		nextVertex = std::max(nextVertex, indices[i] + 1);
+	}
+	valid = valid && canonical(shuffledVertices, indices) == original;
+	valid = valid && report.after.acmr < report.before.acmr * 0.5f && report.after.acmr < 0.8f;
+
+	printf("headless: mesh optimizer %zu triangles, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %u overdraw clusters\n",
+		indices.size() / 3, report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr, report.clusterCount);
+	return valid;
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "mockcommandlist.h"
+#include "resourcemanager.h"
+#include "textureloader.h"
+#include "mipgenerator.h"
+#include "timer.h"
+#include "texture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+// Float references for one mip level from the level above, written independently of the
+// generator: the box average of the 2x2 footprint and a direct 2D Kaiser windowed sinc
+static std::vector<UINT8> ReferenceBox(const UINT8* src, UINT srcWidth, UINT srcHeight)
+{
+	UINT dstWidth = std::max<UINT>(1, srcWidth / 2), dstHeight = std::max<UINT>(1, srcHeight / 2);
+	std::vector<UINT8> dst((size_t)dstWidth * dstHeight * 4);
+	for (UINT y = 0; y < dstHeight; y++) {
+		for (UINT x = 0; x < dstWidth; x++) {
+			for (UINT c = 0; c < 4; c++) {
+				float sum = 0.0f;
+				for (UINT j = 0; j < 2; j++) {
+					for (UINT i = 0; i < 2; i++) {
+						sum += src[((size_t)std::min<UINT>(y * 2 + j, srcHeight - 1) * srcWidth + std::min<UINT>(x * 2 + i, srcWidth - 1)) * 4 + c];
+					}
+				}
+				dst[((size_t)y * dstWidth + x) * 4 + c] = (UINT8)std::floor(sum / 4.0f + 0.5f);
+			}
+		}
+	}
+	return dst;
+}
+
+static double ReferenceKaiserWeight(double x)
+{
+	const double radius = 3.0, beta = 4.0, pi = 3.14159265358979323846;
+	if (std::abs(x) >= radius) {
+		return 0.0;
+	}
+	auto besselI0 = [](double v) {
+		double sum = 0.0, term = 1.0;
+		for (int k = 1; k < 50; k++) {
+			sum += term;
+			term *= v * v / (4.0 * k * k);
+		}
+		return sum;
+	};
+	double sinc = x == 0.0 ? 1.0 : std::sin(pi * x) / (pi * x);
+	return sinc * besselI0(beta * std::sqrt(1.0 - x * x / (radius * radius))) / besselI0(beta);
+}
+
+static std::vector<UINT8> ReferenceKaiser(const UINT8* src, UINT srcWidth, UINT srcHeight)
+{
+	UINT dstWidth = std::max<UINT>(1, srcWidth / 2), dstHeight = std::max<UINT>(1, srcHeight / 2);
+	double scaleX = (double)srcWidth / dstWidth, scaleY = (double)srcHeight / dstHeight;
+	std::vector<UINT8> dst((size_t)dstWidth * dstHeight * 4);
+	for (UINT y = 0; y < dstHeight; y++) {
+		for (UINT x = 0; x < dstWidth; x++) {
+			double centerX = (x + 0.5) * scaleX - 0.5, centerY = (y + 0.5) * scaleY - 0.5;
+			double sum[4] = {}, total = 0.0;
+			for (int j = (int)std::floor(centerY - 3.0 * scaleY); j <= (int)std::ceil(centerY + 3.0 * scaleY); j++) {
+				for (int i = (int)std::floor(centerX - 3.0 * scaleX); i <= (int)std::ceil(centerX + 3.0 * scaleX); i++) {
+					double weight = ReferenceKaiserWeight((i - centerX) / scaleX) * ReferenceKaiserWeight((j - centerY) / scaleY);
+					int sx = std::min<int>(std::max<int>(i, 0), (int)srcWidth - 1), sy = std::min<int>(std::max<int>(j, 0), (int)srcHeight - 1);
+					for (UINT c = 0; c < 4; c++) {
+						sum[c] += weight * src[((size_t)sy * srcWidth + sx) * 4 + c];
+					}
+					total += weight;
+				}
+			}
+			for (UINT c = 0; c < 4; c++) {
+				dst[((size_t)y * dstWidth + x) * 4 + c] = (UINT8)std::min<double>(std::max<double>(std::floor(sum[c] / total + 0.5), 0.0), 255.0);
+			}
+		}
+	}
+	return dst;
+}
+
+bool CheckMipGenerator(ResourceManager* resourceManager, MockCommandList* commandList)
+{
+	const UINT width = 75, height = 43;
+	UINT mipLevels = GetMipLevelCount(width, height);
+	MipLevel levels[D3D12_REQ_MIP_LEVELS];
+	UINT64 chainSize = GetMipChainLayout(width, height, mipLevels, levels);
+	bool valid = mipLevels == 7 && levels[mipLevels - 1].width == 1 && levels[mipLevels - 1].height == 1 &&
+		levels[mipLevels - 1].offset + 4 == chainSize && GetMipLevelCount(1, 1) == 1 && GetMipLevelCount(16, 1) == 5;
+
+	// Smooth gradients with hard edges and noise on top, alpha varies too
+	std::vector<UINT8> image((size_t)width * height * 4);
+	for (UINT y = 0; y < height; y++) {
+		for (UINT x = 0; x < width; x++) {
+			UINT8* texel = &image[((size_t)y * width + x) * 4];
+			UINT noise = (x * 73856093u) ^ (y * 19349663u);
+			texel[0] = (UINT8)(x * 255 / (width - 1));
+			texel[1] = (UINT8)((x / 8 + y / 8) % 2 ? 230 : 20);
+			texel[2] = (UINT8)(noise >> 7);
+			texel[3] = (UINT8)(255 - y * 3);
+		}
+	}
+
+	float filterMs[2] = {};
+	for (MIP_FILTER filter : { MF_BOX, MF_KAISER })
+	{
+		std::vector<UINT8> chain((size_t)chainSize);
+		memcpy(chain.data(), image.data(), image.size());
+		Timer timer;
+		GenerateMipChain(chain.data(), width, height, mipLevels, filter);
+		filterMs[filter == MF_KAISER] = timer.GetFrameDelta();
+
+		for (UINT mip = 1; mip < mipLevels && valid; mip++) {
+			const MipLevel& src = levels[mip - 1];
+			const UINT8* above = chain.data() + src.offset;
+			const UINT8* level = chain.data() + levels[mip].offset;
+			size_t levelSize = (size_t)(levels[mip].rowPitch * levels[mip].rows);
+			std::vector<UINT8> reference = filter == MF_BOX ? ReferenceBox(above, src.width, src.height) : ReferenceKaiser(above, src.width, src.height);
+			for (size_t i = 0; i < levelSize && valid; i++) {
+				valid = std::abs((int)level[i] - (int)reference[i]) <= (filter == MF_BOX ? 0 : 1);
+			}
+
+			std::vector<UINT8> scalar(levelSize);
+			if (filter == MF_BOX) DownsampleBoxScalar(above, src.width, src.height, scalar.data());
+			else DownsampleKaiserScalar(above, src.width, src.height, scalar.data());
+			valid = valid && memcmp(scalar.data(), level, levelSize) == 0;
+		}
+	}
+
+	// Load Through The Texture Loader & Upload Every Level
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "headless_mips.png";
+	TestPng png = { width, height, 6, 8, 4, false, [&image](UINT x, UINT y, UINT c) { return (UINT)image[((size_t)y * width + x) * 4 + c]; } };
+	std::vector<UINT8> file = WriteTestPng(png);
+	std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+
+	TextureLoader loader;
+	Texture texture;
+	valid = valid && loader.Init(1) && loader.Load(&texture, path) && texture.GetDesc().MipLevels == mipLevels && texture.GetSize() == (int)chainSize;
+	std::vector<UINT8> expected((size_t)chainSize);
+	memcpy(expected.data(), image.data(), image.size());
+	GenerateMipChain(expected.data(), width, height, mipLevels, MF_BOX);
+	valid = valid && memcmp(texture.GetData(), expected.data(), expected.size()) == 0;
+
+	GpuAllocation allocation;
+	commandList->Reset(nullptr, nullptr);
+	UINT64 copies = commandList->GetCopyCount();
+	valid = valid && resourceManager->CreateTexture(&texture, L"Mip Chain Texture", &allocation);
+	valid = valid && resourceManager->UploadTextureResources(commandList, allocation, &texture);
+	valid = valid && commandList->GetCopyCount() - copies == mipLevels;
+	const UINT8* staged = static_cast<MockResource*>(commandList->GetLastCopySource())->GetStorage() + commandList->GetLastCopySourceOffset();
+	valid = valid && memcmp(staged, expected.data() + levels[mipLevels - 1].offset, 4) == 0;
+	resourceManager->FlushBarriers(commandList);
+	commandList->Close();
+
+	printf("headless: mip generator %ux%u, %u levels, %s box %.3f ms, Kaiser %.3f ms\n",
+		width, height, mipLevels, GetMipGeneratorPath(), filterMs[0], filterMs[1]);
+
+	resourceManager->FreeResource(&allocation);
+	texture.CleanObsoleteTextureData();
+	loader.UnInit();
+	std::error_code error;
+	std::filesystem::remove(path, error);
+	return valid;
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "pipelinecache.h"
+#include "vertexformat.h"
+#include "workerpool.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+
+// The scene, post and shadow descriptions as PipelineStateObject builds them, with stand-in
+// bytecode. shadow switches to the depth only pass with its bias.
+static D3D12_GRAPHICS_PIPELINE_STATE_DESC GetCheckPipelineDesc(const std::vector<UINT8>& vs, const std::vector<UINT8>& ps, bool shadow,
+	D3D12_INPUT_ELEMENT_DESC* inputLayout)
+{
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
+	desc.InputLayout = GetVertexFormat(VL_PACKED).GetInputLayout(inputLayout);
+	desc.VS = { vs.data(), vs.size() };
+	desc.PS = { ps.data(), ps.size() };
+	desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	desc.SampleDesc.Count = 1;
+	desc.SampleMask = 0xffffffff;
+	desc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	desc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+	desc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	if (shadow) {
+		desc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+		desc.RasterizerState.DepthBias = 100;
+		desc.RasterizerState.SlopeScaledDepthBias = 1.5f;
+		desc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
+	}
+	else {
+		desc.NumRenderTargets = 1;
+		desc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+	}
+	return desc;
+}
+
+bool CheckPipelineCache(HeadlessDevice* device)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "headless_pipeline_cache";
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+	std::filesystem::path file = directory / "pipelines.bin";
+
+	std::vector<UINT8> vs(64, 0x11), ps(96, 0x22), ppPs(80, 0x33), dsPs(32, 0x44);
+	D3D12_INPUT_ELEMENT_DESC layouts[4][MAX_VERTEX_ATTRIBUTES];
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC descs[3] = {
+		GetCheckPipelineDesc(vs, ps, false, layouts[0]),
+		GetCheckPipelineDesc(vs, ppPs, false, layouts[1]),
+		GetCheckPipelineDesc(vs, dsPs, true, layouts[2]),
+	};
+
+	// Acquires every description and releases them again, true if all were created
+	auto launch = [&](PipelineCache* cache) {
+		bool created = true;
+		for (const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc : descs)
+		{
+			ID3D12PipelineState* pso = cache->Acquire(desc);
+			created = created && pso != nullptr;
+			SAFE_RELEASE(pso);
+		}
+		return created;
+	};
+
+	// First Launch Compiles, A Rebuilt Equal Description Is Reused
+	PipelineCache cache;
+	bool valid = cache.Init(device, file) && !cache.HasLibrary();
+	UINT64 compiled = device->GetPipelinesCompiled();
+	ID3D12PipelineState* scene = cache.Acquire(descs[0]);
+	std::vector<UINT8> vsCopy = vs, psCopy = ps;
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC rebuilt = GetCheckPipelineDesc(vsCopy, psCopy, false, layouts[3]);
+	ID3D12PipelineState* sceneAgain = cache.Acquire(rebuilt);
+	valid = valid && launch(&cache) && scene && scene == sceneAgain;
+	PipelineCacheStats stats = cache.GetStats();
+	valid = valid && stats.created == 3 && stats.hits == 2 && stats.loaded == 0 && device->GetPipelinesCompiled() == compiled + 3;
+	SAFE_RELEASE(scene);
+	SAFE_RELEASE(sceneAgain);
+	valid = valid && cache.Save() && std::filesystem::exists(file);
+
+	// The Key Covers The State, Not The Root Signature
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC changed = descs[2];
+	changed.RasterizerState.DepthBias = 101;
+	valid = valid && PipelineCache::GetKey(changed) != PipelineCache::GetKey(descs[2]);
+	changed = descs[0];
+	changed.RTVFormats[0] = DXGI_FORMAT_R16G16B16A16_FLOAT;
+	valid = valid && PipelineCache::GetKey(changed) != PipelineCache::GetKey(descs[0]);
+	changed = descs[0];
+	changed.BlendState.RenderTarget[0].BlendEnable = TRUE;
+	valid = valid && PipelineCache::GetKey(changed) != PipelineCache::GetKey(descs[0]);
+	changed = descs[0];
+	changed.pRootSignature = reinterpret_cast<ID3D12RootSignature*>(0x1000);
+	ID3D12PipelineState* other = cache.Acquire(changed);
+	scene = cache.Acquire(descs[0]);
+	valid = valid && PipelineCache::GetKey(changed) == PipelineCache::GetKey(descs[0]) && other && other != scene;
+	SAFE_RELEASE(other);
+	SAFE_RELEASE(scene);
+	cache.UnInit();
+
+	// Second Launch Creates Everything From The Stored Blobs
+	UINT64 fromBlob = device->GetPipelinesFromBlob();
+	cache.Init(device, file);
+	valid = valid && launch(&cache);
+	stats = cache.GetStats();
+	valid = valid && stats.loaded == 3 && stats.created == 0 && stats.rejected == 0 && device->GetPipelinesFromBlob() == fromBlob + 3;
+	double warmLoadMs = stats.loadMs;
+	cache.UnInit();
+
+	// A Driver Update Refuses The Blobs, They Are Compiled And Stored Again
+	device->SetDriverVersion(2);
+	cache.Init(device, file);
+	valid = valid && launch(&cache) && cache.Save();
+	stats = cache.GetStats();
+	valid = valid && stats.rejected == 3 && stats.created == 3 && stats.loaded == 0;
+	cache.UnInit();
+	cache.Init(device, file);
+	valid = valid && launch(&cache) && cache.GetStats().loaded == 3;
+	cache.UnInit();
+	device->SetDriverVersion(1);
+
+	// A Damaged File Starts Empty
+	std::filesystem::resize_file(file, std::filesystem::file_size(file) - 7, error);
+	cache.Init(device, file);
+	valid = valid && launch(&cache);
+	stats = cache.GetStats();
+	valid = valid && stats.rejected == 1 && stats.created == 3 && stats.loaded == 0;
+	valid = valid && cache.Save();
+	cache.UnInit();
+
+	// So Does One Whose Size Was Damaged
+	{
+		UINT64 damagedSize = ~0ull >> 8;
+		std::fstream damaged(file, std::ios::binary | std::ios::in | std::ios::out);
+		damaged.seekp(16);
+		damaged.write(reinterpret_cast<const char*>(&damagedSize), sizeof(damagedSize));
+	}
+	cache.Init(device, file);
+	valid = valid && launch(&cache);
+	stats = cache.GetStats();
+	valid = valid && stats.rejected == 1 && stats.created == 3 && stats.loaded == 0;
+	cache.UnInit();
+
+	// Threads Asking For The Same Pipelines Share Them
+	WorkerPool workers;
+	workers.Init(4);
+	cache.Init(device, directory / "threaded.bin");
+	std::atomic<UINT> failed = 0;
+	ID3D12PipelineState* first[3] = { cache.Acquire(descs[0]), cache.Acquire(descs[1]), cache.Acquire(descs[2]) };
+	for (UINT i = 0; i < 24; i++)
+	{
+		workers.Submit([&cache, &descs, &first, &failed, i](UINT) {
+			ID3D12PipelineState* pso = cache.Acquire(descs[i % 3]);
+			failed += pso == first[i % 3] ? 0 : 1;
+			SAFE_RELEASE(pso);
+		});
+	}
+	workers.Wait();
+	workers.UnInit();
+	stats = cache.GetStats();
+	valid = valid && failed == 0 && stats.hits == 24 && stats.created == 3;
+	for (ID3D12PipelineState*& pso : first) {
+		SAFE_RELEASE(pso);
+	}
+	cache.UnInit();
+
+	printf("headless: pipeline cache 3 pipelines compiled once, warm launch loaded them in %.3f ms\n", warmLoadMs);
+	std::filesystem::remove_all(directory, error);
+	return valid;
+}
\ No newline at end of file
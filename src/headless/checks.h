@@ -0,0 +1,142 @@
+#pragma once
+
+#include "coreconst.h"
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+class HeadlessDevice;
+class GpuTimeline;
+class ResourceManager;
+class MockCommandList;
+
+// The headless executable's checks, one check<component>.cpp per component in src/headless.
+// main.cpp runs them all after the frame loop and reports the first one that fails.
+
+// Shared Helpers
+
+// Stand-in for D3DCompileFromFile: the "bytecode" is the entry, target, defines and source
+// behind a DXBC tag, and sources with an #error directive fail.
+bool StandInCompile(const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines,
+	std::vector<UINT8>* bytecode, std::string* errors, UINT* compileCount);
+
+// Copies only land once a queue runs the list, so checks that read back what they uploaded
+// submit the list, wait for it and reset it for the next check
+void ExecuteAndWait(ResourceManager* resourceManager, GpuTimeline* timeline, ID3D12GraphicsCommandList* commandList);
+
+// Test PNGs are written with stored deflate blocks and cycle through every row filter,
+// so the decoder's unfiltering, bit unpacking and Adam7 scatter are checked exactly
+struct TestPng {
+	UINT width, height, colorType, bitDepth, channels;
+	bool interlace;
+	std::function<UINT(UINT, UINT, UINT)> sample;
+	// Only for palette images, left out of the initializer otherwise
+	std::vector<UINT8> palette = {};
+	std::vector<UINT8> transparency = {};
+};
+
+std::vector<UINT8> WriteTestPng(const TestPng& png);
+
+// Checks, In The Order main Runs Them
+
+// Places a mix of buffers and textures, frees every other one and then the rest,
+// printing fragmentation in between. Returns false if any memory is left behind.
+bool CheckGpuAllocator(HeadlessDevice* device);
+
+// Queues a deferred release on a newer ticket, then one on an older ticket. Once only the
+// older ticket has completed its object must be released without waiting on the newer one.
+bool CheckGpuTimeline(HeadlessDevice* device);
+
+// Records an upload, then overwrites its staging bytes while the copy is still queued, the way a
+// ring slot reused too early would be. The destination must end up with the overwritten bytes,
+// so reading back uploads after the copy has retired is enough to catch early ring reuse.
+bool CheckDeferredCopies(HeadlessDevice* device);
+
+// Appends one mesh too large for 16-bit indices, then small meshes until the pool is full,
+// and checks every handle reads back its own vertices and indices in the format it was given.
+bool CheckGeometryPool(ResourceManager* resourceManager, GpuTimeline* timeline, ID3D12GraphicsCommandList* commandList);
+
+// Streams a set of assets through the copy queue while the direct queue keeps submitting
+// frames. Frames only wait on the GPU for the geometry, so the first one goes out before
+// the rest has arrived. Returns false if batching, tickets or the copied bytes are wrong,
+// including bytes staged before the ring wrapped and an upload retried after a flush.
+bool CheckAsyncUploader(HeadlessDevice* device, ResourceManager* resourceManager, ID3D12CommandQueue* directQueue);
+
+// Packs random vertices plus the octahedron's corner cases and checks the decode stays inside the
+// error each encoding allows: half rounding for positions and UVs, a few thousandths of a degree
+// for snorm16 octahedral normals. Then appends them to a packed pool and compares the bytes.
+bool CheckVertexFormat(ResourceManager* resourceManager, GpuTimeline* timeline, ID3D12GraphicsCommandList* commandList);
+
+// Imports Suzanne from a scratch copy so the cooked blob doesn't land in the source tree:
+// the first load parses, the second comes from the cook, a touched source parses again.
+// Also imports a small OBJ without normals to cover generated normals and negative indices.
+bool CheckMeshImporter();
+
+// Packs a small mesh, a two mip texture with unaligned rows and a shader blob, maps the
+// package back and uploads straight from the mapping. Blobs must sit on placement
+// boundaries and the staged texture bytes must be the mapped ones, copied as they are.
+bool CheckAssetPackage(ResourceManager* resourceManager, GpuTimeline* timeline, MockCommandList* commandList);
+
+// Decodes the shipped JPEGs (one with restart intervals) in both channel orders, generated
+// PNGs against their source samples, and checks every SIMD conversion against the scalar one.
+bool CheckImageDecoder();
+
+// Queues copies of both shipped images and a missing file on three decode workers. Every
+// texture must come back exactly once, decoded to the same bytes as a load on this thread.
+bool CheckTextureLoader();
+
+// Builds box and Kaiser chains for odd sized noise and checks every level against the
+// reference downsample of the level above it (exact for box, within 1 for Kaiser) and the
+// build's instruction set against the scalar path. A PNG loaded through the texture loader
+// must then upload one copy per level, with the smallest level staged intact.
+bool CheckMipGenerator(ResourceManager* resourceManager, MockCommandList* commandList);
+
+// Compresses a smooth odd sized image with alpha to every BC format and checks the decoded
+// blocks against the source (PSNR over the channels the format keeps), that solid blocks
+// come back within the endpoint precision and that compressing on workers gives the same
+// blocks. A BC7 chain written as DDS must load with its format and mips intact and upload
+// one copy per level.
+bool CheckBlockCompression(ResourceManager* resourceManager, MockCommandList* commandList);
+
+// Loads one image through two spellings of its path and a second encoding of the same pixels,
+// all three must share one resident texture. A fourth image over the budget only evicts the
+// unreferenced one once the GPU has retired the frame that drew it.
+bool CheckTextureCache(HeadlessDevice* device, ResourceManager* resourceManager, GpuTimeline* timeline);
+
+// Flies a camera past a row of quads whose full mip chains are far over the streaming
+// budget. Every frame the visible quads report their screen size, and the levels frames
+// still in flight may sample must stay mapped until those frames retire.
+bool CheckTextureStreamer(HeadlessDevice* device, GpuTimeline* timeline);
+
+// Compiles through the on-disk shader cache twice, as two launches would, and checks that
+// only a change to the source, an include, the defines, the target or the compiler misses.
+bool CheckShaderCache();
+
+// Variant names have to match the ones compile_shader() gives the embedded headers
+bool CheckShaderBytecode();
+
+// Startup as the renderer runs it: six shaders compile through one shader cache on four
+// workers, each slowed down like a real compile, and three pipelines wait on their pairs.
+// Pipelines must only start once both of their shaders are in, and a failed shader skips
+// its pipeline without holding up the others.
+bool CheckTaskGraph();
+
+// Three launches against one cache file: the first compiles every pipeline once however often
+// it is asked for, the second creates them all from the stored blobs, and after a driver
+// update the stale blobs are refused and replaced. A damaged file only costs a compile.
+bool CheckPipelineCache(HeadlessDevice* device);
+
+// The renderer's two permutations: every valid mask compiles once through the shader cache on
+// the worker pool into its own variant, exclusive keywords never combine, the variant names
+// match the ones compile_shader() embeds, and the scene settings select the right masks.
+bool CheckShaderPermutation();
+
+// Uploads vertices and 16/32-bit indices through the typed span path and byte-compares
+// both the staged upload heap bytes and the destination buffers against the source.
+bool CheckTypedUploads(ResourceManager* resourceManager, GpuTimeline* timeline, MockCommandList* commandList);
+
+// Shuffles a regular grid's triangles and vertices, runs the mesh optimizer and checks the
+// cache statistics improved while every triangle survived with its winding intact.
+bool CheckMeshOptimizer();
\ No newline at end of file
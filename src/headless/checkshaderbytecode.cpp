@@ -0,0 +1,23 @@
+#include "checks.h"
+#include "shaderbytecode.h"
+
+#include <string>
+
+bool CheckShaderBytecode()
+{
+	static const UINT8 plain[] = { 0x44, 0x58, 0x42, 0x43 };
+	static const UINT8 packed[] = { 0x44, 0x58, 0x42, 0x43, 0x01 };
+	const ShaderBytecodeEntry table[] = {
+		{ "VertexShader.main.vs_5_0", plain, sizeof(plain) },
+		{ "VertexShader.main.vs_5_0.PACKED_VERTICES=1", packed, sizeof(packed) },
+	};
+	const D3D_SHADER_MACRO packedDefines[] = { { "PACKED_VERTICES", "1" }, { nullptr, nullptr } };
+
+	std::string plainName = GetShaderVariantName(L"shaders/VertexShader.hlsl", "main", "vs_5_0", nullptr);
+	std::string packedName = GetShaderVariantName(L"shaders/VertexShader.hlsl", "main", "vs_5_0", packedDefines);
+	const ShaderBytecodeEntry* found = FindShaderBytecode(table, packedName);
+	bool valid = plainName == "VertexShader.main.vs_5_0" && packedName == "VertexShader.main.vs_5_0.PACKED_VERTICES=1";
+	valid = valid && FindShaderBytecode(table, plainName) == &table[0] && found && found->data == packed && found->size == sizeof(packed);
+	valid = valid && !FindShaderBytecode(table, GetShaderVariantName(L"shaders/VertexShader.hlsl", "main", "ps_5_0", nullptr));
+	return valid;
+}
\ No newline at end of file
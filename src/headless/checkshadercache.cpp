@@ -0,0 +1,111 @@
+#include "checks.h"
+#include "shadercache.h"
+
+#include <cstdio>
+#include <fstream>
+
+bool StandInCompile(const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines,
+	std::vector<UINT8>* bytecode, std::string* errors, UINT* compileCount)
+{
+	(*compileCount)++;
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		*errors = "cannot open " + path.string();
+		return false;
+	}
+	std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (source.find("#error") != std::string::npos) {
+		*errors = path.string() + "(1,1): error X1503: #error";
+		return false;
+	}
+	std::string output = std::string("DXBC") + entry + target;
+	for (const D3D_SHADER_MACRO* define = defines; define && define->Name; define++) {
+		output += std::string(define->Name) + "=" + define->Definition;
+	}
+	output += source;
+	bytecode->assign(output.begin(), output.end());
+	return true;
+}
+
+bool CheckShaderCache()
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "headless_shader_cache";
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+	std::filesystem::create_directories(directory / "shaders", error);
+	auto writeFile = [](const std::filesystem::path& path, const char* text) { std::ofstream(path, std::ios::binary) << text; };
+	std::filesystem::path shaderPath = directory / "shaders" / "Lit.hlsl";
+	std::filesystem::path brokenPath = directory / "shaders" / "Broken.hlsl";
+	writeFile(directory / "shaders" / "common.hlsli", "float4 Tint() { return 1.0f; }\n");
+	writeFile(shaderPath, "#include \"common.hlsli\"\nfloat4 main() : SV_TARGET { return Tint(); }\n");
+	writeFile(brokenPath, "#error unfinished\n");
+
+	UINT compileCount = 0;
+	auto compile = [&compileCount](const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines,
+		std::vector<UINT8>* bytecode, std::string* errors) {
+		return StandInCompile(path, entry, target, defines, bytecode, errors, &compileCount);
+	};
+	const D3D_SHADER_MACRO packedDefines[] = { { "PACKED_VERTICES", "1" }, { nullptr, nullptr } };
+
+	// First Launch Compiles Every Variant Once
+	ShaderCache cold;
+	if (!cold.Init(directory / "cache", compile, "stand-in 1")) {
+		return false;
+	}
+	std::vector<UINT8> ps, psAgain, psPacked, vs;
+	bool valid = cold.Load(shaderPath, "main", "ps_5_0", nullptr, &ps) && cold.Load(shaderPath, "main", "ps_5_0", nullptr, &psAgain);
+	valid = valid && cold.Load(shaderPath, "main", "ps_5_0", packedDefines, &psPacked) && cold.Load(shaderPath, "main", "vs_5_0", nullptr, &vs);
+	valid = valid && compileCount == 3 && cold.GetStats().hits == 1 && cold.GetStats().misses == 3 && psAgain == ps && psPacked != ps;
+	const D3D_SHADER_MACRO unpackedDefines[] = { { "PACKED_VERTICES", "0" }, { nullptr, nullptr } };
+	valid = valid && cold.GetKey(shaderPath, "main", "ps_5_0", unpackedDefines) != cold.GetKey(shaderPath, "main", "ps_5_0", packedDefines);
+
+	// Second Launch Compiles Nothing
+	ShaderCache warm;
+	warm.Init(directory / "cache", compile, "stand-in 1");
+	std::vector<UINT8> warmPs, warmPacked, warmVs;
+	valid = valid && warm.Load(shaderPath, "main", "ps_5_0", nullptr, &warmPs) && warm.Load(shaderPath, "main", "ps_5_0", packedDefines, &warmPacked);
+	valid = valid && warm.Load(shaderPath, "main", "vs_5_0", nullptr, &warmVs);
+	valid = valid && compileCount == 3 && warm.GetStats().hits == 3 && warm.GetStats().misses == 0;
+	valid = valid && warmPs == ps && warmPacked == psPacked && warmVs == vs;
+
+	// Editing An Include Or Changing The Compiler Misses
+	UINT64 oldKey = warm.GetKey(shaderPath, "main", "ps_5_0", nullptr);
+	writeFile(directory / "shaders" / "common.hlsli", "float4 Tint() { return 0.5f; }\n");
+	valid = valid && warm.GetKey(shaderPath, "main", "ps_5_0", nullptr) != oldKey;
+	valid = valid && warm.Load(shaderPath, "main", "ps_5_0", nullptr, &warmPs) && compileCount == 4;
+	ShaderCache newCompiler;
+	newCompiler.Init(directory / "cache", compile, "stand-in 2");
+	valid = valid && newCompiler.Load(shaderPath, "main", "ps_5_0", nullptr, &warmPs) && compileCount == 5 && newCompiler.GetStats().misses == 1;
+
+	// A Torn Entry Is Rejected And Compiled Again
+	std::filesystem::path entryPath = warm.GetEntryPath(warm.GetKey(shaderPath, "main", "ps_5_0", nullptr));
+	std::filesystem::resize_file(entryPath, std::filesystem::file_size(entryPath, error) - 4, error);
+	std::vector<UINT8> recompiled;
+	valid = valid && warm.Load(shaderPath, "main", "ps_5_0", nullptr, &recompiled) && recompiled == warmPs && compileCount == 6 && warm.GetStats().rejected == 1;
+	valid = valid && warm.Load(shaderPath, "main", "ps_5_0", nullptr, &recompiled) && recompiled == warmPs && compileCount == 6;
+
+	// So Is One Whose Size Was Damaged
+	{
+		UINT64 damagedSize = ~0ull >> 8;
+		std::fstream entry(entryPath, std::ios::binary | std::ios::in | std::ios::out);
+		entry.seekp(16);
+		entry.write(reinterpret_cast<const char*>(&damagedSize), sizeof(damagedSize));
+	}
+	valid = valid && warm.Load(shaderPath, "main", "ps_5_0", nullptr, &recompiled) && recompiled == warmPs && compileCount == 7 && warm.GetStats().rejected == 2;
+
+	// Failures Report Errors And Store Nothing
+	std::string errors;
+	std::vector<UINT8> broken;
+	valid = valid && !warm.Load(brokenPath, "main", "ps_5_0", nullptr, &broken, &errors) && errors.find("error") != std::string::npos;
+	valid = valid && !std::filesystem::exists(warm.GetEntryPath(warm.GetKey(brokenPath, "main", "ps_5_0", nullptr)), error);
+	valid = valid && !warm.Load(directory / "shaders" / "Missing.hlsl", "main", "ps_5_0", nullptr, &broken, &errors);
+	valid = valid && warm.GetStats().compileFailures == 2;
+
+	const ShaderCacheStats& stats = warm.GetStats();
+	printf("headless: shader cache %llu hits, %llu misses, %llu rejected, %llu bytes loaded, %llu stored, hash %.3f ms, load %.3f ms\n",
+		(unsigned long long)stats.hits, (unsigned long long)stats.misses, (unsigned long long)stats.rejected,
+		(unsigned long long)stats.bytesLoaded, (unsigned long long)stats.bytesStored, stats.hashMs, stats.loadMs);
+
+	std::filesystem::remove_all(directory, error);
+	return valid;
+}
\ No newline at end of file
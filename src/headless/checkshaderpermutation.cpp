@@ -0,0 +1,86 @@
+#include "checks.h"
+#include "shaderpermutation.h"
+#include "shadercache.h"
+#include "shaderbytecode.h"
+#include "taskgraph.h"
+#include "scene.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+bool CheckShaderPermutation()
+{
+	ShaderPermutation lit, post;
+	lit.Init("PixelShader", { "SPECULAR", "SHADOWS" });
+	post.Init("PPPixelShader", { "SHOW_SHADOW_MAP", "BOX_BLUR", "GAUSSIAN_BLUR" });
+	post.AddExclusiveGroup(PK_SHOW_SHADOW_MAP | PK_BOX_BLUR | PK_GAUSSIAN_BLUR);
+	std::vector<UINT32> litMasks = lit.GetMasks();
+	std::vector<UINT32> postMasks = post.GetMasks();
+	bool valid = litMasks == std::vector<UINT32>{ 0, 1, 2, 3 } && postMasks == std::vector<UINT32>{ 0, 1, 2, 4 };
+	valid = valid && !post.IsValid(PK_BOX_BLUR | PK_GAUSSIAN_BLUR) && !post.IsValid(post.GetMaskCount());
+
+	// Names Match compile_shader()
+	const D3D_SHADER_MACRO packedDefines[] = { { "PACKED_VERTICES", "1" }, { nullptr, nullptr } };
+	valid = valid && GetShaderVariantName("shaders/PixelShader.hlsl", "main", "ps_5_0", lit.GetDefines(LK_SPECULAR | LK_SHADOWS).data()) == "PixelShader.main.ps_5_0.SPECULAR=1.SHADOWS=1";
+	valid = valid && GetShaderVariantName("shaders/PPPixelShader.hlsl", "main", "ps_5_0", post.GetDefines(PK_BOX_BLUR).data()) == "PPPixelShader.main.ps_5_0.BOX_BLUR=1";
+	valid = valid && GetShaderVariantName("shaders/PPPixelShader.hlsl", "main", "ps_5_0", post.GetDefines(0).data()) == "PPPixelShader.main.ps_5_0";
+	valid = valid && GetShaderVariantName("shaders/PixelShader.hlsl", "main", "ps_5_0", lit.GetDefines(LK_SHADOWS, packedDefines).data()) == "PixelShader.main.ps_5_0.PACKED_VERTICES=1.SHADOWS=1";
+
+	// Every Variant Compiles Once, Into Its Own Bytecode
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "headless_shader_permutation";
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+	std::filesystem::create_directories(directory, error);
+	std::ofstream(directory / "PPPixelShader.hlsl", std::ios::binary) << "#if defined(BOX_BLUR)\nbox\n#else\nsample\n#endif\n";
+	std::atomic<UINT> compileCount = 0;
+	ShaderCache cache;
+	cache.Init(directory / "cache", [&compileCount](const std::filesystem::path& path, const char* entry, const char* target,
+		const D3D_SHADER_MACRO* defines, std::vector<UINT8>* bytecode, std::string* errors) {
+		UINT unused = 0;
+		compileCount++;
+		return StandInCompile(path, entry, target, defines, bytecode, errors, &unused);
+	}, "stand-in");
+	std::vector<std::vector<UINT8>> bytecode(post.GetMaskCount());
+	std::vector<std::vector<D3D_SHADER_MACRO>> defines(post.GetMaskCount());
+	std::vector<TaskId> tasks(post.GetMaskCount());
+	TaskGraph graph;
+	for (UINT32 mask : postMasks)
+	{
+		defines[mask] = post.GetDefines(mask);
+		tasks[mask] = graph.Add("PPPixelShader " + post.GetVariantLabel(mask), [&, mask]() {
+			return cache.Load(directory / "PPPixelShader.hlsl", "main", "ps_5_0", defines[mask].data(), &bytecode[mask]);
+		});
+	}
+	WorkerPool workers;
+	workers.Init(4);
+	valid = valid && graph.Run(&workers) && compileCount == postMasks.size();
+	workers.UnInit();
+	std::set<std::string> distinct;
+	for (UINT32 mask : postMasks)
+	{
+		post.SetVariantStats(mask, graph.GetTimings()[tasks[mask]].durationMs, bytecode[mask].size());
+		distinct.insert(std::string(bytecode[mask].begin(), bytecode[mask].end()));
+	}
+	valid = valid && distinct.size() == postMasks.size() && !bytecode[PK_SHOW_SHADOW_MAP].empty();
+
+	// One Line Per Variant Plus The Totals
+	std::string report = post.FormatReport();
+	valid = valid && std::count(report.begin(), report.end(), '\n') == (long)postMasks.size() + 1;
+	valid = valid && report.find("GAUSSIAN_BLUR") != std::string::npos && post.GetVariantLabel(0) == "default" && lit.GetVariantLabel(LK_SPECULAR | LK_SHADOWS) == "SPECULAR+SHADOWS";
+
+	// Settings Select The Masks
+	Scene scene;
+	scene.GetSettings().ppOption = 3;
+	scene.GetSettings().shadows = false;
+	valid = valid && scene.GetPostMask() == PK_GAUSSIAN_BLUR && scene.GetLightingMask() == LK_SPECULAR;
+	scene.GetSettings().ppOption = 0;
+	scene.GetSettings().shadows = true;
+	valid = valid && scene.GetPostMask() == 0 && scene.GetLightingMask() == (LK_SPECULAR | LK_SHADOWS);
+
+	printf("headless: shader permutations %zu lit and %zu post variants, post compiled in %.2f ms\n", litMasks.size(), postMasks.size(), graph.GetWallMs());
+	std::filesystem::remove_all(directory, error);
+	return valid;
+}
\ No newline at end of file
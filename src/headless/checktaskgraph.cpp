@@ -0,0 +1,93 @@
+#include "checks.h"
+#include "shadercache.h"
+#include "taskgraph.h"
+#include "workerpool.h"
+#include "scene.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+bool CheckTaskGraph()
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "headless_task_graph";
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+	std::filesystem::create_directories(directory, error);
+	const char* names[] = { "VertexShader", "PixelShader", "PPVertexShader", "PPPixelShader", "DSVertexShader", "DSPixelShader" };
+	for (const char* name : names) {
+		std::ofstream(directory / (std::string(name) + ".hlsl"), std::ios::binary) << "float4 main() : SV_TARGET { return " << strlen(name) << "; }\n";
+	}
+	std::ofstream(directory / "Broken.hlsl", std::ios::binary) << "#error unfinished\n";
+
+	std::atomic<UINT> compileCount = 0;
+	ShaderCache cache;
+	cache.Init(directory / "cache", [&compileCount](const std::filesystem::path& path, const char* entry, const char* target,
+		const D3D_SHADER_MACRO* defines, std::vector<UINT8>* bytecode, std::string* errors) {
+		UINT unused = 0;
+		compileCount++;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		return StandInCompile(path, entry, target, defines, bytecode, errors, &unused);
+	}, "stand-in");
+	WorkerPool workers;
+	workers.Init(4);
+
+	// Runs the startup graph, a pipeline "creates" when both of its shaders have bytecode
+	auto runStartup = [&](const char* brokenShader, TaskGraph* graph) {
+		std::vector<UINT8> bytecode[6];
+		TaskId shaders[6];
+		for (UINT i = 0; i < 6; i++)
+		{
+			std::filesystem::path path = directory / (std::string(brokenShader && i == 5 ? brokenShader : names[i]) + ".hlsl");
+			const char* target = i % 2 == 0 ? "vs_5_0" : "ps_5_0";
+			shaders[i] = graph->Add(names[i], [&cache, path, target, &bytecode, i]() { return cache.Load(path, "main", target, nullptr, &bytecode[i]); });
+		}
+		std::atomic<UINT> created = 0;
+		const char* pipelines[] = { "Scene PSO", "Post PSO", "Shadow PSO" };
+		for (UINT i = 0; i < 3; i++)
+		{
+			graph->Add(pipelines[i], [&bytecode, &created, i]() {
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+				bool ready = !bytecode[i * 2].empty() && !bytecode[i * 2 + 1].empty();
+				created += ready ? 1 : 0;
+				return ready;
+			}, { shaders[i * 2], shaders[i * 2 + 1] });
+		}
+		bool succeeded = graph->Run(&workers);
+		return std::make_pair(succeeded, created.load());
+	};
+
+	// Cold Start, Every Shader Compiles
+	TaskGraph cold;
+	auto [coldSucceeded, coldCreated] = runStartup(nullptr, &cold);
+	bool valid = coldSucceeded && coldCreated == 3 && compileCount == 6;
+	valid = valid && cold.GetWallMs() < cold.GetSerialMs() * 0.75;
+	for (UINT i = 6; i < 9; i++)
+	{
+		const TaskTiming& pso = cold.GetTimings()[i];
+		const TaskTiming& vsTiming = cold.GetTimings()[(i - 6) * 2];
+		const TaskTiming& psTiming = cold.GetTimings()[(i - 6) * 2 + 1];
+		valid = valid && pso.startMs >= vsTiming.startMs + vsTiming.durationMs && pso.startMs >= psTiming.startMs + psTiming.durationMs;
+	}
+
+	// Warm Start Compiles Nothing
+	TaskGraph warm;
+	auto [warmSucceeded, warmCreated] = runStartup(nullptr, &warm);
+	valid = valid && warmSucceeded && warmCreated == 3 && compileCount == 6 && cache.GetStats().hits == 6;
+
+	// A Broken Shader Skips Only Its Pipeline
+	TaskGraph broken;
+	auto [brokenSucceeded, brokenCreated] = runStartup("Broken", &broken);
+	valid = valid && !brokenSucceeded && brokenCreated == 2 && broken.GetTimings()[8].skipped && !broken.GetTimings()[5].succeeded;
+
+	printf("headless: startup graph cold %.2f ms for %.2f ms of work on %u workers, warm %.2f ms\n",
+		cold.GetWallMs(), cold.GetSerialMs(), workers.GetThreadCount(), warm.GetWallMs());
+
+	workers.UnInit();
+	std::filesystem::remove_all(directory, error);
+	return valid;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "gputimeline.h"
+#include "resourcemanager.h"
+#include "asyncuploader.h"
+#include "texturecache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+bool CheckTextureCache(HeadlessDevice* device, ResourceManager* resourceManager, GpuTimeline* timeline)
+{
+	AsyncUploader uploader;
+	TextureCache cache;
+	if (!uploader.Init(device, 1024 * 1024, 256 * 1024) || !cache.Init(resourceManager, &uploader, timeline, TEXTURE_CACHE_BUDGET, 2)) {
+		return false;
+	}
+	UINT64 usedBytes = resourceManager->GetGpuAllocator()->GetStats().usedBytes;
+
+	// RGBA and RGB Encodings Of One Image, Then Two Others
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "headless_texture_cache";
+	std::error_code error;
+	std::filesystem::create_directories(directory / "sub", error);
+	auto pattern = [](UINT seed) { return [seed](UINT x, UINT y, UINT c) { return c == 3 ? 255u : (x * 13 + y * 7 + c * 50 + seed * 90) & 255; }; };
+	const TestPng pngs[] = {
+		{ 32, 32, 6, 8, 4, false, pattern(0) },
+		{ 32, 32, 2, 8, 3, false, pattern(0) },
+		{ 32, 32, 6, 8, 4, false, pattern(1) },
+		{ 32, 32, 6, 8, 4, false, pattern(2) },
+	};
+	const char* names[] = { "a.png", "b.png", "c.png", "d.png" };
+	for (UINT i = 0; i < 4; i++) {
+		std::vector<UINT8> file = WriteTestPng(pngs[i]);
+		std::ofstream(directory / names[i], std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+	}
+
+	// Lookups By Normalized Path
+	TextureHandle a = cache.Acquire(directory / "a.png");
+	TextureHandle aAgain = cache.Acquire(directory / "sub" / ".." / "a.png");
+	TextureHandle b = cache.Acquire(directory / "b.png");
+	bool valid = a == aAgain && !(a == b) && cache.Find(directory / "." / "a.png") == a && !cache.Find(directory / "c.png").IsValid();
+	valid = valid && cache.GetRefCount(a) == 2 && cache.GetStats().misses == 2 && cache.GetStats().hits == 1;
+
+	// Content Deduplication
+	valid = valid && cache.WaitForResident(a) && cache.WaitForResident(b);
+	valid = valid && cache.GetResource(a) != nullptr && cache.GetResource(b) == cache.GetResource(a);
+	valid = valid && cache.GetStats().deduplicated == 1 && cache.GetStats().residentCount == 1;
+
+	// Budget Of Exactly Two Textures, The Released One Was Drawn By A Frame Still In Flight
+	TextureHandle c = cache.Acquire(directory / "c.png");
+	valid = valid && cache.WaitForResident(c) && cache.GetResource(c) != cache.GetResource(a);
+	uploader.Flush();
+	uploader.WaitFor(cache.GetUploadTicket(c));
+	cache.SetBudget(cache.GetStats().residentBytes);
+	cache.Release(c);
+	UINT64 frameTicket = timeline->Submit();
+	cache.MarkUsed(c, frameTicket);
+	TextureHandle d = cache.Acquire(directory / "d.png");
+	valid = valid && cache.WaitForResident(d) && cache.IsResident(c) && cache.GetStats().evictions == 0 && cache.GetStats().overBudget > 0;
+
+	// Retired, So Update Evicts It Back Under Budget
+	uploader.Flush();
+	uploader.WaitFor(cache.GetUploadTicket(d));
+	timeline->WaitFor(frameTicket);
+	cache.Update();
+	valid = valid && !cache.IsResident(c) && cache.IsResident(a) && cache.IsResident(d) && cache.GetStats().evictions == 1;
+	valid = valid && cache.GetStats().residentBytes <= cache.GetBudget();
+
+	// The Deduplicated File Pins Its Owner
+	cache.Release(a);
+	cache.Release(aAgain);
+	cache.Release(d);
+	cache.SetBudget(0);
+	valid = valid && cache.IsResident(b) && cache.IsResident(a) && !cache.IsResident(d);
+	cache.Release(b);
+	cache.SetBudget(0);
+	valid = valid && !cache.IsResident(a) && !cache.IsResident(b) && cache.GetStats().residentCount == 0;
+	valid = valid && resourceManager->GetGpuAllocator()->GetStats().usedBytes == usedBytes;
+
+	// Evicted Textures Decode Again, Missing Files Fail
+	TextureHandle missing = cache.Acquire(directory / "missing.png");
+	c = cache.Acquire(directory / "c.png");
+	valid = valid && !cache.WaitForResident(missing) && cache.IsFailed(missing) && cache.WaitForResident(c);
+
+	const TextureCacheStats& stats = cache.GetStats();
+	printf("headless: texture cache %llu hits, %llu misses, %llu deduplicated, %llu evictions, %llu over budget\n",
+		(unsigned long long)stats.hits, (unsigned long long)stats.misses, (unsigned long long)stats.deduplicated,
+		(unsigned long long)stats.evictions, (unsigned long long)stats.overBudget);
+	valid = valid && stats.misses == 6;
+
+	uploader.Flush();
+	uploader.WaitFor(cache.GetUploadTicket(c));
+	cache.Release(c);
+	cache.Release(missing);
+	cache.UnInit();
+	uploader.UnInit();
+	valid = valid && resourceManager->GetGpuAllocator()->GetStats().usedBytes == usedBytes;
+	std::filesystem::remove_all(directory, error);
+	return valid;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "checks.h"
+#include "textureloader.h"
+#include "timer.h"
+#include "texture.h"
+
+#include <cstdio>
+
+bool CheckTextureLoader()
+{
+	TextureLoader loader;
+	if (!loader.Init(3)) {
+		return false;
+	}
+
+	const char* paths[] = { ASSET_DIR "/gato.png", ASSET_DIR "/brick_color.jpg" };
+	Texture references[2];
+	bool valid = loader.Load(&references[0], paths[0]) && loader.Load(&references[1], paths[1]);
+
+	Texture textures[9];
+	Timer timer;
+	for (UINT i = 0; i < 8; i++) {
+		loader.Queue(&textures[i], paths[i % 2]);
+	}
+	loader.Queue(&textures[8], ASSET_DIR "/missing.png");
+
+	UINT popped[9] = {};
+	Texture* tex;
+	while (loader.PopDecoded(&tex, true)) {
+		popped[tex - textures]++;
+	}
+	float decodeMs = timer.GetFrameDelta();
+
+	for (UINT i = 0; i < 8 && valid; i++) {
+		Texture& reference = references[i % 2];
+		valid = popped[i] == 1 && textures[i].GetState() == TS_DECODED && textures[i].GetSize() == reference.GetSize();
+		valid = valid && memcmp(textures[i].GetData(), reference.GetData(), reference.GetSize()) == 0;
+	}
+	valid = valid && popped[8] == 1 && textures[8].GetState() == TS_FAILED && textures[8].GetData() == nullptr;
+	valid = valid && loader.GetPendingCount() == 0 && !loader.PopDecoded(&tex, false);
+
+	printf("headless: texture loader 9 queued images on %u workers in %.2f ms\n", loader.GetThreadCount(), decodeMs);
+
+	for (Texture& texture : textures) {
+		texture.CleanObsoleteTextureData();
+	}
+	for (Texture& reference : references) {
+		reference.CleanObsoleteTextureData();
+	}
+	loader.UnInit();
+	return valid;
+}
\ No newline at end of file
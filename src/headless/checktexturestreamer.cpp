@@ -0,0 +1,112 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "gputimeline.h"
+#include "asyncuploader.h"
+#include "texturestreamer.h"
+#include "mipgenerator.h"
+#include "texture.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+
+bool CheckTextureStreamer(HeadlessDevice* device, GpuTimeline* timeline)
+{
+	const UINT quadCount = 12;
+	const UINT64 budget = 8 * 1024 * 1024;
+	AsyncUploader uploader;
+	TextureStreamer streamer;
+	if (!uploader.Init(device, 8 * 1024 * 1024, 2 * 1024 * 1024) || !streamer.Init(device, &uploader, timeline, budget)) {
+		return false;
+	}
+
+	// One 512x512 Chain Shared By Every Quad
+	D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 512, 512, 1, 10);
+	std::vector<std::vector<UINT8>> levels(desc.MipLevels);
+	std::vector<D3D12_SUBRESOURCE_DATA> subresources(desc.MipLevels);
+	for (UINT mip = 0; mip < desc.MipLevels; mip++)
+	{
+		UINT size = std::max<UINT>(1, 512 >> mip);
+		levels[mip].assign((size_t)size * size * 4, (UINT8)(mip * 25));
+		subresources[mip] = { levels[mip].data(), (LONG_PTR)size * 4, (LONG_PTR)size * size * 4 };
+	}
+	UINT32 quads[quadCount];
+	bool valid = true;
+	for (UINT i = 0; i < quadCount; i++)
+	{
+		quads[i] = streamer.Register(desc, subresources.data(), L"Streamed Quad Texture");
+		valid = valid && quads[i] != STREAMED_TEXTURE_INVALID;
+	}
+	if (!valid) {
+		streamer.UnInit();
+		uploader.UnInit();
+		return false;
+	}
+	uploader.Flush();
+
+	// The camera looks down +z from 2.5 in front of the row, then holds still over the last quad
+	float aspect = (float)DEFAULT_WINDOW_WIDTH / DEFAULT_WINDOW_HEIGHT;
+	Float4x4 proj = MatrixPerspectiveFovLH(3.14159f / 3.0f, aspect, 0.1f, 100.0f);
+	float halfWidth = 2.5f * aspect / proj.m[1][1];
+	const UINT flyFrames = 120;
+	const UINT holdFrames = 40;
+	UINT64 missesBeforeSettled = 0;
+
+	// Resident levels of every frame still on the GPU
+	struct InFlight { UINT64 ticket; std::vector<UINT> residentMips; };
+	std::deque<InFlight> inFlight;
+	for (UINT frame = 0; frame < flyFrames + holdFrames; frame++)
+	{
+		float cameraX = std::min<float>((float)frame, (float)flyFrames) * (quadCount - 1) * 2.5f / flyFrames;
+		Float4x4 view = MatrixLookAtLH(Float3(cameraX, 0.0f, -2.5f), Float3(cameraX, 0.0f, 0.0f), Float3(0.0f, 1.0f, 0.0f));
+		for (UINT i = 0; i < quadCount; i++)
+		{
+			if (std::abs(i * 2.5f - cameraX) < halfWidth + 1.0f) {
+				streamer.Request(quads[i], TextureStreamer::GetScreenSize(view, proj, Float3(i * 2.5f, 0.0f, 0.0f), 1.0f, DEFAULT_WINDOW_HEIGHT));
+			}
+		}
+		streamer.Update();
+
+		InFlight submitted;
+		for (UINT i = 0; i < quadCount; i++) {
+			submitted.residentMips.push_back(streamer.GetResidentMip(quads[i]));
+		}
+		submitted.ticket = timeline->Submit();
+		inFlight.push_back(submitted);
+		while (!inFlight.empty() && timeline->IsComplete(inFlight.front().ticket)) {
+			inFlight.pop_front();
+		}
+		for (const InFlight& pending : inFlight)
+		{
+			for (UINT i = 0; i < quadCount; i++)
+			{
+				MockResource* resource = static_cast<MockResource*>(streamer.GetResource(quads[i]));
+				for (UINT mip = pending.residentMips[i]; mip < desc.MipLevels; mip++) {
+					valid = valid && resource->IsSubresourceMapped(mip);
+				}
+			}
+		}
+
+		valid = valid && streamer.GetStats().residentBytes <= budget;
+		if (frame == flyFrames + holdFrames / 2) {
+			missesBeforeSettled = streamer.GetStats().mipMisses;
+		}
+	}
+	timeline->WaitForIdle();
+
+	const TextureStreamerStats& stats = streamer.GetStats();
+	printf("headless: texture streamer %llu of %llu bytes resident (peak %llu), %llu promotions, %llu demotions, %llu misses in %llu requests\n",
+		(unsigned long long)stats.residentBytes, (unsigned long long)budget, (unsigned long long)stats.peakResidentBytes,
+		(unsigned long long)stats.promotions, (unsigned long long)stats.demotions, (unsigned long long)stats.mipMisses,
+		(unsigned long long)stats.requests);
+	valid = valid && stats.peakResidentBytes <= budget && stats.promotions > 0 && stats.demotions > 0;
+	valid = valid && stats.mipMisses == missesBeforeSettled && streamer.GetResidentMip(quads[quadCount - 1]) == 0;
+	for (UINT i = 0; i < quadCount; i++) {
+		valid = valid && static_cast<MockResource*>(streamer.GetResource(quads[i]))->GetUnmappedWrites() == 0;
+	}
+
+	streamer.UnInit();
+	uploader.UnInit();
+	return valid;
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "mockcommandlist.h"
+#include "gputimeline.h"
+#include "resourcemanager.h"
+
+#include <cstdio>
+
+void ExecuteAndWait(ResourceManager* resourceManager, GpuTimeline* timeline, ID3D12GraphicsCommandList* commandList)
+{
+	commandList->Close();
+	ID3D12CommandList* ppCommandLists[] = { commandList };
+	timeline->GetCommandQueue()->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+	UINT64 ticket = timeline->Submit();
+	resourceManager->FinishUploads(ticket);
+	timeline->WaitFor(ticket);
+	commandList->Reset(nullptr, nullptr);
+}
+
+bool CheckDeferredCopies(HeadlessDevice* device)
+{
+	D3D12_COMMAND_QUEUE_DESC cqDesc = {};
+	ID3D12CommandQueue* commandQueue;
+	device->CreateCommandQueue(&cqDesc, IID_PPV_ARGS(&commandQueue));
+	static_cast<MockCommandQueue*>(commandQueue)->SetLatency(2);
+	GpuTimeline timeline;
+	ResourceManager resourceManager;
+	if (!timeline.Init(device, commandQueue) || !resourceManager.Init(device, &timeline, 64 * 1024)) {
+		SAFE_RELEASE(commandQueue);
+		return false;
+	}
+
+	std::vector<UINT8> uploaded(4096, 0x11);
+	std::vector<UINT8> reused(uploaded.size(), 0x22);
+	GpuAllocation buffer;
+	resourceManager.CreateVIBuffer(L"Deferred Copy Buffer", (int)uploaded.size(), &buffer);
+	MockCommandList* commandList = new MockCommandList();
+	bool valid = resourceManager.UploadBuffer(commandList, buffer, uploaded.data(), (int)uploaded.size());
+	commandList->Close();
+	ID3D12CommandList* ppCommandLists[] = { commandList };
+	commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+	UINT64 ticket = timeline.Submit();
+	resourceManager.FinishUploads(ticket);
+
+	// Overwrite The Staging Bytes Before The Copy Retires
+	UINT8* staged = static_cast<MockResource*>(commandList->GetLastCopySource())->GetStorage() + commandList->GetLastCopySourceOffset();
+	const UINT8* stored = static_cast<MockResource*>(buffer.resource)->GetStorage() + buffer.offset;
+	valid = valid && !timeline.IsComplete(ticket) && memcmp(stored, uploaded.data(), uploaded.size()) != 0;
+	memcpy(staged, reused.data(), reused.size());
+
+	timeline.WaitFor(ticket);
+	valid = valid && memcmp(stored, reused.data(), reused.size()) == 0;
+
+	resourceManager.FreeResource(&buffer);
+	resourceManager.UnInit();
+	SAFE_RELEASE(commandList);
+	timeline.UnInit();
+	SAFE_RELEASE(commandQueue);
+	return valid;
+}
+
+bool CheckTypedUploads(ResourceManager* resourceManager, GpuTimeline* timeline, MockCommandList* commandList)
+{
+	std::vector<Vertex> vertices;
+	for (int i = 0; i < 3000; i++) {
+		vertices.push_back(Vertex((float)i, (float)(i * 2), (float)(i * 3), (float)(i % 7), (float)(i % 5)));
+	}
+	std::vector<UINT32> shortIndices, longIndices;
+	for (UINT32 i = 0; i < 900; i++) {
+		shortIndices.push_back((i * 17) % (UINT32)vertices.size());
+	}
+	for (UINT32 i = 0; i < 20000; i++) {
+		longIndices.push_back(i * 97);
+	}
+
+	// The short mesh fits 16-bit indices, a 70000 vertex mesh does not
+	DXGI_FORMAT shortFormat = IndexFormatFor(vertices.size());
+	DXGI_FORMAT longFormat = IndexFormatFor(70000);
+	if (shortFormat != DXGI_FORMAT_R16_UINT || longFormat != DXGI_FORMAT_R32_UINT) {
+		return false;
+	}
+
+	GpuAllocation vertexBuffer, shortIndexBuffer, longIndexBuffer;
+	resourceManager->CreateVIBuffer(L"Typed Vertex Buffer", (int)(vertices.size() * sizeof(Vertex)), &vertexBuffer);
+	resourceManager->CreateVIBuffer(L"Typed Short Index Buffer", (int)(shortIndices.size() * IndexSizeOf(shortFormat)), &shortIndexBuffer);
+	resourceManager->CreateVIBuffer(L"Typed Long Index Buffer", (int)(longIndices.size() * IndexSizeOf(longFormat)), &longIndexBuffer);
+
+	commandList->Reset(nullptr, nullptr);
+	UINT64 copyBytes = commandList->GetCopyBytes();
+	UINT64 barrierCalls = commandList->GetBarrierCallCount();
+	UINT64 barriers = commandList->GetBarrierCount();
+	bool valid = true;
+
+	// Staged bytes are read back through the source of the copy the upload recorded
+	auto staged = [commandList]() {
+		return static_cast<MockResource*>(commandList->GetLastCopySource())->GetStorage() + commandList->GetLastCopySourceOffset();
+	};
+	auto stored = [](const GpuAllocation& allocation) {
+		return static_cast<MockResource*>(allocation.resource)->GetStorage() + allocation.offset;
+	};
+
+	valid = valid && resourceManager->UploadVertices(commandList, vertexBuffer, vertices);
+	valid = valid && memcmp(staged(), vertices.data(), vertices.size() * sizeof(Vertex)) == 0;
+
+	valid = valid && resourceManager->UploadIndices(commandList, shortIndexBuffer, shortIndices, shortFormat);
+	for (size_t i = 0; i < shortIndices.size() && valid; i++) {
+		valid = reinterpret_cast<UINT16*>(staged())[i] == shortIndices[i];
+	}
+
+	valid = valid && resourceManager->UploadIndices(commandList, longIndexBuffer, longIndices, longFormat);
+	valid = valid && memcmp(staged(), longIndices.data(), longIndices.size() * sizeof(UINT32)) == 0;
+
+	// Copies sized from the spans, both placed buffers transition in a single call
+	UINT64 expectedBytes = vertices.size() * sizeof(Vertex) + shortIndices.size() * sizeof(UINT16) + longIndices.size() * sizeof(UINT32);
+	resourceManager->FlushBarriers(commandList);
+	valid = valid && commandList->GetCopyBytes() - copyBytes == expectedBytes;
+	valid = valid && commandList->GetBarrierCallCount() - barrierCalls == 1 && commandList->GetBarrierCount() - barriers == 2;
+
+	// The destinations once the queue has run the copies
+	ExecuteAndWait(resourceManager, timeline, commandList);
+	valid = valid && memcmp(stored(vertexBuffer), vertices.data(), vertices.size() * sizeof(Vertex)) == 0;
+	for (size_t i = 0; i < shortIndices.size() && valid; i++) {
+		valid = reinterpret_cast<UINT16*>(stored(shortIndexBuffer))[i] == shortIndices[i];
+	}
+	valid = valid && memcmp(stored(longIndexBuffer), longIndices.data(), longIndices.size() * sizeof(UINT32)) == 0;
+	commandList->Close();
+
+	printf("headless: typed uploads %llu bytes, %s and %s indices\n", (unsigned long long)expectedBytes,
+		shortFormat == DXGI_FORMAT_R16_UINT ? "16-bit" : "32-bit", longFormat == DXGI_FORMAT_R16_UINT ? "16-bit" : "32-bit");
+
+	resourceManager->FreeResource(&vertexBuffer);
+	resourceManager->FreeResource(&shortIndexBuffer);
+	resourceManager->FreeResource(&longIndexBuffer);
+	return valid;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "checks.h"
+#include "headlessdevice.h"
+#include "gputimeline.h"
+#include "resourcemanager.h"
+#include "geometrypool.h"
+#include "vertexformat.h"
+
+#include <cstdio>
+
+bool CheckVertexFormat(ResourceManager* resourceManager, GpuTimeline* timeline, ID3D12GraphicsCommandList* commandList)
+{
+	UINT32 seed = 777;
+	auto random = [&seed](float low, float high) { seed = seed * 1664525u + 1013904223u; return low + (high - low) * (float)(seed >> 8) / 16777216.0f; };
+
+	const float positionRange = 50.0f;
+	std::vector<Vertex> vertices;
+	const float corners[][3] = { {0, 0, 1}, {0, 0, -1}, {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {1, 1, -1}, {-1, -1, -1}, {0, 0, 0} };
+	for (const float* corner : corners) {
+		Vertex vertex(0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+		vertex.normals = Float3(corner[0], corner[1], corner[2]);
+		vertices.push_back(vertex);
+	}
+	for (int i = 0; i < 4096; i++) {
+		Vertex vertex(random(-positionRange, positionRange), random(-positionRange, positionRange), random(-positionRange, positionRange), random(0.0f, 1.0f), random(0.0f, 1.0f));
+		vertex.normals = Float3(random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f));
+		vertices.push_back(vertex);
+	}
+
+	std::vector<PackedVertex> packed(vertices.size());
+	WriteVertices(vertices, VL_PACKED, packed.data());
+	VertexPackError error = MeasurePackError(vertices, packed);
+
+	const float positionBound = positionRange / 2048.0f;
+	const float texCoordBound = 1.0f / 4096.0f;
+	const float normalBound = 0.01f;
+	printf("headless: packed vertices %u bytes instead of %u, max error position %.5f (bound %.5f), normal %.5f deg, uv %.6f\n",
+		GetVertexFormat(VL_PACKED).stride, GetVertexFormat(VL_FULL).stride, error.position, positionBound, error.normalDegrees, error.texCoord);
+	bool valid = error.position <= positionBound && error.normalDegrees <= normalBound && error.texCoord <= texCoordBound;
+	valid = valid && sizeof(PackedVertex) == 16 && GetVertexFormat(VL_PACKED).stride == sizeof(PackedVertex) && GetVertexFormat(VL_FULL).stride == sizeof(Vertex);
+
+	// Input layouts come out of the descriptor in attribute order
+	for (VERTEX_LAYOUT layout : { VL_FULL, VL_PACKED }) {
+		D3D12_INPUT_ELEMENT_DESC elements[MAX_VERTEX_ATTRIBUTES];
+		D3D12_INPUT_LAYOUT_DESC inputLayout = GetVertexFormat(layout).GetInputLayout(elements);
+		valid = valid && inputLayout.NumElements == 3 && strcmp(elements[1].SemanticName, "NORMALS") == 0;
+		valid = valid && elements[0].AlignedByteOffset == 0 && elements[2].AlignedByteOffset < GetVertexFormat(layout).stride;
+	}
+
+	// A packed pool encodes while staging
+	GeometryPool pool;
+	if (!pool.Init(resourceManager, 1024, 2048, 0, VL_PACKED)) {
+		return false;
+	}
+	std::span<const Vertex> meshVertices(vertices.data(), 512);
+	std::vector<UINT32> indices(768);
+	for (UINT32 i = 0; i < indices.size(); i++) {
+		indices[i] = i % meshVertices.size();
+	}
+	MeshHandle first, second;
+	valid = valid && pool.AddMesh(commandList, meshVertices, indices, &first) && pool.AddMesh(commandList, meshVertices, indices, &second);
+	ExecuteAndWait(resourceManager, timeline, commandList);
+	const UINT8* pooled = static_cast<MockResource*>(pool.GetVertexBuffer().resource)->GetStorage() + pool.GetVertexBuffer().offset;
+	valid = valid && pool.GetVertexBufferView().StrideInBytes == sizeof(PackedVertex);
+	valid = valid && memcmp(pooled + second.baseVertex * sizeof(PackedVertex), packed.data(), meshVertices.size() * sizeof(PackedVertex)) == 0;
+
+	pool.UnInit();
+	return valid;
+}
\ No newline at end of file
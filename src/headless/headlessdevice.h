@@ -0,0 +1,364 @@
+#pragma once
+
+// MockDevice that actually creates (CPU backed) objects and computes real copyable
+// footprints, so ResourceManager and the upload paths can run headless.
+
+#include "mockobjects.h"
+#include "mockqueue.h"
+#include "mockcommandlist.h"
+#include "MockDevice.hpp"
+
+#include <d3dx12_property_format_table.h>
+
+#include <algorithm>
+
+class HeadlessDevice : public MockDevice
+{
+public:
+    HeadlessDevice()
+    {
+        m_TiledResourcesTier = D3D12_TILED_RESOURCES_TIER_1;
+    }
+
+    // Only ID3D12Device itself, pipeline libraries and the other newer interfaces are not mocked
+    virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+    {
+        if (riid != __uuidof(ID3D12Device) && riid != __uuidof(IUnknown))
+        {
+            *ppvObject = nullptr;
+            return E_NOINTERFACE;
+        }
+        *ppvObject = this;
+        return S_OK;
+    }
+
+    // A pipeline's cached blob names the driver version and its shaders, a blob from another
+    // version or for other shaders is refused as a real driver would
+    virtual HRESULT STDMETHODCALLTYPE CreateGraphicsPipelineState(
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC* pDesc,
+        REFIID /*riid*/,
+        void** ppPipelineState) override
+    {
+        UINT64 blob[3] = { m_DriverVersion, pDesc->VS.BytecodeLength, pDesc->PS.BytecodeLength };
+        if (pDesc->CachedPSO.CachedBlobSizeInBytes > 0)
+        {
+            if (pDesc->CachedPSO.CachedBlobSizeInBytes != sizeof(blob) || memcmp(pDesc->CachedPSO.pCachedBlob, blob, sizeof(blob)) != 0)
+            {
+                return E_INVALIDARG;
+            }
+            m_PipelinesFromBlob++;
+        }
+        else
+        {
+            m_PipelinesCompiled++;
+        }
+        const UINT8* bytes = reinterpret_cast<const UINT8*>(blob);
+        *ppPipelineState = new MockPipelineState(std::vector<UINT8>(bytes, bytes + sizeof(blob)));
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE CreateCommandQueue(
+        const D3D12_COMMAND_QUEUE_DESC* pDesc,
+        REFIID /*riid*/,
+        void** ppCommandQueue) override
+    {
+        *ppCommandQueue = new MockCommandQueue(*pDesc);
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE CreateCommandAllocator(
+        D3D12_COMMAND_LIST_TYPE /*type*/,
+        REFIID /*riid*/,
+        void** ppCommandAllocator) override
+    {
+        *ppCommandAllocator = new MockCommandAllocator();
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE CreateCommandList(
+        UINT /*nodeMask*/,
+        D3D12_COMMAND_LIST_TYPE type,
+        ID3D12CommandAllocator* /*pCommandAllocator*/,
+        ID3D12PipelineState* /*pInitialState*/,
+        REFIID /*riid*/,
+        void** ppCommandList) override
+    {
+        *ppCommandList = new MockCommandList(type);
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE CreateFence(
+        UINT64 InitialValue,
+        D3D12_FENCE_FLAGS /*Flags*/,
+        REFIID /*riid*/,
+        void** ppFence) override
+    {
+        *ppFence = new MockFence(InitialValue);
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE CreateCommittedResource(
+        const D3D12_HEAP_PROPERTIES* pHeapProperties,
+        D3D12_HEAP_FLAGS /*HeapFlags*/,
+        const D3D12_RESOURCE_DESC* pDesc,
+        D3D12_RESOURCE_STATES /*InitialResourceState*/,
+        const D3D12_CLEAR_VALUE* /*pOptimizedClearValue*/,
+        REFIID /*riidResource*/,
+        void** ppvResource) override
+    {
+        if (!ppvResource)
+        {
+            return S_FALSE;
+        }
+
+        UINT64 size = pDesc->Width;
+        if (pDesc->Dimension != D3D12_RESOURCE_DIMENSION_BUFFER)
+        {
+            GetCopyableFootprints(pDesc, 0, pDesc->MipLevels * pDesc->DepthOrArraySize, 0, nullptr, nullptr, nullptr, &size);
+        }
+
+        *ppvResource = new MockResource(*pDesc, pHeapProperties->Type, size);
+        m_CommittedResourceCount++;
+        m_CommittedResourceBytes += size;
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE CreateHeap(
+        const D3D12_HEAP_DESC* pDesc,
+        REFIID /*riid*/,
+        void** ppvHeap) override
+    {
+        *ppvHeap = new MockHeap(*pDesc);
+        m_HeapCount++;
+        m_HeapBytes += pDesc->SizeInBytes;
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE CreatePlacedResource(
+        ID3D12Heap* pHeap,
+        UINT64 HeapOffset,
+        const D3D12_RESOURCE_DESC* pDesc,
+        D3D12_RESOURCE_STATES /*InitialState*/,
+        const D3D12_CLEAR_VALUE* /*pOptimizedClearValue*/,
+        REFIID /*riid*/,
+        void** ppvResource) override
+    {
+        D3D12_RESOURCE_ALLOCATION_INFO info = GetAllocationInfo(*pDesc);
+        D3D12_HEAP_DESC heapDesc = static_cast<MockHeap*>(pHeap)->GetDesc();
+        if (HeapOffset % info.Alignment != 0 || HeapOffset + info.SizeInBytes > heapDesc.SizeInBytes)
+        {
+            return E_INVALIDARG;
+        }
+
+        *ppvResource = new MockResource(*pDesc, heapDesc.Properties.Type, info.SizeInBytes);
+        m_PlacedResourceCount++;
+        return S_OK;
+    }
+
+    // CPU storage for the whole chain, copies into it check their tiles are mapped
+    virtual HRESULT STDMETHODCALLTYPE CreateReservedResource(
+        const D3D12_RESOURCE_DESC* pDesc,
+        D3D12_RESOURCE_STATES /*InitialState*/,
+        const D3D12_CLEAR_VALUE* /*pOptimizedClearValue*/,
+        REFIID /*riid*/,
+        void** ppvResource) override
+    {
+        if (pDesc->Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE2D || pDesc->Layout != D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE)
+        {
+            return E_INVALIDARG;
+        }
+
+        UINT64 size = 0;
+        GetCopyableFootprints(pDesc, 0, pDesc->MipLevels, 0, nullptr, nullptr, nullptr, &size);
+        MockResource* resource = new MockResource(*pDesc, D3D12_HEAP_TYPE_DEFAULT, size);
+        D3D12_PACKED_MIP_INFO packedMips;
+        std::vector<D3D12_SUBRESOURCE_TILING> tilings(pDesc->MipLevels);
+        ComputeTiling(*pDesc, &packedMips, nullptr, tilings.data());
+        tilings.resize(packedMips.NumStandardMips);
+        resource->SetTiling(tilings, packedMips.NumTilesForPackedMips);
+        *ppvResource = resource;
+        m_ReservedResourceCount++;
+        return S_OK;
+    }
+
+    virtual void STDMETHODCALLTYPE GetResourceTiling(
+        ID3D12Resource* pTiledResource,
+        UINT* pNumTilesForEntireResource,
+        D3D12_PACKED_MIP_INFO* pPackedMipDesc,
+        D3D12_TILE_SHAPE* pStandardTileShapeForNonPackedMips,
+        UINT* pNumSubresourceTilings,
+        UINT FirstSubresourceTilingToGet,
+        D3D12_SUBRESOURCE_TILING* pSubresourceTilingsForNonPackedMips) override
+    {
+        D3D12_RESOURCE_DESC desc = pTiledResource->GetDesc();
+        D3D12_PACKED_MIP_INFO packedMips;
+        std::vector<D3D12_SUBRESOURCE_TILING> tilings(desc.MipLevels);
+        UINT tileCount = ComputeTiling(desc, &packedMips, pStandardTileShapeForNonPackedMips, tilings.data());
+        if (pNumTilesForEntireResource) *pNumTilesForEntireResource = tileCount;
+        if (pPackedMipDesc) *pPackedMipDesc = packedMips;
+        if (pNumSubresourceTilings)
+        {
+            UINT count = 0;
+            for (UINT i = FirstSubresourceTilingToGet; i < desc.MipLevels && count < *pNumSubresourceTilings; i++)
+            {
+                pSubresourceTilingsForNonPackedMips[count++] = tilings[i];
+            }
+            *pNumSubresourceTilings = count;
+        }
+    }
+
+#if defined(_MSC_VER) || !defined(_WIN32)
+    virtual D3D12_RESOURCE_ALLOCATION_INFO STDMETHODCALLTYPE GetResourceAllocationInfo(
+        UINT /*visibleMask*/,
+        UINT /*numResourceDescs*/,
+        const D3D12_RESOURCE_DESC* pResourceDescs) override
+    {
+        return GetAllocationInfo(pResourceDescs[0]);
+    }
+#endif
+
+    virtual void STDMETHODCALLTYPE GetCopyableFootprints(
+        const D3D12_RESOURCE_DESC* pResourceDesc,
+        UINT FirstSubresource,
+        UINT NumSubresources,
+        UINT64 BaseOffset,
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT* pLayouts,
+        UINT* pNumRows,
+        UINT64* pRowSizeInBytes,
+        UINT64* pTotalBytes) override
+    {
+        if (pResourceDesc->Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+        {
+            if (pLayouts)
+            {
+                pLayouts[0].Offset = BaseOffset;
+                pLayouts[0].Footprint = { DXGI_FORMAT_UNKNOWN, (UINT)pResourceDesc->Width, 1, 1,
+                    (UINT)((pResourceDesc->Width + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(UINT64)(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1)) };
+            }
+            if (pNumRows) pNumRows[0] = 1;
+            if (pRowSizeInBytes) pRowSizeInBytes[0] = pResourceDesc->Width;
+            if (pTotalBytes) *pTotalBytes = pResourceDesc->Width;
+            return;
+        }
+
+        // 2D textures: 256 byte row pitch, 512 byte subresource placement
+        UINT bitsPerUnit = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetBitsPerUnit(pResourceDesc->Format);
+        UINT blockWidth = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetWidthAlignment(pResourceDesc->Format);
+        UINT blockHeight = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetHeightAlignment(pResourceDesc->Format);
+        UINT mipLevels = pResourceDesc->MipLevels ? pResourceDesc->MipLevels : 1;
+
+        UINT64 offset = BaseOffset;
+        UINT64 total = 0;
+        for (UINT i = 0; i < NumSubresources; i++)
+        {
+            UINT mip = (FirstSubresource + i) % mipLevels;
+            UINT width = (UINT)std::max<UINT64>(1, pResourceDesc->Width >> mip);
+            UINT height = std::max<UINT>(1, pResourceDesc->Height >> mip);
+            UINT blocksWide = (width + blockWidth - 1) / blockWidth;
+            UINT blocksHigh = (height + blockHeight - 1) / blockHeight;
+            UINT64 rowSize = (UINT64)blocksWide * bitsPerUnit / 8;
+            UINT rowPitch = (UINT)((rowSize + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(UINT64)(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1));
+
+            offset = (offset + D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1) & ~(UINT64)(D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - 1);
+            if (pLayouts)
+            {
+                pLayouts[i].Offset = offset;
+                pLayouts[i].Footprint = { pResourceDesc->Format, width, height, 1, rowPitch };
+            }
+            if (pNumRows) pNumRows[i] = blocksHigh;
+            if (pRowSizeInBytes) pRowSizeInBytes[i] = rowSize;
+
+            total = offset + (UINT64)rowPitch * (blocksHigh - 1) + rowSize - BaseOffset;
+            offset += (UINT64)rowPitch * blocksHigh;
+        }
+        if (pTotalBytes) *pTotalBytes = total;
+    }
+
+    virtual UINT STDMETHODCALLTYPE GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE /*DescriptorHeapType*/) override
+    {
+        return 32;
+    }
+
+    UINT64 GetCommittedResourceCount() const { return m_CommittedResourceCount; }
+    UINT64 GetCommittedResourceBytes() const { return m_CommittedResourceBytes; }
+    UINT64 GetPlacedResourceCount() const { return m_PlacedResourceCount; }
+    UINT64 GetHeapCount() const { return m_HeapCount; }
+    UINT64 GetHeapBytes() const { return m_HeapBytes; }
+    UINT64 GetReservedResourceCount() const { return m_ReservedResourceCount; }
+    UINT64 GetPipelinesCompiled() const { return m_PipelinesCompiled; }
+    UINT64 GetPipelinesFromBlob() const { return m_PipelinesFromBlob; }
+    void SetDriverVersion(UINT64 version) { m_DriverVersion = version; }
+
+private:
+    // Everything is 64KB aligned, textures take their linear footprint size
+    D3D12_RESOURCE_ALLOCATION_INFO GetAllocationInfo(const D3D12_RESOURCE_DESC& desc)
+    {
+        UINT64 size = desc.Width;
+        if (desc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER)
+        {
+            GetCopyableFootprints(&desc, 0, desc.MipLevels * desc.DepthOrArraySize, 0, nullptr, nullptr, nullptr, &size);
+        }
+
+        D3D12_RESOURCE_ALLOCATION_INFO info = {};
+        info.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        info.SizeInBytes = (size + info.Alignment - 1) & ~(info.Alignment - 1);
+        return info;
+    }
+
+    // Standard 64KB tile shapes, a mip smaller than one tile in either dimension and every mip
+    // after it are packed into the fewest tiles that hold their bytes
+    UINT ComputeTiling(const D3D12_RESOURCE_DESC& desc, D3D12_PACKED_MIP_INFO* packedMips, D3D12_TILE_SHAPE* shape, D3D12_SUBRESOURCE_TILING* tilings)
+    {
+        UINT bitsPerUnit = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetBitsPerUnit(desc.Format);
+        UINT blockWidth = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetWidthAlignment(desc.Format);
+        UINT blockHeight = D3D12_PROPERTY_LAYOUT_FORMAT_TABLE::GetHeightAlignment(desc.Format);
+        UINT bytesPerUnit = std::max<UINT>(1, bitsPerUnit / 8);
+        UINT tileWidth = bytesPerUnit <= 2 ? 256 : (bytesPerUnit <= 8 ? 128 : 64);
+        UINT tileHeight = D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES / bytesPerUnit / tileWidth;
+        if (shape)
+        {
+            shape->WidthInTexels = tileWidth * blockWidth;
+            shape->HeightInTexels = tileHeight * blockHeight;
+            shape->DepthInTexels = 1;
+        }
+
+        *packedMips = {};
+        UINT tileCount = 0;
+        UINT64 packedBytes = 0;
+        for (UINT mip = 0; mip < desc.MipLevels; mip++)
+        {
+            UINT unitsWide = ((UINT)std::max<UINT64>(1, desc.Width >> mip) + blockWidth - 1) / blockWidth;
+            UINT unitsHigh = (std::max<UINT>(1, desc.Height >> mip) + blockHeight - 1) / blockHeight;
+            if (packedMips->NumPackedMips == 0 && unitsWide >= tileWidth && unitsHigh >= tileHeight)
+            {
+                tilings[mip].WidthInTiles = (unitsWide + tileWidth - 1) / tileWidth;
+                tilings[mip].HeightInTiles = (UINT16)((unitsHigh + tileHeight - 1) / tileHeight);
+                tilings[mip].DepthInTiles = 1;
+                tilings[mip].StartTileIndexInOverallResource = tileCount;
+                tileCount += tilings[mip].WidthInTiles * tilings[mip].HeightInTiles;
+                packedMips->NumStandardMips++;
+                continue;
+            }
+            tilings[mip] = { 0, 0, 0, D3D12_PACKED_TILE };
+            packedMips->NumPackedMips++;
+            packedBytes += (UINT64)unitsWide * unitsHigh * bytesPerUnit;
+        }
+        if (packedMips->NumPackedMips > 0)
+        {
+            packedMips->NumTilesForPackedMips = (UINT)((packedBytes + D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES - 1) / D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES);
+            packedMips->StartTileIndexInOverallResource = tileCount;
+            tileCount += packedMips->NumTilesForPackedMips;
+        }
+        return tileCount;
+    }
+
+    UINT64 m_CommittedResourceCount = 0;
+    UINT64 m_CommittedResourceBytes = 0;
+    UINT64 m_PlacedResourceCount = 0;
+    UINT64 m_HeapCount = 0;
+    UINT64 m_HeapBytes = 0;
+    UINT64 m_ReservedResourceCount = 0;
+    std::atomic<UINT64> m_PipelinesCompiled = 0;
+    std::atomic<UINT64> m_PipelinesFromBlob = 0;
+    UINT64 m_DriverVersion = 1;
+};
@@ -0,0 +1,262 @@
+#include "headlessdevice.h"
+#include "checks.h"
+#include "framescheduler.h"
+#include "resourcemanager.h"
+#include "scene.h"
+#include "timer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <utility>
+
+// Runs the CPU side of the scene against a CPU backed device, no window or GPU required.
+// The queue's fake GPU lags far behind, so the frame scheduler has to throttle the CPU;
+// exits with an error if it ever lets the CPU get more than FRAMES_IN_FLIGHT frames ahead.
+int main(int argc, char* args[]) {
+
+	int frameCount = argc > 1 ? atoi(args[1]) : 1000;
+
+	HeadlessDevice* device = new HeadlessDevice();
+
+	// Create Command Queue & Frame Scheduler
+	D3D12_COMMAND_QUEUE_DESC cqDesc = {};
+	ID3D12CommandQueue* commandQueue;
+	device->CreateCommandQueue(&cqDesc, IID_PPV_ARGS(&commandQueue));
+	static_cast<MockCommandQueue*>(commandQueue)->SetLatency(MAX_FRAMES_IN_FLIGHT * 2);
+
+	GpuTimeline gpuTimeline;
+	FrameScheduler frameScheduler;
+	if (!gpuTimeline.Init(device, commandQueue) || !frameScheduler.Init(device, &gpuTimeline, FRAMES_IN_FLIGHT)) {
+		printf("headless: failed to create frame scheduler\n");
+		return 1;
+	}
+
+	// Stream a buffer through the upload ring every frame, big enough that the ring holds fewer
+	// frames than are in flight and has to wait for the GPU before reusing a slot
+	ResourceManager resourceManager;
+	if (!resourceManager.Init(device, &gpuTimeline, 1024 * 1024)) {
+		printf("headless: failed to create upload ring\n");
+		return 1;
+	}
+	MockCommandList* commandList = new MockCommandList();
+	std::vector<Vertex> streamedVertices(12000, Vertex(0.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+	int streamedSize = (int)(streamedVertices.size() * sizeof(Vertex));
+	GpuAllocation streamedBuffer;
+	resourceManager.CreateVIBuffer(L"Streamed Vertex Buffer", streamedSize, &streamedBuffer);
+
+	// Create Constant Buffer Resource Heap, one slice per frame in flight
+	int alignedSize = (sizeof(ConstantBufferPerObject) + 255) & ~255;
+	int sliceSize = alignedSize * 2; // Cube & Plane
+	CD3DX12_HEAP_PROPERTIES uHeapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resoDesc = CD3DX12_RESOURCE_DESC::Buffer(sliceSize * MAX_FRAMES_IN_FLIGHT);
+	ID3D12Resource* constantBufferUploadHeap;
+	UINT8* cbvGPUAddress;
+	device->CreateCommittedResource(&uHeapProp, D3D12_HEAP_FLAG_NONE, &resoDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&constantBufferUploadHeap));
+	CD3DX12_RANGE readRange(0, 0);
+	constantBufferUploadHeap->Map(0, &readRange, reinterpret_cast<void**>(&cbvGPUAddress));
+
+	Scene scene;
+	scene.Init(DEFAULT_WINDOW_WIDTH, DEFAULT_WINDOW_HEIGHT);
+	scene.GetSettings().rotateY = true;
+
+	// Frames whose upload has not been checked against the default buffer yet
+	std::deque<std::pair<UINT64, int>> uncheckedFrames;
+	bool framesIntact = true;
+
+	Timer timer;
+	float totalTime = 0.0f;
+	UINT64 maxFramesAhead = 0;
+	for (int frame = 0; frame < frameCount; frame++)
+	{
+		float dt = timer.GetFrameDelta();
+		totalTime += dt;
+
+		int slot = frameScheduler.BeginFrame();
+
+		// Frames still on the GPU plus the one about to be recorded
+		UINT64 framesAhead = gpuTimeline.GetLastSubmitted() - gpuTimeline.GetCompletedValue() + 1;
+		maxFramesAhead = framesAhead > maxFramesAhead ? framesAhead : maxFramesAhead;
+
+		// The default buffer holds the newest retired frame, a ring slot reused before its copy ran would show here
+		int retiredFrame = -1;
+		while (!uncheckedFrames.empty() && gpuTimeline.IsComplete(uncheckedFrames.front().first)) {
+			retiredFrame = uncheckedFrames.front().second;
+			uncheckedFrames.pop_front();
+		}
+		if (retiredFrame >= 0) {
+			const Vertex* streamed = reinterpret_cast<const Vertex*>(static_cast<MockResource*>(streamedBuffer.resource)->GetStorage() + streamedBuffer.offset);
+			int streamedCount = (int)streamedVertices.size();
+			for (int i = 0; i < streamedCount && framesIntact; i++) {
+				int written = retiredFrame - ((retiredFrame - i) % streamedCount + streamedCount) % streamedCount;
+				framesIntact = streamed[i].pos.x == (written >= 0 ? (float)written : 0.0f);
+			}
+		}
+
+		scene.Update(dt);
+		scene.WriteConstants(cbvGPUAddress + slot * sliceSize, alignedSize);
+
+		streamedVertices[frame % streamedVertices.size()].pos.x = (float)frame;
+		commandList->Reset(frameScheduler.GetCommandAllocator(slot), nullptr);
+		if (!resourceManager.UploadBuffer(commandList, streamedBuffer, streamedVertices.data(), streamedSize)) {
+			printf("headless: upload ring could not fit frame %d\n", frame);
+			return 1;
+		}
+		commandList->Close();
+
+		ID3D12CommandList* ppCommandLists[] = { commandList };
+		commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+		UINT64 ticket = frameScheduler.EndFrame();
+		resourceManager.FinishUploads(ticket);
+		uncheckedFrames.push_back({ ticket, frame });
+	}
+	gpuTimeline.WaitForIdle();
+
+	printf("headless: %d frames, %.4f ms average CPU frame time\n", frameCount, frameCount > 0 ? totalTime / frameCount : 0.0f);
+	bool allocatorClean = CheckGpuAllocator(device);
+	bool timelineValid = CheckGpuTimeline(device);
+	bool deferredCopiesValid = CheckDeferredCopies(device);
+
+	commandList->Reset(frameScheduler.GetCommandAllocator(0), nullptr);
+	bool poolValid = CheckGeometryPool(&resourceManager, &gpuTimeline, commandList);
+	commandList->Close();
+	bool asyncValid = CheckAsyncUploader(device, &resourceManager, commandQueue);
+	bool vertexFormatValid = CheckVertexFormat(&resourceManager, &gpuTimeline, commandList);
+	bool importerValid = CheckMeshImporter();
+	bool packageValid = CheckAssetPackage(&resourceManager, &gpuTimeline, commandList);
+	bool decoderValid = CheckImageDecoder();
+	bool loaderValid = CheckTextureLoader();
+	bool mipsValid = CheckMipGenerator(&resourceManager, commandList);
+	bool compressionValid = CheckBlockCompression(&resourceManager, commandList);
+	bool cacheValid = CheckTextureCache(device, &resourceManager, &gpuTimeline);
+	bool streamerValid = CheckTextureStreamer(device, &gpuTimeline);
+	bool shaderCacheValid = CheckShaderCache();
+	bool bytecodeValid = CheckShaderBytecode();
+	bool taskGraphValid = CheckTaskGraph();
+	bool pipelineCacheValid = CheckPipelineCache(device);
+	bool permutationValid = CheckShaderPermutation();
+	bool typedValid = CheckTypedUploads(&resourceManager, &gpuTimeline, commandList);
+	bool optimizerValid = CheckMeshOptimizer();
+	resourceManager.FinishUploads(gpuTimeline.Submit());
+	gpuTimeline.WaitForIdle();
+
+	printf("headless: at most %llu of %d frames in flight\n", (unsigned long long)maxFramesAhead, FRAMES_IN_FLIGHT);
+
+	const UploadRingStats& ringStats = resourceManager.GetUploadRing()->GetStats();
+	printf("headless: upload ring %llu allocations, high water %llu of %llu bytes, %llu wraps, %llu stalls\n",
+		(unsigned long long)ringStats.allocations, (unsigned long long)ringStats.highWater,
+		(unsigned long long)ringStats.capacity, (unsigned long long)ringStats.wraps, (unsigned long long)ringStats.stalls);
+
+	// Every copy has retired, so the default buffer holds the last frame's data
+	UINT8* streamedData = static_cast<MockResource*>(streamedBuffer.resource)->GetStorage() + streamedBuffer.offset;
+	bool uploadMatches = memcmp(streamedData, streamedVertices.data(), streamedSize) == 0;
+
+	resourceManager.FreeResource(&streamedBuffer);
+	resourceManager.UnInit();
+	SAFE_RELEASE(commandList);
+	frameScheduler.UnInit();
+	gpuTimeline.UnInit();
+	SAFE_RELEASE(constantBufferUploadHeap);
+	SAFE_RELEASE(commandQueue);
+	delete device;
+
+	if (maxFramesAhead > FRAMES_IN_FLIGHT) {
+		printf("headless: CPU got more than %d frames ahead of the GPU\n", FRAMES_IN_FLIGHT);
+		return 1;
+	}
+	if (!allocatorClean) {
+		printf("headless: gpu allocator did not return to empty\n");
+		return 1;
+	}
+	if (!timelineValid) {
+		printf("headless: a deferred release waited behind a newer ticket\n");
+		return 1;
+	}
+	if (!deferredCopiesValid) {
+		printf("headless: mock copies landed before the queue ran them\n");
+		return 1;
+	}
+	if (!poolValid) {
+		printf("headless: geometry pool handles do not match the appended meshes\n");
+		return 1;
+	}
+	if (!optimizerValid) {
+		printf("headless: mesh optimizer lost triangles or did not improve the vertex cache\n");
+		return 1;
+	}
+	if (!vertexFormatValid) {
+		printf("headless: packed vertices decode outside their error bounds\n");
+		return 1;
+	}
+	if (!importerValid) {
+		printf("headless: imported meshes are wrong or the cooked cache was not used\n");
+		return 1;
+	}
+	if (!packageValid) {
+		printf("headless: asset package entries or mapped uploads do not match the packed data\n");
+		return 1;
+	}
+	if (!decoderValid) {
+		printf("headless: decoded images or SIMD colour conversion do not match the expected pixels\n");
+		return 1;
+	}
+	if (!loaderValid) {
+		printf("headless: texture loader lost a texture or decoded it differently on a worker\n");
+		return 1;
+	}
+	if (!mipsValid) {
+		printf("headless: mip levels do not match the reference downsample or were not all uploaded\n");
+		return 1;
+	}
+	if (!compressionValid) {
+		printf("headless: block compressed textures decode badly or did not load from DDS\n");
+		return 1;
+	}
+	if (!cacheValid) {
+		printf("headless: texture cache did not share, pin or evict textures as expected\n");
+		return 1;
+	}
+	if (!shaderCacheValid) {
+		printf("headless: shader cache compiled unchanged shaders again or served stale bytecode\n");
+		return 1;
+	}
+	if (!bytecodeValid) {
+		printf("headless: shader variant names do not match the embedded bytecode table\n");
+		return 1;
+	}
+	if (!permutationValid) {
+		printf("headless: shader permutation compiled the wrong variants or selected the wrong masks\n");
+		return 1;
+	}
+	if (!pipelineCacheValid) {
+		printf("headless: pipeline cache compiled a pipeline twice or did not reuse stored blobs\n");
+		return 1;
+	}
+	if (!taskGraphValid) {
+		printf("headless: startup task graph ran pipelines before their shaders or did not run in parallel\n");
+		return 1;
+	}
+	if (!streamerValid) {
+		printf("headless: texture streamer went over budget, unmapped levels in use or left quads blurry\n");
+		return 1;
+	}
+	if (!typedValid) {
+		printf("headless: typed uploads do not match the source data\n");
+		return 1;
+	}
+	if (!asyncValid) {
+		printf("headless: async uploads did not batch or land as expected\n");
+		return 1;
+	}
+	if (!framesIntact) {
+		printf("headless: a retired frame's upload was overwritten before its copy ran\n");
+		return 1;
+	}
+	if (!uploadMatches) {
+		printf("headless: streamed buffer does not match the uploaded data\n");
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,340 @@
+#pragma once
+
+// Graphics command list that records nothing but counts what it was asked to do.
+// Buffer copies are the exception: they are kept until Reset and applied by the queue
+// that executes the list, once the fake GPU gets to them, so staged bytes must stay
+// untouched until then just like on a real GPU.
+
+#include "mockobjects.h"
+
+struct MockBufferCopy
+{
+    MockResource* dst;
+    UINT64 dstOffset;
+    MockResource* src;
+    UINT64 srcOffset;
+    UINT64 size;
+};
+
+class MockCommandList : public MockObject<ID3D12GraphicsCommandList>
+{
+public:
+    MockCommandList(D3D12_COMMAND_LIST_TYPE type = D3D12_COMMAND_LIST_TYPE_DIRECT)
+    : m_Type(type)
+    {
+
+    }
+
+    bool IsClosed() const { return m_Closed; }
+    UINT64 GetCommandCount() const { return m_CommandCount; }
+    UINT64 GetDrawCount() const { return m_DrawCount; }
+    UINT64 GetBarrierCount() const { return m_BarrierCount; }
+    UINT64 GetCopyCount() const { return m_CopyCount; }
+    UINT64 GetCopyBytes() const { return m_CopyBytes; }
+    UINT64 GetBarrierCallCount() const { return m_BarrierCallCount; }
+    // Where the last buffer or placed footprint copy read from, to inspect staged data
+    ID3D12Resource* GetLastCopySource() const { return m_LastCopySource; }
+    UINT64 GetLastCopySourceOffset() const { return m_LastCopySourceOffset; }
+    const std::vector<MockBufferCopy>& GetRecordedCopies() const { return m_Copies; }
+
+public: // ID3D12CommandList
+    virtual D3D12_COMMAND_LIST_TYPE STDMETHODCALLTYPE GetType(void) override
+    {
+        return m_Type;
+    }
+
+public: // ID3D12GraphicsCommandList
+    virtual HRESULT STDMETHODCALLTYPE Close(void) override
+    {
+        m_Closed = true;
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE Reset(ID3D12CommandAllocator* /*pAllocator*/, ID3D12PipelineState* /*pInitialState*/) override
+    {
+        m_Closed = false;
+        m_Copies.clear();
+        return S_OK;
+    }
+
+    virtual void STDMETHODCALLTYPE ClearState(ID3D12PipelineState* /*pPipelineState*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE DrawInstanced(UINT /*VertexCountPerInstance*/, UINT /*InstanceCount*/, UINT /*StartVertexLocation*/, UINT /*StartInstanceLocation*/) override
+    {
+        m_CommandCount++;
+        m_DrawCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE DrawIndexedInstanced(UINT /*IndexCountPerInstance*/, UINT /*InstanceCount*/, UINT /*StartIndexLocation*/, INT /*BaseVertexLocation*/, UINT /*StartInstanceLocation*/) override
+    {
+        m_CommandCount++;
+        m_DrawCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE Dispatch(UINT /*ThreadGroupCountX*/, UINT /*ThreadGroupCountY*/, UINT /*ThreadGroupCountZ*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE CopyBufferRegion(ID3D12Resource* pDstBuffer, UINT64 DstOffset, ID3D12Resource* pSrcBuffer, UINT64 SrcOffset, UINT64 NumBytes) override
+    {
+        m_CommandCount++;
+        m_CopyCount++;
+        m_CopyBytes += NumBytes;
+
+        // Read from the source when the queue runs the list, not now
+        m_Copies.push_back({ static_cast<MockResource*>(pDstBuffer), DstOffset, static_cast<MockResource*>(pSrcBuffer), SrcOffset, NumBytes });
+        m_LastCopySource = pSrcBuffer;
+        m_LastCopySourceOffset = SrcOffset;
+    }
+
+    virtual void STDMETHODCALLTYPE CopyTextureRegion(const D3D12_TEXTURE_COPY_LOCATION* pDst, UINT /*DstX*/, UINT /*DstY*/, UINT /*DstZ*/, const D3D12_TEXTURE_COPY_LOCATION* pSrc, const D3D12_BOX* /*pSrcBox*/) override
+    {
+        m_CommandCount++;
+        m_CopyCount++;
+        if (pSrc->Type == D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT)
+        {
+            m_LastCopySource = pSrc->pResource;
+            m_LastCopySourceOffset = pSrc->PlacedFootprint.Offset;
+        }
+        MockResource* dst = static_cast<MockResource*>(pDst->pResource);
+        if (dst->IsReserved() && !dst->IsSubresourceMapped(pDst->SubresourceIndex))
+        {
+            dst->AddUnmappedWrite();
+        }
+    }
+
+    virtual void STDMETHODCALLTYPE CopyResource(ID3D12Resource* /*pDstResource*/, ID3D12Resource* /*pSrcResource*/) override
+    {
+        m_CommandCount++;
+        m_CopyCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE CopyTiles(ID3D12Resource* /*pTiledResource*/, const D3D12_TILED_RESOURCE_COORDINATE* /*pTileRegionStartCoordinate*/, const D3D12_TILE_REGION_SIZE* /*pTileRegionSize*/, ID3D12Resource* /*pBuffer*/, UINT64 /*BufferStartOffsetInBytes*/, D3D12_TILE_COPY_FLAGS /*Flags*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE ResolveSubresource(ID3D12Resource* /*pDstResource*/, UINT /*DstSubresource*/, ID3D12Resource* /*pSrcResource*/, UINT /*SrcSubresource*/, DXGI_FORMAT /*Format*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY /*PrimitiveTopology*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE RSSetViewports(UINT /*NumViewports*/, const D3D12_VIEWPORT* /*pViewports*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE RSSetScissorRects(UINT /*NumRects*/, const D3D12_RECT* /*pRects*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE OMSetBlendFactor(const FLOAT /*BlendFactor*/[ 4 ]) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE OMSetStencilRef(UINT /*StencilRef*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetPipelineState(ID3D12PipelineState* /*pPipelineState*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE ResourceBarrier(UINT NumBarriers, const D3D12_RESOURCE_BARRIER* /*pBarriers*/) override
+    {
+        m_CommandCount++;
+        m_BarrierCount += NumBarriers;
+        m_BarrierCallCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE ExecuteBundle(ID3D12GraphicsCommandList* /*pCommandList*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetDescriptorHeaps(UINT /*NumDescriptorHeaps*/, ID3D12DescriptorHeap* const* /*ppDescriptorHeaps*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRootSignature(ID3D12RootSignature* /*pRootSignature*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRootSignature(ID3D12RootSignature* /*pRootSignature*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRootDescriptorTable(UINT /*RootParameterIndex*/, D3D12_GPU_DESCRIPTOR_HANDLE /*BaseDescriptor*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRootDescriptorTable(UINT /*RootParameterIndex*/, D3D12_GPU_DESCRIPTOR_HANDLE /*BaseDescriptor*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRoot32BitConstant(UINT /*RootParameterIndex*/, UINT /*SrcData*/, UINT /*DestOffsetIn32BitValues*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRoot32BitConstant(UINT /*RootParameterIndex*/, UINT /*SrcData*/, UINT /*DestOffsetIn32BitValues*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRoot32BitConstants(UINT /*RootParameterIndex*/, UINT /*Num32BitValuesToSet*/, const void* /*pSrcData*/, UINT /*DestOffsetIn32BitValues*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRoot32BitConstants(UINT /*RootParameterIndex*/, UINT /*Num32BitValuesToSet*/, const void* /*pSrcData*/, UINT /*DestOffsetIn32BitValues*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRootConstantBufferView(UINT /*RootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*BufferLocation*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRootConstantBufferView(UINT /*RootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*BufferLocation*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRootShaderResourceView(UINT /*RootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*BufferLocation*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRootShaderResourceView(UINT /*RootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*BufferLocation*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetComputeRootUnorderedAccessView(UINT /*RootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*BufferLocation*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetGraphicsRootUnorderedAccessView(UINT /*RootParameterIndex*/, D3D12_GPU_VIRTUAL_ADDRESS /*BufferLocation*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* /*pView*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE IASetVertexBuffers(UINT /*StartSlot*/, UINT /*NumViews*/, const D3D12_VERTEX_BUFFER_VIEW* /*pViews*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SOSetTargets(UINT /*StartSlot*/, UINT /*NumViews*/, const D3D12_STREAM_OUTPUT_BUFFER_VIEW* /*pViews*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE OMSetRenderTargets(UINT /*NumRenderTargetDescriptors*/, const D3D12_CPU_DESCRIPTOR_HANDLE* /*pRenderTargetDescriptors*/, BOOL /*RTsSingleHandleToDescriptorRange*/, const D3D12_CPU_DESCRIPTOR_HANDLE* /*pDepthStencilDescriptor*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE /*DepthStencilView*/, D3D12_CLEAR_FLAGS /*ClearFlags*/, FLOAT /*Depth*/, UINT8 /*Stencil*/, UINT /*NumRects*/, const D3D12_RECT* /*pRects*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE /*RenderTargetView*/, const FLOAT /*ColorRGBA*/[ 4 ], UINT /*NumRects*/, const D3D12_RECT* /*pRects*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE ClearUnorderedAccessViewUint(D3D12_GPU_DESCRIPTOR_HANDLE /*ViewGPUHandleInCurrentHeap*/, D3D12_CPU_DESCRIPTOR_HANDLE /*ViewCPUHandle*/, ID3D12Resource* /*pResource*/, const UINT /*Values*/[ 4 ], UINT /*NumRects*/, const D3D12_RECT* /*pRects*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE ClearUnorderedAccessViewFloat(D3D12_GPU_DESCRIPTOR_HANDLE /*ViewGPUHandleInCurrentHeap*/, D3D12_CPU_DESCRIPTOR_HANDLE /*ViewCPUHandle*/, ID3D12Resource* /*pResource*/, const FLOAT /*Values*/[ 4 ], UINT /*NumRects*/, const D3D12_RECT* /*pRects*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE DiscardResource(ID3D12Resource* /*pResource*/, const D3D12_DISCARD_REGION* /*pRegion*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE BeginQuery(ID3D12QueryHeap* /*pQueryHeap*/, D3D12_QUERY_TYPE /*Type*/, UINT /*Index*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE EndQuery(ID3D12QueryHeap* /*pQueryHeap*/, D3D12_QUERY_TYPE /*Type*/, UINT /*Index*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE ResolveQueryData(ID3D12QueryHeap* /*pQueryHeap*/, D3D12_QUERY_TYPE /*Type*/, UINT /*StartIndex*/, UINT /*NumQueries*/, ID3D12Resource* /*pDestinationBuffer*/, UINT64 /*AlignedDestinationBufferOffset*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetPredication(ID3D12Resource* /*pBuffer*/, UINT64 /*AlignedBufferOffset*/, D3D12_PREDICATION_OP /*Operation*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE SetMarker(UINT /*Metadata*/, const void* /*pData*/, UINT /*Size*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE BeginEvent(UINT /*Metadata*/, const void* /*pData*/, UINT /*Size*/) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE EndEvent(void) override
+    {
+        m_CommandCount++;
+    }
+
+    virtual void STDMETHODCALLTYPE ExecuteIndirect(ID3D12CommandSignature* /*pCommandSignature*/, UINT /*MaxCommandCount*/, ID3D12Resource* /*pArgumentBuffer*/, UINT64 /*ArgumentBufferOffset*/, ID3D12Resource* /*pCountBuffer*/, UINT64 /*CountBufferOffset*/) override
+    {
+        m_CommandCount++;
+    }
+
+private:
+    D3D12_COMMAND_LIST_TYPE m_Type;
+    bool m_Closed = false;
+    UINT64 m_CommandCount = 0;
+    UINT64 m_DrawCount = 0;
+    UINT64 m_BarrierCount = 0;
+    UINT64 m_CopyCount = 0;
+    UINT64 m_CopyBytes = 0;
+    UINT64 m_BarrierCallCount = 0;
+    ID3D12Resource* m_LastCopySource = nullptr;
+    UINT64 m_LastCopySourceOffset = 0;
+    std::vector<MockBufferCopy> m_Copies;
+};
@@ -0,0 +1,301 @@
+#pragma once
+
+// COM objects backed by CPU memory so the render core can run without a GPU.
+// Extends libs/DirectX12/googletest/MockDevice.hpp, which only returns S_OK.
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "coreconst.h"
+
+template <class Interface>
+class MockObject : public Interface
+{
+public:
+    virtual ~MockObject() = default;
+
+public: // IUnknown
+    virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID /*riid*/, void** ppvObject) override
+    {
+        *ppvObject = this;
+        AddRef();
+        return S_OK;
+    }
+
+    virtual ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return ++m_RefCount;
+    }
+
+    virtual ULONG STDMETHODCALLTYPE Release() override
+    {
+        ULONG count = --m_RefCount;
+        if (count == 0)
+        {
+            delete this;
+        }
+        return count;
+    }
+
+public: // ID3D12Object
+    virtual HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID /*guid*/, UINT* /*pDataSize*/, void* /*pData*/) override
+    {
+        return E_NOTIMPL;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID /*guid*/, UINT /*DataSize*/, const void* /*pData*/) override
+    {
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID /*guid*/, const IUnknown* /*pData*/) override
+    {
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE SetName(LPCWSTR Name) override
+    {
+        m_Name = Name ? Name : L"";
+        return S_OK;
+    }
+
+public: // ID3D12DeviceChild
+    virtual HRESULT STDMETHODCALLTYPE GetDevice(REFIID /*riid*/, void** ppvDevice) override
+    {
+        if (ppvDevice)
+        {
+            *ppvDevice = nullptr;
+        }
+        return E_NOINTERFACE;
+    }
+
+    const std::wstring& GetName() const { return m_Name; }
+
+protected:
+    std::atomic<ULONG> m_RefCount = 1;
+    std::wstring m_Name;
+};
+
+class MockResource : public MockObject<ID3D12Resource>
+{
+public:
+    MockResource(const D3D12_RESOURCE_DESC& desc, D3D12_HEAP_TYPE heapType, UINT64 sizeInBytes)
+    : m_Desc(desc)
+    , m_HeapType(heapType)
+    , m_Data((size_t)sizeInBytes)
+    {
+        // Hand out unique, 64KB aligned fake GPU addresses
+        static std::atomic<UINT64> s_NextAddress = 0x10000;
+        UINT64 span = (sizeInBytes + 0xFFFF) & ~0xFFFFull;
+        m_GPUAddress = s_NextAddress.fetch_add(span ? span : 0x10000);
+    }
+
+    UINT8* GetStorage() { return m_Data.data(); }
+    UINT64 GetStorageSize() const { return m_Data.size(); }
+    D3D12_HEAP_TYPE GetHeapType() const { return m_HeapType; }
+
+    // Reserved resources: tiles per standard mip, then the packed mips sharing one set of tiles
+    void SetTiling(const std::vector<D3D12_SUBRESOURCE_TILING>& tilings, UINT packedTiles)
+    {
+        m_Reserved = true;
+        m_Tilings = tilings;
+        m_PackedTiles = packedTiles;
+    }
+    bool IsReserved() const { return m_Reserved; }
+
+    // Tiles are keyed by their subresource and index within it, packed mips use the first packed one
+    void MapTile(UINT subresource, UINT x, UINT y, bool mapped)
+    {
+        UINT mip = std::min<UINT>(subresource, (UINT)m_Tilings.size());
+        UINT index = mip < m_Tilings.size() ? y * m_Tilings[mip].WidthInTiles + x : x;
+        UINT64 key = ((UINT64)mip << 32) | index;
+        if (mapped) m_MappedTiles.insert(key);
+        else m_MappedTiles.erase(key);
+    }
+    bool IsSubresourceMapped(UINT subresource) const
+    {
+        UINT mip = std::min<UINT>(subresource, (UINT)m_Tilings.size());
+        UINT tiles = mip < m_Tilings.size() ? m_Tilings[mip].WidthInTiles * m_Tilings[mip].HeightInTiles : m_PackedTiles;
+        for (UINT i = 0; i < tiles; i++) {
+            if (m_MappedTiles.count(((UINT64)mip << 32) | i) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+    size_t GetMappedTileCount() const { return m_MappedTiles.size(); }
+
+    // Copies recorded into reserved tiles that were not mapped at the time
+    void AddUnmappedWrite() { m_UnmappedWrites++; }
+    UINT64 GetUnmappedWrites() const { return m_UnmappedWrites; }
+
+public: // ID3D12Resource
+    virtual HRESULT STDMETHODCALLTYPE Map(UINT /*Subresource*/, const D3D12_RANGE* /*pReadRange*/, void** ppData) override
+    {
+        if (ppData)
+        {
+            *ppData = m_Data.data();
+        }
+        return S_OK;
+    }
+
+    virtual void STDMETHODCALLTYPE Unmap(UINT /*Subresource*/, const D3D12_RANGE* /*pWrittenRange*/) override
+    {
+        return;
+    }
+
+#if defined(_MSC_VER) || !defined(_WIN32)
+    virtual D3D12_RESOURCE_DESC STDMETHODCALLTYPE GetDesc(void) override
+    {
+        return m_Desc;
+    }
+#else
+    virtual D3D12_RESOURCE_DESC* STDMETHODCALLTYPE GetDesc(D3D12_RESOURCE_DESC* RetVal) override
+    {
+        *RetVal = m_Desc;
+        return RetVal;
+    }
+#endif
+
+    virtual D3D12_GPU_VIRTUAL_ADDRESS STDMETHODCALLTYPE GetGPUVirtualAddress(void) override
+    {
+        return m_Desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER ? m_GPUAddress : 0;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE WriteToSubresource(UINT /*DstSubresource*/, const D3D12_BOX* /*pDstBox*/, const void* /*pSrcData*/, UINT /*SrcRowPitch*/, UINT /*SrcDepthPitch*/) override
+    {
+        return E_NOTIMPL;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE ReadFromSubresource(void* /*pDstData*/, UINT /*DstRowPitch*/, UINT /*DstDepthPitch*/, UINT /*SrcSubresource*/, const D3D12_BOX* /*pSrcBox*/) override
+    {
+        return E_NOTIMPL;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE GetHeapProperties(D3D12_HEAP_PROPERTIES* pHeapProperties, D3D12_HEAP_FLAGS* pHeapFlags) override
+    {
+        if (pHeapProperties)
+        {
+            *pHeapProperties = CD3DX12_HEAP_PROPERTIES(m_HeapType);
+        }
+        if (pHeapFlags)
+        {
+            *pHeapFlags = D3D12_HEAP_FLAG_NONE;
+        }
+        return S_OK;
+    }
+
+private:
+    D3D12_RESOURCE_DESC m_Desc;
+    D3D12_HEAP_TYPE m_HeapType;
+    std::vector<UINT8> m_Data;
+    D3D12_GPU_VIRTUAL_ADDRESS m_GPUAddress = 0;
+
+    bool m_Reserved = false;
+    std::vector<D3D12_SUBRESOURCE_TILING> m_Tilings;
+    UINT m_PackedTiles = 0;
+    std::set<UINT64> m_MappedTiles;
+    UINT64 m_UnmappedWrites = 0;
+};
+
+
+class MockHeap : public MockObject<ID3D12Heap>
+{
+public:
+    MockHeap(const D3D12_HEAP_DESC& desc)
+    : m_Desc(desc)
+    {
+
+    }
+
+public: // ID3D12Heap
+#if defined(_MSC_VER) || !defined(_WIN32)
+    virtual D3D12_HEAP_DESC STDMETHODCALLTYPE GetDesc(void) override
+    {
+        return m_Desc;
+    }
+#else
+    virtual D3D12_HEAP_DESC* STDMETHODCALLTYPE GetDesc(D3D12_HEAP_DESC* RetVal) override
+    {
+        *RetVal = m_Desc;
+        return RetVal;
+    }
+#endif
+
+private:
+    D3D12_HEAP_DESC m_Desc;
+};
+
+// A plain byte buffer, what the runtime hands out for cached pipeline blobs
+class MockBlob : public ID3DBlob
+{
+public:
+    MockBlob(const void* data, size_t size)
+    : m_Data(static_cast<const UINT8*>(data), static_cast<const UINT8*>(data) + size)
+    {
+
+    }
+
+    virtual ~MockBlob() = default;
+
+public: // IUnknown
+    virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID /*riid*/, void** ppvObject) override
+    {
+        *ppvObject = this;
+        AddRef();
+        return S_OK;
+    }
+
+    virtual ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return ++m_RefCount;
+    }
+
+    virtual ULONG STDMETHODCALLTYPE Release() override
+    {
+        ULONG count = --m_RefCount;
+        if (count == 0)
+        {
+            delete this;
+        }
+        return count;
+    }
+
+public: // ID3DBlob
+    virtual LPVOID STDMETHODCALLTYPE GetBufferPointer() override
+    {
+        return m_Data.data();
+    }
+
+    virtual SIZE_T STDMETHODCALLTYPE GetBufferSize() override
+    {
+        return m_Data.size();
+    }
+
+private:
+    std::atomic<ULONG> m_RefCount = 1;
+    std::vector<UINT8> m_Data;
+};
+
+class MockPipelineState : public MockObject<ID3D12PipelineState>
+{
+public:
+    MockPipelineState(const std::vector<UINT8>& cachedBlob)
+    : m_CachedBlob(cachedBlob)
+    {
+
+    }
+
+public: // ID3D12PipelineState
+    virtual HRESULT STDMETHODCALLTYPE GetCachedBlob(ID3DBlob** ppBlob) override
+    {
+        *ppBlob = new MockBlob(m_CachedBlob.data(), m_CachedBlob.size());
+        return S_OK;
+    }
+
+private:
+    std::vector<UINT8> m_CachedBlob;
+};
\ No newline at end of file
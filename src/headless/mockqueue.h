@@ -0,0 +1,247 @@
+#pragma once
+
+// Command queue, fence and allocator for the headless backend. The queue plays the
+// part of a GPU that runs behind the CPU: signals stay pending until more than
+// `latency` of them are queued, or until someone blocks on the fence. The buffer
+// copies of executed command lists wait with them and land in submission order.
+
+#include "mockobjects.h"
+#include "mockcommandlist.h"
+
+#include <deque>
+
+class MockCommandQueue;
+
+class MockFence : public MockObject<ID3D12Fence>
+{
+public:
+    MockFence(UINT64 initialValue)
+    : m_CompletedValue(initialValue)
+    {
+
+    }
+
+    void SetQueue(MockCommandQueue* queue) { m_Queue = queue; }
+    MockCommandQueue* GetQueue() const { return m_Queue; }
+    UINT64 GetWaitCount() const { return m_WaitCount; }
+
+public: // ID3D12Fence
+    virtual UINT64 STDMETHODCALLTYPE GetCompletedValue(void) override
+    {
+        return m_CompletedValue;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE SetEventOnCompletion(UINT64 Value, HANDLE hEvent) override;
+
+    virtual HRESULT STDMETHODCALLTYPE Signal(UINT64 Value) override
+    {
+        m_CompletedValue = Value;
+        return S_OK;
+    }
+
+private:
+    UINT64 m_CompletedValue = 0;
+    UINT64 m_WaitCount = 0;
+    MockCommandQueue* m_Queue = nullptr;
+};
+
+class MockCommandAllocator : public MockObject<ID3D12CommandAllocator>
+{
+public:
+    UINT64 GetResetCount() const { return m_ResetCount; }
+
+public: // ID3D12CommandAllocator
+    virtual HRESULT STDMETHODCALLTYPE Reset(void) override
+    {
+        m_ResetCount++;
+        return S_OK;
+    }
+
+private:
+    UINT64 m_ResetCount = 0;
+};
+
+class MockCommandQueue : public MockObject<ID3D12CommandQueue>
+{
+public:
+    MockCommandQueue(const D3D12_COMMAND_QUEUE_DESC& desc, size_t latency = 0)
+    : m_Desc(desc)
+    , m_Latency(latency)
+    {
+
+    }
+
+    // Number of signals the fake GPU may leave unfinished
+    void SetLatency(size_t latency) { m_Latency = latency; RetirePending(m_Latency); }
+    size_t GetPendingCount() const { return m_PendingSignals; }
+    UINT64 GetExecuteCount() const { return m_ExecuteCount; }
+    UINT64 GetQueueWaitCount() const { return m_QueueWaitCount; }
+    UINT64 GetTileMappingCount() const { return m_TileMappingCount; }
+
+    // Finishes pending work in submission order until the fence reaches the value
+    void RetireUntil(MockFence* fence, UINT64 value)
+    {
+        while (!m_Pending.empty() && fence->GetCompletedValue() < value)
+        {
+            RetireOldest();
+        }
+    }
+
+public: // ID3D12CommandQueue
+    // Applied immediately, only single tile regions are tracked
+    virtual void STDMETHODCALLTYPE UpdateTileMappings(ID3D12Resource* pResource, UINT NumResourceRegions, const D3D12_TILED_RESOURCE_COORDINATE* pResourceRegionStartCoordinates, const D3D12_TILE_REGION_SIZE* /*pResourceRegionSizes*/, ID3D12Heap* pHeap, UINT /*NumRanges*/, const D3D12_TILE_RANGE_FLAGS* pRangeFlags, const UINT* /*pHeapRangeStartOffsets*/, const UINT* /*pRangeTileCounts*/, D3D12_TILE_MAPPING_FLAGS /*Flags*/) override
+    {
+        m_TileMappingCount++;
+        MockResource* resource = static_cast<MockResource*>(pResource);
+        bool mapped = pHeap && !(pRangeFlags && (pRangeFlags[0] & D3D12_TILE_RANGE_FLAG_NULL));
+        for (UINT i = 0; i < NumResourceRegions; i++)
+        {
+            const D3D12_TILED_RESOURCE_COORDINATE& start = pResourceRegionStartCoordinates[i];
+            resource->MapTile(start.Subresource, start.X, start.Y, mapped);
+        }
+    }
+
+    virtual void STDMETHODCALLTYPE CopyTileMappings(ID3D12Resource* /*pDstResource*/, const D3D12_TILED_RESOURCE_COORDINATE* /*pDstRegionStartCoordinate*/, ID3D12Resource* /*pSrcResource*/, const D3D12_TILED_RESOURCE_COORDINATE* /*pSrcRegionStartCoordinate*/, const D3D12_TILE_REGION_SIZE* /*pRegionSize*/, D3D12_TILE_MAPPING_FLAGS /*Flags*/) override
+    {
+        return;
+    }
+
+    virtual void STDMETHODCALLTYPE ExecuteCommandLists(UINT NumCommandLists, ID3D12CommandList* const* ppCommandLists) override
+    {
+        m_ExecuteCount += NumCommandLists;
+        for (UINT i = 0; i < NumCommandLists; i++)
+        {
+            const std::vector<MockBufferCopy>& copies = static_cast<MockCommandList*>(ppCommandLists[i])->GetRecordedCopies();
+            if (!copies.empty())
+            {
+                m_Pending.push_back({ nullptr, 0, copies });
+            }
+        }
+    }
+
+    virtual void STDMETHODCALLTYPE SetMarker(UINT /*Metadata*/, const void* /*pData*/, UINT /*Size*/) override
+    {
+        return;
+    }
+
+    virtual void STDMETHODCALLTYPE BeginEvent(UINT /*Metadata*/, const void* /*pData*/, UINT /*Size*/) override
+    {
+        return;
+    }
+
+    virtual void STDMETHODCALLTYPE EndEvent(void) override
+    {
+        return;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE Signal(ID3D12Fence* pFence, UINT64 Value) override
+    {
+        MockFence* fence = static_cast<MockFence*>(pFence);
+        fence->SetQueue(this);
+        m_Pending.push_back({ fence, Value, {} });
+        m_PendingSignals++;
+        RetirePending(m_Latency);
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE Wait(ID3D12Fence* pFence, UINT64 Value) override;
+
+    virtual HRESULT STDMETHODCALLTYPE GetTimestampFrequency(UINT64* pFrequency) override
+    {
+        *pFrequency = 1000000;
+        return S_OK;
+    }
+
+    virtual HRESULT STDMETHODCALLTYPE GetClockCalibration(UINT64* pGpuTimestamp, UINT64* pCpuTimestamp) override
+    {
+        *pGpuTimestamp = 0;
+        *pCpuTimestamp = 0;
+        return S_OK;
+    }
+
+#if defined(_MSC_VER) || !defined(_WIN32)
+    virtual D3D12_COMMAND_QUEUE_DESC STDMETHODCALLTYPE GetDesc(void) override
+    {
+        return m_Desc;
+    }
+#else
+    virtual D3D12_COMMAND_QUEUE_DESC* STDMETHODCALLTYPE GetDesc(D3D12_COMMAND_QUEUE_DESC* RetVal) override
+    {
+        *RetVal = m_Desc;
+        return RetVal;
+    }
+#endif
+
+private:
+    // A signal, or the copies of one executed command list when fence is null
+    struct PendingWork
+    {
+        MockFence* fence;
+        UINT64 value;
+        std::vector<MockBufferCopy> copies;
+    };
+
+    void RetirePending(size_t keep)
+    {
+        while (m_PendingSignals > keep)
+        {
+            RetireOldest();
+        }
+    }
+
+    void RetireOldest()
+    {
+        PendingWork work = std::move(m_Pending.front());
+        m_Pending.pop_front();
+        for (const MockBufferCopy& copy : work.copies)
+        {
+            memcpy(copy.dst->GetStorage() + copy.dstOffset, copy.src->GetStorage() + copy.srcOffset, (size_t)copy.size);
+        }
+        if (work.fence)
+        {
+            m_PendingSignals--;
+            work.fence->Signal(work.value);
+        }
+    }
+
+    D3D12_COMMAND_QUEUE_DESC m_Desc;
+    size_t m_Latency = 0;
+    UINT64 m_ExecuteCount = 0;
+    UINT64 m_TileMappingCount = 0;
+    UINT64 m_QueueWaitCount = 0;
+    std::deque<PendingWork> m_Pending;
+    size_t m_PendingSignals = 0;
+};
+
+inline HRESULT STDMETHODCALLTYPE MockFence::SetEventOnCompletion(UINT64 Value, HANDLE /*hEvent*/)
+{
+    // Blocking on the fence lets the fake GPU catch up to the requested value
+    if (m_CompletedValue < Value)
+    {
+        m_WaitCount++;
+        if (m_Queue)
+        {
+            m_Queue->RetireUntil(this, Value);
+        }
+    }
+#ifdef _WIN32
+    if (hEvent)
+    {
+        SetEvent(hEvent);
+    }
+#endif
+    return S_OK;
+}
+
+inline HRESULT STDMETHODCALLTYPE MockCommandQueue::Wait(ID3D12Fence* pFence, UINT64 Value)
+{
+    // Work queued after the wait cannot finish before the other queue reaches the value,
+    // so let that queue catch up now instead of holding back our own signals
+    MockFence* fence = static_cast<MockFence*>(pFence);
+    m_QueueWaitCount++;
+    if (fence->GetCompletedValue() < Value && fence->GetQueue())
+    {
+        fence->GetQueue()->RetireUntil(fence, Value);
+    }
+    return S_OK;
+}
\ No newline at end of file
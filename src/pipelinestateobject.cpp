@@ -5,100 +5,54 @@ PipelineStateObject::~PipelineStateObject()
 	SAFE_RELEASE(pso);
 }
 
-bool PipelineStateObject::Init(ID3D12Device* device, ID3D12RootSignature* rootSignature, Shader* vs, Shader* ps, UINT32 numRenderTargets)
+D3D12_GRAPHICS_PIPELINE_STATE_DESC PipelineStateObject::GetBaseDesc(ID3D12RootSignature* rootSignature, const VertexFormat& vertexFormat,
+	Shader* vs, Shader* ps, D3D12_INPUT_ELEMENT_DESC* inputLayout)
 {
-	HRESULT result;
-
 	// Create Sample Descriptor
 	DXGI_SAMPLE_DESC sampleDesc = {};
 	sampleDesc.Count = 1;
 
-	// Create Input Layout
-	D3D12_INPUT_ELEMENT_DESC inputLayout[] =
-	{
-		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-		{ "NORMALS", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-	};
-
-	// Fill Input Layout Descriptor
-	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc = {};
-	inputLayoutDesc.NumElements = sizeof(inputLayout) / sizeof(D3D12_INPUT_ELEMENT_DESC);
-	inputLayoutDesc.pInputElementDescs = inputLayout;
-
 	// Create PSO Descriptor
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
-	psoDesc.InputLayout = inputLayoutDesc;
+	psoDesc.InputLayout = vertexFormat.GetInputLayout(inputLayout);
 	psoDesc.pRootSignature = rootSignature;
 	psoDesc.VS = vs->GetBytecode();
 	psoDesc.PS = ps->GetBytecode();
 	psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
 	psoDesc.SampleDesc = sampleDesc;
-	psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
 	psoDesc.SampleMask = 0xffffffff;
 	psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
 	psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
-	psoDesc.NumRenderTargets = numRenderTargets;
 	psoDesc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
-
-	// Create PSO
-	result = device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pso));
-	if (FAILED(result))
-	{
-		return false;
-	}
-
-	return true;
+	return psoDesc;
 }
 
-bool PipelineStateObject::InitShadowMap(ID3D12Device* device, ID3D12RootSignature* rootSignature, Shader* vs, Shader* ps)
+bool PipelineStateObject::Init(PipelineCache* cache, ID3D12RootSignature* rootSignature, const VertexFormat& vertexFormat, Shader* vs, Shader* ps, UINT32 numRenderTargets)
 {
-	HRESULT result;
-
-	// Create Sample Descriptor
-	DXGI_SAMPLE_DESC sampleDesc = {};
-	sampleDesc.Count = 1;
-
-	// Create Input Layout
-	D3D12_INPUT_ELEMENT_DESC inputLayout[] =
-	{
-		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-		{ "NORMALS", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-	};
+	D3D12_INPUT_ELEMENT_DESC inputLayout[MAX_VERTEX_ATTRIBUTES];
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = GetBaseDesc(rootSignature, vertexFormat, vs, ps, inputLayout);
+	psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+	psoDesc.NumRenderTargets = numRenderTargets;
 
-	// Fill Input Layout Descriptor
-	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc = {};
-	inputLayoutDesc.NumElements = sizeof(inputLayout) / sizeof(D3D12_INPUT_ELEMENT_DESC);
-	inputLayoutDesc.pInputElementDescs = inputLayout;
+	// Create PSO, Or Reuse One With The Same Description
+	pso = cache->Acquire(psoDesc);
+	return pso != nullptr;
+}
 
-	// Create PSO Descriptor
-	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
-	psoDesc.InputLayout = inputLayoutDesc;
-	psoDesc.pRootSignature = rootSignature;
-	psoDesc.VS = vs->GetBytecode();
-	psoDesc.PS = ps->GetBytecode();
-	psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+bool PipelineStateObject::InitShadowMap(PipelineCache* cache, ID3D12RootSignature* rootSignature, const VertexFormat& vertexFormat, Shader* vs, Shader* ps)
+{
+	D3D12_INPUT_ELEMENT_DESC inputLayout[MAX_VERTEX_ATTRIBUTES];
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = GetBaseDesc(rootSignature, vertexFormat, vs, ps, inputLayout);
 	psoDesc.NumRenderTargets = 0;
-	psoDesc.SampleDesc = sampleDesc;
-	psoDesc.SampleMask = 0xffffffff;
 	psoDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
-	psoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
 	psoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
 	psoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
 	psoDesc.RasterizerState.DepthBias = 100;
 	psoDesc.RasterizerState.DepthBiasClamp = 0.0f;
 	psoDesc.RasterizerState.SlopeScaledDepthBias = 1.5f;
-	psoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
-	psoDesc.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
 	psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
 
-	// Create PSO
-	result = device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pso));
-	if (FAILED(result))
-	{
-		return false;
-	}
-
-	return true;
-}
+	// Create PSO, Or Reuse One With The Same Description
+	pso = cache->Acquire(psoDesc);
+	return pso != nullptr;
+}
\ No newline at end of file
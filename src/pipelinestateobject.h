@@ -2,19 +2,25 @@
 
 #include "gconst.h"
 #include "shader.h"
+#include "vertexformat.h"
+#include "pipelinecache.h"
 
 class PipelineStateObject
 {
 public:
 
 	~PipelineStateObject();
-	bool Init(ID3D12Device* device, ID3D12RootSignature* rootSignature, Shader* vs, Shader* ps, UINT32 numRenderTargets);
-	bool InitShadowMap(ID3D12Device* device, ID3D12RootSignature* rootSignature, Shader* vs, Shader* ps);
+	bool Init(PipelineCache* cache, ID3D12RootSignature* rootSignature, const VertexFormat& vertexFormat, Shader* vs, Shader* ps, UINT32 numRenderTargets);
+	bool InitShadowMap(PipelineCache* cache, ID3D12RootSignature* rootSignature, const VertexFormat& vertexFormat, Shader* vs, Shader* ps);
 
 	ID3D12PipelineState* GetState() { return pso; }
 
 private:
 
-	ID3D12PipelineState* pso;
+	// Fields every pipeline shares, inputLayout backs the description's input layout
+	static D3D12_GRAPHICS_PIPELINE_STATE_DESC GetBaseDesc(ID3D12RootSignature* rootSignature, const VertexFormat& vertexFormat,
+		Shader* vs, Shader* ps, D3D12_INPUT_ELEMENT_DESC* inputLayout);
+
+	ID3D12PipelineState* pso = nullptr;
 
 };
\ No newline at end of file
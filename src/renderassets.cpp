@@ -54,11 +54,16 @@ bool RenderAssets::Init(const HWND& window, bool screenState)
 		rtvHandle.Offset(1, rtvDescriptorSize);
 	}
 
-	// Create Command Allocators & Command List
-	CreateCommandList();
-
-	// Create Fence & Fence Event Handle
-	CreateFence();
+	// Create Timeline Fence, Frame Scheduler (per frame allocators) & Command List
+	if (!gpuTimeline.Init(device, commandQueue)) {
+		return false;
+	}
+	if (!frameScheduler.Init(device, &gpuTimeline, FRAMES_IN_FLIGHT)) {
+		return false;
+	}
+	if (!CreateCommandList()) {
+		return false;
+	}
 
 	return true;
 }
@@ -69,6 +74,9 @@ void RenderAssets::UnInit()
 	swapChain->SetFullscreenState(false, NULL);
 
 	// Release objects
+	gpuTimeline.WaitForIdle();
+	frameScheduler.UnInit();
+	gpuTimeline.UnInit();
 	SAFE_RELEASE(device);
 	SAFE_RELEASE(swapChain);
 	SAFE_RELEASE(commandQueue);
@@ -78,8 +86,6 @@ void RenderAssets::UnInit()
 	for (int i = 0; i < FRAME_BUFFER_COUNT; ++i)
 	{
 		SAFE_RELEASE(renderTargets[i]);
-		SAFE_RELEASE(commandAllocator[i]);
-		SAFE_RELEASE(fence[i]);
 	};
 }
 
@@ -147,39 +153,12 @@ void RenderAssets::CreateSwapChain(const HWND& window, DXGI_SAMPLE_DESC sampleDe
 bool RenderAssets::CreateCommandList()
 {
 	HRESULT result;
-	// Create command allocators
-	for (int i = 0; i < FRAME_BUFFER_COUNT; i++) {
-		result = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator[i]));
-		if (FAILED(result)) {
-			return false;
-		}
-	}
 
 	// Create command list
-	result = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator[0], NULL, IID_PPV_ARGS(&commandList));
+	result = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, frameScheduler.GetCommandAllocator(0), NULL, IID_PPV_ARGS(&commandList));
 	if (FAILED(result)) {
 		return false;
 	}
 
 	return true;
-}
-
-bool RenderAssets::CreateFence()
-{
-	HRESULT result;
-
-	for (int i = 0; i < FRAME_BUFFER_COUNT; i++) {
-		result = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence[i]));
-		if (FAILED(result)) {
-			return false;
-		}
-		fenceValue[i] = 0;
-	}
-
-	fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-	if (fenceEvent == nullptr) {
-		return false;
-	}
-
-	return true;
-}
+}
\ No newline at end of file
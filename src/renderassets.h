@@ -1,6 +1,8 @@
 #pragma once
 
 #include "gconst.h"
+#include "gputimeline.h"
+#include "framescheduler.h"
 
 class RenderAssets {
 
@@ -12,13 +14,9 @@ public:
 	ID3D12Device* GetDevice() { return device; }
 	IDXGISwapChain3* GetSwapChain() { return swapChain; }
 	ID3D12CommandQueue* GetCommandQueue() { return commandQueue; }
-	ID3D12CommandAllocator* GetCommandAllocator(int index) { return commandAllocator[index]; }
+	GpuTimeline* GetGpuTimeline() { return &gpuTimeline; }
+	FrameScheduler* GetFrameScheduler() { return &frameScheduler; }
 	ID3D12GraphicsCommandList* GetCommandList() { return commandList; }
-	ID3D12Fence* GetFence(int index) { return fence[index]; }
-	ID3D12Fence* IncrementFence(int index) { return fence[index]++; }
-	HANDLE GetFenceEvent() { return fenceEvent; }
-	UINT64 GetFenceValue(int index) { return fenceValue[index]; }
-	UINT64 IncrementFenceValue(int index) { return fenceValue[index]++; }
 	int GetFrameIndex() { return frameIndex; }
 	void SetFrameIndex(int i) { frameIndex = i; }
 	ID3D12DescriptorHeap* GetRtvDescriptorHeap() { return rtvDescriptorHeap; }
@@ -30,7 +28,6 @@ private:
 	bool FindCompatibleAdapter(IDXGIAdapter1* adap);
 	void CreateSwapChain(const HWND& window, DXGI_SAMPLE_DESC sampleDesc, bool screenState);
 	bool CreateCommandList();
-	bool CreateFence();
 
 	// Device & Swapchain
 	ID3D12Device* device;
@@ -39,11 +36,9 @@ private:
 
 	// Commands
 	ID3D12CommandQueue* commandQueue;
-	ID3D12CommandAllocator* commandAllocator[FRAME_BUFFER_COUNT];
+	GpuTimeline gpuTimeline;
+	FrameScheduler frameScheduler;
 	ID3D12GraphicsCommandList* commandList;
-	ID3D12Fence* fence[FRAME_BUFFER_COUNT];
-	HANDLE fenceEvent;
-	UINT64 fenceValue[FRAME_BUFFER_COUNT];
 
 	// Render Target View
 	ID3D12DescriptorHeap* rtvDescriptorHeap;
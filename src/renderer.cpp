@@ -18,8 +18,41 @@ bool Renderer::Init(const HWND& window, bool screenState, float width, float hei
 	}
 
 	// Create Managers
-	textureManager = new TextureManager();
 	resourceManager = new ResourceManager();
+#ifdef MIP_GENERATION_COMPUTE
+	// Decoded images keep level 0 only, the rest of the chain is generated on the GPU
+	MIP_FILTER mipFilter = MF_NONE;
+	bool gpuMips = true;
+#else
+	MIP_FILTER mipFilter = MF_BOX;
+	bool gpuMips = false;
+#endif
+	if (!resourceManager->Init(assets->GetDevice(), assets->GetGpuTimeline()) || !uploader.Init(assets->GetDevice()) ||
+		!textureCache.Init(resourceManager, &uploader, assets->GetGpuTimeline(), TEXTURE_CACHE_BUDGET, 0, mipFilter, gpuMips))
+	{
+		return false;
+	}
+
+	// Cooked assets are optional, anything missing from the package loads from its source
+	assetPackage.Open("assets/assets.pak");
+
+	// Without tiled resources packaged textures are uploaded whole
+	bool streaming = textureStreamer.Init(assets->GetDevice(), &uploader, assets->GetGpuTimeline());
+	streamedTexture = STREAMED_TEXTURE_INVALID;
+
+	// Source images decode on the worker pool while the pipeline objects are created
+	const AssetEntry* textureEntry = assetPackage.Find("gato", AT_TEXTURE);
+	if (!textureEntry)
+	{
+		sceneTexture = textureCache.Acquire(L"assets/gato.png");
+	}
+
+	// Create Geometry Pool
+	if (!geometryPool.Init(resourceManager))
+	{
+		return false;
+	}
+	texturesReady = false;
 
 	// Create Root Descriptor
 	D3D12_ROOT_DESCRIPTOR rootCBVDescriptor;
@@ -91,9 +124,16 @@ bool Renderer::Init(const HWND& window, bool screenState, float width, float hei
 		return false;
 	}
 
+	// Compiled shaders are kept on disk between launches, only changed ones compile again
+	shaderCache.Init("shadercache", Shader::Compile, Shader::GetCompilerTag());
+	// So are the driver's compiled pipelines
+	pipelineCache.Init(assets->GetDevice(), "shadercache/pipelines.bin");
 	CreatePipelineStateObjects();
 
-	CreateUploadVIData();
+	if (!CreateUploadVIData()) {
+		running = false;
+		return false;
+	}
 
 	CD3DX12_HEAP_PROPERTIES dHeapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
 	CD3DX12_HEAP_PROPERTIES uHeapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
@@ -155,43 +195,94 @@ bool Renderer::Init(const HWND& window, bool screenState, float width, float hei
 
 	assets->GetDevice()->CreateDepthStencilView(shadowMapBuffer, &depthStencilDesc, dsvHandle);
 
-	// Create Constant Buffer Resource Heap
-	resoDesc = CD3DX12_RESOURCE_DESC::Buffer(1024 * 64);
-	for (int i = 0; i < FRAME_BUFFER_COUNT; ++i)
-	{
-		result = assets->GetDevice()->CreateCommittedResource(
-			&uHeapProp,
-			D3D12_HEAP_FLAG_NONE,
-			&resoDesc,
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			nullptr,
-			IID_PPV_ARGS(&constantBufferUploadHeaps[i]));
-		constantBufferUploadHeaps[i]->SetName(L"Constant Buffer Upload Resource Heap");
-
-		ZeroMemory(&cbPerObject, sizeof(cbPerObject));
+	// Create Constant Buffer Resource Heap, one slice per frame in flight
+	resoDesc = CD3DX12_RESOURCE_DESC::Buffer(ConstantBufferSliceSize * FRAMES_IN_FLIGHT);
+	result = assets->GetDevice()->CreateCommittedResource(
+		&uHeapProp,
+		D3D12_HEAP_FLAG_NONE,
+		&resoDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&constantBufferUploadHeap));
+	if (FAILED(result)) {
+		running = false;
+		return false;
+	}
+	constantBufferUploadHeap->SetName(L"Constant Buffer Upload Resource Heap");
 
-		CD3DX12_RANGE readRange(0, 0);
+	CD3DX12_RANGE readRange(0, 0);
 
-		result = constantBufferUploadHeaps[i]->Map(0, &readRange, reinterpret_cast<void**>(&cbvGPUAddress[i]));
+	result = constantBufferUploadHeap->Map(0, &readRange, reinterpret_cast<void**>(&cbvGPUAddress));
 
-		memcpy(cbvGPUAddress[i], &cbPerObject, sizeof(cbPerObject)); // Cube
-		memcpy(cbvGPUAddress[i] + ConstantBufferPerObjectAlignedSize, &cbPerObject, sizeof(cbPerObject)); // Plane
-	}
+	ZeroMemory(cbvGPUAddress, ConstantBufferSliceSize * FRAMES_IN_FLIGHT);
 
-	// Load Image From File
-	Texture* newTex = textureManager->CreateTexture(L"assets/gato.png");
+	// Packaged textures upload straight from the mapped file, otherwise decode the source image
+	D3D12_RESOURCE_DESC textureDesc;
+	ID3D12Resource* textureResource;
+	if (textureEntry)
+	{
+		D3D12_SUBRESOURCE_DATA subresources[D3D12_REQ_MIP_LEVELS];
+		UINT subresourceCount = assetPackage.GetSubresources(*textureEntry, subresources);
+		textureDesc = assetPackage.GetTextureDesc(*textureEntry);
+		if (subresourceCount == 0)
+		{
+			running = false;
+			return false;
+		}
 
-	// Assert Image Data
-	if (newTex->GetSize() <= 0)
+		// The package stays mapped, so levels can stream back in from it whenever they are needed
+		if (streaming)
+		{
+			streamedTexture = textureStreamer.Register(textureDesc, subresources, L"Streamed Texture Resource");
+		}
+		if (streamedTexture != STREAMED_TEXTURE_INVALID)
+		{
+			textureTicket = textureStreamer.GetTailTicket(streamedTexture);
+			textureResource = textureStreamer.GetResource(streamedTexture);
+		}
+		else
+		{
+			if (!resourceManager->GetGpuAllocator()->CreateTexture(textureDesc, D3D12_RESOURCE_STATE_COMMON, L"Texture Buffer Resource Heap", &textureBuffer))
+			{
+				running = false;
+				return false;
+			}
+			textureTicket = uploader.UploadSubresources(textureBuffer, 0, subresourceCount, subresources);
+			textureResource = textureBuffer.resource;
+		}
+	}
+	else
+	{
+		// The cache creates and uploads the image once its decode finishes, with room for the
+		// whole chain when the GPU generates the mips
+		if (!textureCache.WaitForResident(sceneTexture))
+		{
+			running = false;
+			return false;
+		}
+		textureDesc = textureCache.GetDesc(sceneTexture);
+		textureResource = textureCache.GetResource(sceneTexture);
+		textureTicket = textureCache.GetUploadTicket(sceneTexture);
+	}
+	if (textureTicket == 0)
 	{
 		running = false;
 		return false;
 	}
+	uploader.Flush();
 
-	// Texture Buffer Heap
-	textureBuffer = resourceManager->CreateTexDefaultHeap(assets->GetDevice(), textureBuffer, newTex, L"Texture Buffer Resource Heap", newTex->GetSize());
-	ID3D12Resource* textureBufferUploadHeap = resourceManager->CreateTexUploadHeap(assets->GetDevice(), newTex, L"Texture Buffer Upload Resource Heap", newTex->GetSize());
-	resourceManager->UploadTextureResources(assets->GetCommandList(), textureBuffer, textureBufferUploadHeap, newTex);
+#ifdef MIP_GENERATION_COMPUTE
+	// The setup list waits on the GPU for level 0 to land, then fills the rest of the chain
+	if (!textureEntry)
+	{
+		if (!mipGenerator.Init(assets->GetDevice(), &shaderCache) || !mipGenerator.Generate(assets->GetDevice(), assets->GetCommandList(), textureResource))
+		{
+			running = false;
+			return false;
+		}
+		uploader.QueueWait(assets->GetCommandQueue(), textureTicket);
+	}
+#endif
 
 	// Create SRV Descriptor Heap
 	D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
@@ -207,10 +298,10 @@ bool Renderer::Init(const HWND& window, bool screenState, float width, float hei
 	// Create SRV
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.Format = newTex->GetDesc().Format;
+	srvDesc.Format = textureDesc.Format;
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	srvDesc.Texture2D.MipLevels = 1;
-	assets->GetDevice()->CreateShaderResourceView(textureBuffer, &srvDesc, srvDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
+	srvDesc.Texture2D.MipLevels = textureDesc.MipLevels;
+	assets->GetDevice()->CreateShaderResourceView(textureResource, &srvDesc, srvDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
 
 	// Create Render Texture Heap
 	D3D12_DESCRIPTOR_HEAP_DESC rtHeapDesc = {};
@@ -287,16 +378,13 @@ bool Renderer::Init(const HWND& window, bool screenState, float width, float hei
 	ID3D12CommandList* ppCommandLists[] = { assets->GetCommandList() };
 	assets->GetCommandQueue()->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
 
-	// Increment Fence Value
-	assets->IncrementFenceValue(assets->GetFrameIndex());
-	result = assets->GetCommandQueue()->Signal(assets->GetFence(assets->GetFrameIndex()), assets->GetFenceValue(assets->GetFrameIndex()));
-	if (FAILED(result))
-	{
-		return false;
-	}
+	// Submit the setup list as the first frame so allocator 0 retires like any other,
+	// the upload ring space is reclaimed once that ticket completes
+	UINT64 uploadTicket = assets->GetFrameScheduler()->EndFrame();
+	resourceManager->FinishUploads(uploadTicket);
 
-	// Free Obsolete Texture Data
-	textureManager->Cleanup();
+	// Direct queue work from here on waits for the geometry on the GPU, the CPU never blocks
+	uploader.QueueWait(assets->GetCommandQueue(), geometryTicket);
 
 	// Define Viewport
 	viewport.TopLeftX = 0;
@@ -326,40 +414,13 @@ bool Renderer::Init(const HWND& window, bool screenState, float width, float hei
 	smScissorRect.right = (LONG)512;
 	smScissorRect.bottom = (LONG)512;
 
-	// build projection and view matrix
-	DirectX::XMMATRIX tmpMat = DirectX::XMMatrixPerspectiveFovLH(60.0f * (3.14f / 180.0f), (float)width / (float)height, 0.1f, 1000.0f);
-	XMStoreFloat4x4(&cameraProjMat, tmpMat);
-
-	// set starting camera state
-	cameraPosition = DirectX::XMFLOAT4(0.0f, 2.0f, -2.0f, 0.0f);
-	cameraTarget = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
-	cameraUp = DirectX::XMFLOAT4(0.0f, 1.0f, 0.0f, 0.0f);
-
-	// build view matrix
-	DirectX::XMVECTOR cPos = XMLoadFloat4(&cameraPosition);
-	DirectX::XMVECTOR cTarg = XMLoadFloat4(&cameraTarget);
-	DirectX::XMVECTOR cUp = XMLoadFloat4(&cameraUp);
-	tmpMat = DirectX::XMMatrixLookAtLH(cPos, cTarg, cUp);
-	XMStoreFloat4x4(&cameraViewMat, tmpMat);
-
-	cubePosition = DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
-	DirectX::XMVECTOR posVec = XMLoadFloat4(&cubePosition);
-
-	tmpMat = DirectX::XMMatrixTranslationFromVector(posVec);
-	XMStoreFloat4x4(&cubeDefaultRotMat, DirectX::XMMatrixIdentity());
-	XMStoreFloat4x4(&cubeRotMat, DirectX::XMMatrixIdentity());
-	XMStoreFloat4x4(&cubeWorldMat, tmpMat);
-
-	planePosition = DirectX::XMFLOAT4(0.0f, -0.5f, 0.0f, 0.0f);
-	posVec = XMLoadFloat4(&planePosition);
-
-	tmpMat = DirectX::XMMatrixTranslationFromVector(posVec);
-	XMStoreFloat4x4(&planeWorldMat, tmpMat);
+	// Build Camera, Cube & Plane
+	scene.Init(width, height);
 
 	ImGui_ImplDX12_InitInfo init_info = {};
 	init_info.Device = assets->GetDevice();
 	init_info.CommandQueue = assets->GetCommandQueue();
-	init_info.NumFramesInFlight = FRAME_BUFFER_COUNT;
+	init_info.NumFramesInFlight = FRAMES_IN_FLIGHT;
 	init_info.RTVFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
 	init_info.DSVFormat = DXGI_FORMAT_UNKNOWN;
 	init_info.SrvDescriptorHeap = srvDescriptorHeap;
@@ -369,8 +430,19 @@ bool Renderer::Init(const HWND& window, bool screenState, float width, float hei
 		return false;
 	}
 
-	dsaModifiers = {1.0f, 1.0f, 1.0f};
-	ppOption = 0;
+	// Hand the pass resources to the frame recorder and the per frame update
+	FillFrameBindings();
+	FrameTargets targets;
+	targets.frameScheduler = assets->GetFrameScheduler();
+	targets.scene = &scene;
+	targets.textureCache = &textureCache;
+	targets.textureStreamer = &textureStreamer;
+	targets.streamedTexture = streamedTexture;
+	targets.viewportHeight = viewport.Height;
+	targets.constantBuffer = cbvGPUAddress;
+	targets.constantBufferSliceSize = ConstantBufferSliceSize;
+	targets.constantBufferStride = ConstantBufferPerObjectAlignedSize;
+	frameUpdater.SetTargets(targets);
 
 	return true;
 }
@@ -378,26 +450,36 @@ bool Renderer::Init(const HWND& window, bool screenState, float width, float hei
 void Renderer::UnInit()
 {
 	// Wait for GPU to finish
-	for (int i = 0; i < FRAME_BUFFER_COUNT; ++i)
-	{
-		assets->SetFrameIndex(i);
-		WaitForPreviousFrame();
+	assets->GetGpuTimeline()->WaitForIdle();
+
+	// Pipelines and the cache's library hold on to the device, release them before it
+	for (PipelineStateObject* pso : scenePSOs) {
+		delete pso;
+	}
+	for (PipelineStateObject* pso : postPSOs) {
+		delete pso;
 	}
+	scenePSOs.clear();
+	postPSOs.clear();
+	delete shadowPSO;
+	shadowPSO = nullptr;
+	pipelineCache.UnInit();
 
 	assets->UnInit();
 	delete assets;
 	assets = nullptr;
 
 	SAFE_RELEASE(renderTexture);
-	delete scenePSO;
-	delete postPSO;
-	delete shadowPSO;
 	SAFE_RELEASE(baseRootSig);
-	SAFE_RELEASE(cubeVertexBuffer);
-	SAFE_RELEASE(cubeIndexBuffer);
-	SAFE_RELEASE(textureBuffer);
-	SAFE_RELEASE(renderTriVertexBuffer);
-	SAFE_RELEASE(renderTriIndexBuffer);
+	uploader.UnInit();
+	geometryPool.UnInit();
+	resourceManager->FreeResource(&textureBuffer);
+	if (sceneTexture.IsValid()) {
+		textureCache.Release(sceneTexture);
+	}
+	textureCache.UnInit();
+	textureStreamer.UnInit();
+	mipGenerator.UnInit();
 
 	SAFE_RELEASE(depthStencilBuffer);
 	SAFE_RELEASE(shadowMapBuffer);
@@ -409,100 +491,40 @@ void Renderer::UnInit()
 	SAFE_RELEASE(rtDescriptorHeap);
 	SAFE_RELEASE(fontDescriptorHeap);
 
-	delete textureManager;
-	textureManager = nullptr;
-
+	resourceManager->UnInit();
 	delete resourceManager;
 	resourceManager = nullptr;
 
-	for (int i = 0; i < FRAME_BUFFER_COUNT; ++i)
-	{
-		SAFE_RELEASE(constantBufferUploadHeaps[i]);
-	};
+	SAFE_RELEASE(constantBufferUploadHeap);
 
 	ImGui_ImplDX12_Shutdown();
 }
 
 void Renderer::Update(float dt)
 {
-	// add rotation to cube1's rotation matrix and store it
-	DirectX::XMMATRIX rotMat = XMLoadFloat4x4(&cubeRotMat);
-	if (rotateX) {
-		DirectX::XMMATRIX rotMatX = XMMatrixRotationX(rotateSpeed * 0.002f * dt);
-		rotMat *= rotMatX;
-	}
-	if (rotateY) {
-		DirectX::XMMATRIX rotMatY = XMMatrixRotationY(rotateSpeed * 0.002f * dt);
-		rotMat *= rotMatY;
-	}
-	if (rotateZ) {
-		DirectX::XMMATRIX rotMatZ = XMMatrixRotationZ(rotateSpeed * 0.002f * dt);
-		rotMat *= rotMatZ;
-	}
-	if (resetCube) {
-		rotateX = false;
-		rotateY = false;
-		rotateZ = false;
-		rotMat = XMLoadFloat4x4(&cubeDefaultRotMat);
-	}
-	XMStoreFloat4x4(&cubeRotMat, rotMat);
-
-	// create translation matrix for cube 1 from cube 1's position vector
-	DirectX::XMMATRIX translationMat = DirectX::XMMatrixTranslationFromVector(XMLoadFloat4(&cubePosition));
-
-	// create cube1's world matrix by first rotating the cube, then positioning the rotated cube
-	DirectX::XMMATRIX worldMat = rotMat * translationMat;
-
-	// store cube1's world matrix
-	XMStoreFloat4x4(&cubeWorldMat, worldMat);
-
-	// update constant buffer for cube1
-	// create the wvp matrix and store in constant buffer
-	DirectX::XMMATRIX viewMat = XMLoadFloat4x4(&cameraViewMat); // load view matrix
-	DirectX::XMMATRIX projMat = XMLoadFloat4x4(&cameraProjMat); // load projection matrix
-	DirectX::XMMATRIX wMat = XMLoadFloat4x4(&cubeWorldMat); // create world matrix
-	DirectX::XMMATRIX vpMat = XMMatrixMultiply(viewMat, projMat); // create view projection matrix
-
-	XMStoreFloat4x4(&cbPerObject.wMat, XMMatrixTranspose(wMat)); // store transposed w matrix in constant buffer
-	XMStoreFloat4x4(&cbPerObject.vpMat, XMMatrixTranspose(vpMat)); // store transposed vp matrix in constant buffer
-	XMStoreFloat4(&cbPerObject.camPos, XMLoadFloat4(&cameraPosition));
-	XMStoreFloat3(&cbPerObject.dsaMod, XMLoadFloat3(&dsaModifiers));
-	XMStoreInt(&cbPerObject.ppOption, XMLoadInt(&ppOption));
-
-	DirectX::XMMATRIX lightView = DirectX::XMMatrixLookAtLH(XMLoadFloat4(&lightPosition), XMLoadFloat4(&cameraTarget), XMLoadFloat4(&cameraUp));
-	DirectX::XMMATRIX lightProj = DirectX::XMMatrixOrthographicLH(20, 20, nearPlane, farPlane);
-	DirectX::XMMATRIX lightMat = XMMatrixMultiply(lightView, lightProj);
-	XMStoreFloat4x4(&cbPerObject.lMat, XMMatrixTranspose(lightMat));
-	XMStoreFloat4(&cbPerObject.lDir, XMLoadFloat4(&lightPosition));
-
-	// copy our ConstantBuffer instance to the mapped constant buffer resource
-	memcpy(cbvGPUAddress[assets->GetFrameIndex()], &cbPerObject, sizeof(cbPerObject));
-
-	translationMat = DirectX::XMMatrixTranslationFromVector(XMLoadFloat4(&planePosition));
-	worldMat = translationMat;
-	XMStoreFloat4x4(&planeWorldMat, worldMat);
-
-	wMat = XMLoadFloat4x4(&planeWorldMat);
-	XMStoreFloat4x4(&cbPerObject.wMat, XMMatrixTranspose(wMat));
-
-	memcpy(cbvGPUAddress[assets->GetFrameIndex()] + ConstantBufferPerObjectAlignedSize, &cbPerObject, sizeof(cbPerObject));
+	// Scene, textures and constants for the next frame slot, shared with bench_renderer
+	if (frameUpdater.Update(dt)) {
+		FillFrameBindings();
+	}
+	frameSlot = frameUpdater.GetFrameSlot();
 }
 
 void Renderer::UpdatePipeline()
 {
 	HRESULT result;
 
-	// Wait for GPU to finish
-	WaitForPreviousFrame();
+	// Swap to correct buffer
+	assets->SetFrameIndex(assets->GetSwapChain()->GetCurrentBackBufferIndex());
 
-	// Reset allocator when GPU is done
-	result = assets->GetCommandAllocator(assets->GetFrameIndex())->Reset();
+	// Reset allocator, its last frame was retired in Update
+	ID3D12CommandAllocator* commandAllocator = assets->GetFrameScheduler()->GetCommandAllocator(frameSlot);
+	result = commandAllocator->Reset();
 	if (FAILED(result)) {
 		running = false;
 	}
 
 	// Reset command lists and set starting PSO
-	result = assets->GetCommandList()->Reset(assets->GetCommandAllocator(assets->GetFrameIndex()), scenePSO->GetState());
+	result = assets->GetCommandList()->Reset(commandAllocator, scenePSOs[frameUpdater.GetLightingMask()]->GetState());
 	if (FAILED(result)) {
 		running = false;
 	}
@@ -511,54 +533,22 @@ void Renderer::UpdatePipeline()
 	CD3DX12_RESOURCE_BARRIER resoBarr = CD3DX12_RESOURCE_BARRIER::Transition(assets->GetRenderTarget(assets->GetFrameIndex()), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
 	assets->GetCommandList()->ResourceBarrier(1, &resoBarr);
 
-	// Get handle to render target and depth buffer for merger stage
-	CD3DX12_CPU_DESCRIPTOR_HANDLE fbHandle(rtDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
-	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(assets->GetRtvDescriptorHeap()->GetCPUDescriptorHandleForHeapStart(), assets->GetFrameIndex(), assets->GetRtvDescriptorSize());
-	CD3DX12_CPU_DESCRIPTOR_HANDLE dsvHandle(dsDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
-
-	ID3D12DescriptorHeap* descriptorHeaps[] = { srvDescriptorHeap };
-	assets->GetCommandList()->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
-
-	assets->GetCommandList()->SetGraphicsRootSignature(baseRootSig);
-	assets->GetCommandList()->SetGraphicsRootDescriptorTable(1, srvDescriptorHeap->GetGPUDescriptorHandleForHeapStart());
-
-	// Shadow Map Pass
-	dsvHandle.ptr += assets->GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
+	// Draw the textured scene once its uploads have landed
+	if (!texturesReady) {
+		texturesReady = uploader.IsComplete(textureTicket);
+	}
 
-	assets->GetCommandList()->RSSetViewports(1, &smViewport);
-	assets->GetCommandList()->RSSetScissorRects(1, &smScissorRect);
-
-	assets->GetCommandList()->OMSetRenderTargets(0, nullptr, FALSE, &dsvHandle);
-	assets->GetCommandList()->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
-	assets->GetCommandList()->SetPipelineState(shadowPSO->GetState());
-	DrawScene(true, true);
-
-	// Scene Pass
-	dsvHandle.ptr -= assets->GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
-
-	assets->GetCommandList()->RSSetViewports(1, &viewport);
-	assets->GetCommandList()->RSSetScissorRects(1, &scissorRect);
-	
-	assets->GetCommandList()->OMSetRenderTargets(1, &fbHandle, FALSE, &dsvHandle);
-	const float newClearColor[] = {0.2f, 0.1f, 0.3f, 1.0f};
-	assets->GetCommandList()->ClearRenderTargetView(fbHandle, newClearColor, 0, nullptr);
-	assets->GetCommandList()->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
-	assets->GetCommandList()->SetPipelineState(scenePSO->GetState());
-	DrawScene(true, true);
-
-	// Post Process Pass
-	assets->GetCommandList()->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
-	const float newerClearColor[] = {1.0f, 1.0f, 1.0f, 1.0f};
-	assets->GetCommandList()->ClearRenderTargetView(rtvHandle, newerClearColor, 0, nullptr);
-	assets->GetCommandList()->SetPipelineState(postPSO->GetState());
-	assets->GetCommandList()->IASetVertexBuffers(0, 1, &renderTriVertexBufferView);
-	assets->GetCommandList()->IASetIndexBuffer(&renderTriIndexBufferView);
-	assets->GetCommandList()->DrawIndexedInstanced(3, 1, 0, 0, 0);
+	// Record shadow, scene and post process passes
+	CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(assets->GetRtvDescriptorHeap()->GetCPUDescriptorHandleForHeapStart(), assets->GetFrameIndex(), assets->GetRtvDescriptorSize());
+	frameRecorder.RecordPasses(assets->GetCommandList(), constantBufferUploadHeap->GetGPUVirtualAddress() + frameSlot * ConstantBufferSliceSize, ConstantBufferPerObjectAlignedSize, rtvHandle, texturesReady);
 
 	// Render ImGui
 	RenderImGui();
 
 	// Set render target to present state
+	resoBarr = CD3DX12_RESOURCE_BARRIER::Transition(assets->GetRenderTarget(assets->GetFrameIndex()), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+	assets->GetCommandList()->ResourceBarrier(1, &resoBarr);
+
 	result = assets->GetCommandList()->Close();
 	if (FAILED(result)) {
 		running = false;
@@ -577,10 +567,12 @@ void Renderer::Render()
 	// Execute command lists
 	assets->GetCommandQueue()->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
 
-	// Last command in queue
-	result = assets->GetCommandQueue()->Signal(assets->GetFence(assets->GetFrameIndex()), assets->GetFenceValue(assets->GetFrameIndex()));
-	if (FAILED(result)) {
-		running = false;
+	// Last command in queue, retires this frame's slot
+	UINT64 frameTicket = assets->GetFrameScheduler()->EndFrame();
+
+	// Cached textures drawn this frame stay resident until it retires
+	if (sceneTexture.IsValid()) {
+		textureCache.MarkUsed(sceneTexture, frameTicket);
 	}
 
 	// Present the backbuffer
@@ -590,33 +582,7 @@ void Renderer::Render()
 	}
 }
 
-void Renderer::WaitForPreviousFrame()
-{
-	HRESULT result;
-
-	// Swap to correct buffer
-	assets->SetFrameIndex(assets->GetSwapChain()->GetCurrentBackBufferIndex());
-
-	// Check if GPU has finished executing
-	if (assets->GetFence(assets->GetFrameIndex())->GetCompletedValue() < assets->GetFenceValue(assets->GetFrameIndex()))
-	{
-		// Fence create an event
-		result = assets->GetFence(assets->GetFrameIndex())->SetEventOnCompletion(assets->GetFenceValue(assets->GetFrameIndex()), assets->GetFenceEvent());
-		if (FAILED(result)) {
-			running = false;
-		}
-
-		// Wait for event to finish
-		WaitForSingleObject(assets->GetFenceEvent(), INFINITE);
-	}
-
-	// Increment for next frame
-	assets->IncrementFenceValue(assets->GetFrameIndex());
-}
-
-void Renderer::CloseFenceEventHandle() { CloseHandle(assets->GetFenceEvent()); }
-
-void Renderer::CreateUploadVIData()
+bool Renderer::CreateUploadVIData()
 {
 	// Verticies
 	Vertex cubeVList[] = {
@@ -656,7 +622,6 @@ void Renderer::CreateUploadVIData()
 		{  0.5f, -0.5f, -0.5f, 0.0f, 1.0f },
 		{ -0.5f, -0.5f,  0.5f, 1.0f, 0.0f },
 	};
-	int cubeVBufferSize = sizeof(cubeVList);
 
 	// Verticies
 	Vertex triVList[] = {
@@ -665,7 +630,6 @@ void Renderer::CreateUploadVIData()
 		{  3.0f,  1.0f, 0.0f, 2.0f, 0.0f },
 		{ -1.0f, -3.0f, 0.0f, 0.0f, 2.0f },
 	};
-	int triVBufferSize = sizeof(triVList);
 
 	Vertex planeVList[] = {
 
@@ -674,28 +638,6 @@ void Renderer::CreateUploadVIData()
 		{  2.0f, 0.0f, -2.0f, 1.0f, 1.0f },
 		{ -2.0f, 0.0f, -2.0f, 0.0f, 1.0f },
 	};
-	int planeVBufferSize = sizeof(planeVList);
-
-	// Cube Verticies Heaps
-	cubeVertexBuffer = resourceManager->CreateVIDefaultHeap(assets->GetDevice(), cubeVertexBuffer, L"Cube Vertex Buffer Resource Heap", cubeVBufferSize);
-	ID3D12Resource* cubeVBufferUploadHeap = resourceManager->CreateVIUploadHeap(assets->GetDevice(), L"Cube Vertex Buffer Upload Resource Heap", cubeVBufferSize);
-
-	// Cube Copy Verticies to Default Heap
-	resourceManager->UploadVertexResources(assets->GetCommandList(), cubeVertexBuffer, cubeVBufferUploadHeap, cubeVList);
-
-	// Tri Verticies Heaps
-	renderTriVertexBuffer = resourceManager->CreateVIDefaultHeap(assets->GetDevice(), renderTriVertexBuffer, L"Tri Vertex Buffer Resource Heap", triVBufferSize);
-	ID3D12Resource* triVBufferUploadHeap = resourceManager->CreateVIUploadHeap(assets->GetDevice(), L"Tri Vertex Buffer Upload Resource Heap", triVBufferSize);
-
-	// Tri Copy Verticies to Default Heap
-	resourceManager->UploadVertexResources(assets->GetCommandList(), renderTriVertexBuffer, triVBufferUploadHeap, triVList);
-
-	// Plane Verticies Heaps
-	planeVertexBuffer = resourceManager->CreateVIDefaultHeap(assets->GetDevice(), planeVertexBuffer, L"Plane Vertex Buffer Resource Heap", planeVBufferSize);
-	ID3D12Resource* planeVBufferUploadHeap = resourceManager->CreateVIUploadHeap(assets->GetDevice(), L"Plane Vertex Buffer Upload Resource Heap", planeVBufferSize);
-
-	// Plane Copy Verticies to Default Heap
-	resourceManager->UploadVertexResources(assets->GetCommandList(), planeVertexBuffer, planeVBufferUploadHeap, planeVList);
 
 	// Cube Indicies
 	UINT32 cubeIList[] = {
@@ -723,134 +665,189 @@ void Renderer::CreateUploadVIData()
 		20, 21, 22,
 		20, 23, 21,
 	};
-	int cubeIBufferSize = sizeof(cubeIList);
-	numCubeIndices = sizeof(cubeIList) / sizeof(UINT32);
 
 	// Tri Indicies
 	UINT32 triIList[] = {
 		0, 1, 2,
 	};
-	int triIBufferSize = sizeof(triIList);
 
 	// Plane Indicies
 	UINT32 planeIList[] = {
 		0, 1, 2,
 		0, 2, 3,
 	};
-	int planeIBufferSize = sizeof(planeIList);
-
-	// Cube Indicies Heaps
-	cubeIndexBuffer = resourceManager->CreateVIDefaultHeap(assets->GetDevice(), cubeIndexBuffer, L"Cube Index Buffer Resource Heap", cubeIBufferSize);
-	ID3D12Resource* cubeIBufferUploadHeap = resourceManager->CreateVIUploadHeap(assets->GetDevice(), L"Cube Index Buffer Upload Resource Heap", cubeIBufferSize);
-
-	// Cube Copy Indicies to Default Heap
-	resourceManager->UploadIndexResources(assets->GetCommandList(), cubeIndexBuffer, cubeIBufferUploadHeap, cubeIList);
-
-	// Tri Indicies Heaps
-	renderTriIndexBuffer = resourceManager->CreateVIDefaultHeap(assets->GetDevice(), renderTriIndexBuffer, L"Tri Index Buffer Resource Heap", triIBufferSize);
-	ID3D12Resource* triIBufferUploadHeap = resourceManager->CreateVIUploadHeap(assets->GetDevice(), L"Tri Index Buffer Upload Resource Heap", triIBufferSize);
-
-	// Tri Copy Indicies to Default Heap
-	resourceManager->UploadIndexResources(assets->GetCommandList(), renderTriIndexBuffer, triIBufferUploadHeap, triIList);
-
-	// Plane Indicies Heaps
-	planeIndexBuffer = resourceManager->CreateVIDefaultHeap(assets->GetDevice(), planeIndexBuffer, L"Plane Index Buffer Resource Heap", planeIBufferSize);
-	ID3D12Resource* planeIBufferUploadHeap = resourceManager->CreateVIUploadHeap(assets->GetDevice(), L"Plane Index Buffer Upload Resource Heap", planeIBufferSize);
-
-	// Plane Copy Indicies to Default Heap
-	resourceManager->UploadIndexResources(assets->GetCommandList(), planeIndexBuffer, planeIBufferUploadHeap, planeIList);
-
-	// Create VBV
-	cubeVertexBufferView.BufferLocation = cubeVertexBuffer->GetGPUVirtualAddress();
-	cubeVertexBufferView.StrideInBytes = sizeof(Vertex);
-	cubeVertexBufferView.SizeInBytes = cubeVBufferSize;
-
-	// Create Index Buffer View
-	cubeIndexBufferView.BufferLocation = cubeIndexBuffer->GetGPUVirtualAddress();
-	cubeIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
-	cubeIndexBufferView.SizeInBytes = cubeIBufferSize;
-
-	// Create VBV
-	renderTriVertexBufferView.BufferLocation = renderTriVertexBuffer->GetGPUVirtualAddress();
-	renderTriVertexBufferView.StrideInBytes = sizeof(Vertex);
-	renderTriVertexBufferView.SizeInBytes = triVBufferSize;
-
-	// Create Index Buffer View
-	renderTriIndexBufferView.BufferLocation = renderTriIndexBuffer->GetGPUVirtualAddress();
-	renderTriIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
-	renderTriIndexBufferView.SizeInBytes = triIBufferSize;
-
-	// Create VBV
-	planeVertexBufferView.BufferLocation = planeVertexBuffer->GetGPUVirtualAddress();
-	planeVertexBufferView.StrideInBytes = sizeof(Vertex);
-	planeVertexBufferView.SizeInBytes = planeVBufferSize;
-
-	// Create Index Buffer View
-	planeIndexBufferView.BufferLocation = planeIndexBuffer->GetGPUVirtualAddress();
-	planeIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
-	planeIndexBufferView.SizeInBytes = planeIBufferSize;
+
+	// Reorder for the vertex cache, overdraw and vertex fetch before they go to the GPU
+	MeshOptimizer meshOptimizer;
+	meshOptimizer.Optimize(cubeVList, cubeIList);
+	meshOptimizer.Optimize(planeVList, planeIList);
+
+	// Suzanne comes straight from the mapped package when it was packed, otherwise she is
+	// imported once and cooked. The scene scales her to the cube's size to take its place.
+	MeshData model;
+	MeshImporter meshImporter;
+	std::span<const Vertex> modelVertices;
+	std::span<const UINT32> modelIndices;
+	if (const AssetEntry* modelEntry = assetPackage.Find("Suzanne", AT_MESH)) {
+		modelVertices = assetPackage.GetVertices(*modelEntry);
+		modelIndices = assetPackage.GetIndices(*modelEntry);
+	}
+	else if (meshImporter.Load("assets/Suzanne.fbx", &model)) {
+		modelVertices = model.vertices;
+		modelIndices = model.indices;
+	}
+	modelMesh = {};
+	if (!modelIndices.empty()) {
+		float extent = 0.0f;
+		for (const Vertex& vertex : modelVertices) {
+			extent = std::max<float>({ extent, std::fabs(vertex.pos.x), std::fabs(vertex.pos.y), std::fabs(vertex.pos.z) });
+		}
+		scene.GetSettings().modelScale = extent > 0.0f ? 0.5f / extent : 1.0f;
+		if (!uploader.UploadMesh(&geometryPool, modelVertices, modelIndices, &modelMesh)) {
+			return false;
+		}
+	}
+
+	// Append Meshes to the Geometry Pool on the copy queue
+	if (!uploader.UploadMesh(&geometryPool, cubeVList, cubeIList, &cubeMesh) ||
+		!uploader.UploadMesh(&geometryPool, triVList, triIList, &renderTriMesh) ||
+		!uploader.UploadMesh(&geometryPool, planeVList, planeIList, &planeMesh))
+	{
+		return false;
+	}
+
+	// Every pass needs the geometry, so send it ahead of the textures
+	geometryTicket = uploader.Flush();
+
+	return true;
 }
 
 bool Renderer::CreatePipelineStateObjects()
 {
-	HRESULT result;
-
-	scenePSO = new PipelineStateObject();
-	postPSO = new PipelineStateObject();
+	// Options are keywords compiled into pixel shader variants, keywords in LIGHTING_KEYWORD and POST_KEYWORD order
+	litPermutation.Init("PixelShader", { "SPECULAR", "SHADOWS" });
+	postPermutation.Init("PPPixelShader", { "SHOW_SHADOW_MAP", "BOX_BLUR", "GAUSSIAN_BLUR" });
+	postPermutation.AddExclusiveGroup(PK_SHOW_SHADOW_MAP | PK_BOX_BLUR | PK_GAUSSIAN_BLUR);
+	std::vector<UINT32> litMasks = litPermutation.GetMasks();
+	std::vector<UINT32> postMasks = postPermutation.GetMasks();
+	scenePSOs.assign(litPermutation.GetMaskCount(), nullptr);
+	postPSOs.assign(postPermutation.GetMaskCount(), nullptr);
 	shadowPSO = new PipelineStateObject();
 
-	// Create Scene Shaders
-	Shader vertexShader{};
-	vertexShader.Init(L"shaders/VertexShader.hlsl", "main", "vs_5_0");
+	// Pipelines read vertices in whatever layout the geometry pool stores
+	const VertexFormat& vertexFormat = GetVertexFormat(geometryPool.GetVertexLayout());
+	const D3D_SHADER_MACRO packedDefines[] = { { "PACKED_VERTICES", "1" }, { nullptr, nullptr } };
+	const D3D_SHADER_MACRO* vertexDefines = vertexFormat.layout == VL_PACKED ? packedDefines : nullptr;
 
-	Shader pixelShader{};
-	pixelShader.Init(L"shaders/PixelShader.hlsl", "main", "ps_5_0");
+	// Every shader compiles on its own worker and each pipeline is created as soon as its two
+	// shaders are in, so startup scales with the core count rather than the shader count
+	Shader vertexShader{}, ppVertexShader{}, dsVertexShader{}, dsPixelShader{};
+	// Variants are indexed by mask, their defines live until the tasks have run
+	std::vector<Shader> pixelShaders(litPermutation.GetMaskCount()), ppPixelShaders(postPermutation.GetMaskCount());
+	std::vector<std::vector<D3D_SHADER_MACRO>> litDefines(litPermutation.GetMaskCount()), postDefines(postPermutation.GetMaskCount());
+	std::vector<TaskId> pixelTasks(litPermutation.GetMaskCount()), ppPixelTasks(postPermutation.GetMaskCount());
+	TaskGraph startup;
 
-	// Create Framebuffer Shaders
-	Shader ppVertexShader{};
-	ppVertexShader.Init(L"shaders/PPVertexShader.hlsl", "main", "vs_5_0");
+	// Create Scene Shaders
+	TaskId vs = startup.Add("VertexShader", [&]() { return vertexShader.Init(L"shaders/VertexShader.hlsl", "main", "vs_5_0", vertexDefines, &shaderCache); });
+	for (UINT32 mask : litMasks)
+	{
+		litDefines[mask] = litPermutation.GetDefines(mask);
+		pixelTasks[mask] = startup.Add("PixelShader " + litPermutation.GetVariantLabel(mask), [&, mask]() {
+			return pixelShaders[mask].Init(L"shaders/PixelShader.hlsl", "main", "ps_5_0", litDefines[mask].data(), &shaderCache);
+		});
+	}
 
-	Shader ppPixelShader{};
-	ppPixelShader.Init(L"shaders/PPPixelShader.hlsl", "main", "ps_5_0");
+	// Create Framebuffer Shaders
+	TaskId ppVs = startup.Add("PPVertexShader", [&]() { return ppVertexShader.Init(L"shaders/PPVertexShader.hlsl", "main", "vs_5_0", nullptr, &shaderCache); });
+	for (UINT32 mask : postMasks)
+	{
+		postDefines[mask] = postPermutation.GetDefines(mask);
+		ppPixelTasks[mask] = startup.Add("PPPixelShader " + postPermutation.GetVariantLabel(mask), [&, mask]() {
+			return ppPixelShaders[mask].Init(L"shaders/PPPixelShader.hlsl", "main", "ps_5_0", postDefines[mask].data(), &shaderCache);
+		});
+	}
 
 	// Create Shadow Map Shaders
-	Shader dsVertexShader{};
-	dsVertexShader.Init(L"shaders/DSVertexShader.hlsl", "main", "vs_5_0");
+	TaskId dsVs = startup.Add("DSVertexShader", [&]() { return dsVertexShader.Init(L"shaders/DSVertexShader.hlsl", "main", "vs_5_0", nullptr, &shaderCache); });
+	TaskId dsPs = startup.Add("DSPixelShader", [&]() { return dsPixelShader.Init(L"shaders/DSPixelShader.hlsl", "main", "ps_5_0", nullptr, &shaderCache); });
 
-	Shader dsPixelShader{};
-	dsPixelShader.Init(L"shaders/DSPixelShader.hlsl", "main", "ps_5_0");
+	// Create Pipeline State Objects, One Per Pixel Shader Variant
+	for (UINT32 mask : litMasks)
+	{
+		scenePSOs[mask] = new PipelineStateObject();
+		startup.Add("Scene PSO " + litPermutation.GetVariantLabel(mask), [&, mask]() {
+			return scenePSOs[mask]->Init(&pipelineCache, baseRootSig, vertexFormat, &vertexShader, &pixelShaders[mask], 1);
+		}, { vs, pixelTasks[mask] });
+	}
+	for (UINT32 mask : postMasks)
+	{
+		postPSOs[mask] = new PipelineStateObject();
+		startup.Add("Post PSO " + postPermutation.GetVariantLabel(mask), [&, mask]() {
+			return postPSOs[mask]->Init(&pipelineCache, baseRootSig, vertexFormat, &ppVertexShader, &ppPixelShaders[mask], 1);
+		}, { ppVs, ppPixelTasks[mask] });
+	}
+	startup.Add("Shadow PSO", [&]() { return shadowPSO->InitShadowMap(&pipelineCache, baseRootSig, vertexFormat, &dsVertexShader, &dsPixelShader); }, { dsVs, dsPs });
 
-	if (!scenePSO->Init(assets->GetDevice(), baseRootSig, &vertexShader, &pixelShader, 1)) {
-		running = false;
-		return false;
+	WorkerPool workers;
+	workers.Init();
+	bool created = startup.Run(&workers);
+	workers.UnInit();
+	OutputDebugStringA(("Pipeline startup\n" + startup.FormatReport()).c_str());
+
+	// Compile time and size of every variant
+	for (UINT32 mask : litMasks) {
+		litPermutation.SetVariantStats(mask, startup.GetTimings()[pixelTasks[mask]].durationMs, pixelShaders[mask].GetBytecode().BytecodeLength);
 	}
-	if (!postPSO->Init(assets->GetDevice(), baseRootSig, &ppVertexShader, &ppPixelShader, 1)) {
-		running = false;
-		return false;
+	for (UINT32 mask : postMasks) {
+		postPermutation.SetVariantStats(mask, startup.GetTimings()[ppPixelTasks[mask]].durationMs, ppPixelShaders[mask].GetBytecode().BytecodeLength);
 	}
-	if (!shadowPSO->InitShadowMap(assets->GetDevice(), baseRootSig, &dsVertexShader, &dsPixelShader)) {
+	OutputDebugStringA((litPermutation.FormatReport() + postPermutation.FormatReport()).c_str());
+	if (!created) {
 		running = false;
 		return false;
 	}
 
+	PipelineCacheStats pipelineStats = pipelineCache.GetStats();
+	char line[160];
+	snprintf(line, sizeof(line), "Pipelines: %llu loaded (%.3f ms), %llu created (%.3f ms), %llu reused, %llu rejected\n",
+		pipelineStats.loaded, pipelineStats.loadMs, pipelineStats.created, pipelineStats.createMs, pipelineStats.hits, pipelineStats.rejected);
+	OutputDebugStringA(line);
+	pipelineCache.Save();
+
 	return true;
 }
 
-void Renderer::DrawScene(bool drawCube, bool drawPlane)
+void Renderer::FillFrameBindings()
 {
-	assets->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	if (drawCube) {
-		assets->GetCommandList()->SetGraphicsRootConstantBufferView(0, constantBufferUploadHeaps[assets->GetFrameIndex()]->GetGPUVirtualAddress());
-		assets->GetCommandList()->IASetVertexBuffers(0, 1, &cubeVertexBufferView);
-		assets->GetCommandList()->IASetIndexBuffer(&cubeIndexBufferView);
-		assets->GetCommandList()->DrawIndexedInstanced(numCubeIndices, 1, 0, 0, 0);
-	}
-	if (drawPlane) {
-		assets->GetCommandList()->SetGraphicsRootConstantBufferView(0, constantBufferUploadHeaps[assets->GetFrameIndex()]->GetGPUVirtualAddress() + ConstantBufferPerObjectAlignedSize);
-		assets->GetCommandList()->IASetVertexBuffers(0, 1, &planeVertexBufferView);
-		assets->GetCommandList()->IASetIndexBuffer(&planeIndexBufferView);
-		assets->GetCommandList()->DrawIndexedInstanced(6, 1, 0, 0, 0);
-	}
+	FrameBindings bindings;
+
+	bindings.rootSignature = baseRootSig;
+	// Variants for the current options, rebound whenever they change
+	bindings.scenePSO = scenePSOs[scene.GetLightingMask()]->GetState();
+	bindings.postPSO = postPSOs[scene.GetPostMask()]->GetState();
+	bindings.shadowPSO = shadowPSO->GetState();
+
+	bindings.srvDescriptorHeap = srvDescriptorHeap;
+	bindings.srvTable = srvDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
+	bindings.renderTextureRtv = rtDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+	bindings.depthStencilDsv = dsDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+	bindings.shadowMapDsv = bindings.depthStencilDsv;
+	bindings.shadowMapDsv.ptr += assets->GetDevice()->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
+
+	bindings.vertexBufferView = geometryPool.GetVertexBufferView();
+	bindings.indexBufferView16 = geometryPool.GetIndexBufferView(DXGI_FORMAT_R16_UINT);
+	bindings.indexBufferView32 = geometryPool.GetIndexBufferView(DXGI_FORMAT_R32_UINT);
+	bindings.cube = scene.GetSettings().showModel && modelMesh.indexCount > 0 ? modelMesh : cubeMesh;
+	bindings.plane = planeMesh;
+	bindings.renderTri = renderTriMesh;
+
+	bindings.viewport = viewport;
+	bindings.scissorRect = scissorRect;
+	bindings.smViewport = smViewport;
+	bindings.smScissorRect = smScissorRect;
+
+	frameRecorder.SetBindings(bindings);
 }
 
 void Renderer::RenderImGui()
@@ -860,24 +857,31 @@ void Renderer::RenderImGui()
 	ImGui_ImplSDL3_NewFrame();
 	ImGui::NewFrame();
 
+	SceneSettings& settings = scene.GetSettings();
+
 	ImGui::Begin("Menu");
 	if (ImGui::CollapsingHeader("Lighting Settings")) {
-		ImGui::SliderFloat("Diffuse", &dsaModifiers.x, 0.0f, 1.0f);
-		ImGui::SliderFloat("Specular", &dsaModifiers.y, 0.0f, 1.0f);
-		ImGui::SliderFloat("Ambient", &dsaModifiers.z, 0.0f, 1.0f);
-		ImGui::SliderFloat3("Light Position", &lightPosition.x, -5.0f, 5.0f);
+		ImGui::SliderFloat("Diffuse", &settings.dsaModifiers.x, 0.0f, 1.0f);
+		ImGui::SliderFloat("Specular", &settings.dsaModifiers.y, 0.0f, 1.0f);
+		ImGui::SliderFloat("Ambient", &settings.dsaModifiers.z, 0.0f, 1.0f);
+		ImGui::SliderFloat3("Light Position", &settings.lightPosition.x, -5.0f, 5.0f);
+		ImGui::Checkbox("Specular Highlights", &settings.specular);
+		ImGui::Checkbox("Receive Shadows", &settings.shadows);
 	}
 	if (ImGui::CollapsingHeader("Cube Settings")) {
-		resetCube = ImGui::Button("Reset Cube");
-		ImGui::Checkbox("Rotate X", &rotateX);
-		ImGui::Checkbox("Rotate Y", &rotateY);
-		ImGui::Checkbox("Rotate Z", &rotateZ);
-		ImGui::SliderFloat("Rotate Speed", &rotateSpeed, -1.0f, 1.0f);
+		settings.resetCube = ImGui::Button("Reset Cube");
+		ImGui::Checkbox("Rotate X", &settings.rotateX);
+		ImGui::Checkbox("Rotate Y", &settings.rotateY);
+		ImGui::Checkbox("Rotate Z", &settings.rotateZ);
+		ImGui::SliderFloat("Rotate Speed", &settings.rotateSpeed, -1.0f, 1.0f);
+		if (modelMesh.indexCount > 0 && ImGui::Checkbox("Show Suzanne", &settings.showModel)) {
+			FillFrameBindings();
+		}
 	}
 	if (ImGui::CollapsingHeader("Post Processing")) {
-		int regInt = ppOption;
+		int regInt = settings.ppOption;
 		const char* ppText = " ";
-		switch (ppOption) {
+		switch (settings.ppOption) {
 		case 0:
 			ppText = "None";
 			break;
@@ -893,7 +897,7 @@ void Renderer::RenderImGui()
 		}
 		ImGui::Text(ppText);
 		ImGui::SliderInt(" ", &regInt, 0, 3);
-		ppOption = regInt;
+		settings.ppOption = regInt;
 	}
 	ImGui::End();
 
@@ -901,41 +905,3 @@ void Renderer::RenderImGui()
 	assets->GetCommandList()->SetDescriptorHeaps(1, &fontDescriptorHeap);
 	ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), assets->GetCommandList());
 }
-
-void DescriptorHeapAllocator::Create(ID3D12Device* device, ID3D12DescriptorHeap* heap)
-{
-	IM_ASSERT(Heap == nullptr && FreeIndices.empty());
-	Heap = heap;
-	D3D12_DESCRIPTOR_HEAP_DESC desc = heap->GetDesc();
-	HeapType = desc.Type;
-	HeapStartCpu = Heap->GetCPUDescriptorHandleForHeapStart();
-	HeapStartGpu = Heap->GetGPUDescriptorHandleForHeapStart();
-	HeapHandleIncrement = device->GetDescriptorHandleIncrementSize(HeapType);
-	FreeIndices.reserve((int)desc.NumDescriptors);
-	for (int n = desc.NumDescriptors; n > 0; n--) {
-		FreeIndices.push_back(n);
-	}
-}
-
-void DescriptorHeapAllocator::Destroy()
-{
-	Heap = nullptr;
-	FreeIndices.clear();
-}
-
-void DescriptorHeapAllocator::Alloc(D3D12_CPU_DESCRIPTOR_HANDLE* out_cpu_desc_handle, D3D12_GPU_DESCRIPTOR_HANDLE* out_gpu_desc_handle)
-{
-	IM_ASSERT(FreeIndices.Size > 0);
-	int idx = FreeIndices.back();
-	FreeIndices.pop_back();
-	out_cpu_desc_handle->ptr = HeapStartCpu.ptr + (idx * HeapHandleIncrement);
-	out_gpu_desc_handle->ptr = HeapStartGpu.ptr + (idx * HeapHandleIncrement);
-}
-
-void DescriptorHeapAllocator::Free(D3D12_CPU_DESCRIPTOR_HANDLE out_cpu_desc_handle, D3D12_GPU_DESCRIPTOR_HANDLE out_gpu_desc_handle)
-{
-	int cpu_idx = (int)((out_cpu_desc_handle.ptr - HeapStartCpu.ptr) / HeapHandleIncrement);
-	int gpu_idx = (int)((out_gpu_desc_handle.ptr - HeapStartGpu.ptr) / HeapHandleIncrement);
-	IM_ASSERT(cpu_idx == gpu_idx);
-	FreeIndices.push_back(cpu_idx);
-}
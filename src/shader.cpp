@@ -1,23 +1,86 @@
 #include "shader.h"
 
-bool Shader::Init(LPCWSTR filename, LPCSTR entryFunc, LPCSTR target)
+#ifdef SHADER_PRECOMPILED
+#include "embeddedshaders.h"
+#endif
+
+bool Shader::Init(LPCWSTR filename, LPCSTR entryFunc, LPCSTR target, const D3D_SHADER_MACRO* defines, ShaderCache* cache)
 {
+#ifdef SHADER_PRECOMPILED
+	// Every variant was compiled with the build, the HLSL compiler is never called
+	std::string name = GetShaderVariantName(filename, entryFunc, target, defines);
+	const ShaderBytecodeEntry* embedded = FindShaderBytecode(embeddedShaders, name);
+	if (!embedded)
+	{
+		OutputDebugStringA(("No precompiled bytecode for " + name + ", add it with compile_shader() in CMakeLists.txt\n").c_str());
+		return false;
+	}
+	shaderBytecode = {};
+	shaderBytecode.BytecodeLength = embedded->size;
+	shaderBytecode.pShaderBytecode = embedded->data;
+	return true;
+#else
 	HRESULT result;
 
-	result = D3DCompileFromFile(filename, nullptr, nullptr,
-		entryFunc, target, 0,
-		0, &shaderBlob, &errorBlob);
+	std::vector<UINT8> bytecode;
+	std::string errors;
+	bool compiled = cache ? cache->Load(filename, entryFunc, target, defines, &bytecode, &errors) :
+		Compile(filename, entryFunc, target, defines, &bytecode, &errors);
+	if (!compiled)
+	{
+		OutputDebugStringA(errors.c_str());
+		if (SUCCEEDED(D3DCreateBlob(errors.size() + 1, &errorBlob))) {
+			memcpy(errorBlob->GetBufferPointer(), errors.c_str(), errors.size() + 1);
+		}
+		return false;
+	}
+
+	result = D3DCreateBlob(bytecode.size(), &shaderBlob);
 	if (FAILED(result))
 	{
-		OutputDebugStringA((char*)errorBlob->GetBufferPointer());
 		return false;
 	}
+	memcpy(shaderBlob->GetBufferPointer(), bytecode.data(), bytecode.size());
 
 	shaderBytecode = {};
 	shaderBytecode.BytecodeLength = shaderBlob->GetBufferSize();
 	shaderBytecode.pShaderBytecode = shaderBlob->GetBufferPointer();
 
 	return true;
+#endif
+}
+
+bool Shader::Compile(const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines,
+	std::vector<UINT8>* bytecode, std::string* errors)
+{
+	ID3DBlob* blob = nullptr;
+	ID3DBlob* compileErrors = nullptr;
+	HRESULT result = D3DCompileFromFile(path.c_str(), defines, D3D_COMPILE_STANDARD_FILE_INCLUDE,
+		entry, target, SHADER_COMPILE_FLAGS,
+		0, &blob, &compileErrors);
+	if (compileErrors)
+	{
+		errors->assign((const char*)compileErrors->GetBufferPointer(), compileErrors->GetBufferSize());
+		compileErrors->Release();
+	}
+	if (FAILED(result))
+	{
+		if (!compileErrors) {
+			*errors = "failed to open " + path.string() + "\n";
+		}
+		SAFE_RELEASE(blob);
+		return false;
+	}
+
+	const UINT8* data = (const UINT8*)blob->GetBufferPointer();
+	bytecode->assign(data, data + blob->GetBufferSize());
+	blob->Release();
+	return true;
+}
+
+std::string Shader::GetCompilerTag()
+{
+	return "d3dcompiler_" + std::to_string(D3D_COMPILER_VERSION) + " flags " + std::to_string(SHADER_COMPILE_FLAGS);
 }
 
 ID3DBlob* Shader::GetBlob() { return shaderBlob; }
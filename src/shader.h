@@ -1,20 +1,34 @@
 #pragma once
 
 #include "gconst.h"
+#include "shadercache.h"
+#include "shaderbytecode.h"
+
+// Flags every shader is compiled with, part of the cache key through the compiler tag
+#define SHADER_COMPILE_FLAGS 0
 
 class Shader {
 
 public:
 
-	bool Init(LPCWSTR filename, LPCSTR entryFunc, LPCSTR target);
+	// With a cache the bytecode is read from disk unless the source, its includes or the
+	// defines changed since it was last compiled. SHADER_PRECOMPILED builds take the variant
+	// embedded at build time instead and ignore the cache.
+	bool Init(LPCWSTR filename, LPCSTR entryFunc, LPCSTR target, const D3D_SHADER_MACRO* defines = nullptr, ShaderCache* cache = nullptr);
+	// Null for embedded shaders
 	ID3DBlob* GetBlob();
 	ID3DBlob* GetErrorBlob();
 	D3D12_SHADER_BYTECODE GetBytecode();
 
+	// D3DCompileFromFile with the standard include handler, the shader cache's compiler
+	static bool Compile(const std::filesystem::path& path, const char* entry, const char* target, const D3D_SHADER_MACRO* defines,
+		std::vector<UINT8>* bytecode, std::string* errors);
+	static std::string GetCompilerTag();
+
 private:
 
-	ID3DBlob* shaderBlob;
-	ID3DBlob* errorBlob;
+	ID3DBlob* shaderBlob = nullptr;
+	ID3DBlob* errorBlob = nullptr;
 	D3D12_SHADER_BYTECODE shaderBytecode;
 
 };
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "assetpackage.h"
+#include "meshimporter.h"
+#include "imagedecoder.h"
+#include "mipgenerator.h"
+#include "ddsfile.h"
+
+#include <cstdio>
+#include <fstream>
+
+// Packs source assets into one package the renderer maps at startup:
+//   asset_packer <output.pak> <input>...
+// Meshes (.fbx, .obj) are imported and optimized, images (.png, .jpg) are decoded to RGBA8
+// with a Kaiser filtered mip chain, DDS textures keep their format and mips, and compiled
+// shaders (.cso, .dxil) are stored as they are. Entries are named after the input's file
+// name without its extension.
+int main(int argc, char* args[]) {
+
+	if (argc < 3) {
+		printf("usage: asset_packer <output.pak> <input>...\n");
+		return 1;
+	}
+
+	AssetPackageWriter writer;
+	MeshImporter importer;
+	ImageDecoder decoder;
+	for (int i = 2; i < argc; i++)
+	{
+		std::filesystem::path input = args[i];
+		std::string name = input.stem().string();
+		std::string extension = input.extension().string();
+		for (char& c : extension) {
+			c = (char)tolower(c);
+		}
+
+		bool added = false;
+		if (extension == ".fbx" || extension == ".obj")
+		{
+			MeshData mesh;
+			added = importer.Import(input, &mesh) && writer.AddMesh(name, mesh.vertices, mesh.indices);
+			if (added) {
+				printf("asset_packer: mesh %s, %zu vertices, %zu indices\n", name.c_str(), mesh.vertices.size(), mesh.indices.size());
+			}
+		}
+		else if (extension == ".png" || extension == ".jpg" || extension == ".jpeg")
+		{
+			ImageData image;
+			AssetTextureInfo info = {};
+			if (decoder.Load(input, DXGI_FORMAT_R8G8B8A8_UNORM, &image)) {
+				info = { image.width, image.height, GetMipLevelCount(image.width, image.height), image.format };
+				MipLevel levels[D3D12_REQ_MIP_LEVELS];
+				std::vector<UINT8> chain((size_t)GetMipChainLayout(info.width, info.height, info.mipLevels, levels));
+				memcpy(chain.data(), image.pixels.data(), image.pixels.size());
+				GenerateMipChain(chain.data(), info.width, info.height, info.mipLevels, MF_KAISER);
+
+				D3D12_SUBRESOURCE_DATA subresources[D3D12_REQ_MIP_LEVELS];
+				for (UINT mip = 0; mip < info.mipLevels; mip++) {
+					subresources[mip] = { chain.data() + levels[mip].offset, (LONG_PTR)levels[mip].rowPitch, (LONG_PTR)(levels[mip].rowPitch * levels[mip].rows) };
+				}
+				added = writer.AddTexture(name, info, subresources);
+			}
+			if (added) {
+				printf("asset_packer: texture %s, %ux%u, %u mips\n", name.c_str(), info.width, info.height, info.mipLevels);
+			}
+		}
+		else if (extension == ".dds")
+		{
+			std::ifstream file(input, std::ios::binary);
+			std::vector<UINT8> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			DdsInfo dds;
+			AssetTextureInfo info = {};
+			if (ReadDdsInfo(data, &dds)) {
+				info = { dds.width, dds.height, dds.mipLevels, dds.format };
+				MipLevel levels[D3D12_REQ_MIP_LEVELS];
+				GetMipChainLayout(info.width, info.height, info.mipLevels, levels, info.format);
+				D3D12_SUBRESOURCE_DATA subresources[D3D12_REQ_MIP_LEVELS];
+				for (UINT mip = 0; mip < info.mipLevels; mip++) {
+					subresources[mip] = { data.data() + dds.dataOffset + levels[mip].offset, (LONG_PTR)levels[mip].rowPitch, (LONG_PTR)(levels[mip].rowPitch * levels[mip].rows) };
+				}
+				added = writer.AddTexture(name, info, subresources);
+			}
+			if (added) {
+				printf("asset_packer: texture %s, %ux%u, %u mips, DXGI format %u\n", name.c_str(), info.width, info.height, info.mipLevels, (UINT)info.format);
+			}
+		}
+		else if (extension == ".cso" || extension == ".dxil")
+		{
+			std::ifstream file(input, std::ios::binary);
+			std::vector<UINT8> bytecode((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			added = !bytecode.empty() && writer.AddShader(name, bytecode);
+			if (added) {
+				printf("asset_packer: shader %s, %zu bytes\n", name.c_str(), bytecode.size());
+			}
+		}
+		else
+		{
+			printf("asset_packer: no packer for %s\n", args[i]);
+			return 1;
+		}
+
+		if (!added) {
+			printf("asset_packer: failed to pack %s\n", args[i]);
+			return 1;
+		}
+	}
+
+	if (!writer.Write(args[1])) {
+		printf("asset_packer: could not write %s\n", args[1]);
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
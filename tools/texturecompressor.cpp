@@ -0,0 +1,60 @@
+#include "imagedecoder.h"
+#include "mipgenerator.h"
+#include "blockcompress.h"
+#include "ddsfile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Converts a source image to a block compressed DDS with a full mip chain:
+//   texture_compressor <input.png|jpg> <output.dds> [bc1|bc3|bc5|bc7]
+// Levels are Kaiser filtered from the decoded RGBA8 image, then every level is compressed
+// on one worker per hardware thread. BC7 is the default.
+int main(int argc, char* args[]) {
+
+	if (argc < 3) {
+		printf("usage: texture_compressor <input.png|jpg> <output.dds> [bc1|bc3|bc5|bc7]\n");
+		return 1;
+	}
+
+	std::string name = argc > 3 ? args[3] : "bc7";
+	DXGI_FORMAT format = name == "bc1" ? DXGI_FORMAT_BC1_UNORM : name == "bc3" ? DXGI_FORMAT_BC3_UNORM :
+		name == "bc5" ? DXGI_FORMAT_BC5_UNORM : name == "bc7" ? DXGI_FORMAT_BC7_UNORM : DXGI_FORMAT_UNKNOWN;
+	if (format == DXGI_FORMAT_UNKNOWN) {
+		printf("texture_compressor: unknown format %s\n", name.c_str());
+		return 1;
+	}
+
+	ImageDecoder decoder;
+	ImageData image;
+	if (!decoder.Load(args[1], DXGI_FORMAT_R8G8B8A8_UNORM, &image)) {
+		printf("texture_compressor: could not decode %s\n", args[1]);
+		return 1;
+	}
+
+	// Build The RGBA8 Mip Chain
+	UINT mipLevels = GetMipLevelCount(image.width, image.height);
+	MipLevel levels[D3D12_REQ_MIP_LEVELS], blockLevels[D3D12_REQ_MIP_LEVELS];
+	std::vector<UINT8> chain((size_t)GetMipChainLayout(image.width, image.height, mipLevels, levels));
+	memcpy(chain.data(), image.pixels.data(), image.pixels.size());
+	GenerateMipChain(chain.data(), image.width, image.height, mipLevels, MF_KAISER);
+
+	// Compress Every Level
+	WorkerPool workers;
+	workers.Init();
+	std::vector<UINT8> blocks((size_t)GetMipChainLayout(image.width, image.height, mipLevels, blockLevels, format));
+	auto start = std::chrono::steady_clock::now();
+	for (UINT mip = 0; mip < mipLevels; mip++) {
+		CompressImage(chain.data() + levels[mip].offset, levels[mip].width, levels[mip].height, format, blocks.data() + blockLevels[mip].offset, &workers);
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	if (!WriteDds(args[2], image.width, image.height, mipLevels, format, blocks)) {
+		printf("texture_compressor: could not write %s\n", args[2]);
+		return 1;
+	}
+	printf("texture_compressor: %s %ux%u, %u mips, %s %zu bytes in %.1f ms on %u workers\n", args[1], image.width, image.height, mipLevels,
+		name.c_str(), blocks.size(), std::chrono::duration<double, std::milli>(end - start).count(), workers.GetThreadCount());
+	return 0;
+}
\ No newline at end of file